@@ -8,6 +8,8 @@
 #cmakedefine CPPUTEST_HAVE_FORK
 #cmakedefine CPPUTEST_HAVE_WAITPID
 #cmakedefine CPPUTEST_HAVE_PTHREAD_MUTEX_LOCK
+#cmakedefine CPPUTEST_HAVE_BACKTRACE
+#cmakedefine CPPUTEST_HAVE_MPROTECT
 
 #cmakedefine CPPUTEST_HAVE_GETTIMEOFDAY
 
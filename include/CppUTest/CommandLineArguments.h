@@ -50,10 +50,13 @@ public:
     bool isListingTestLocations() const;
     bool isRunIgnored() const;
     size_t getRepeatCount() const;
+    size_t getAllocationFailureSweepProcesses() const;
     bool isShuffling() const;
     bool isReversing() const;
     bool isCrashingOnFail() const;
     bool isRethrowingExceptions() const;
+    bool isUsingStringCache() const;
+    bool isUpdatingGoldenFiles() const;
     size_t getShuffleSeed() const;
     const TestFilter* getGroupFilters() const;
     const TestFilter* getNameFilters() const;
@@ -87,10 +90,13 @@ private:
     bool reversing_;
     bool crashOnFail_;
     bool rethrowExceptions_;
+    bool stringCache_;
+    bool updateGoldenFiles_;
     bool shuffling_;
     bool shufflingPreSeeded_;
     size_t repeat_;
     size_t shuffleSeed_;
+    size_t allocationFailureSweepProcesses_;
     TestFilter* groupFilters_;
     TestFilter* nameFilters_;
     OutputType outputType_;
@@ -98,6 +104,7 @@ private:
 
     SimpleString getParameterField(int ac, const char *const *av, int& i, const SimpleString& parameterName);
     void setRepeatCount(int ac, const char *const *av, int& index);
+    void setAllocationFailureSweep(int ac, const char *const *av, int& index);
     bool setShuffle(int ac, const char *const *av, int& index);
     void addGroupFilter(int ac, const char *const *av, int& index);
     bool addGroupDotNameFilter(int ac, const char *const *av, int& index, const SimpleString& parameterName, bool strict, bool exclude);
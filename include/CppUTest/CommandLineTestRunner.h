@@ -62,6 +62,7 @@ private:
 
     bool parseArguments(TestPlugin*);
     int runAllTests();
+    int runAllTestsWithStringCache();
     void initializeTestRun();
 };
 
@@ -154,6 +154,15 @@
   #define CPPUTEST_DO_NOT_SANITIZE_ADDRESS
 #endif
 
+/*
+ * The return address of the current function, as it appears in a stack trace. Compilers that can't tell give NULL.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+  #define CPPUTEST_RETURN_ADDRESS() __builtin_return_address(0)
+#else
+  #define CPPUTEST_RETURN_ADDRESS() 0
+#endif
+
 /*
  * Handling of IEEE754 (IEC559) floating point exceptions via fenv.h
  * Predominantly works on non-Visual C++ compilers and Visual C++ 2008 and newer
@@ -350,6 +359,25 @@ typedef struct
   #endif
 #endif
 
+#ifdef __cplusplus
+  /* Visual C++ 14.0+ (2015+) supports rvalue references that can be used for move construction and assignment */
+  #ifndef CPPUTEST_HAVE_MOVE_SEMANTICS
+    #if (__cplusplus >= 201103L) || (defined(_MSC_VER) && (_MSC_VER >= 1900))
+      #define CPPUTEST_HAVE_MOVE_SEMANTICS 1
+    #else
+      #define CPPUTEST_HAVE_MOVE_SEMANTICS 0
+    #endif
+  #endif
+#endif
+
+/*
+ * Strings that fit in this many characters (including the terminating 0) are stored inside the SimpleString
+ * itself instead of in a buffer from the string allocator. Set it to 1 to allocate every string, like before.
+ */
+#ifndef CPPUTEST_SIMPLESTRING_INLINE_BUFFER_SIZE
+  #define CPPUTEST_SIMPLESTRING_INLINE_BUFFER_SIZE 24
+#endif
+
 #ifdef __clang__
  #pragma clang diagnostic pop
 #endif
@@ -74,6 +74,7 @@ protected:
     virtual void writeTestCases();
     virtual SimpleString encodeXmlText(const SimpleString& textbody);
     virtual SimpleString encodeFileName(const SimpleString& fileName);
+    virtual void writePeakMemory(JUnitTestCaseResultNode* node);
     virtual void writeFailure(JUnitTestCaseResultNode* node);
     virtual void writeFileEnding();
 };
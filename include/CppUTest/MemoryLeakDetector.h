@@ -36,7 +36,28 @@ enum MemLeakPeriod
     mem_leak_period_checking
 };
 
+/* How much checking the memory leak detector does for each allocation, from cheapest to most thorough. With the tier
+ * off, allocations are passed straight through to the allocator without being numbered or remembered, so memory
+ * allocated while it is off has to be freed while it is off. Count only numbers the allocations and remembers them,
+ * so it still reports freeing memory that was never allocated */
+enum MemLeakTier
+{
+    mem_leak_tier_off,
+    mem_leak_tier_count_only,
+    mem_leak_tier_leak_only,
+    mem_leak_tier_full
+};
+
+enum MemLeakSampling
+{
+    mem_leak_sampling_none,
+    mem_leak_sampling_allocations,
+    mem_leak_sampling_bytes
+};
+
 class TestMemoryAllocator;
+class ArenaTestMemoryAllocator;
+class TestOutput;
 class SimpleMutex;
 
 class MemoryLeakFailure
@@ -49,6 +70,40 @@ public:
     virtual void fail(char* fail_string)=0;
 };
 
+class MemoryLeakReportSink
+{
+public:
+    virtual ~MemoryLeakReportSink()
+    {
+    }
+
+    virtual void write(const char* chunk)=0;
+};
+
+class TestOutputMemoryLeakReportSink : public MemoryLeakReportSink
+{
+public:
+    TestOutputMemoryLeakReportSink(TestOutput& output);
+
+    virtual void write(const char* chunk) CPPUTEST_OVERRIDE;
+
+private:
+    TestOutput& output_;
+};
+
+class FileMemoryLeakReportSink : public MemoryLeakReportSink
+{
+public:
+    FileMemoryLeakReportSink(const char* fileName, const char* flag = "a");
+    virtual ~FileMemoryLeakReportSink() CPPUTEST_DESTRUCTOR_OVERRIDE;
+
+    bool isOpen() const;
+    virtual void write(const char* chunk) CPPUTEST_OVERRIDE;
+
+private:
+    void* file_;
+};
+
 struct SimpleStringBuffer
 {
     enum
@@ -66,13 +121,23 @@ struct SimpleStringBuffer
     void setWriteLimit(size_t write_limit);
     void resetWriteLimit();
     bool reachedItsCapacity();
+    bool wasTruncated() const;
+
+    void setSink(MemoryLeakReportSink* sink);
+    bool isStreaming() const;
+    void flush();
 private:
+    size_t write(const char* format, va_list arguments);
+
     char buffer_[SIMPLE_STRING_BUFFER_LEN];
     size_t positions_filled_;
     size_t write_limit_;
+    bool truncated_;
+    MemoryLeakReportSink* sink_;
 };
 
 struct MemoryLeakDetectorNode;
+struct MemoryLeakStackTrace;
 
 class MemoryLeakOutputStringBuffer
 {
@@ -80,11 +145,14 @@ public:
     MemoryLeakOutputStringBuffer();
 
     void clear();
+    void setSink(MemoryLeakReportSink* sink);
 
     void startMemoryLeakReporting();
     void stopMemoryLeakReporting();
 
     void reportMemoryLeak(MemoryLeakDetectorNode* leak);
+    void reportMemoryLeakSite(const char* file, size_t line, TestMemoryAllocator* allocator, size_t leaks, size_t bytes);
+    void reportSampling(MemLeakSampling sampling, size_t samplingRate);
 
     void reportDeallocateNonAllocatedMemoryFailure(const char* freeFile, size_t freeLine, TestMemoryAllocator* freeAllocator, MemoryLeakFailure* reporter);
     void reportMemoryCorruptionFailure(MemoryLeakDetectorNode* node, const char* freeFile, size_t freeLineNumber, TestMemoryAllocator* freeAllocator, MemoryLeakFailure* reporter);
@@ -100,28 +168,118 @@ private:
     void addWarningForUsingMalloc();
     void addNoMemoryLeaksMessage();
     void addErrorMessageForTooMuchLeaks();
+    void addSamplingMessage(MemLeakSampling sampling, size_t samplingRate);
+    void addStackTrace(MemoryLeakStackTrace* stack);
+    void countLeaks(size_t leaks, TestMemoryAllocator* allocator);
 
 private:
 
     size_t total_leaks_;
     bool giveWarningOnUsingMalloc_;
+    MemLeakSampling sampling_;
+    size_t samplingRate_;
 
     void reportFailure(const char* message, const char* allocFile,
             size_t allocLine, size_t allocSize,
-            TestMemoryAllocator* allocAllocator, const char* freeFile,
+            TestMemoryAllocator* allocAllocator, MemoryLeakStackTrace* allocStack, const char* freeFile,
             size_t freeLine, TestMemoryAllocator* freeAllocator, MemoryLeakFailure* reporter);
 
     SimpleStringBuffer outputBuffer_;
 };
 
+struct MemoryLeakStackTrace
+{
+    enum
+    {
+        MAX_DEPTH = 16,
+        MAX_DETECTOR_DEPTH = 16
+    };
+
+    unsigned long hash_;
+    size_t depth_;
+    void* frames_[MAX_DEPTH];
+    MemoryLeakStackTrace* next_;
+};
+
+class MemoryLeakDetector;
+
+/* Allocation entry points, like operator new and cpputest_malloc, mark where they were called from. The stack trace
+ * of the allocation starts at that caller instead of inside the leak detector. Nested entry points keep the outermost
+ * caller. The detector keeps the caller, and only while it captures stack traces */
+class MemoryLeakAllocationCaller
+{
+public:
+    MemoryLeakAllocationCaller(MemoryLeakDetector* detector, void* returnAddress);
+    ~MemoryLeakAllocationCaller();
+
+private:
+    MemoryLeakDetector* detector_;
+    bool marked_;
+};
+
+struct MemoryLeakStackTraceTable
+{
+    MemoryLeakStackTraceTable();
+    ~MemoryLeakStackTraceTable();
+
+    MemoryLeakStackTrace* store(void** frames, size_t depth);
+    size_t size() const;
+    void clear();
+
+    enum
+    {
+        MAX_STACK_TRACES = 4096
+    };
+
+private:
+    unsigned long hash(void** frames, size_t depth);
+    bool equal(MemoryLeakStackTrace* stack, void** frames, size_t depth);
+
+    enum
+    {
+        hash_prime = MEMORY_LEAK_HASH_TABLE_SIZE
+    };
+    MemoryLeakStackTrace* table_[hash_prime];
+    size_t count_;
+};
+
+struct MemoryLeakUntrackedMemory
+{
+    char* memory_;
+    size_t size_;
+    TestMemoryAllocator* allocator_;
+};
+
+/* Memory that was sampled out or tiered off has no accounting information. It is remembered in an open addressing
+ * table so it can still be told apart from memory that was never allocated */
+struct MemoryLeakUntrackedMemoryTable
+{
+    MemoryLeakUntrackedMemoryTable();
+    ~MemoryLeakUntrackedMemoryTable();
+
+    bool add(char* memory, size_t size, TestMemoryAllocator* allocator);
+    MemoryLeakUntrackedMemory* retrieve(char* memory);
+    bool remove(char* memory);
+    size_t size() const;
+    void clear();
+
+private:
+    size_t slot(char* memory) const;
+    bool grow();
+
+    MemoryLeakUntrackedMemory* entries_;
+    size_t capacity_;
+    size_t count_;
+};
+
 struct MemoryLeakDetectorNode
 {
     MemoryLeakDetectorNode() :
-        size_(0), number_(0), memory_(NULLPTR), file_(NULLPTR), line_(0), allocator_(NULLPTR), period_(mem_leak_period_enabled), allocation_stage_(0), next_(NULLPTR)
+        size_(0), number_(0), memory_(NULLPTR), file_(NULLPTR), line_(0), allocator_(NULLPTR), period_(mem_leak_period_enabled), allocation_stage_(0), guarded_(false), stack_(NULLPTR), next_(NULLPTR)
     {
     }
 
-    void init(char* memory, unsigned number, size_t size, TestMemoryAllocator* allocator, MemLeakPeriod period, unsigned char allocation_stage, const char* file, size_t line);
+    void init(char* memory, unsigned number, size_t size, TestMemoryAllocator* allocator, MemLeakPeriod period, unsigned char allocation_stage, const char* file, size_t line, bool guarded);
 
     size_t size_;
     unsigned number_;
@@ -131,6 +289,8 @@ struct MemoryLeakDetectorNode
     TestMemoryAllocator* allocator_;
     MemLeakPeriod period_;
     unsigned char allocation_stage_;
+    bool guarded_;
+    MemoryLeakStackTrace* stack_;
 
 private:
     friend struct MemoryLeakDetectorList;
@@ -203,6 +363,24 @@ public:
     void disableAllocationTypeChecking();
     void enableAllocationTypeChecking();
 
+    void setTier(MemLeakTier tier);
+    MemLeakTier getTier() const;
+    bool isTrackingLeaks() const;
+
+    void sampleEveryNthAllocation(size_t n);
+    void sampleEveryNBytes(size_t n);
+    void disableSampling();
+    MemLeakSampling getSampling() const;
+    size_t getSamplingRate() const;
+    size_t getUntrackedAllocations() const;
+
+    void captureStackTraces(size_t depth);
+    size_t getStackTraceDepth() const;
+    size_t getNumberOfStackTraces() const;
+    bool markAllocationCaller(void* returnAddress);
+    void unmarkAllocationCaller();
+    void* getAllocationCaller() const;
+
     void startChecking();
     void stopChecking();
 
@@ -211,10 +389,20 @@ public:
     void decreaseAllocationStage();
 
     const char* report(MemLeakPeriod period);
+    void report(MemLeakPeriod period, MemoryLeakReportSink& sink);
+    void reportLeaksBySite(bool bySite);
+    bool isReportingLeaksBySite() const;
     void markCheckingPeriodLeaksAsNonCheckingPeriod();
     size_t totalMemoryLeaks(MemLeakPeriod period);
     void clearAllAccounting(MemLeakPeriod period);
 
+    /* Bytes of tracked memory, untracked (sampled out or tiered off) memory isn't counted */
+    size_t getLiveBytes(MemLeakPeriod period) const;
+    size_t getPeakBytes(MemLeakPeriod period) const;
+    void resetPeakBytes();
+    /* Bytes of all allocations, tracked or not */
+    size_t getTotalAllocatedBytes() const;
+
     char* allocMemory(TestMemoryAllocator* allocator, size_t size, bool allocatNodesSeperately = false);
     char* allocMemory(TestMemoryAllocator* allocator, size_t size,
             const char* file, size_t line, bool allocatNodesSeperately = false);
@@ -236,6 +424,13 @@ public:
 
     unsigned getCurrentAllocationNumber();
 
+    /* Remembers the file and line of the allocation with the given number, 0 watches no allocation.
+     * A watch whose allocation was already seen is restored by passing its location too */
+    void watchAllocation(unsigned number, const char* file = NULLPTR, size_t line = 0);
+    unsigned getWatchedAllocation() const;
+    const char* getWatchedAllocationFile() const;
+    size_t getWatchedAllocationLine() const;
+
     SimpleMutex* getMutex(void);
 private:
     MemoryLeakFailure* reporter_;
@@ -246,6 +441,35 @@ private:
     unsigned allocationSequenceNumber_;
     unsigned char current_allocation_stage_;
     SimpleMutex* mutex_;
+    MemLeakTier tier_;
+    MemLeakSampling sampling_;
+    size_t samplingRate_;
+    size_t samplingCountdown_;
+    unsigned long samplingRandom_;
+    MemoryLeakUntrackedMemoryTable untrackedMemory_;
+    size_t stackTraceDepth_;
+    void* allocationCaller_;
+    MemoryLeakStackTraceTable stackTraces_;
+    bool reportLeaksBySite_;
+    size_t liveBytes_[mem_leak_period_checking + 1];
+    size_t peakBytes_[mem_leak_period_checking + 1];
+    size_t totalAllocatedBytes_;
+    unsigned watchedAllocation_;
+    const char* watchedAllocationFile_;
+    size_t watchedAllocationLine_;
+
+    void addNode(MemoryLeakDetectorNode* node);
+    MemoryLeakDetectorNode* removeNode(char* memory);
+    void recountLiveBytes();
+
+    size_t nextSamplingInterval();
+    bool shouldTrackAllocation(size_t size);
+    bool passesMemoryThrough(TestMemoryAllocator* allocator) const;
+    bool isKnownMemory(char* memory);
+    char* registerUntrackedMemory(TestMemoryAllocator* allocator, char* memory, size_t size);
+    void deallocateUntrackedMemory(MemoryLeakUntrackedMemory* untracked, const char* file, size_t line);
+    char* reallocateUntrackedMemory(MemoryLeakUntrackedMemory* untracked, size_t size, const char* file, size_t line);
+    MemoryLeakStackTrace* captureStackTrace();
 
     char* allocateMemoryWithAccountingInformation(TestMemoryAllocator* allocator, size_t size, const char* file, size_t line, bool allocatNodesSeperately);
     char* reallocateMemoryWithAccountingInformation(TestMemoryAllocator* allocator, char* memory, size_t size, const char* file, size_t line, bool allocatNodesSeperately);
@@ -255,13 +479,19 @@ private:
     bool validMemoryCorruptionInformation(char* memory);
     bool matchingAllocation(TestMemoryAllocator *alloc_allocator, TestMemoryAllocator *free_allocator);
 
-    void storeLeakInformation(MemoryLeakDetectorNode * node, char *new_memory, size_t size, TestMemoryAllocator *allocator, const char *file, size_t line);
+    unsigned countAllocation(size_t size, const char* file, size_t line);
+    void storeLeakInformation(MemoryLeakDetectorNode * node, unsigned number, char *new_memory, size_t size, TestMemoryAllocator *allocator, const char *file, size_t line);
     void ConstructMemoryLeakReport(MemLeakPeriod period);
+    void ConstructMemoryLeakReportBySite(MemLeakPeriod period);
 
     size_t sizeOfMemoryWithCorruptionInfo(size_t size);
     MemoryLeakDetectorNode* getNodeFromMemoryPointer(char* memory, size_t size);
 
-    char* reallocateMemoryAndLeakInformation(TestMemoryAllocator* allocator, char* memory, size_t size, const char* file, size_t line, bool allocatNodesSeperately);
+    char* reallocateMemoryAndLeakInformation(MemoryLeakDetectorNode* node, unsigned number, TestMemoryAllocator* allocator, char* memory, size_t size, const char* file, size_t line, bool allocatNodesSeperately);
+    char* reallocateGuardedMemory(TestMemoryAllocator* allocator, char* memory, size_t size, const char* file, size_t line);
+    char* allocateBulkReleasedMemory(TestMemoryAllocator* allocator, size_t size, const char* file, size_t line);
+    char* reallocateBulkReleasedMemory(TestMemoryAllocator* allocator, char* memory, size_t size, const char* file, size_t line);
+    char* reallocateArenaMemory(ArenaTestMemoryAllocator* arena, unsigned number, TestMemoryAllocator* allocator, char* memory, size_t size, const char* file, size_t line, bool allocatNodesSeperately);
 
     void addMemoryCorruptionInformation(char* memory);
     void checkForCorruption(MemoryLeakDetectorNode* node, const char* file, size_t line, TestMemoryAllocator* allocator, bool allocateNodesSeperately);
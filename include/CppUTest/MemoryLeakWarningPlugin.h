@@ -29,15 +29,54 @@
 #define D_MemoryLeakWarningPlugin_h
 
 #include "TestPlugin.h"
+#include "MemoryLeakDetector.h"
 #include "MemoryLeakDetectorNewMacros.h"
 
 #define IGNORE_ALL_LEAKS_IN_TEST() if (MemoryLeakWarningPlugin::getFirstPlugin()) MemoryLeakWarningPlugin::getFirstPlugin()->ignoreAllLeaksInTest()
 #define EXPECT_N_LEAKS(n)          if (MemoryLeakWarningPlugin::getFirstPlugin()) MemoryLeakWarningPlugin::getFirstPlugin()->expectLeaksInTest(n)
+#define SAMPLE_LEAKS_EVERY_N_ALLOCATIONS(n) if (MemoryLeakWarningPlugin::getFirstPlugin()) MemoryLeakWarningPlugin::getFirstPlugin()->sampleLeaksEveryNthAllocationInTest(n)
+#define SAMPLE_LEAKS_EVERY_N_BYTES(n)       if (MemoryLeakWarningPlugin::getFirstPlugin()) MemoryLeakWarningPlugin::getFirstPlugin()->sampleLeaksEveryNBytesInTest(n)
+#define SET_MEMORY_LEAK_TIER(tier)          if (MemoryLeakWarningPlugin::getFirstPlugin()) MemoryLeakWarningPlugin::getFirstPlugin()->setTierInTest(tier)
+
+#define MEMORY_LIVE_BYTES() (MemoryLeakWarningPlugin::getFirstPlugin() ? MemoryLeakWarningPlugin::getFirstPlugin()->getLiveBytesInTest() : 0)
+#define MEMORY_PEAK_LESS_THAN(bytes) MEMORY_PEAK_LESS_THAN_LOCATION(bytes, __FILE__, __LINE__)
+#define MEMORY_PEAK_LESS_THAN_LOCATION(bytes, file, line) if (MemoryLeakWarningPlugin::getFirstPlugin()) MemoryLeakWarningPlugin::getFirstPlugin()->checkPeakInTest(bytes, file, line)
+
+/* The scope following CHECK_ALLOCATIONS_AT_MOST is the else branch of the if holding the budget. The budget is checked
+ * however the scope is left, and a break or continue in it belongs to the enclosing loop */
+#define CHECK_NO_ALLOCATIONS CHECK_ALLOCATIONS_AT_MOST(0)
+#define CHECK_ALLOCATIONS_AT_MOST(n) CHECK_ALLOCATIONS_AT_MOST_LOCATION(n, __FILE__, __LINE__)
+#define CHECK_ALLOCATIONS_AT_MOST_LOCATION(n, file, line) \
+    if (const AllocationBudgetScope& cpputest_allocation_budget = AllocationBudgetScope(n, file, line)) {} else
 
 extern void crash_on_allocation_number(unsigned alloc_number);
 
-class MemoryLeakDetector;
-class MemoryLeakFailure;
+class TestOutput;
+
+/* Settings given on the command line as -p<option>=<value> for all groups or -p<option>=<group>:<value> for one group */
+class MemoryLeakGroupSettings
+{
+public:
+    MemoryLeakGroupSettings();
+
+    bool parse(const SimpleString& argument, const SimpleString& option);
+    static bool split(const SimpleString& argument, const SimpleString& option, SimpleString& group, SimpleString& value);
+    void add(const SimpleString& group, size_t value);
+    bool find(const SimpleString& group, size_t& value) const;
+    bool isEmpty() const;
+
+    enum
+    {
+        MAX_GROUP_SETTINGS = 32
+    };
+
+private:
+    SimpleString groups_[MAX_GROUP_SETTINGS];
+    size_t values_[MAX_GROUP_SETTINGS];
+    size_t count_;
+    bool hasDefault_;
+    size_t default_;
+};
 
 class MemoryLeakWarningPlugin: public TestPlugin
 {
@@ -47,11 +86,22 @@ public:
 
     virtual void preTestAction(UtestShell& test, TestResult& result) CPPUTEST_OVERRIDE;
     virtual void postTestAction(UtestShell& test, TestResult& result) CPPUTEST_OVERRIDE;
+    virtual bool parseArguments(int ac, const char *const *av, int index) CPPUTEST_OVERRIDE;
 
     virtual const char* FinalReport(size_t toBeDeletedLeaks = 0);
+    void printFinalReport(TestOutput& output, size_t toBeDeletedLeaks = 0);
 
     void ignoreAllLeaksInTest();
     void expectLeaksInTest(size_t n);
+    void sampleLeaksEveryNthAllocationInTest(size_t n);
+    void sampleLeaksEveryNBytesInTest(size_t n);
+    void setTierInTest(MemLeakTier tier);
+
+    size_t getLiveBytesInTest() const;
+    size_t getPeakBytesInTest() const;
+    void checkPeakInTest(size_t bytes, const char* file, size_t line);
+
+    static bool parseTier(const SimpleString& name, MemLeakTier& tier);
 
     void destroyGlobalDetectorAndTurnOffMemoryLeakDetectionInDestructor(bool des);
 
@@ -60,6 +110,7 @@ public:
     static MemoryLeakWarningPlugin* getFirstPlugin();
 
     static MemoryLeakDetector* getGlobalDetector();
+    static MemoryLeakDetector* getGlobalDetectorIfCreated();
     static MemoryLeakFailure* getGlobalFailureReporter();
     static void setGlobalDetector(MemoryLeakDetector* detector, MemoryLeakFailure* reporter);
     static void destroyGlobalDetector();
@@ -78,10 +129,69 @@ private:
     bool destroyGlobalDetectorAndTurnOfMemoryLeakDetectionInDestructor_;
     size_t expectedLeaks_;
     size_t failureCount_;
+    MemoryLeakGroupSettings samplingAllocations_;
+    MemoryLeakGroupSettings samplingBytes_;
+    MemoryLeakGroupSettings tiers_;
+    MemoryLeakGroupSettings maximumAllocations_;
+    MemoryLeakGroupSettings maximumAllocatedBytes_;
+    unsigned allocationNumberAtStart_;
+    size_t allocatedBytesAtStart_;
+    SimpleString reportFileName_;
+
+    void setSamplingForGroup(const SimpleString& group);
+    void setTierForGroup(const SimpleString& group);
+    void checkAllocationBudget(UtestShell& test, TestResult& result);
+    bool parseTierArgument(const SimpleString& argument);
+    bool parseStackTraceArgument(const SimpleString& argument);
+    bool parseReportFileArgument(const SimpleString& argument);
+    void writeReportToFile();
 
     static MemoryLeakWarningPlugin* firstPlugin_;
 };
 
+/* Counts the allocations the global memory leak detector sees between start and stop, tracked or not, and fails the
+ * test at stop when there were more than the budget allows. Counting doesn't allocate, so a budget can be used inside
+ * tight loops. The budget doesn't replace the allocators, so memory allocated in the scope can outlive it. A budget
+ * that is started but never stopped is checked when it is destroyed. Without the new and delete overloads of the
+ * memory leak detection, or with its tier off, nothing is counted, so starting a budget fails the test */
+class AllocationBudget
+{
+public:
+    AllocationBudget(size_t maximumAllocations, const char* file, size_t line);
+    ~AllocationBudget();
+
+    void start();
+    void stop();
+
+    size_t getAllocations() const;
+    bool isExceeded() const;
+
+private:
+    void finishCounting();
+    SimpleString failureMessage() const;
+
+    size_t maximumAllocations_;
+    const char* file_;
+    size_t line_;
+    unsigned allocationNumberAtStart_;
+    size_t allocations_;
+    const char* firstOverBudgetFile_;
+    size_t firstOverBudgetLine_;
+    bool started_;
+    unsigned outerWatchedAllocation_;
+    const char* outerWatchedAllocationFile_;
+    size_t outerWatchedAllocationLine_;
+};
+
+/* The budget of a CHECK_ALLOCATIONS_AT_MOST scope, started when it is created and checked when it is destroyed */
+class AllocationBudgetScope : public AllocationBudget
+{
+public:
+    AllocationBudgetScope(size_t maximumAllocations, const char* file, size_t line);
+
+    operator bool() const;
+};
+
 extern void* cpputest_malloc_location_with_leak_detection(size_t size, const char* file, size_t line);
 extern void* cpputest_realloc_location_with_leak_detection(void* memory, size_t size, const char* file, size_t line);
 extern void cpputest_free_location_with_leak_detection(void* buffer, const char* file, size_t line);
@@ -36,6 +36,14 @@ extern void (*PlatformSpecificRunTestInASeperateProcess)(UtestShell* shell, Test
 extern int (*PlatformSpecificFork)(void);
 extern int (*PlatformSpecificWaitPid)(int pid, int* status, int options);
 
+/* Runs function(data) in a child process. Returns the child id or -1 when the platform can't start child processes.
+ * Waiting returns the id of the first of the given children to end, ids below 1 are skipped. It sets result to what
+ * function returned or, when the child ended before function returned, to its exit status or to minus the signal that
+ * killed it.
+ */
+extern int (*PlatformSpecificStartChildProcess)(int (*function)(void* data), void* data);
+extern int (*PlatformSpecificWaitForChildProcess)(const int* children, size_t count, int* result);
+
 /* Platform specific interface we use in order to minimize dependencies with LibC.
  * This enables porting to different embedded platforms.
  *
@@ -48,6 +48,7 @@ extern void (*PlatformSpecificRestoreJumpBuffer)(void);
 
 /* Time operations */
 extern unsigned long (*GetPlatformSpecificTimeInMillis)(void);
+extern unsigned long (*GetPlatformSpecificTimeInMicros)(void);
 extern const char* (*GetPlatformSpecificTimeString)(void);
 
 /* String operations */
@@ -66,6 +67,8 @@ extern PlatformSpecificFile PlatformSpecificStdOut;
 
 extern PlatformSpecificFile (*PlatformSpecificFOpen)(const char* filename, const char* flag);
 extern void (*PlatformSpecificFPuts)(const char* str, PlatformSpecificFile file);
+extern size_t (*PlatformSpecificFRead)(void* buffer, size_t size, PlatformSpecificFile file);
+extern size_t (*PlatformSpecificFWrite)(const void* buffer, size_t size, PlatformSpecificFile file);
 extern void (*PlatformSpecificFClose)(PlatformSpecificFile file);
 
 extern void (*PlatformSpecificFlush)(void);
@@ -90,6 +93,22 @@ extern void (*PlatformSpecificMutexUnlock)(PlatformSpecificMutex mtx);
 extern void (*PlatformSpecificMutexDestroy)(PlatformSpecificMutex mtx);
 extern void (*PlatformSpecificAbort)(void);
 
+/* Page operations. A page size of 0 means pages can't be protected on this platform */
+extern size_t (*PlatformSpecificPageSize)(void);
+extern void* (*PlatformSpecificMapPages)(size_t size);
+extern void (*PlatformSpecificProtectPages)(void* memory, size_t size);
+extern void (*PlatformSpecificUnmapPages)(void* memory, size_t size);
+extern void (*PlatformSpecificAdviseHugePages)(void* memory, size_t size);
+
+/* Maps a file, unmap it with PlatformSpecificUnmapPages. A writable file is created with the given size, a read only
+ * file must exist and its size is returned. Returns NULL when the file can't be mapped. An empty read only
+ * file can't be mapped either, but its size of 0 is returned */
+extern void* (*PlatformSpecificMapFile)(const char* filename, size_t* size, int writable);
+
+/* Call stack operations */
+extern int (*PlatformSpecificBacktrace)(void** addresses, int maxAddresses);
+extern void (*PlatformSpecificSymbolize)(void* address, char* name, size_t size);
+
 #ifdef __cplusplus
 }
 #endif
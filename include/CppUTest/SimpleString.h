@@ -55,6 +55,10 @@ public:
     ~SimpleString();
 
     SimpleString& operator=(const SimpleString& other);
+#if CPPUTEST_HAVE_MOVE_SEMANTICS
+    SimpleString(SimpleString&& other);
+    SimpleString& operator=(SimpleString&& other);
+#endif
     SimpleString operator+(const SimpleString&) const;
     SimpleString& operator+=(const SimpleString&);
     SimpleString& operator+=(const char*);
@@ -103,6 +107,7 @@ public:
     static const char* StrStr(const char* s1, const char* s2);
     static char ToLower(char ch);
     static int MemCmp(const void* s1, const void *s2, size_t n);
+    static size_t MemFirstDifference(const void* s1, const void *s2, size_t n);
     static char* allocStringBuffer(size_t size, const char* file, size_t line);
     static void deallocStringBuffer(char* str, size_t size, const char* file, size_t line);
 private:
@@ -116,13 +121,15 @@ private:
     void copyBufferToNewInternalBuffer(const char* otherBuffer);
     void copyBufferToNewInternalBuffer(const char* otherBuffer, size_t bufferSize);
     void copyBufferToNewInternalBuffer(const SimpleString& otherBuffer);
+    void takeInternalBufferFrom(SimpleString& other);
+    bool hasInlineBuffer() const;
 
     char *buffer_;
     size_t bufferSize_;
+    char inlineBuffer_[CPPUTEST_SIMPLESTRING_INLINE_BUFFER_SIZE];
 
     static TestMemoryAllocator* stringAllocator_;
 
-    char* getEmptyString() const;
     static char* copyToNewBuffer(const char* bufferToCopy, size_t bufferSize);
     static bool isDigit(char ch);
     static bool isSpace(char ch);
@@ -153,6 +160,39 @@ private:
     SimpleStringCollection(SimpleStringCollection&);
 };
 
+/*
+ * Builds up a long text without copying it on every append, like SimpleString's += does.
+ * The buffer doubles when it is full, so appending n characters costs O(n) in total.
+ */
+class SimpleStringBuilder
+{
+public:
+    SimpleStringBuilder();
+    ~SimpleStringBuilder();
+
+    SimpleStringBuilder& append(const char* text);
+    SimpleStringBuilder& append(const char* text, size_t length);
+    SimpleStringBuilder& append(const SimpleString& text);
+    SimpleStringBuilder& appendFormatted(const char* format, ...) CPPUTEST_CHECK_FORMAT(CPPUTEST_CHECK_FORMAT_TYPE, 2, 3);
+
+    size_t size() const;
+    bool isEmpty() const;
+    const char* asCharString() const;
+    SimpleString toString() const;
+
+    void clear();
+
+private:
+    void makeRoomFor(size_t length);
+
+    char* buffer_;
+    size_t size_;
+    size_t capacity_;
+
+    void operator =(SimpleStringBuilder&);
+    SimpleStringBuilder(SimpleStringBuilder&);
+};
+
 class GlobalSimpleStringAllocatorStash
 {
 public:
@@ -32,6 +32,7 @@
 
 struct SimpleStringMemoryBlock;
 struct SimpleStringInternalCacheNode;
+class SimpleMutex;
 
 class SimpleStringInternalCache
 {
@@ -41,6 +42,10 @@ public:
 
     void setAllocator(TestMemoryAllocator* allocator);
 
+    /* The sizes are rounded up to a multiple of 16. Change them before anything is allocated from the cache */
+    void useCacheSizes(size_t sizes[], size_t length);
+    void turnOnThreadSafety();
+
     char* alloc(size_t size);
     void dealloc(char* memory, size_t size);
 
@@ -48,16 +53,24 @@ public:
 
     void clearCache();
     void clearAllIncludingCurrentlyUsedMemory();
+
+    size_t cacheHits() const;
+    size_t cacheMisses() const;
+    size_t uncachedAllocations() const;
+    SimpleString report() const;
 private:
     void printDeallocatingUnknownMemory(char* memory);
 
-    enum { amountOfInternalCacheNodes = 5};
+    enum { sizeGranularity = 16 };
     bool isCached(size_t size);
     size_t getIndexForCache(size_t size);
     SimpleStringInternalCacheNode* getCacheNodeFromSize(size_t size);
 
-    SimpleStringInternalCacheNode* createInternalCacheNodes();
-    void destroyInternalCacheNode(SimpleStringInternalCacheNode * node);
+    char* allocUnlocked(size_t size);
+    void deallocUnlocked(char* memory, size_t size);
+
+    void createInternalCacheNodes(size_t sizes[], size_t length);
+    void destroyInternalCacheNodes();
     SimpleStringMemoryBlock* createSimpleStringMemoryBlock(size_t sizeOfString, SimpleStringMemoryBlock* next);
     void destroySimpleStringMemoryBlock(SimpleStringMemoryBlock * block, size_t size);
     void destroySimpleStringMemoryBlockList(SimpleStringMemoryBlock * block, size_t size);
@@ -71,7 +84,12 @@ private:
 
     TestMemoryAllocator* allocator_;
     SimpleStringInternalCacheNode* cache_;
+    size_t amountOfInternalCacheNodes_;
+    size_t* cacheIndexForSize_;
+    size_t largestCachedSize_;
     SimpleStringMemoryBlock* nonCachedAllocations_;
+    size_t uncachedAllocations_;
+    SimpleMutex* mutex_;
     bool hasWarnedAboutDeallocations;
 };
 
@@ -105,6 +123,7 @@ public:
     ~GlobalSimpleStringCache();
 
     TestMemoryAllocator* getAllocator();
+    SimpleStringInternalCache& getCache();
 };
 
 #endif
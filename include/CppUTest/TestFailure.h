@@ -70,6 +70,8 @@ protected:
     SimpleString createButWasString(const SimpleString& expected, const SimpleString& actual);
     SimpleString createDifferenceAtPosString(const SimpleString& actual, size_t offset, size_t reportedPosition);
     SimpleString createUserText(const SimpleString& text);
+    SimpleString createStringDifferenceString(const char* expected, const char* actual);
+    static bool isLongString(const char* value);
 
     SimpleString testName_;
     SimpleString testNameOnly_;
@@ -174,6 +176,24 @@ public:
 	BinaryEqualFailure(UtestShell* test, const char* fileName, size_t lineNumber, const unsigned char* expected, const unsigned char* actual, size_t size, const SimpleString& text);
 };
 
+class FileEqualFailure : public TestFailure
+{
+public:
+    FileEqualFailure(UtestShell* test, const char* fileName, size_t lineNumber, const char* goldenFileName, const char* problem, const SimpleString& text);
+    FileEqualFailure(UtestShell* test, const char* fileName, size_t lineNumber, const char* goldenFileName, const unsigned char* golden, size_t goldenSize,
+                     const unsigned char* actual, size_t actualSize, size_t failStart, const SimpleString& text);
+};
+
+class ArrayEqualFailure : public TestFailure
+{
+public:
+    ArrayEqualFailure(UtestShell* test, const char* fileName, size_t lineNumber, size_t failedIndex, size_t count, const SimpleString& expectedWindow, const SimpleString& actualWindow, const SimpleString& text);
+
+    static size_t windowStart(size_t failedIndex);
+    static size_t windowEnd(size_t failedIndex, size_t count);
+    static void addToWindow(SimpleString& window, const SimpleString& element);
+};
+
 class BitsEqualFailure : public TestFailure
 {
 public:
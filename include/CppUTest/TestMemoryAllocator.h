@@ -80,6 +80,13 @@ public:
 
     virtual TestMemoryAllocator* actualAllocator();
 
+    virtual bool guardsMemory();
+    virtual bool isMemoryCorrupted(char* memory);
+
+    virtual bool releasesMemoryInBulk();
+    virtual bool ownsMemory(char* memory);
+    virtual size_t sizeOfMemory(char* memory);
+
 protected:
 
     const char* name_;
@@ -107,6 +114,116 @@ private:
     TestMemoryAllocator* originalAllocator_;
 };
 
+enum GuardedMemoryMode
+{
+    guard_page_after_memory,
+    guard_page_before_memory,
+    guard_canaries
+};
+
+class GuardedTestMemoryAllocator : public TestMemoryAllocator
+{
+public:
+    GuardedTestMemoryAllocator(TestMemoryAllocator* originalAllocator, GuardedMemoryMode mode = guard_page_after_memory);
+    virtual ~GuardedTestMemoryAllocator() CPPUTEST_DESTRUCTOR_OVERRIDE;
+
+    GuardedMemoryMode mode() const;
+
+    virtual char* alloc_memory(size_t size, const char* file, size_t line) CPPUTEST_OVERRIDE;
+    virtual void free_memory(char* memory, size_t size, const char* file, size_t line) CPPUTEST_OVERRIDE;
+
+    virtual const char* name() const CPPUTEST_OVERRIDE;
+    virtual const char* alloc_name() const CPPUTEST_OVERRIDE;
+    virtual const char* free_name() const CPPUTEST_OVERRIDE;
+
+    virtual TestMemoryAllocator* actualAllocator() CPPUTEST_OVERRIDE;
+
+    virtual bool guardsMemory() CPPUTEST_OVERRIDE;
+    virtual bool isMemoryCorrupted(char* memory) CPPUTEST_OVERRIDE;
+
+private:
+    char* allocWithGuardPage(size_t size);
+    void freeWithGuardPage(char* memory);
+    char* allocWithCanaries(size_t size, const char* file, size_t line);
+    void freeWithCanaries(char* memory, const char* file, size_t line);
+
+    TestMemoryAllocator* originalAllocator_;
+    GuardedMemoryMode mode_;
+};
+
+struct ArenaTestMemoryAllocatorChunk;
+
+/* Bump allocates from large chunks and releases everything at once with reset. Freeing memory does nothing.
+ * Memory from an arena isn't tracked by the memory leak detector, the arena accounting is all there is. Memory that
+ * is freed after the arena is uninstalled is found by its chunk and still returned to the arena. Install it for a
+ * group with ArenaTestMemoryAllocatorScope */
+class ArenaTestMemoryAllocator : public TestMemoryAllocator
+{
+public:
+    enum
+    {
+        DEFAULT_CHUNK_SIZE = 256 * 1024,
+        HUGE_PAGE_SIZE = 2 * 1024 * 1024
+    };
+
+    ArenaTestMemoryAllocator(size_t chunkSize = DEFAULT_CHUNK_SIZE, bool useHugePages = false);
+    virtual ~ArenaTestMemoryAllocator() CPPUTEST_DESTRUCTOR_OVERRIDE;
+
+    virtual char* alloc_memory(size_t size, const char* file, size_t line) CPPUTEST_OVERRIDE;
+    virtual void free_memory(char* memory, size_t size, const char* file, size_t line) CPPUTEST_OVERRIDE;
+
+    virtual bool releasesMemoryInBulk() CPPUTEST_OVERRIDE;
+    virtual bool ownsMemory(char* memory) CPPUTEST_OVERRIDE;
+    virtual size_t sizeOfMemory(char* memory) CPPUTEST_OVERRIDE;
+
+    void reset();
+    static ArenaTestMemoryAllocator* findArenaOwning(char* memory);
+
+    size_t getAllocations() const;
+    size_t getDeallocations() const;
+    size_t getAllocatedBytes() const;
+    size_t getReservedBytes() const;
+    size_t getNumberOfChunks() const;
+    bool usesHugePages() const;
+
+private:
+    ArenaTestMemoryAllocatorChunk* allocateChunk(size_t size);
+    void releaseChunk(ArenaTestMemoryAllocatorChunk* chunk);
+
+    size_t chunkSize_;
+    bool useHugePages_;
+    ArenaTestMemoryAllocatorChunk* chunks_;
+    ArenaTestMemoryAllocatorChunk* currentChunk_;
+    size_t currentChunkUsed_;
+
+    size_t allocations_;
+    size_t deallocations_;
+    size_t allocatedBytes_;
+    size_t reservedBytes_;
+    size_t numberOfChunks_;
+
+    ArenaTestMemoryAllocator* nextArena_;
+};
+
+extern ArenaTestMemoryAllocator* defaultArenaTestMemoryAllocator();
+
+/* Installs the arena as the malloc, new and new[] allocator while it lives, then restores the allocators and resets
+ * the arena. As a member of a TEST_GROUP, every test of the group runs on the default arena and the arena is reset
+ * after the teardown of each test. The arena outlives the tests, so its current chunk is reused */
+class ArenaTestMemoryAllocatorScope
+{
+public:
+    ArenaTestMemoryAllocatorScope();
+    explicit ArenaTestMemoryAllocatorScope(ArenaTestMemoryAllocator& arena);
+    ~ArenaTestMemoryAllocatorScope();
+
+private:
+    void install();
+
+    ArenaTestMemoryAllocator& arena_;
+    GlobalMemoryAllocatorStash stash_;
+};
+
 class CrashOnAllocationAllocator : public TestMemoryAllocator
 {
     unsigned allocationToCrashOn_;
@@ -176,23 +293,54 @@ public:
 
     size_t totalAllocations() const;
     size_t totalDeallocations() const;
+    size_t currentAllocations() const;
+    size_t maximumAllocationsAtATime() const;
+
+    /* Smallest size that percent% of the allocations fit in, rounded up to its histogram bucket */
+    size_t allocationSizePercentile(size_t percent) const;
 
     SimpleString report() const;
+    SimpleString reportPercentiles() const;
 
     void setAllocator(TestMemoryAllocator* allocator);
+
+    /* Sizes below HISTOGRAM_EXACT_SIZES get a bucket each, larger sizes get HISTOGRAM_SUB_BUCKETS buckets per power of two */
+    enum
+    {
+        HISTOGRAM_EXACT_SIZES = 16,
+        HISTOGRAM_SUB_BUCKETS = 4,
+        HISTOGRAM_BUCKETS = HISTOGRAM_EXACT_SIZES + (sizeof(size_t) * 8 - 4) * HISTOGRAM_SUB_BUCKETS
+    };
+
+    static size_t histogramBucketOfSize(size_t size);
+    static size_t largestSizeInHistogramBucket(size_t bucket);
+
 private:
     MemoryAccountantAllocationNode* findOrCreateNodeOfSize(size_t size);
     MemoryAccountantAllocationNode* findNodeOfSize(size_t size) const;
+    size_t sizeTableBucketOfSize(size_t size) const;
+    void growSizeTable();
 
     MemoryAccountantAllocationNode* createNewAccountantAllocationNode(size_t size, MemoryAccountantAllocationNode* next) const;
     void destroyAccountantAllocationNode(MemoryAccountantAllocationNode* node) const;
 
     void createCacheSizeNodes(size_t sizes[], size_t length);
+    void clearHistogram();
 
     MemoryAccountantAllocationNode* head_;
+    MemoryAccountantAllocationNode** sizeTable_;
+    size_t sizeTableSize_;
+    size_t numberOfNodes_;
     TestMemoryAllocator* allocator_;
     bool useCacheSizes_;
 
+    size_t totalAllocations_;
+    size_t totalDeallocations_;
+    size_t currentAllocations_;
+    size_t maxAllocations_;
+    size_t largestSize_;
+    size_t histogram_[HISTOGRAM_BUCKETS];
+
     SimpleString reportNoAllocations() const;
     SimpleString reportTitle() const;
     SimpleString reportHeader() const;
@@ -222,12 +370,14 @@ private:
     void addMemoryToMemoryTrackingToKeepTrackOfSize(char* memory, size_t size);
     size_t removeMemoryFromTrackingAndReturnAllocatedSize(char* memory);
 
-    size_t removeNextNodeAndReturnSize(AccountingTestMemoryAllocatorMemoryNode* node);
-    size_t removeHeadAndReturnSize();
+    size_t hashOfMemory(char* memory) const;
+    void growMemoryTracking();
 
     MemoryAccountant& accountant_;
     TestMemoryAllocator* originalAllocator_;
-    AccountingTestMemoryAllocatorMemoryNode* head_;
+    AccountingTestMemoryAllocatorMemoryNode** table_;
+    size_t tableSize_;
+    size_t numberOfNodes_;
 };
 
 class GlobalMemoryAccountant
@@ -241,6 +391,7 @@ public:
     void start();
     void stop();
     SimpleString report();
+    SimpleString reportPercentiles();
     SimpleString reportWithCacheSizes(size_t sizes[], size_t length);
 
     TestMemoryAllocator* getMallocAllocator();
@@ -48,6 +48,15 @@ public:
     {
     }
 
+    /* Called once around every repetition of the test run, however many tests run */
+    virtual void preTestRunAction(TestResult&)
+    {
+    }
+
+    virtual void postTestRunAction(TestResult&)
+    {
+    }
+
     virtual bool parseArguments(int /* ac */, const char *const * /* av */, int /* index */ )
     {
         return false;
@@ -55,6 +64,8 @@ public:
 
     virtual void runAllPreTestAction(UtestShell&, TestResult&);
     virtual void runAllPostTestAction(UtestShell&, TestResult&);
+    virtual void runAllPreTestRunAction(TestResult&);
+    virtual void runAllPostTestRunAction(TestResult&);
     virtual bool parseAllArguments(int ac, const char *const *av, int index);
     virtual bool parseAllArguments(int ac, char** av, int index);
 
@@ -116,6 +127,8 @@ public:
 
     virtual void runAllPreTestAction(UtestShell& test, TestResult& result) CPPUTEST_OVERRIDE;
     virtual void runAllPostTestAction(UtestShell& test, TestResult& result) CPPUTEST_OVERRIDE;
+    virtual void runAllPreTestRunAction(TestResult& result) CPPUTEST_OVERRIDE;
+    virtual void runAllPostTestRunAction(TestResult& result) CPPUTEST_OVERRIDE;
 
     static NullTestPlugin* instance();
 };
@@ -96,6 +96,9 @@ public:
 
     size_t getCurrentTestTotalExecutionTime() const;
     size_t getCurrentGroupTotalExecutionTime() const;
+
+    size_t getCurrentTestPeakMemory() const;
+    void setCurrentTestPeakMemory(size_t bytes);
 private:
 
     TestOutput& output_;
@@ -111,6 +114,7 @@ private:
     size_t currentTestTotalExecutionTime_;
     size_t currentGroupTimeStarted_;
     size_t currentGroupTotalExecutionTime_;
+    size_t currentTestPeakMemory_;
 };
 
 #endif
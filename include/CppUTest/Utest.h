@@ -110,6 +110,12 @@ public:
     static void setRethrowExceptions(bool rethrowExceptions);
     static bool isRethrowingExceptions();
 
+    static void setUpdateGoldenFiles(bool updateGoldenFiles);
+    static bool isUpdatingGoldenFiles();
+
+    static void setAllocationFailureSweep(size_t parallelProcesses);
+    static size_t getAllocationFailureSweep();
+
 public:
     UtestShell(const char* groupName, const char* testName, const char* fileName, size_t lineNumber);
     virtual ~UtestShell();
@@ -123,6 +129,9 @@ public:
     const SimpleString getGroup() const;
     virtual SimpleString getFormattedName() const;
     const SimpleString getFile() const;
+    const char* getNameAsCharString() const;
+    const char* getGroupAsCharString() const;
+    const char* getFileAsCharString() const;
     size_t getLineNumber() const;
     virtual bool willRun() const;
     virtual bool hasFailed() const;
@@ -143,7 +152,13 @@ public:
     virtual void assertFunctionPointersEqual(void (*expected)(), void (*actual)(), const char* text, const char* fileName, size_t lineNumber, const TestTerminator& testTerminator = getCurrentTestTerminator());
     virtual void assertDoublesEqual(double expected, double actual, double threshold, const char* text, const char *fileName, size_t lineNumber, const TestTerminator& testTerminator = getCurrentTestTerminator());
     virtual void assertEquals(bool failed, const char* expected, const char* actual, const char* text, const char* file, size_t lineNumber, const TestTerminator& testTerminator = getCurrentTestTerminator());
+    virtual void assertDoublesArrayEqual(const double* expected, const double* actual, size_t count, double threshold, const char* text, const char *fileName, size_t lineNumber, const TestTerminator& testTerminator = getCurrentTestTerminator());
+    virtual void assertDoublesArrayEqual(const float* expected, const float* actual, size_t count, double threshold, const char* text, const char *fileName, size_t lineNumber, const TestTerminator& testTerminator = getCurrentTestTerminator());
+    virtual void assertDoublesArrayEqualUlps(const double* expected, const double* actual, size_t count, unsigned long maxUlps, const char* text, const char *fileName, size_t lineNumber, const TestTerminator& testTerminator = getCurrentTestTerminator());
+    virtual void assertDoublesArrayEqualUlps(const float* expected, const float* actual, size_t count, unsigned long maxUlps, const char* text, const char *fileName, size_t lineNumber, const TestTerminator& testTerminator = getCurrentTestTerminator());
+    virtual void assertArrayEqual(size_t failedIndex, size_t count, const SimpleString& expectedWindow, const SimpleString& actualWindow, const char* text, const char *fileName, size_t lineNumber, const TestTerminator& testTerminator = getCurrentTestTerminator());
     virtual void assertBinaryEqual(const void *expected, const void *actual, size_t length, const char* text, const char *fileName, size_t lineNumber, const TestTerminator& testTerminator = getCurrentTestTerminator());
+    virtual void assertFileEqual(const char* goldenFileName, const void *actual, size_t length, const char* text, const char *fileName, size_t lineNumber, const TestTerminator& testTerminator = getCurrentTestTerminator());
     virtual void assertBitsEqual(unsigned long expected, unsigned long actual, unsigned long mask, size_t byteCount, const char* text, const char *fileName, size_t lineNumber, const TestTerminator& testTerminator = getCurrentTestTerminator());
     virtual void assertCompare(bool comparison, const char *checkString, const char *comparisonString, const char *text, const char *fileName, size_t lineNumber, const TestTerminator& testTerminator = getCurrentTestTerminator());
     virtual void fail(const char *text, const char *fileName, size_t lineNumber, const TestTerminator& testTerminator = getCurrentTestTerminator());
@@ -178,6 +193,8 @@ public:
 
     virtual void addFailure(const TestFailure& failure);
 
+    virtual void sweepAllocationFailures(Utest* test);
+
 protected:
     UtestShell();
     UtestShell(const char *groupName, const char *testName, const char *fileName, size_t lineNumber, UtestShell *nextTest);
@@ -196,6 +213,7 @@ private:
     void setTestResult(TestResult* result);
     void setCurrentTest(UtestShell* test);
     bool match(const char* target, const TestFilter* filters) const;
+    static int runWithFailingAllocation(void* data);
 
     static UtestShell* currentTest_;
     static TestResult* testResult_;
@@ -203,6 +221,8 @@ private:
     static const TestTerminator *currentTestTerminator_;
     static const TestTerminator *currentTestTerminatorWithoutExceptions_;
     static bool rethrowExceptions_;
+    static bool updateGoldenFiles_;
+    static size_t allocationFailureSweepProcesses_;
 };
 
 
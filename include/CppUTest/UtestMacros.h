@@ -296,6 +296,51 @@
 #define DOUBLES_EQUAL_LOCATION(expected, actual, threshold, text, file, line)\
   do { UtestShell::getCurrent()->assertDoublesEqual(expected, actual, threshold, text, file, line); } while(0)
 
+//Check two arrays of doubles or floats for equality within a tolerance threshold, counts as one check
+#define DOUBLES_ARRAY_EQUAL(expected, actual, count, threshold)\
+  DOUBLES_ARRAY_EQUAL_LOCATION(expected, actual, count, threshold, NULLPTR, __FILE__, __LINE__)
+
+#define DOUBLES_ARRAY_EQUAL_TEXT(expected, actual, count, threshold, text)\
+  DOUBLES_ARRAY_EQUAL_LOCATION(expected, actual, count, threshold, text, __FILE__, __LINE__)
+
+#define DOUBLES_ARRAY_EQUAL_LOCATION(expected, actual, count, threshold, text, file, line)\
+  do { UtestShell::getCurrent()->assertDoublesArrayEqual(expected, actual, count, threshold, text, file, line); } while(0)
+
+//Same, but allows maxUlps representable values between the expected and actual element
+#define DOUBLES_ARRAY_EQUAL_ULPS(expected, actual, count, maxUlps)\
+  DOUBLES_ARRAY_EQUAL_ULPS_LOCATION(expected, actual, count, maxUlps, NULLPTR, __FILE__, __LINE__)
+
+#define DOUBLES_ARRAY_EQUAL_ULPS_TEXT(expected, actual, count, maxUlps, text)\
+  DOUBLES_ARRAY_EQUAL_ULPS_LOCATION(expected, actual, count, maxUlps, text, __FILE__, __LINE__)
+
+#define DOUBLES_ARRAY_EQUAL_ULPS_LOCATION(expected, actual, count, maxUlps, text, file, line)\
+  do { UtestShell::getCurrent()->assertDoublesArrayEqualUlps(expected, actual, count, maxUlps, text, file, line); } while(0)
+
+//This check needs the operator!=(), and a StringFrom(YourType) function for the elements, counts as one check
+#define CHECK_ARRAY_EQUAL(expected, actual, count)\
+  CHECK_ARRAY_EQUAL_LOCATION(expected, actual, count, NULLPTR, __FILE__, __LINE__)
+
+#define CHECK_ARRAY_EQUAL_TEXT(expected, actual, count, text)\
+  CHECK_ARRAY_EQUAL_LOCATION(expected, actual, count, text, __FILE__, __LINE__)
+
+#define CHECK_ARRAY_EQUAL_LOCATION(expected, actual, count, text, file, line)\
+  do { \
+      size_t cpputest_array_count = (size_t) (count); \
+      size_t cpputest_failed_index = 0; \
+      while (cpputest_failed_index < cpputest_array_count && !((expected)[cpputest_failed_index] != (actual)[cpputest_failed_index])) \
+          cpputest_failed_index++; \
+      SimpleString cpputest_expected_window; \
+      SimpleString cpputest_actual_window; \
+      if (cpputest_failed_index < cpputest_array_count) { \
+          size_t cpputest_window_end = ArrayEqualFailure::windowEnd(cpputest_failed_index, cpputest_array_count); \
+          for (size_t cpputest_i = ArrayEqualFailure::windowStart(cpputest_failed_index); cpputest_i < cpputest_window_end; cpputest_i++) { \
+              ArrayEqualFailure::addToWindow(cpputest_expected_window, StringFrom((expected)[cpputest_i])); \
+              ArrayEqualFailure::addToWindow(cpputest_actual_window, StringFrom((actual)[cpputest_i])); \
+          } \
+      } \
+      UtestShell::getCurrent()->assertArrayEqual(cpputest_failed_index, cpputest_array_count, cpputest_expected_window, cpputest_actual_window, text, file, line); \
+  } while(0)
+
 #define MEMCMP_EQUAL(expected, actual, size)\
   MEMCMP_EQUAL_LOCATION(expected, actual, size, NULLPTR, __FILE__, __LINE__)
 
@@ -305,6 +350,15 @@
 #define MEMCMP_EQUAL_LOCATION(expected, actual, size, text, file, line)\
   do { UtestShell::getCurrent()->assertBinaryEqual(expected, actual, size, text, file, line); } while(0)
 
+#define CHECK_FILE_EQUAL(goldenFileName, actual, size)\
+  CHECK_FILE_EQUAL_LOCATION(goldenFileName, actual, size, NULLPTR, __FILE__, __LINE__)
+
+#define CHECK_FILE_EQUAL_TEXT(goldenFileName, actual, size, text)\
+  CHECK_FILE_EQUAL_LOCATION(goldenFileName, actual, size, text, __FILE__, __LINE__)
+
+#define CHECK_FILE_EQUAL_LOCATION(goldenFileName, actual, size, text, file, line)\
+  do { UtestShell::getCurrent()->assertFileEqual(goldenFileName, actual, size, text, file, line); } while(0)
+
 #define BITS_EQUAL(expected, actual, mask)\
   BITS_LOCATION(expected, actual, mask, NULLPTR, __FILE__, __LINE__)
 
@@ -36,6 +36,9 @@ class MemoryReportFormatter
 public:
     virtual ~MemoryReportFormatter(){}
 
+    virtual void report_testrun_start(TestResult* /*result*/) {} // LCOV_EXCL_LINE
+    virtual void report_testrun_end(TestResult* /*result*/) {} // LCOV_EXCL_LINE
+
     virtual void report_testgroup_start(TestResult* result, UtestShell& test)=0;
     virtual void report_testgroup_end(TestResult* result, UtestShell& test)=0;
 
@@ -42,12 +42,15 @@ class MemoryReporterPlugin : public TestPlugin
     MemoryReportAllocator newArrayAllocator;
 
     SimpleString currentTestGroup_;
+    UtestShell* lastTestOfOpenGroup_;
 public:
     MemoryReporterPlugin();
     virtual ~MemoryReporterPlugin() CPPUTEST_DESTRUCTOR_OVERRIDE;
 
     virtual void preTestAction(UtestShell & test, TestResult & result) CPPUTEST_OVERRIDE;
     virtual void postTestAction(UtestShell & test, TestResult & result) CPPUTEST_OVERRIDE;
+    virtual void preTestRunAction(TestResult & result) CPPUTEST_OVERRIDE;
+    virtual void postTestRunAction(TestResult & result) CPPUTEST_OVERRIDE;
     virtual bool parseArguments(int, const char *const *, int) CPPUTEST_OVERRIDE;
 
     MemoryReportAllocator* getMallocAllocator();
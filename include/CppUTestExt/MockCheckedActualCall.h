@@ -225,7 +225,7 @@ public:
     static void clearInstance();
 
 private:
-    SimpleString traceBuffer_;
+    SimpleStringBuilder traceBuffer_;
 
     static MockActualCallTrace* instance_;
 
@@ -67,6 +67,7 @@ public:
     virtual MockCheckedExpectedCall* removeFirstFinalizedMatchingExpectation();
     virtual MockCheckedExpectedCall* removeFirstMatchingExpectation();
     virtual MockCheckedExpectedCall* getFirstMatchingExpectation();
+    virtual MockCheckedExpectedCall* getFirstExpectation();
 
     virtual void resetActualCallMatchingState();
     virtual void wasPassedToObject();
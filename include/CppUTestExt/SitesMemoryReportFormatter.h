@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2007, Michael Feathers, James Grenning and Bas Vodde
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE EARLIER MENTIONED AUTHORS ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <copyright holder> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef D_SitesMemoryReportFormatter_h
+#define D_SitesMemoryReportFormatter_h
+
+#include "CppUTestExt/MemoryReportFormatter.h"
+
+/* Counts per allocation site (file:line) */
+struct MemoryAllocationSite
+{
+    const char* file_;
+    size_t line_;
+
+    size_t allocations_;
+    size_t bytes_;
+    size_t frees_;
+    size_t lifetimes_;
+
+    size_t group_;
+    size_t groupAllocations_;
+    size_t groupBytes_;
+    size_t groupFrees_;
+    size_t groupLifetimes_;
+
+    size_t test_;
+    size_t testAllocations_;
+    UtestShell* busiestTest_;
+    size_t busiestTestAllocations_;
+};
+
+/* Aggregates allocations by the file and line they are done from and prints the sites that allocate most at the end
+ * of every group and of the test run. Every repetition of the test run is counted and printed on its own. Lifetimes
+ * are counted in allocations that were done while a block was alive, which doesn't depend on the resolution of the
+ * clock */
+class SitesMemoryReportFormatter : public MemoryReportFormatter
+{
+public:
+    enum { DEFAULT_TOP_SITES = 10 };
+
+    SitesMemoryReportFormatter(size_t topSites = DEFAULT_TOP_SITES);
+    virtual ~SitesMemoryReportFormatter() CPPUTEST_DESTRUCTOR_OVERRIDE;
+
+    virtual void report_testrun_start(TestResult* result) CPPUTEST_OVERRIDE;
+    virtual void report_testrun_end(TestResult* result) CPPUTEST_OVERRIDE;
+
+    virtual void report_testgroup_start(TestResult* result, UtestShell& test) CPPUTEST_OVERRIDE;
+    virtual void report_testgroup_end(TestResult* result, UtestShell& test) CPPUTEST_OVERRIDE;
+
+    virtual void report_test_start(TestResult* result, UtestShell& test) CPPUTEST_OVERRIDE;
+    virtual void report_test_end(TestResult* /*result*/, UtestShell& /*test*/) CPPUTEST_OVERRIDE {} // LCOV_EXCL_LINE
+
+    virtual void report_alloc_memory(TestResult* result, TestMemoryAllocator* allocator, size_t size, char* memory, const char* file, size_t line) CPPUTEST_OVERRIDE;
+    virtual void report_free_memory(TestResult* result, TestMemoryAllocator* allocator, char* memory, const char* file, size_t line) CPPUTEST_OVERRIDE;
+
+    size_t numberOfSites() const;
+    const MemoryAllocationSite* findSite(const char* file, size_t line) const;
+
+private:
+    struct LiveAllocation
+    {
+        char* memory_;
+        size_t site_;
+        size_t allocationNumber_;
+    };
+
+    size_t siteOf(const char* file, size_t line);
+    size_t findSiteIndex(const char* file, size_t line) const;
+    bool growSites();
+    bool addLive(char* memory, size_t site);
+    size_t findLive(char* memory) const;
+    bool growLive();
+    void warnOnceAboutMemory(TestResult* result);
+    void removeLiveAt(size_t index);
+    void touch(MemoryAllocationSite& site);
+
+    void printTopSites(TestResult* result, const SimpleString& title, bool groupOnly);
+    size_t allocationsOf(const MemoryAllocationSite& site, bool groupOnly) const;
+
+    size_t topSites_;
+    size_t allocationNumber_;
+    size_t currentGroup_;
+    size_t currentTest_;
+    UtestShell* test_;
+
+    /* Once a table can't grow, nothing more is collected */
+    bool outOfMemory_;
+    bool warnedAboutMemory_;
+
+    /* The sites are kept in order of appearance, the hash maps file and line to their index plus one */
+    MemoryAllocationSite* sites_;
+    size_t numberOfSites_;
+    size_t* siteHash_;
+    size_t siteHashSize_;
+
+    LiveAllocation* live_;
+    size_t liveSize_;
+    size_t numberOfLive_;
+};
+
+#endif
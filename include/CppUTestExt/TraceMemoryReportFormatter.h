@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2007, Michael Feathers, James Grenning and Bas Vodde
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE EARLIER MENTIONED AUTHORS ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <copyright holder> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef D_TraceMemoryReportFormatter_h
+#define D_TraceMemoryReportFormatter_h
+
+#include "CppUTestExt/MemoryReportFormatter.h"
+
+/* A memory trace is a header, a table of file and test names and a ring of fixed size records. It is written in the
+ * byte order and word size of the machine that runs the tests, the header records both. scripts/memory_trace_to_json.py
+ * converts a trace into a heap timeline for trace viewers */
+struct MemoryTraceHeader
+{
+    char magic_[8];
+    unsigned version_;
+    unsigned byteOrder_;
+    unsigned wordSize_;
+    unsigned recordSize_;
+    size_t stringTableSize_;
+    size_t stringTableUsed_;
+    size_t capacity_;
+    size_t recordsWritten_;
+};
+
+enum MemoryTraceEventKind
+{
+    memory_trace_alloc = 1,
+    memory_trace_free,
+    memory_trace_test_start,
+    memory_trace_test_end
+};
+
+/* The timestamp is in microseconds since the trace started. File and test are offsets in the string table, offset 0 is
+ * an unknown name */
+struct MemoryTraceRecord
+{
+    size_t timestamp_;
+    size_t address_;
+    size_t size_;
+    unsigned file_;
+    unsigned line_;
+    unsigned test_;
+    unsigned kind_;
+};
+
+class TraceMemoryReportFormatter : public MemoryReportFormatter
+{
+public:
+    enum
+    {
+        DEFAULT_CAPACITY = 1024 * 1024,
+        DEFAULT_STRING_TABLE_SIZE = 64 * 1024,
+        NAME_CACHE_SIZE = 4096
+    };
+
+    TraceMemoryReportFormatter(const char* filename, size_t capacity = DEFAULT_CAPACITY, size_t stringTableSize = DEFAULT_STRING_TABLE_SIZE);
+    virtual ~TraceMemoryReportFormatter() CPPUTEST_DESTRUCTOR_OVERRIDE;
+
+    virtual void report_testgroup_start(TestResult* result, UtestShell& test) CPPUTEST_OVERRIDE;
+    virtual void report_testgroup_end(TestResult* /*result*/, UtestShell& /*test*/) CPPUTEST_OVERRIDE {} // LCOV_EXCL_LINE
+
+    virtual void report_test_start(TestResult* result, UtestShell& test) CPPUTEST_OVERRIDE;
+    virtual void report_test_end(TestResult* result, UtestShell& test) CPPUTEST_OVERRIDE;
+
+    virtual void report_alloc_memory(TestResult* result, TestMemoryAllocator* allocator, size_t size, char* memory, const char* file, size_t line) CPPUTEST_OVERRIDE;
+    virtual void report_free_memory(TestResult* result, TestMemoryAllocator* allocator, char* memory, const char* file, size_t line) CPPUTEST_OVERRIDE;
+
+    bool isMappedToFile() const;
+    bool isTracing() const;
+    const MemoryTraceHeader& header() const;
+    size_t numberOfRecords() const;
+    const MemoryTraceRecord& record(size_t index) const;
+    const char* stringAt(unsigned offset) const;
+
+private:
+    struct NameCacheEntry
+    {
+        const void* key_;
+        unsigned offset_;
+    };
+
+    void addRecord(unsigned kind, size_t address, size_t size, unsigned file, size_t line);
+    unsigned addString(const char* str);
+    NameCacheEntry* findNameCacheEntry(const void* key);
+    unsigned cacheName(NameCacheEntry* entry, const void* key, unsigned offset);
+    unsigned fileNameOffset(const char* file);
+    unsigned testNameOffset(UtestShell& test);
+    void warnAboutFullStringTable(TestResult* result);
+    bool warnWhenNotTracing(TestResult* result);
+    void releaseTrace();
+
+    SimpleString filename_;
+    char* trace_;
+    size_t traceSize_;
+    bool mappedToFile_;
+    bool warnedAboutMapping_;
+    bool stringTableFull_;
+    bool warnedAboutStringTable_;
+    bool warnedAboutNotTracing_;
+    unsigned long startTime_;
+
+    MemoryTraceHeader* header_;
+    char* strings_;
+    MemoryTraceRecord* records_;
+    unsigned currentTest_;
+
+    /* File names and tests are cached on their pointer, so each is stored once */
+    NameCacheEntry* nameCache_;
+
+    /* Without memory for the trace, the header is kept here and nothing is traced */
+    MemoryTraceHeader emptyHeader_;
+};
+
+#endif
@@ -0,0 +1,104 @@
+#!/usr/bin/env python3
+#
+# Converts a memory trace written with -pmemoryreport=trace into the JSON trace event format that trace viewers
+# like chrome://tracing and Perfetto load. The timeline has a counter with the live heap bytes and blocks over time,
+# one slice per test and the peak heap of every test.
+#
+# Usage: memory_trace_to_json.py <trace file> [<json file>]
+#
+# The layout of the trace is described in include/CppUTestExt/TraceMemoryReportFormatter.h
+
+import json
+import struct
+import sys
+
+MAGIC = b"CPPUTRC\0"
+KIND_ALLOC, KIND_FREE, KIND_TEST_START, KIND_TEST_END = 1, 2, 3, 4
+
+
+def read_trace(data):
+    if data[0:8] != MAGIC:
+        raise ValueError("not a CppUTest memory trace")
+
+    byte_order = "<" if struct.unpack_from("<I", data, 12)[0] == 0x01020304 else ">"
+    version, _, word_size, record_size = struct.unpack_from(byte_order + "4I", data, 8)
+    if version != 1:
+        raise ValueError("unsupported memory trace version %d" % version)
+
+    word = {4: "I", 8: "Q"}[word_size]
+    header_format = byte_order + "8s4I4" + word
+    string_table_size, _, capacity, written = struct.unpack_from(header_format, data, 0)[5:]
+
+    def round_up_to_word(size):
+        return (size + word_size - 1) // word_size * word_size
+
+    strings_offset = round_up_to_word(struct.calcsize(header_format))
+    strings = data[strings_offset:strings_offset + string_table_size]
+    records_offset = round_up_to_word(strings_offset + string_table_size)
+
+    def string_at(offset):
+        return strings[offset:strings.index(b"\0", offset)].decode("utf-8", "replace")
+
+    record_format = byte_order + "3" + word + "4I"
+    count = min(written, capacity)
+    records = []
+    for index in range(written - count, written):
+        offset = records_offset + (index % capacity) * record_size
+        timestamp, address, size, file, line, test, kind = struct.unpack_from(record_format, data, offset)
+        records.append((timestamp, address, size, string_at(file), line, string_at(test), kind))
+    return records, written - count
+
+
+def timeline(records, lost_records):
+    events = []
+    live_sizes = {}
+    live_bytes = 0
+    test_start = None
+    test_peak = 0
+    overall_peak = 0
+
+    for ts, address, size, file, line, test, kind in records:
+        if kind == KIND_ALLOC:
+            live_sizes[address] = size
+            live_bytes += size
+        elif kind == KIND_FREE:
+            live_bytes -= live_sizes.pop(address, 0)
+        elif kind == KIND_TEST_START:
+            test_start = ts
+            test_peak = live_bytes
+            continue
+        elif kind == KIND_TEST_END:
+            if test_start is not None:
+                events.append({"name": test, "cat": "test", "ph": "X", "ts": test_start, "dur": ts - test_start,
+                               "pid": 1, "tid": 1, "args": {"peak bytes": test_peak, "line": line}})
+            test_start = None
+            continue
+
+        test_peak = max(test_peak, live_bytes)
+        overall_peak = max(overall_peak, live_bytes)
+        events.append({"name": "heap", "ph": "C", "ts": ts, "pid": 1, "tid": 1,
+                       "args": {"live bytes": live_bytes, "live blocks": len(live_sizes)}})
+        events.append({"name": "%s:%d" % (file, line), "cat": "alloc" if kind == KIND_ALLOC else "free", "ph": "i",
+                       "s": "t", "ts": ts, "pid": 1, "tid": 2, "args": {"address": hex(address), "size": size}})
+
+    return {"traceEvents": events, "displayTimeUnit": "ms",
+            "otherData": {"peak bytes": overall_peak, "records lost in the ring": lost_records}}
+
+
+def main(argv):
+    if len(argv) < 2:
+        sys.stderr.write("usage: %s <trace file> [<json file>]\n" % argv[0])
+        return 1
+
+    with open(argv[1], "rb") as trace_file:
+        records, lost_records = read_trace(trace_file.read())
+
+    output = open(argv[2], "w") if len(argv) > 2 else sys.stdout
+    json.dump(timeline(records, lost_records), output)
+    if output is not sys.stdout:
+        output.close()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
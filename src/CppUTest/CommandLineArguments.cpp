@@ -32,7 +32,7 @@
 CommandLineArguments::CommandLineArguments(int ac, const char *const *av) :
     ac_(ac), av_(av), needHelp_(false), verbose_(false), veryVerbose_(false), color_(false), runTestsAsSeperateProcess_(false),
     listTestGroupNames_(false), listTestGroupAndCaseNames_(false), listTestLocations_(false), runIgnored_(false), reversing_(false),
-    crashOnFail_(false), rethrowExceptions_(true), shuffling_(false), shufflingPreSeeded_(false), repeat_(1), shuffleSeed_(0),
+    crashOnFail_(false), rethrowExceptions_(true), stringCache_(false), updateGoldenFiles_(false), shuffling_(false), shufflingPreSeeded_(false), repeat_(1), shuffleSeed_(0), allocationFailureSweepProcesses_(0),
     groupFilters_(NULLPTR), nameFilters_(NULLPTR), outputType_(OUTPUT_ECLIPSE)
 {
 }
@@ -72,7 +72,10 @@ bool CommandLineArguments::parse(TestPlugin* plugin)
         else if (argument == "-ri") runIgnored_ = true;
         else if (argument == "-f") crashOnFail_ = true;
         else if ((argument == "-e") || (argument == "-ci")) rethrowExceptions_ = false;
+        else if (argument == "-sc") stringCache_ = true;
+        else if (argument == "-ug") updateGoldenFiles_ = true;
         else if (argument.startsWith("-r")) setRepeatCount(ac_, av_, i);
+        else if (argument.startsWith("-af")) setAllocationFailureSweep(ac_, av_, i);
         else if (argument.startsWith("-g")) addGroupFilter(ac_, av_, i);
         else if (argument.startsWith("-t")) correctParameters = addGroupDotNameFilter(ac_, av_, i, "-t", false, false);
         else if (argument.startsWith("-st")) correctParameters = addGroupDotNameFilter(ac_, av_, i, "-st", true, false);
@@ -103,7 +106,7 @@ bool CommandLineArguments::parse(TestPlugin* plugin)
 const char* CommandLineArguments::usage() const
 {
     return "use -h for more extensive help\n"
-           "usage [-h] [-v] [-vv] [-c] [-p] [-lg] [-ln] [-ll] [-ri] [-r[<#>]] [-f] [-e] [-ci]\n"
+           "usage [-h] [-v] [-vv] [-c] [-p] [-lg] [-ln] [-ll] [-ri] [-r[<#>]] [-af[<#>]] [-f] [-e] [-ci] [-sc] [-ug]\n"
            "      [-g|sg|xg|xsg <groupName>]... [-n|sn|xn|xsn <testName>]... [-t|st|xt|xst <groupName>.<testName>]...\n"
            "      [-b] [-s [<seed>]] [\"[IGNORE_]TEST(<groupName>, <testName>)\"]...\n"
            "      [-o{normal|eclipse|junit|teamcity}] [-k <packageName>]\n";
@@ -155,9 +158,13 @@ const char* CommandLineArguments::help() const
       "  -b                - run the tests backwards, reversing the normal way\n"
       "  -s [<seed>]       - shuffle tests randomly (randomization seed is optional, must be greater than 0)\n"
       "  -r[<#>]           - repeat the tests <#> times (or twice if <#> is not specified)\n"
+      "  -af[<#>]          - rerun each test once for every allocation it does, with that allocation failing,\n"
+      "                      in <#> parallel processes (or 4 if <#> is not specified)\n"
       "  -f                - Cause the tests to crash on failure (to allow the test to be debugged if necessary)\n"
       "  -e                - do not rethrow unexpected exceptions on failure\n"
-      "  -ci               - continuous integration mode (equivalent to -e)\n";
+      "  -ci               - continuous integration mode (equivalent to -e)\n"
+      "  -sc               - allocate the SimpleString buffers from a thread-safe cache and print its hit rate\n"
+      "  -ug               - write the actual contents of CHECK_FILE_EQUAL to its golden file instead of comparing\n";
 }
 
 bool CommandLineArguments::needHelp() const
@@ -211,11 +218,26 @@ size_t CommandLineArguments::getRepeatCount() const
     return repeat_;
 }
 
+size_t CommandLineArguments::getAllocationFailureSweepProcesses() const
+{
+    return allocationFailureSweepProcesses_;
+}
+
 bool CommandLineArguments::isReversing() const
 {
     return reversing_;
 }
 
+bool CommandLineArguments::isUsingStringCache() const
+{
+    return stringCache_;
+}
+
+bool CommandLineArguments::isUpdatingGoldenFiles() const
+{
+    return updateGoldenFiles_;
+}
+
 bool CommandLineArguments::isCrashingOnFail() const
 {
     return crashOnFail_;
@@ -261,6 +283,20 @@ void CommandLineArguments::setRepeatCount(int ac, const char *const *av, int& i)
 
 }
 
+void CommandLineArguments::setAllocationFailureSweep(int ac, const char *const *av, int& i)
+{
+    allocationFailureSweepProcesses_ = 0;
+
+    SimpleString sweepParameter(av[i]);
+    if (sweepParameter.size() > 3) allocationFailureSweepProcesses_ = (size_t) (SimpleString::AtoI(av[i] + 3));
+    else if (i + 1 < ac) {
+        allocationFailureSweepProcesses_ = (size_t) (SimpleString::AtoI(av[i + 1]));
+        if (allocationFailureSweepProcesses_ != 0) i++;
+    }
+
+    if (0 == allocationFailureSweepProcesses_) allocationFailureSweepProcesses_ = 4;
+}
+
 bool CommandLineArguments::setShuffle(int ac, const char * const *av, int& i)
 {
     shuffling_ = true;
@@ -32,6 +32,7 @@
 #include "CppUTest/PlatformSpecificFunctions.h"
 #include "CppUTest/TeamCityTestOutput.h"
 #include "CppUTest/TestRegistry.h"
+#include "CppUTest/SimpleStringInternalCache.h"
 
 int CommandLineTestRunner::RunAllTests(int ac, char** av)
 {
@@ -53,7 +54,7 @@ int CommandLineTestRunner::RunAllTests(int ac, const char *const *av)
     }
 
     if (result == 0) {
-        backupOutput << memLeakWarn.FinalReport(0);
+        memLeakWarn.printFinalReport(backupOutput, 0);
     }
     TestRegistry::getCurrentRegistry()->removePluginByName(DEF_PLUGIN_MEM_LEAK);
     return result;
@@ -79,7 +80,7 @@ int CommandLineTestRunner::runAllTestsMain()
     registry_->installPlugin(&pPlugin);
 
     if (parseArguments(registry_->getFirstPlugin()))
-        testResult = runAllTests();
+        testResult = arguments_->isUsingStringCache() ? runAllTestsWithStringCache() : runAllTests();
 
     registry_->removePluginByName(DEF_PLUGIN_SET_POINTER);
     return testResult;
@@ -98,6 +99,8 @@ void CommandLineTestRunner::initializeTestRun()
     if (arguments_->isCrashingOnFail()) UtestShell::setCrashOnFail();
 
     UtestShell::setRethrowExceptions( arguments_->isRethrowingExceptions() );
+    UtestShell::setUpdateGoldenFiles( arguments_->isUpdatingGoldenFiles() );
+    UtestShell::setAllocationFailureSweep( arguments_->getAllocationFailureSweepProcesses() );
 }
 
 int CommandLineTestRunner::runAllTests()
@@ -154,6 +157,27 @@ int CommandLineTestRunner::runAllTests()
     return (int) (failedTestCount != 0 ? failedTestCount : failedExecutionCount);
 }
 
+/*
+ * The cache gets its memory from the original string allocator. Strings made before the run, like the arguments, and
+ * strings in statics that outlive it aren't released with the cache. They free their memory through the original
+ * allocator later.
+ */
+int CommandLineTestRunner::runAllTestsWithStringCache()
+{
+    ConsoleTestOutput cacheReportOutput;
+    SimpleStringInternalCache stringCache;
+    stringCache.turnOnThreadSafety();
+    SimpleStringCacheAllocator cacheAllocator(stringCache, SimpleString::getStringAllocator());
+    SimpleString::setStringAllocator(&cacheAllocator);
+
+    int result = runAllTests();
+
+    SimpleString::setStringAllocator(cacheAllocator.originalAllocator());
+    cacheReportOutput.print(stringCache.report().asCharString());
+    stringCache.clearCache();
+    return result;
+}
+
 TestOutput* CommandLineTestRunner::createTeamCityOutput()
 {
     return new TeamCityTestOutput;
@@ -34,12 +34,13 @@
 struct JUnitTestCaseResultNode
 {
     JUnitTestCaseResultNode() :
-        execTime_(0), failure_(NULLPTR), ignored_(false), lineNumber_ (0), checkCount_ (0), next_(NULLPTR)
+        execTime_(0), peakMemory_(0), failure_(NULLPTR), ignored_(false), lineNumber_ (0), checkCount_ (0), next_(NULLPTR)
     {
     }
 
     SimpleString name_;
     size_t execTime_;
+    size_t peakMemory_;
     TestFailure* failure_;
     bool ignored_;
     SimpleString file_;
@@ -111,6 +112,7 @@ void JUnitTestOutput::printCurrentGroupStarted(const UtestShell& /*test*/)
 void JUnitTestOutput::printCurrentTestEnded(const TestResult& result)
 {
     impl_->results_.tail_->execTime_ = result.getCurrentTestTotalExecutionTime();
+    impl_->results_.tail_->peakMemory_ = result.getCurrentTestPeakMemory();
     impl_->results_.tail_->checkCount_ = result.getCheckCount();
 }
 
@@ -128,7 +130,7 @@ void JUnitTestOutput::printCurrentGroupEnded(const TestResult& result)
 void JUnitTestOutput::printCurrentTestStarted(const UtestShell& test)
 {
     impl_->results_.testCount_++;
-    impl_->results_.group_ = test.getGroup();
+    impl_->results_.group_ = test.getGroupAsCharString();
     impl_->results_.startTime_ = (size_t) GetPlatformSpecificTimeInMillis();
 
     if (impl_->results_.tail_ == NULLPTR) {
@@ -139,8 +141,8 @@ void JUnitTestOutput::printCurrentTestStarted(const UtestShell& test)
         impl_->results_.tail_->next_ = new JUnitTestCaseResultNode;
         impl_->results_.tail_ = impl_->results_.tail_->next_;
     }
-    impl_->results_.tail_->name_ = test.getName();
-    impl_->results_.tail_->file_ = test.getFile();
+    impl_->results_.tail_->name_ = test.getNameAsCharString();
+    impl_->results_.tail_->file_ = test.getFileAsCharString();
     impl_->results_.tail_->lineNumber_ = test.getLineNumber();
     if (!test.willRun()) {
         impl_->results_.tail_->ignored_ = true;
@@ -232,6 +234,9 @@ void JUnitTestOutput::writeTestCases()
 
         impl_->results_.totalCheckCount_ = cur->checkCount_;
 
+        if (cur->peakMemory_) {
+            writePeakMemory(cur);
+        }
         if (cur->failure_) {
             writeFailure(cur);
         }
@@ -243,6 +248,13 @@ void JUnitTestOutput::writeTestCases()
     }
 }
 
+void JUnitTestOutput::writePeakMemory(JUnitTestCaseResultNode* node)
+{
+    writeToFile("<properties>\n");
+    writeToFile(StringFromFormat("<property name=\"peak_memory\" value=\"%lu\"/>\n", (unsigned long) node->peakMemory_).asCharString());
+    writeToFile("</properties>\n");
+}
+
 void JUnitTestOutput::writeFailure(JUnitTestCaseResultNode* node)
 {
     SimpleString buf = StringFromFormat(
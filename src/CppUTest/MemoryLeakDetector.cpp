@@ -27,6 +27,7 @@
 #include "CppUTest/TestHarness.h"
 #include "CppUTest/MemoryLeakDetector.h"
 #include "CppUTest/TestMemoryAllocator.h"
+#include "CppUTest/TestOutput.h"
 #include "CppUTest/PlatformSpecificFunctions.h"
 #include "CppUTest/SimpleMutex.h"
 
@@ -34,8 +35,39 @@ static const char* UNKNOWN = "<unknown>";
 
 static const char GuardBytes[] = {'B','A','S'};
 
+TestOutputMemoryLeakReportSink::TestOutputMemoryLeakReportSink(TestOutput& output) : output_(output)
+{
+}
+
+void TestOutputMemoryLeakReportSink::write(const char* chunk)
+{
+    output_.print(chunk);
+}
+
+FileMemoryLeakReportSink::FileMemoryLeakReportSink(const char* fileName, const char* flag)
+    : file_(PlatformSpecificFOpen(fileName, flag))
+{
+}
+
+FileMemoryLeakReportSink::~FileMemoryLeakReportSink()
+{
+    if (file_) PlatformSpecificFClose(file_);
+}
+
+bool FileMemoryLeakReportSink::isOpen() const
+{
+    return file_ != NULLPTR;
+}
+
+void FileMemoryLeakReportSink::write(const char* chunk)
+{
+    if (file_) PlatformSpecificFPuts(chunk, file_);
+}
+
+////////////////////////
+
 SimpleStringBuffer::SimpleStringBuffer() :
-    positions_filled_(0), write_limit_(SIMPLE_STRING_BUFFER_LEN-1)
+    positions_filled_(0), write_limit_(SIMPLE_STRING_BUFFER_LEN-1), truncated_(false), sink_(NULLPTR)
 {
     buffer_[0] = '\0';
 }
@@ -44,19 +76,46 @@ void SimpleStringBuffer::clear()
 {
     positions_filled_ = 0;
     buffer_[0] = '\0';
+    truncated_ = false;
 }
 
+/* When streaming to a sink, text that doesn't fit anymore is written again after the buffer was flushed to the sink.
+ * Only a single add larger than the whole buffer is still cut off.
+ */
 void SimpleStringBuffer::add(const char* format, ...)
 {
-    const size_t positions_left = write_limit_ - positions_filled_;
-    if (positions_left == 0) return;
+    if (sink_ && reachedItsCapacity()) flush();
+
+    const size_t positions_filled_before = positions_filled_;
+    const bool truncated_before = truncated_;
 
     va_list arguments;
     va_start(arguments, format);
-    const int count = PlatformSpecificVSNprintf(buffer_ + positions_filled_, positions_left+1, format, arguments);
-    if (count > 0) positions_filled_ += (size_t) count;
-    if (positions_filled_ > write_limit_) positions_filled_ = write_limit_;
+    const size_t count = write(format, arguments);
     va_end(arguments);
+
+    if (sink_ && positions_filled_before > 0 && count > write_limit_ - positions_filled_before) {
+        positions_filled_ = positions_filled_before;
+        buffer_[positions_filled_] = '\0';
+        truncated_ = truncated_before;
+        flush();
+
+        va_start(arguments, format);
+        write(format, arguments);
+        va_end(arguments);
+    }
+}
+
+/* Only text that is actually cut off marks the buffer as truncated, filling it up exactly doesn't */
+size_t SimpleStringBuffer::write(const char* format, va_list arguments)
+{
+    const size_t positions_left = (positions_filled_ < write_limit_) ? write_limit_ - positions_filled_ : 0;
+
+    const int count = PlatformSpecificVSNprintf(buffer_ + positions_filled_, positions_left+1, format, arguments);
+    if (count <= 0) return 0;
+    if ((size_t) count > positions_left) truncated_ = true;
+    positions_filled_ += ((size_t) count > positions_left) ? positions_left : (size_t) count;
+    return (size_t) count;
 }
 
 void SimpleStringBuffer::addMemoryDump(const void* memory, size_t memorySize)
@@ -121,6 +180,29 @@ bool SimpleStringBuffer::reachedItsCapacity()
     return positions_filled_ >= write_limit_;
 }
 
+bool SimpleStringBuffer::wasTruncated() const
+{
+    return truncated_;
+}
+
+void SimpleStringBuffer::setSink(MemoryLeakReportSink* sink)
+{
+    sink_ = sink;
+}
+
+bool SimpleStringBuffer::isStreaming() const
+{
+    return sink_ != NULLPTR;
+}
+
+void SimpleStringBuffer::flush()
+{
+    if (sink_ == NULLPTR || positions_filled_ == 0) return;
+    sink_->write(buffer_);
+    positions_filled_ = 0;
+    buffer_[0] = '\0';
+}
+
 ////////////////////////
 
 #define MEM_LEAK_TOO_MUCH "\netc etc etc etc. !!!! Too many memory leaks to report. Bailing out\n"
@@ -129,9 +211,12 @@ bool SimpleStringBuffer::reachedItsCapacity()
                                          "\tMemory leak reports about malloc and free can be caused by allocating using the cpputest version of malloc,\n" \
                                          "\tbut deallocate using the standard free.\n" \
                                          "\tIf this is the case, check whether your malloc/free replacements are working (#define malloc cpputest_malloc etc).\n"
+#define MEM_LEAK_SAMPLING_NOTE "NOTE:\n" \
+                               "\tLeak detection was sampling, only one in every %lu %s was tracked.\n" \
+                               "\tThe reported leaks are a sample of all leaks.\n"
 
 MemoryLeakOutputStringBuffer::MemoryLeakOutputStringBuffer()
-    : total_leaks_(0), giveWarningOnUsingMalloc_(false)
+    : total_leaks_(0), giveWarningOnUsingMalloc_(false), sampling_(mem_leak_sampling_none), samplingRate_(0)
 {
 }
 
@@ -154,39 +239,65 @@ void MemoryLeakOutputStringBuffer::startMemoryLeakReporting()
 {
     giveWarningOnUsingMalloc_ = false;
     total_leaks_ = 0;
+    sampling_ = mem_leak_sampling_none;
+    samplingRate_ = 0;
 
     size_t memory_leak_normal_footer_size = sizeof(MEM_LEAK_FOOTER) + 10 + sizeof(MEM_LEAK_TOO_MUCH); /* the number of leaks */
     size_t memory_leak_foot_size_with_malloc_warning = memory_leak_normal_footer_size + sizeof(MEM_LEAK_ADDITION_MALLOC_WARNING);
+    size_t memory_leak_foot_size_with_sampling_note = memory_leak_foot_size_with_malloc_warning + sizeof(MEM_LEAK_SAMPLING_NOTE) + 30; /* the rate and unit */
 
-    outputBuffer_.setWriteLimit(SimpleStringBuffer::SIMPLE_STRING_BUFFER_LEN - memory_leak_foot_size_with_malloc_warning);
+    if (outputBuffer_.isStreaming())
+        outputBuffer_.resetWriteLimit();
+    else
+        outputBuffer_.setWriteLimit(SimpleStringBuffer::SIMPLE_STRING_BUFFER_LEN - memory_leak_foot_size_with_sampling_note);
 }
 
-void MemoryLeakOutputStringBuffer::reportMemoryLeak(MemoryLeakDetectorNode* leak)
+void MemoryLeakOutputStringBuffer::reportSampling(MemLeakSampling sampling, size_t samplingRate)
+{
+    sampling_ = sampling;
+    samplingRate_ = samplingRate;
+}
+
+void MemoryLeakOutputStringBuffer::countLeaks(size_t leaks, TestMemoryAllocator* allocator)
 {
     if (total_leaks_ == 0) {
         addMemoryLeakHeader();
     }
 
-    total_leaks_++;
+    total_leaks_ += leaks;
+
+    if (SimpleString::StrCmp(allocator->alloc_name(), (const char*) "malloc") == 0)
+        giveWarningOnUsingMalloc_ = true;
+}
+
+void MemoryLeakOutputStringBuffer::reportMemoryLeak(MemoryLeakDetectorNode* leak)
+{
+    countLeaks(1, leak->allocator_);
     outputBuffer_.add("Alloc num (%u) Leak size: %lu Allocated at: %s and line: %d. Type: \"%s\"\n\tMemory: <%p> Content:\n",
             leak->number_, (unsigned long) leak->size_, leak->file_, (int) leak->line_, leak->allocator_->alloc_name(), (void*) leak->memory_);
     outputBuffer_.addMemoryDump(leak->memory_, leak->size_);
+    addStackTrace(leak->stack_);
+}
 
-    if (SimpleString::StrCmp(leak->allocator_->alloc_name(), (const char*) "malloc") == 0)
-        giveWarningOnUsingMalloc_ = true;
+void MemoryLeakOutputStringBuffer::reportMemoryLeakSite(const char* file, size_t line, TestMemoryAllocator* allocator, size_t leaks, size_t bytes)
+{
+    countLeaks(leaks, allocator);
+    outputBuffer_.add("%lu leak(s), %lu bytes allocated at: %s and line: %d. Type: \"%s\"\n",
+            (unsigned long) leaks, (unsigned long) bytes, file, (int) line, allocator->alloc_name());
 }
 
 void MemoryLeakOutputStringBuffer::stopMemoryLeakReporting()
 {
     if (total_leaks_ == 0) {
         addNoMemoryLeaksMessage();
+        outputBuffer_.flush();
         return;
     }
 
-    bool buffer_reached_its_capacity = outputBuffer_.reachedItsCapacity();
+    bool buffer_was_truncated = outputBuffer_.wasTruncated();
     outputBuffer_.resetWriteLimit();
 
-    if (buffer_reached_its_capacity)
+    if (buffer_was_truncated)
         addErrorMessageForTooMuchLeaks();
 
     addMemoryLeakFooter(total_leaks_);
@@ -194,6 +305,10 @@ void MemoryLeakOutputStringBuffer::stopMemoryLeakReporting()
     if (giveWarningOnUsingMalloc_)
         addWarningForUsingMalloc();
 
+    if (sampling_ != mem_leak_sampling_none)
+        addSamplingMessage(sampling_, samplingRate_);
+
+    outputBuffer_.flush();
 }
 
 void MemoryLeakOutputStringBuffer::addMemoryLeakHeader()
@@ -216,26 +331,45 @@ void MemoryLeakOutputStringBuffer::addWarningForUsingMalloc()
     outputBuffer_.add(MEM_LEAK_ADDITION_MALLOC_WARNING);
 }
 
+void MemoryLeakOutputStringBuffer::addSamplingMessage(MemLeakSampling sampling, size_t samplingRate)
+{
+    outputBuffer_.add(MEM_LEAK_SAMPLING_NOTE, (unsigned long) samplingRate, (sampling == mem_leak_sampling_bytes) ? "allocated bytes" : "allocations");
+}
+
+/* Stack traces are only symbolized here, so the cost of resolving names is only paid for reported memory. */
+void MemoryLeakOutputStringBuffer::addStackTrace(MemoryLeakStackTrace* stack)
+{
+    if (stack == NULLPTR) return;
+
+    char name[256];
+    outputBuffer_.add("\tAllocation stack:\n");
+    for (size_t i = 0; i < stack->depth_; i++) {
+        PlatformSpecificSymbolize(stack->frames_[i], name, sizeof(name));
+        outputBuffer_.add("\t\t#%lu <%p> %s\n", (unsigned long) i, stack->frames_[i], name);
+    }
+}
+
 void MemoryLeakOutputStringBuffer::reportDeallocateNonAllocatedMemoryFailure(const char* freeFile, size_t freeLine, TestMemoryAllocator* freeAllocator, MemoryLeakFailure* reporter)
 {
-    reportFailure("Deallocating non-allocated memory\n", "<unknown>", 0, 0, NullUnknownAllocator::defaultAllocator(), freeFile, freeLine, freeAllocator, reporter);
+    reportFailure("Deallocating non-allocated memory\n", "<unknown>", 0, 0, NullUnknownAllocator::defaultAllocator(), NULLPTR, freeFile, freeLine, freeAllocator, reporter);
 }
 
 void MemoryLeakOutputStringBuffer::reportAllocationDeallocationMismatchFailure(MemoryLeakDetectorNode* node, const char* freeFile, size_t freeLineNumber, TestMemoryAllocator* freeAllocator, MemoryLeakFailure* reporter)
 {
-    reportFailure("Allocation/deallocation type mismatch\n", node->file_, node->line_, node->size_, node->allocator_, freeFile, freeLineNumber, freeAllocator, reporter);
+    reportFailure("Allocation/deallocation type mismatch\n", node->file_, node->line_, node->size_, node->allocator_, node->stack_, freeFile, freeLineNumber, freeAllocator, reporter);
 }
 
 void MemoryLeakOutputStringBuffer::reportMemoryCorruptionFailure(MemoryLeakDetectorNode* node, const char* freeFile, size_t freeLineNumber, TestMemoryAllocator* freeAllocator, MemoryLeakFailure* reporter)
 {
-        reportFailure("Memory corruption (written out of bounds?)\n", node->file_, node->line_, node->size_, node->allocator_, freeFile, freeLineNumber, freeAllocator, reporter);
+        reportFailure("Memory corruption (written out of bounds?)\n", node->file_, node->line_, node->size_, node->allocator_, node->stack_, freeFile, freeLineNumber, freeAllocator, reporter);
 }
 
-void MemoryLeakOutputStringBuffer::reportFailure(const char* message, const char* allocFile, size_t allocLine, size_t allocSize, TestMemoryAllocator* allocAllocator, const char* freeFile, size_t freeLine,
+void MemoryLeakOutputStringBuffer::reportFailure(const char* message, const char* allocFile, size_t allocLine, size_t allocSize, TestMemoryAllocator* allocAllocator, MemoryLeakStackTrace* allocStack, const char* freeFile, size_t freeLine,
         TestMemoryAllocator* freeAllocator, MemoryLeakFailure* reporter)
 {
     outputBuffer_.add("%s", message);
     addAllocationLocation(allocFile, allocLine, allocSize, allocAllocator);
+    addStackTrace(allocStack);
     addDeallocationLocation(freeFile, freeLine, freeAllocator);
     reporter->fail(toString());
 }
@@ -251,9 +385,14 @@ void MemoryLeakOutputStringBuffer::clear()
     outputBuffer_.clear();
 }
 
+void MemoryLeakOutputStringBuffer::setSink(MemoryLeakReportSink* sink)
+{
+    outputBuffer_.setSink(sink);
+}
+
 ////////////////////////
 
-void MemoryLeakDetectorNode::init(char* memory, unsigned number, size_t size, TestMemoryAllocator* allocator, MemLeakPeriod period, unsigned char allocation_stage, const char* file, size_t line)
+void MemoryLeakDetectorNode::init(char* memory, unsigned number, size_t size, TestMemoryAllocator* allocator, MemLeakPeriod period, unsigned char allocation_stage, const char* file, size_t line, bool guarded)
 {
     number_ = number;
     memory_ = memory;
@@ -263,6 +402,187 @@ void MemoryLeakDetectorNode::init(char* memory, unsigned number, size_t size, Te
     allocation_stage_ = allocation_stage;
     file_ = file;
     line_ = line;
+    guarded_ = guarded;
+    stack_ = NULLPTR;
+}
+
+///////////////////////
+
+MemoryLeakAllocationCaller::MemoryLeakAllocationCaller(MemoryLeakDetector* detector, void* returnAddress)
+    : detector_(detector), marked_(detector && detector->markAllocationCaller(returnAddress))
+{
+}
+
+MemoryLeakAllocationCaller::~MemoryLeakAllocationCaller()
+{
+    if (marked_) detector_->unmarkAllocationCaller();
+}
+
+///////////////////////
+
+MemoryLeakStackTraceTable::MemoryLeakStackTraceTable() : count_(0)
+{
+    for (int i = 0; i < hash_prime; i++)
+        table_[i] = NULLPTR;
+}
+
+MemoryLeakStackTraceTable::~MemoryLeakStackTraceTable()
+{
+    clear();
+}
+
+unsigned long MemoryLeakStackTraceTable::hash(void** frames, size_t depth)
+{
+    unsigned long hash = (unsigned long) depth;
+    for (size_t i = 0; i < depth; i++)
+        hash = hash * 31 + (unsigned long) (size_t) frames[i];
+    return hash;
+}
+
+bool MemoryLeakStackTraceTable::equal(MemoryLeakStackTrace* stack, void** frames, size_t depth)
+{
+    if (stack->depth_ != depth) return false;
+    for (size_t i = 0; i < depth; i++)
+        if (stack->frames_[i] != frames[i]) return false;
+    return true;
+}
+
+/* Allocations from the same call site share one stack trace. When the table is full, new call sites are not recorded. */
+MemoryLeakStackTrace* MemoryLeakStackTraceTable::store(void** frames, size_t depth)
+{
+    if (depth > MemoryLeakStackTrace::MAX_DEPTH) depth = MemoryLeakStackTrace::MAX_DEPTH;
+
+    unsigned long stackHash = hash(frames, depth);
+    MemoryLeakStackTrace** bucket = &table_[stackHash % hash_prime];
+    for (MemoryLeakStackTrace* cur = *bucket; cur; cur = cur->next_)
+        if (cur->hash_ == stackHash && equal(cur, frames, depth)) return cur;
+
+    if (count_ == MAX_STACK_TRACES) return NULLPTR;
+    MemoryLeakStackTrace* stack = (MemoryLeakStackTrace*) PlatformSpecificMalloc(sizeof(MemoryLeakStackTrace));
+    if (stack == NULLPTR) return NULLPTR;
+
+    stack->hash_ = stackHash;
+    stack->depth_ = depth;
+    for (size_t i = 0; i < depth; i++)
+        stack->frames_[i] = frames[i];
+    stack->next_ = *bucket;
+    *bucket = stack;
+    count_++;
+    return stack;
+}
+
+size_t MemoryLeakStackTraceTable::size() const
+{
+    return count_;
+}
+
+void MemoryLeakStackTraceTable::clear()
+{
+    for (int i = 0; i < hash_prime; i++) {
+        while (table_[i]) {
+            MemoryLeakStackTrace* next = table_[i]->next_;
+            PlatformSpecificFree(table_[i]);
+            table_[i] = next;
+        }
+    }
+    count_ = 0;
+}
+
+///////////////////////
+
+MemoryLeakUntrackedMemoryTable::MemoryLeakUntrackedMemoryTable() : entries_(NULLPTR), capacity_(0), count_(0)
+{
+}
+
+MemoryLeakUntrackedMemoryTable::~MemoryLeakUntrackedMemoryTable()
+{
+    clear();
+}
+
+size_t MemoryLeakUntrackedMemoryTable::slot(char* memory) const
+{
+    size_t hash = ((size_t) memory >> 4) * 2654435761U;
+    return (hash ^ (hash >> 16)) & (capacity_ - 1);
+}
+
+/* The table is kept at most half full, so probe sequences stay short */
+bool MemoryLeakUntrackedMemoryTable::grow()
+{
+    size_t oldCapacity = capacity_;
+    MemoryLeakUntrackedMemory* oldEntries = entries_;
+    size_t newCapacity = (oldCapacity == 0) ? 64 : oldCapacity * 2;
+    MemoryLeakUntrackedMemory* newEntries = (MemoryLeakUntrackedMemory*) PlatformSpecificMalloc(newCapacity * sizeof(MemoryLeakUntrackedMemory));
+    if (newEntries == NULLPTR) return false;
+
+    for (size_t i = 0; i < newCapacity; i++)
+        newEntries[i].memory_ = NULLPTR;
+    entries_ = newEntries;
+    capacity_ = newCapacity;
+
+    for (size_t i = 0; i < oldCapacity; i++) {
+        if (oldEntries[i].memory_ == NULLPTR) continue;
+        size_t j = slot(oldEntries[i].memory_);
+        while (entries_[j].memory_) j = (j + 1) & (capacity_ - 1);
+        entries_[j] = oldEntries[i];
+    }
+    PlatformSpecificFree(oldEntries);
+    return true;
+}
+
+bool MemoryLeakUntrackedMemoryTable::add(char* memory, size_t size, TestMemoryAllocator* allocator)
+{
+    if ((count_ + 1) * 2 > capacity_ && !grow()) return false;
+
+    size_t i = slot(memory);
+    while (entries_[i].memory_) i = (i + 1) & (capacity_ - 1);
+    entries_[i].memory_ = memory;
+    entries_[i].size_ = size;
+    entries_[i].allocator_ = allocator;
+    count_++;
+    return true;
+}
+
+MemoryLeakUntrackedMemory* MemoryLeakUntrackedMemoryTable::retrieve(char* memory)
+{
+    if (count_ == 0) return NULLPTR;
+
+    for (size_t i = slot(memory); entries_[i].memory_; i = (i + 1) & (capacity_ - 1))
+        if (entries_[i].memory_ == memory) return &entries_[i];
+    return NULLPTR;
+}
+
+/* Entries after the removed one are shifted back when their probe sequence passes the freed slot, so no tombstones
+ * are needed */
+bool MemoryLeakUntrackedMemoryTable::remove(char* memory)
+{
+    MemoryLeakUntrackedMemory* entry = retrieve(memory);
+    if (entry == NULLPTR) return false;
+
+    size_t mask = capacity_ - 1;
+    size_t hole = (size_t) (entry - entries_);
+    for (size_t i = (hole + 1) & mask; entries_[i].memory_; i = (i + 1) & mask) {
+        size_t home = slot(entries_[i].memory_);
+        if (((i - home) & mask) >= ((i - hole) & mask)) {
+            entries_[hole] = entries_[i];
+            hole = i;
+        }
+    }
+    entries_[hole].memory_ = NULLPTR;
+    count_--;
+    return true;
+}
+
+size_t MemoryLeakUntrackedMemoryTable::size() const
+{
+    return count_;
+}
+
+void MemoryLeakUntrackedMemoryTable::clear()
+{
+    PlatformSpecificFree(entries_);
+    entries_ = NULLPTR;
+    capacity_ = 0;
+    count_ = 0;
 }
 
 ///////////////////////
@@ -472,6 +792,20 @@ MemoryLeakDetector::MemoryLeakDetector(MemoryLeakFailure* reporter)
     current_allocation_stage_ = 0;
     reporter_ = reporter;
     mutex_ = new SimpleMutex;
+    tier_ = mem_leak_tier_full;
+    sampling_ = mem_leak_sampling_none;
+    samplingRate_ = 0;
+    samplingCountdown_ = 0;
+    samplingRandom_ = 0;
+    stackTraceDepth_ = 0;
+    allocationCaller_ = NULLPTR;
+    reportLeaksBySite_ = false;
+    for (int i = 0; i <= mem_leak_period_checking; i++)
+        liveBytes_[i] = peakBytes_[i] = 0;
+    totalAllocatedBytes_ = 0;
+    watchedAllocation_ = 0;
+    watchedAllocationFile_ = NULLPTR;
+    watchedAllocationLine_ = 0;
 }
 
 MemoryLeakDetector::~MemoryLeakDetector()
@@ -485,6 +819,58 @@ MemoryLeakDetector::~MemoryLeakDetector()
 void MemoryLeakDetector::clearAllAccounting(MemLeakPeriod period)
 {
     memoryTable_.clearAllAccounting(period);
+    recountLiveBytes();
+}
+
+/* liveBytes_ is kept per node period, the queried periods overlap the same way as in MemoryLeakDetectorList::isInPeriod */
+size_t MemoryLeakDetector::getLiveBytes(MemLeakPeriod period) const
+{
+    if (period == mem_leak_period_all)
+        return liveBytes_[mem_leak_period_disabled] + liveBytes_[mem_leak_period_enabled] + liveBytes_[mem_leak_period_checking];
+    if (period == mem_leak_period_enabled)
+        return liveBytes_[mem_leak_period_enabled] + liveBytes_[mem_leak_period_checking];
+    return liveBytes_[period];
+}
+
+size_t MemoryLeakDetector::getPeakBytes(MemLeakPeriod period) const
+{
+    return peakBytes_[period];
+}
+
+void MemoryLeakDetector::resetPeakBytes()
+{
+    for (int i = 0; i <= mem_leak_period_checking; i++)
+        peakBytes_[i] = getLiveBytes((MemLeakPeriod) i);
+}
+
+size_t MemoryLeakDetector::getTotalAllocatedBytes() const
+{
+    return totalAllocatedBytes_;
+}
+
+void MemoryLeakDetector::addNode(MemoryLeakDetectorNode* node)
+{
+    memoryTable_.addNewNode(node);
+    liveBytes_[node->period_] += node->size_;
+    for (int i = 0; i <= mem_leak_period_checking; i++) {
+        size_t live = getLiveBytes((MemLeakPeriod) i);
+        if (live > peakBytes_[i]) peakBytes_[i] = live;
+    }
+}
+
+MemoryLeakDetectorNode* MemoryLeakDetector::removeNode(char* memory)
+{
+    MemoryLeakDetectorNode* node = memoryTable_.removeNode(memory);
+    if (node) liveBytes_[node->period_] -= node->size_;
+    return node;
+}
+
+void MemoryLeakDetector::recountLiveBytes()
+{
+    for (int i = 0; i <= mem_leak_period_checking; i++)
+        liveBytes_[i] = 0;
+    for (MemoryLeakDetectorNode* node = memoryTable_.getFirstLeak(mem_leak_period_all); node; node = memoryTable_.getNextLeak(node, mem_leak_period_all))
+        liveBytes_[node->period_] += node->size_;
 }
 
 void MemoryLeakDetector::startChecking()
@@ -523,11 +909,130 @@ void MemoryLeakDetector::enableAllocationTypeChecking()
     doAllocationTypeChecking_ = true;
 }
 
+void MemoryLeakDetector::setTier(MemLeakTier tier)
+{
+    tier_ = tier;
+}
+
+MemLeakTier MemoryLeakDetector::getTier() const
+{
+    return tier_;
+}
+
+bool MemoryLeakDetector::isTrackingLeaks() const
+{
+    return tier_ == mem_leak_tier_leak_only || tier_ == mem_leak_tier_full;
+}
+
+static const unsigned long samplingSeed = 0x2545F491UL;
+
+void MemoryLeakDetector::sampleEveryNthAllocation(size_t n)
+{
+    if (n <= 1) {
+        disableSampling();
+        return;
+    }
+    sampling_ = mem_leak_sampling_allocations;
+    samplingRate_ = n;
+    samplingRandom_ = samplingSeed;
+    samplingCountdown_ = nextSamplingInterval();
+}
+
+void MemoryLeakDetector::sampleEveryNBytes(size_t n)
+{
+    if (n <= 1) {
+        disableSampling();
+        return;
+    }
+    sampling_ = mem_leak_sampling_bytes;
+    samplingRate_ = n;
+    samplingRandom_ = samplingSeed;
+    samplingCountdown_ = nextSamplingInterval();
+}
+
+void MemoryLeakDetector::disableSampling()
+{
+    sampling_ = mem_leak_sampling_none;
+    samplingRate_ = 0;
+    samplingCountdown_ = 0;
+}
+
+MemLeakSampling MemoryLeakDetector::getSampling() const
+{
+    return sampling_;
+}
+
+size_t MemoryLeakDetector::getSamplingRate() const
+{
+    return samplingRate_;
+}
+
+size_t MemoryLeakDetector::getUntrackedAllocations() const
+{
+    return untrackedMemory_.size();
+}
+
+void MemoryLeakDetector::captureStackTraces(size_t depth)
+{
+    if (depth > MemoryLeakStackTrace::MAX_DEPTH) depth = MemoryLeakStackTrace::MAX_DEPTH;
+    stackTraceDepth_ = depth;
+}
+
+size_t MemoryLeakDetector::getStackTraceDepth() const
+{
+    return stackTraceDepth_;
+}
+
+size_t MemoryLeakDetector::getNumberOfStackTraces() const
+{
+    return stackTraces_.size();
+}
+
+/* Without stack traces the caller isn't needed, so allocations don't pay for marking it */
+bool MemoryLeakDetector::markAllocationCaller(void* returnAddress)
+{
+    if (stackTraceDepth_ == 0 || allocationCaller_ != NULLPTR || returnAddress == NULLPTR) return false;
+    allocationCaller_ = returnAddress;
+    return true;
+}
+
+void MemoryLeakDetector::unmarkAllocationCaller()
+{
+    allocationCaller_ = NULLPTR;
+}
+
+void* MemoryLeakDetector::getAllocationCaller() const
+{
+    return allocationCaller_;
+}
+
 unsigned MemoryLeakDetector::getCurrentAllocationNumber()
 {
     return allocationSequenceNumber_;
 }
 
+void MemoryLeakDetector::watchAllocation(unsigned number, const char* file, size_t line)
+{
+    watchedAllocation_ = number;
+    watchedAllocationFile_ = file;
+    watchedAllocationLine_ = line;
+}
+
+unsigned MemoryLeakDetector::getWatchedAllocation() const
+{
+    return watchedAllocation_;
+}
+
+const char* MemoryLeakDetector::getWatchedAllocationFile() const
+{
+    return watchedAllocationFile_;
+}
+
+size_t MemoryLeakDetector::getWatchedAllocationLine() const
+{
+    return watchedAllocationLine_;
+}
+
 void MemoryLeakDetector::increaseAllocationStage()
 {
     current_allocation_stage_++;
@@ -562,26 +1067,74 @@ MemoryLeakDetectorNode* MemoryLeakDetector::getNodeFromMemoryPointer(char* memor
     return (MemoryLeakDetectorNode*) (void*) (memory + sizeOfMemoryWithCorruptionInfo(memory_size));
 }
 
-void MemoryLeakDetector::storeLeakInformation(MemoryLeakDetectorNode * node, char *new_memory, size_t size, TestMemoryAllocator *allocator, const char *file, size_t line)
+/* Every allocation is counted, whether it is tracked or not, so the allocation budgets don't depend on sampling or the
+ * tier, as long as it isn't off */
+unsigned MemoryLeakDetector::countAllocation(size_t size, const char* file, size_t line)
 {
-    node->init(new_memory, allocationSequenceNumber_++, size, allocator, current_period_, current_allocation_stage_, file, line);
-    addMemoryCorruptionInformation(node->memory_ + node->size_);
-    memoryTable_.addNewNode(node);
+    if (allocationSequenceNumber_ == watchedAllocation_) {
+        watchedAllocationFile_ = file;
+        watchedAllocationLine_ = line;
+    }
+    totalAllocatedBytes_ += size;
+    return allocationSequenceNumber_++;
+}
+
+void MemoryLeakDetector::storeLeakInformation(MemoryLeakDetectorNode * node, unsigned number, char *new_memory, size_t size, TestMemoryAllocator *allocator, const char *file, size_t line)
+{
+    bool guarded = (tier_ == mem_leak_tier_full) && !allocator->guardsMemory();
+    node->init(new_memory, number, size, allocator, current_period_, current_allocation_stage_, file, line, guarded);
+    if (guarded) addMemoryCorruptionInformation(node->memory_ + node->size_);
+    node->stack_ = captureStackTrace();
+    addNode(node);
 }
 
-char* MemoryLeakDetector::reallocateMemoryAndLeakInformation(TestMemoryAllocator* allocator, char* memory, size_t size, const char* file, size_t line, bool allocatNodesSeperately)
+/* The frames up to the marked allocation caller belong to the leak detector and the allocation entry points. Without a
+ * marked caller, like when the detector is called directly or the compiler can't tell return addresses, only the frames
+ * of the platform hook, this function and storeLeakInformation are skipped */
+MemoryLeakStackTrace* MemoryLeakDetector::captureStackTrace()
+{
+    if (stackTraceDepth_ == 0) return NULLPTR;
+
+    const int maxDetectorDepth = MemoryLeakStackTrace::MAX_DETECTOR_DEPTH;
+    void* frames[MemoryLeakStackTrace::MAX_DEPTH + maxDetectorDepth];
+    int depth = PlatformSpecificBacktrace(frames, (int) stackTraceDepth_ + maxDetectorDepth);
+
+    int firstCallerFrame = 3;
+    void* caller = allocationCaller_;
+    for (int i = 0; caller && i < depth && i <= maxDetectorDepth; i++) {
+        if (frames[i] == caller) {
+            firstCallerFrame = i;
+            break;
+        }
+    }
+    if (depth <= firstCallerFrame) return NULLPTR;
+
+    size_t callerDepth = (size_t) (depth - firstCallerFrame);
+    if (callerDepth > stackTraceDepth_) callerDepth = stackTraceDepth_;
+    return stackTraces_.store(frames + firstCallerFrame, callerDepth);
+}
+
+/* PlatformSpecificRealloc grows the memory in place whenever it can. A separately allocated node is kept and rehashed on the
+ * new address, storeLeakInformation moves the canary behind the new end. When realloc fails, the original memory is still
+ * valid and stays tracked */
+char* MemoryLeakDetector::reallocateMemoryAndLeakInformation(MemoryLeakDetectorNode* node, unsigned number, TestMemoryAllocator* allocator, char* memory, size_t size, const char* file, size_t line, bool allocatNodesSeperately)
 {
     char* new_memory = reallocateMemoryWithAccountingInformation(allocator, memory, size, file, line, allocatNodesSeperately);
-    if (new_memory == NULLPTR) return NULLPTR;
+    if (new_memory == NULLPTR) {
+        if (node) addNode(node);
+        return NULLPTR;
+    }
 
-    MemoryLeakDetectorNode *node = createMemoryLeakAccountingInformation(allocator, size, new_memory, allocatNodesSeperately);
-    storeLeakInformation(node, new_memory, size, allocator, file, line);
+    if (node == NULLPTR || !allocatNodesSeperately)
+        node = createMemoryLeakAccountingInformation(allocator, size, new_memory, allocatNodesSeperately);
+    storeLeakInformation(node, number, new_memory, size, allocator, file, line);
     return node->memory_;
 }
 
 void MemoryLeakDetector::invalidateMemory(char* memory)
 {
 #ifndef CPPUTEST_DISABLE_HEAP_POISON
+  if (tier_ != mem_leak_tier_full) return;
   MemoryLeakDetectorNode* node = memoryTable_.retrieveNode(memory);
   if (node)
     PlatformSpecificMemset(memory, 0xCD, node->size_);
@@ -605,18 +1158,111 @@ bool MemoryLeakDetector::validMemoryCorruptionInformation(char* memory)
 bool MemoryLeakDetector::matchingAllocation(TestMemoryAllocator *alloc_allocator, TestMemoryAllocator *free_allocator)
 {
     if (alloc_allocator == free_allocator) return true;
-    if (!doAllocationTypeChecking_) return true;
+    if (!doAllocationTypeChecking_ || tier_ != mem_leak_tier_full) return true;
     return free_allocator->isOfEqualType(alloc_allocator);
 }
 
+/* Reporting a failure ends the test, so a separately allocated node is freed before and the failure is reported from a copy */
 void MemoryLeakDetector::checkForCorruption(MemoryLeakDetectorNode* node, const char* file, size_t line, TestMemoryAllocator* allocator, bool allocateNodesSeperately)
 {
-    if (!matchingAllocation(node->allocator_->actualAllocator(), allocator->actualAllocator()))
-        outputBuffer_.reportAllocationDeallocationMismatchFailure(node, file, line, allocator->actualAllocator(), reporter_);
-    else if (!validMemoryCorruptionInformation(node->memory_ + node->size_))
-        outputBuffer_.reportMemoryCorruptionFailure(node, file, line, allocator->actualAllocator(), reporter_);
-    else if (allocateNodesSeperately)
+    MemoryLeakDetectorNode checked(*node);
+    if (allocateNodesSeperately)
         allocator->freeMemoryLeakNode((char*) node);
+
+    if (!matchingAllocation(checked.allocator_->actualAllocator(), allocator->actualAllocator()))
+        outputBuffer_.reportAllocationDeallocationMismatchFailure(&checked, file, line, allocator->actualAllocator(), reporter_);
+    else if (checked.guarded_ && tier_ == mem_leak_tier_full && !validMemoryCorruptionInformation(checked.memory_ + checked.size_))
+        outputBuffer_.reportMemoryCorruptionFailure(&checked, file, line, allocator->actualAllocator(), reporter_);
+    else if (allocator->isMemoryCorrupted(checked.memory_))
+        outputBuffer_.reportMemoryCorruptionFailure(&checked, file, line, allocator->actualAllocator(), reporter_);
+}
+
+/* The distance to the next tracked allocation is drawn uniformly from 1 to 2n - 1, so on average one in n is tracked
+ * without locking onto allocation patterns that repeat. The generator is seeded whenever sampling is set, so a test
+ * samples the same allocations on every run */
+size_t MemoryLeakDetector::nextSamplingInterval()
+{
+    unsigned long random = samplingRandom_;
+    random ^= (random << 13) & 0xFFFFFFFFUL;
+    random ^= random >> 17;
+    random ^= (random << 5) & 0xFFFFFFFFUL;
+    samplingRandom_ = random;
+    return 1 + (size_t) (random % (2 * samplingRate_ - 1));
+}
+
+/* Sampling keeps a countdown to the next allocation that is tracked. When counting bytes, an allocation is
+ * tracked when it crosses the countdown, so large allocations are tracked more often than small ones.
+ */
+bool MemoryLeakDetector::shouldTrackAllocation(size_t size)
+{
+    if (sampling_ == mem_leak_sampling_allocations) {
+        if (--samplingCountdown_ > 0) return false;
+    }
+    else if (sampling_ == mem_leak_sampling_bytes) {
+        if (size < samplingCountdown_) {
+            samplingCountdown_ -= size;
+            return false;
+        }
+    }
+    else return true;
+
+    samplingCountdown_ = nextSamplingInterval();
+    return true;
+}
+
+/* Guarded memory and memory released in bulk need the detector to be freed, everything else it passes through with the tier off */
+bool MemoryLeakDetector::passesMemoryThrough(TestMemoryAllocator* allocator) const
+{
+    return tier_ == mem_leak_tier_off && !allocator->guardsMemory() && !allocator->releasesMemoryInBulk();
+}
+
+/* Memory allocated before the tier was turned off is still known and is freed the way it was allocated */
+bool MemoryLeakDetector::isKnownMemory(char* memory)
+{
+    return memoryTable_.retrieveNode(memory) != NULLPTR || untrackedMemory_.retrieve(memory) != NULLPTR ||
+           ArenaTestMemoryAllocator::findArenaOwning(memory) != NULLPTR;
+}
+
+/* When the untracked memory can't be remembered, it couldn't be freed without being reported, so the allocation fails */
+char* MemoryLeakDetector::registerUntrackedMemory(TestMemoryAllocator* allocator, char* memory, size_t size)
+{
+    if (memory == NULLPTR) return NULLPTR;
+
+    if (!untrackedMemory_.add(memory, size, allocator)) {
+        allocator->free_memory(memory, size, UNKNOWN, 0);
+        return NULLPTR;
+    }
+    return memory;
+}
+
+/* Untracked memory has no accounting information, so it can't be checked. It is freed by the allocator that allocated it */
+void MemoryLeakDetector::deallocateUntrackedMemory(MemoryLeakUntrackedMemory* untracked, const char* file, size_t line)
+{
+    TestMemoryAllocator* allocator = untracked->allocator_;
+    char* memory = untracked->memory_;
+    size_t size = untracked->size_;
+    untrackedMemory_.remove(memory);
+    if (!allocator->hasBeenDestroyed())
+        allocator->free_memory(memory, size, file, line);
+}
+
+char* MemoryLeakDetector::reallocateUntrackedMemory(MemoryLeakUntrackedMemory* untracked, size_t size, const char* file, size_t line)
+{
+    TestMemoryAllocator* allocator = untracked->allocator_;
+    char* memory = untracked->memory_;
+    size_t oldSize = untracked->size_;
+
+    char* new_memory = allocator->alloc_memory(size, file, line);
+    if (new_memory == NULLPTR) return NULLPTR;
+    if (!untrackedMemory_.add(new_memory, size, allocator)) {
+        allocator->free_memory(new_memory, size, file, line);
+        return NULLPTR;
+    }
+
+    PlatformSpecificMemCpy(new_memory, memory, (oldSize < size) ? oldSize : size);
+    untrackedMemory_.remove(memory);
+    allocator->free_memory(memory, oldSize, file, line);
+    return new_memory;
 }
 
 char* MemoryLeakDetector::allocMemory(TestMemoryAllocator* allocator, size_t size, bool allocatNodesSeperately)
@@ -626,6 +1272,7 @@ char* MemoryLeakDetector::allocMemory(TestMemoryAllocator* allocator, size_t siz
 
 char* MemoryLeakDetector::allocateMemoryWithAccountingInformation(TestMemoryAllocator* allocator, size_t size, const char* file, size_t line, bool allocatNodesSeperately)
 {
+    if (allocator->guardsMemory()) return allocator->alloc_memory(size, file, line);
     if (allocatNodesSeperately) return allocator->alloc_memory(sizeOfMemoryWithCorruptionInfo(size), file, line);
     else return allocator->alloc_memory(sizeOfMemoryWithCorruptionInfo(size) + sizeof(MemoryLeakDetectorNode), file, line);
 }
@@ -652,19 +1299,31 @@ char* MemoryLeakDetector::allocMemory(TestMemoryAllocator* allocator, size_t siz
      * If the same allocation is used and the wrong free is called, it will deallocate the memory leak information
      * without the memory leak detector ever noticing it!
      * So, for malloc, we'll allocate the memory separately so we can detect this and give a proper error.
+     *
+     * Guarding allocators place their own guards right against the memory, so the accounting information is
+     * always allocated separately. Guarded memory is always tracked, the accounting information is needed to free it.
      */
+    if (passesMemoryThrough(allocator))
+        return allocator->alloc_memory(size, file, line);
+    unsigned number = countAllocation(size, file, line);
+    if (allocator->releasesMemoryInBulk())
+        return allocateBulkReleasedMemory(allocator, size, file, line);
+    if (allocator->guardsMemory())
+        allocatNodesSeperately = true;
+    else if (!isTrackingLeaks() || !shouldTrackAllocation(size))
+        return registerUntrackedMemory(allocator, allocator->alloc_memory(size, file, line), size);
 
     char* memory = allocateMemoryWithAccountingInformation(allocator, size, file, line, allocatNodesSeperately);
     if (memory == NULLPTR) return NULLPTR;
     MemoryLeakDetectorNode* node = createMemoryLeakAccountingInformation(allocator, size, memory, allocatNodesSeperately);
 
-    storeLeakInformation(node, memory, size, allocator, file, line);
+    storeLeakInformation(node, number, memory, size, allocator, file, line);
     return node->memory_;
 }
 
 void MemoryLeakDetector::removeMemoryLeakInformationWithoutCheckingOrDeallocatingTheMemoryButDeallocatingTheAccountInformation(TestMemoryAllocator* allocator, void* memory, bool allocatNodesSeperately)
 {
-    MemoryLeakDetectorNode* node = memoryTable_.removeNode((char*) memory);
+    MemoryLeakDetectorNode* node = removeNode((char*) memory);
     if (allocatNodesSeperately) allocator->freeMemoryLeakNode( (char*) node);
 }
 
@@ -672,15 +1331,29 @@ void MemoryLeakDetector::deallocMemory(TestMemoryAllocator* allocator, void* mem
 {
     if (memory == NULLPTR) return;
 
-    MemoryLeakDetectorNode* node = memoryTable_.removeNode((char*) memory);
+    MemoryLeakDetectorNode* node = removeNode((char*) memory);
     if (node == NULLPTR) {
-        outputBuffer_.reportDeallocateNonAllocatedMemoryFailure(file, line, allocator, reporter_);
+        MemoryLeakUntrackedMemory* untracked = untrackedMemory_.retrieve((char*) memory);
+        ArenaTestMemoryAllocator* arena = NULLPTR;
+        if (untracked)
+            deallocateUntrackedMemory(untracked, file, line);
+        else if (allocator->releasesMemoryInBulk() && allocator->ownsMemory((char*) memory))
+            allocator->free_memory((char*) memory, 0, file, line);
+        else if ((arena = ArenaTestMemoryAllocator::findArenaOwning((char*) memory)) != NULLPTR)
+            arena->free_memory((char*) memory, 0, file, line);
+        else if (passesMemoryThrough(allocator))
+            allocator->free_memory((char*) memory, 0, file, line);
+        else
+            outputBuffer_.reportDeallocateNonAllocatedMemoryFailure(file, line, allocator, reporter_);
         return;
     }
 #ifdef CPPUTEST_DISABLE_MEM_CORRUPTION_CHECK
    allocatNodesSeperately = true;
 #endif
+    if (allocator->releasesMemoryInBulk())
+        allocator = node->allocator_;
     if (!allocator->hasBeenDestroyed()) {
+        if (allocator->guardsMemory()) allocatNodesSeperately = true;
         size_t size = node->size_;
         checkForCorruption(node, file, line, allocator, allocatNodesSeperately);
         allocator->free_memory((char*) memory, size, file, line);
@@ -704,36 +1377,194 @@ void MemoryLeakDetector::deallocAllMemoryInCurrentAllocationStage()
     }
 }
 
+/* Guarded memory isn't allocated with PlatformSpecificMalloc, so it can't be grown with PlatformSpecificRealloc */
+char* MemoryLeakDetector::reallocateGuardedMemory(TestMemoryAllocator* allocator, char* memory, size_t size, const char* file, size_t line)
+{
+    MemoryLeakDetectorNode* node = NULLPTR;
+    if (memory) {
+        node = memoryTable_.retrieveNode(memory);
+        if (node == NULLPTR) {
+            outputBuffer_.reportDeallocateNonAllocatedMemoryFailure(file, line, allocator, reporter_);
+            return NULLPTR;
+        }
+    }
+
+    char* new_memory = allocMemory(allocator, size, file, line, true);
+    if (new_memory == NULLPTR || node == NULLPTR) return new_memory;
+
+    PlatformSpecificMemCpy(new_memory, memory, (node->size_ < size) ? node->size_ : size);
+    deallocMemory(allocator, memory, file, line, true);
+    return new_memory;
+}
+
+/* Memory from an allocator that releases it in bulk, like an arena, isn't tracked. It is only counted, so allocation
+ * budgets keep working. Memory that was allocated before the arena was installed is still tracked and freed as usual */
+char* MemoryLeakDetector::allocateBulkReleasedMemory(TestMemoryAllocator* allocator, size_t size, const char* file, size_t line)
+{
+    return allocator->alloc_memory(size, file, line);
+}
+
+/* The old memory can be tracked, untracked, from this or another arena. Anything else wasn't allocated */
+char* MemoryLeakDetector::reallocateBulkReleasedMemory(TestMemoryAllocator* allocator, char* memory, size_t size, const char* file, size_t line)
+{
+    size_t oldSize = 0;
+    if (memory) {
+        MemoryLeakDetectorNode* node = memoryTable_.retrieveNode(memory);
+        MemoryLeakUntrackedMemory* untracked = NULLPTR;
+        TestMemoryAllocator* owner = NULLPTR;
+        if (node)
+            oldSize = node->size_;
+        else if ((untracked = untrackedMemory_.retrieve(memory)) != NULLPTR)
+            oldSize = untracked->size_;
+        else if ((owner = allocator->ownsMemory(memory) ? allocator : ArenaTestMemoryAllocator::findArenaOwning(memory)) != NULLPTR)
+            oldSize = owner->sizeOfMemory(memory);
+        else {
+            outputBuffer_.reportDeallocateNonAllocatedMemoryFailure(file, line, allocator, reporter_);
+            return NULLPTR;
+        }
+    }
+
+    char* new_memory = allocateBulkReleasedMemory(allocator, size, file, line);
+    if (new_memory == NULLPTR || memory == NULLPTR) return new_memory;
+
+    PlatformSpecificMemCpy(new_memory, memory, (oldSize < size) ? oldSize : size);
+    deallocMemory(allocator, memory, file, line);
+    return new_memory;
+}
+
+/* Memory of an arena that isn't installed anymore moves to the current allocator, the arena releases it in bulk */
+char* MemoryLeakDetector::reallocateArenaMemory(ArenaTestMemoryAllocator* arena, unsigned number, TestMemoryAllocator* allocator, char* memory, size_t size, const char* file, size_t line, bool allocatNodesSeperately)
+{
+    char* new_memory;
+    if (!isTrackingLeaks() || !shouldTrackAllocation(size))
+        new_memory = registerUntrackedMemory(allocator, allocator->alloc_memory(size, file, line), size);
+    else
+        new_memory = reallocateMemoryAndLeakInformation(NULLPTR, number, allocator, NULLPTR, size, file, line, allocatNodesSeperately);
+    if (new_memory == NULLPTR) return NULLPTR;
+
+    size_t oldSize = arena->sizeOfMemory(memory);
+    PlatformSpecificMemCpy(new_memory, memory, (oldSize < size) ? oldSize : size);
+    arena->free_memory(memory, oldSize, file, line);
+    return new_memory;
+}
+
 char* MemoryLeakDetector::reallocMemory(TestMemoryAllocator* allocator, char* memory, size_t size, const char* file, size_t line, bool allocatNodesSeperately)
 {
 #ifdef CPPUTEST_DISABLE_MEM_CORRUPTION_CHECK
    allocatNodesSeperately = true;
 #endif
+    if (allocator->guardsMemory())
+        return reallocateGuardedMemory(allocator, memory, size, file, line);
+    if (passesMemoryThrough(allocator) && (memory == NULLPTR || !isKnownMemory(memory)))
+        return (char*) PlatformSpecificRealloc(memory, size);
+    unsigned number = countAllocation(size, file, line);
+    if (allocator->releasesMemoryInBulk())
+        return reallocateBulkReleasedMemory(allocator, memory, size, file, line);
+
+    MemoryLeakDetectorNode* node = NULLPTR;
     if (memory) {
-        MemoryLeakDetectorNode* node = memoryTable_.removeNode(memory);
+        node = removeNode(memory);
         if (node == NULLPTR) {
+            MemoryLeakUntrackedMemory* untracked = untrackedMemory_.retrieve(memory);
+            if (untracked)
+                return reallocateUntrackedMemory(untracked, size, file, line);
+            ArenaTestMemoryAllocator* arena = ArenaTestMemoryAllocator::findArenaOwning(memory);
+            if (arena)
+                return reallocateArenaMemory(arena, number, allocator, memory, size, file, line, allocatNodesSeperately);
             outputBuffer_.reportDeallocateNonAllocatedMemoryFailure(file, line, allocator, reporter_);
             return NULLPTR;
         }
-        checkForCorruption(node, file, line, allocator, allocatNodesSeperately);
+        checkForCorruption(node, file, line, allocator, false);
     }
-    return reallocateMemoryAndLeakInformation(allocator, memory, size, file, line, allocatNodesSeperately);
+    else if (!isTrackingLeaks() || !shouldTrackAllocation(size))
+        return registerUntrackedMemory(allocator, allocator->alloc_memory(size, file, line), size);
+
+    return reallocateMemoryAndLeakInformation(node, number, allocator, memory, size, file, line, allocatNodesSeperately);
 }
 
 void MemoryLeakDetector::ConstructMemoryLeakReport(MemLeakPeriod period)
 {
-    MemoryLeakDetectorNode* leak = memoryTable_.getFirstLeak(period);
-
     outputBuffer_.startMemoryLeakReporting();
+    outputBuffer_.reportSampling(sampling_, samplingRate_);
 
-    while (leak) {
-        outputBuffer_.reportMemoryLeak(leak);
-        leak = memoryTable_.getNextLeak(leak, period);
+    if (reportLeaksBySite_) {
+        ConstructMemoryLeakReportBySite(period);
+    }
+    else {
+        MemoryLeakDetectorNode* leak = memoryTable_.getFirstLeak(period);
+        while (leak) {
+            outputBuffer_.reportMemoryLeak(leak);
+            leak = memoryTable_.getNextLeak(leak, period);
+        }
     }
 
     outputBuffer_.stopMemoryLeakReporting();
 }
 
+struct MemoryLeakSite
+{
+    const char* file_;
+    size_t line_;
+    TestMemoryAllocator* allocator_;
+    size_t leaks_;
+    size_t bytes_;
+    size_t next_;
+};
+
+/* Sites are kept in one growing array, chained per bucket by index. They are reported with the largest amount of
+ * leaked bytes first.
+ */
+void MemoryLeakDetector::ConstructMemoryLeakReportBySite(MemLeakPeriod period)
+{
+    const size_t no_site = (size_t) -1;
+    size_t buckets[MEMORY_LEAK_HASH_TABLE_SIZE];
+    for (size_t b = 0; b < MEMORY_LEAK_HASH_TABLE_SIZE; b++)
+        buckets[b] = no_site;
+
+    MemoryLeakSite* sites = NULLPTR;
+    size_t count = 0;
+    size_t capacity = 0;
+
+    for (MemoryLeakDetectorNode* leak = memoryTable_.getFirstLeak(period); leak; leak = memoryTable_.getNextLeak(leak, period)) {
+        size_t* bucket = &buckets[leak->line_ % MEMORY_LEAK_HASH_TABLE_SIZE];
+        size_t i = *bucket;
+        while (i != no_site && (sites[i].line_ != leak->line_ || SimpleString::StrCmp(sites[i].file_, leak->file_) != 0))
+            i = sites[i].next_;
+
+        if (i == no_site) {
+            if (count == capacity) {
+                capacity = (capacity == 0) ? 16 : capacity * 2;
+                MemoryLeakSite* grown = (MemoryLeakSite*) PlatformSpecificRealloc(sites, capacity * sizeof(MemoryLeakSite));
+                if (grown == NULLPTR) break;
+                sites = grown;
+            }
+            i = count++;
+            sites[i].file_ = leak->file_;
+            sites[i].line_ = leak->line_;
+            sites[i].allocator_ = leak->allocator_;
+            sites[i].leaks_ = 0;
+            sites[i].bytes_ = 0;
+            sites[i].next_ = *bucket;
+            *bucket = i;
+        }
+        sites[i].leaks_++;
+        sites[i].bytes_ += leak->size_;
+    }
+
+    for (size_t i = 1; i < count; i++) {
+        MemoryLeakSite site = sites[i];
+        size_t j = i;
+        for (; j > 0 && sites[j - 1].bytes_ < site.bytes_; j--)
+            sites[j] = sites[j - 1];
+        sites[j] = site;
+    }
+
+    for (size_t i = 0; i < count; i++)
+        outputBuffer_.reportMemoryLeakSite(sites[i].file_, sites[i].line_, sites[i].allocator_, sites[i].leaks_, sites[i].bytes_);
+
+    PlatformSpecificFree(sites);
+}
+
 const char* MemoryLeakDetector::report(MemLeakPeriod period)
 {
     ConstructMemoryLeakReport(period);
@@ -741,6 +1572,24 @@ const char* MemoryLeakDetector::report(MemLeakPeriod period)
     return outputBuffer_.toString();
 }
 
+void MemoryLeakDetector::report(MemLeakPeriod period, MemoryLeakReportSink& sink)
+{
+    outputBuffer_.clear();
+    outputBuffer_.setSink(&sink);
+    ConstructMemoryLeakReport(period);
+    outputBuffer_.setSink(NULLPTR);
+}
+
+void MemoryLeakDetector::reportLeaksBySite(bool bySite)
+{
+    reportLeaksBySite_ = bySite;
+}
+
+bool MemoryLeakDetector::isReportingLeaksBySite() const
+{
+    return reportLeaksBySite_;
+}
+
 void MemoryLeakDetector::markCheckingPeriodLeaksAsNonCheckingPeriod()
 {
     MemoryLeakDetectorNode* leak = memoryTable_.getFirstLeak(mem_leak_period_checking);
@@ -748,6 +1597,8 @@ void MemoryLeakDetector::markCheckingPeriodLeaksAsNonCheckingPeriod()
         if (leak->period_ == mem_leak_period_checking) leak->period_ = mem_leak_period_enabled;
         leak = memoryTable_.getNextLeak(leak, mem_leak_period_checking);
     }
+    liveBytes_[mem_leak_period_enabled] += liveBytes_[mem_leak_period_checking];
+    liveBytes_[mem_leak_period_checking] = 0;
 }
 
 size_t MemoryLeakDetector::totalMemoryLeaks(MemLeakPeriod period)
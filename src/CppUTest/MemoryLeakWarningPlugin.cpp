@@ -112,11 +112,13 @@ static void*(*realloc_fptr)(void* memory, size_t size, const char* file, size_t
 
 void* cpputest_malloc_location_with_leak_detection(size_t size, const char* file, size_t line)
 {
+    MemoryLeakAllocationCaller caller(MemoryLeakWarningPlugin::getGlobalDetectorIfCreated(), CPPUTEST_RETURN_ADDRESS());
     return malloc_fptr(size, file, line);
 }
 
 void* cpputest_realloc_location_with_leak_detection(void* memory, size_t size, const char* file, size_t line)
 {
+    MemoryLeakAllocationCaller caller(MemoryLeakWarningPlugin::getGlobalDetectorIfCreated(), CPPUTEST_RETURN_ADDRESS());
     return realloc_fptr(memory, size, file, line);
 }
 
@@ -314,16 +316,19 @@ static int save_counter = 0;
 
 void* operator new(size_t size) UT_THROW(CPPUTEST_BAD_ALLOC)
 {
+    MemoryLeakAllocationCaller caller(MemoryLeakWarningPlugin::getGlobalDetectorIfCreated(), CPPUTEST_RETURN_ADDRESS());
     return operator_new_fptr(size);
 }
 
 void* operator new(size_t size, const char* file, int line) UT_THROW(CPPUTEST_BAD_ALLOC)
 {
+    MemoryLeakAllocationCaller caller(MemoryLeakWarningPlugin::getGlobalDetectorIfCreated(), CPPUTEST_RETURN_ADDRESS());
     return operator_new_debug_fptr(size, file, (size_t)line);
 }
 
 void* operator new(size_t size, const char* file, size_t line) UT_THROW(CPPUTEST_BAD_ALLOC)
 {
+    MemoryLeakAllocationCaller caller(MemoryLeakWarningPlugin::getGlobalDetectorIfCreated(), CPPUTEST_RETURN_ADDRESS());
     return operator_new_debug_fptr(size, file, line);
 }
 
@@ -351,16 +356,19 @@ void operator delete (void* mem, size_t) UT_NOTHROW
 
 void* operator new[](size_t size) UT_THROW(CPPUTEST_BAD_ALLOC)
 {
+    MemoryLeakAllocationCaller caller(MemoryLeakWarningPlugin::getGlobalDetectorIfCreated(), CPPUTEST_RETURN_ADDRESS());
     return operator_new_array_fptr(size);
 }
 
 void* operator new [](size_t size, const char* file, int line) UT_THROW(CPPUTEST_BAD_ALLOC)
 {
+    MemoryLeakAllocationCaller caller(MemoryLeakWarningPlugin::getGlobalDetectorIfCreated(), CPPUTEST_RETURN_ADDRESS());
     return operator_new_array_debug_fptr(size, file, (size_t)line);
 }
 
 void* operator new [](size_t size, const char* file, size_t line) UT_THROW(CPPUTEST_BAD_ALLOC)
 {
+    MemoryLeakAllocationCaller caller(MemoryLeakWarningPlugin::getGlobalDetectorIfCreated(), CPPUTEST_RETURN_ADDRESS());
     return operator_new_array_debug_fptr(size, file, line);
 }
 
@@ -390,6 +398,7 @@ void operator delete[] (void* mem, size_t) UT_NOTHROW
 
 void* operator new(size_t size, const std::nothrow_t&) UT_NOTHROW
 {
+    MemoryLeakAllocationCaller caller(MemoryLeakWarningPlugin::getGlobalDetectorIfCreated(), CPPUTEST_RETURN_ADDRESS());
     return operator_new_nothrow_fptr(size);
 }
 
@@ -400,6 +409,7 @@ void operator delete(void* mem, const std::nothrow_t&) UT_NOTHROW
 
 void* operator new[](size_t size, const std::nothrow_t&) UT_NOTHROW
 {
+    MemoryLeakAllocationCaller caller(MemoryLeakWarningPlugin::getGlobalDetectorIfCreated(), CPPUTEST_RETURN_ADDRESS());
     return operator_new_array_nothrow_fptr(size);
 }
 
@@ -565,6 +575,12 @@ MemoryLeakDetector* MemoryLeakWarningPlugin::getGlobalDetector()
     return globalDetector;
 }
 
+/* The allocation entry points ask for the detector without creating it, as creating it allocates */
+MemoryLeakDetector* MemoryLeakWarningPlugin::getGlobalDetectorIfCreated()
+{
+    return globalDetector;
+}
+
 MemoryLeakFailure* MemoryLeakWarningPlugin::getGlobalFailureReporter()
 {
     return globalReporter;
@@ -612,8 +628,52 @@ void MemoryLeakWarningPlugin::expectLeaksInTest(size_t n)
     expectedLeaks_ = n;
 }
 
+void MemoryLeakWarningPlugin::sampleLeaksEveryNthAllocationInTest(size_t n)
+{
+    memLeakDetector_->sampleEveryNthAllocation(n);
+}
+
+void MemoryLeakWarningPlugin::sampleLeaksEveryNBytesInTest(size_t n)
+{
+    memLeakDetector_->sampleEveryNBytes(n);
+}
+
+void MemoryLeakWarningPlugin::setTierInTest(MemLeakTier tier)
+{
+    memLeakDetector_->setTier(tier);
+}
+
+size_t MemoryLeakWarningPlugin::getLiveBytesInTest() const
+{
+    return memLeakDetector_->getLiveBytes(mem_leak_period_checking);
+}
+
+size_t MemoryLeakWarningPlugin::getPeakBytesInTest() const
+{
+    return memLeakDetector_->getPeakBytes(mem_leak_period_checking);
+}
+
+void MemoryLeakWarningPlugin::checkPeakInTest(size_t bytes, const char* file, size_t line)
+{
+    UtestShell::getCurrent()->countCheck();
+    size_t peak = getPeakBytesInTest();
+    if (peak >= bytes)
+        UtestShell::getCurrent()->fail(StringFromFormat("Memory peak of %lu bytes is not less than %lu bytes", (unsigned long) peak, (unsigned long) bytes).asCharString(), file, line);
+}
+
+bool MemoryLeakWarningPlugin::parseTier(const SimpleString& name, MemLeakTier& tier)
+{
+    if (name == "off") tier = mem_leak_tier_off;
+    else if (name == "count-only") tier = mem_leak_tier_count_only;
+    else if (name == "leak-only") tier = mem_leak_tier_leak_only;
+    else if (name == "full") tier = mem_leak_tier_full;
+    else return false;
+    return true;
+}
+
 MemoryLeakWarningPlugin::MemoryLeakWarningPlugin(const SimpleString& name, MemoryLeakDetector* localDetector) :
-    TestPlugin(name), ignoreAllWarnings_(false), destroyGlobalDetectorAndTurnOfMemoryLeakDetectionInDestructor_(false), expectedLeaks_(0)
+    TestPlugin(name), ignoreAllWarnings_(false), destroyGlobalDetectorAndTurnOfMemoryLeakDetectionInDestructor_(false), expectedLeaks_(0),
+    allocationNumberAtStart_(0), allocatedBytesAtStart_(0)
 {
     if (firstPlugin_ == NULLPTR) firstPlugin_ = this;
 
@@ -631,30 +691,149 @@ MemoryLeakWarningPlugin::~MemoryLeakWarningPlugin()
     }
 }
 
-void MemoryLeakWarningPlugin::preTestAction(UtestShell& /*test*/, TestResult& result)
+void MemoryLeakWarningPlugin::setSamplingForGroup(const SimpleString& group)
+{
+    size_t rate = 0;
+    if (samplingBytes_.find(group, rate))
+        memLeakDetector_->sampleEveryNBytes(rate);
+    else if (samplingAllocations_.find(group, rate))
+        memLeakDetector_->sampleEveryNthAllocation(rate);
+}
+
+void MemoryLeakWarningPlugin::setTierForGroup(const SimpleString& group)
+{
+    size_t tier = mem_leak_tier_full;
+    if (tiers_.find(group, tier))
+        memLeakDetector_->setTier((MemLeakTier) tier);
+}
+
+/* Budgets given with -pmaxallocs and -pmaxallocbytes, they count all allocations made during the test, also the ones
+ * that the tier or sampling leaves untracked. Only with the tier off nothing is counted */
+void MemoryLeakWarningPlugin::checkAllocationBudget(UtestShell& test, TestResult& result)
+{
+    size_t maximum = 0;
+    size_t allocations = memLeakDetector_->getCurrentAllocationNumber() - allocationNumberAtStart_;
+    if (maximumAllocations_.find(test.getGroup(), maximum) && allocations > maximum) {
+        TestFailure f(&test, StringFromFormat("Test made %lu allocations, the maximum is %lu allocations per test", (unsigned long) allocations, (unsigned long) maximum));
+        result.addFailure(f);
+    }
+
+    size_t bytes = memLeakDetector_->getTotalAllocatedBytes() - allocatedBytesAtStart_;
+    if (maximumAllocatedBytes_.find(test.getGroup(), maximum) && bytes > maximum) {
+        TestFailure f(&test, StringFromFormat("Test allocated %lu bytes, the maximum is %lu bytes per test", (unsigned long) bytes, (unsigned long) maximum));
+        result.addFailure(f);
+    }
+}
+
+void MemoryLeakWarningPlugin::preTestAction(UtestShell& test, TestResult& result)
 {
     memLeakDetector_->startChecking();
+    memLeakDetector_->resetPeakBytes();
     failureCount_ = result.getFailureCount();
+    allocationNumberAtStart_ = memLeakDetector_->getCurrentAllocationNumber();
+    allocatedBytesAtStart_ = memLeakDetector_->getTotalAllocatedBytes();
+
+    if (!tiers_.isEmpty())
+        setTierForGroup(test.getGroup());
+
+    if (!samplingAllocations_.isEmpty() || !samplingBytes_.isEmpty())
+        setSamplingForGroup(test.getGroup());
 }
 
 void MemoryLeakWarningPlugin::postTestAction(UtestShell& test, TestResult& result)
 {
     memLeakDetector_->stopChecking();
     size_t leaks = memLeakDetector_->totalMemoryLeaks(mem_leak_period_checking);
+    result.setCurrentTestPeakMemory(getPeakBytesInTest());
+    bool testFailed = failureCount_ != result.getFailureCount();
 
-    if (!ignoreAllWarnings_ && expectedLeaks_ != leaks && failureCount_ == result.getFailureCount()) {
+    if (!ignoreAllWarnings_ && memLeakDetector_->isTrackingLeaks() && expectedLeaks_ != leaks && !testFailed) {
         if(MemoryLeakWarningPlugin::areNewDeleteOverloaded()) {
             TestFailure f(&test, memLeakDetector_->report(mem_leak_period_checking));
             result.addFailure(f);
+            if (!reportFileName_.isEmpty()) writeReportToFile();
         } else if(expectedLeaks_ > 0) {
             result.print(StringFromFormat("Warning: Expected %d leak(s), but leak detection was disabled", (int) expectedLeaks_).asCharString());
         }
     }
+    if (!testFailed && !(maximumAllocations_.isEmpty() && maximumAllocatedBytes_.isEmpty()))
+        checkAllocationBudget(test, result);
+
     memLeakDetector_->markCheckingPeriodLeaksAsNonCheckingPeriod();
+    memLeakDetector_->disableSampling();
+    memLeakDetector_->setTier(mem_leak_tier_full);
     ignoreAllWarnings_ = false;
     expectedLeaks_ = 0;
 }
 
+bool MemoryLeakWarningPlugin::parseArguments(int /* ac */, const char *const *av, int index)
+{
+    SimpleString argument(av[index]);
+    if (argument.startsWith("-pmemleaksamplebytes="))
+        return samplingBytes_.parse(argument, "-pmemleaksamplebytes=");
+    if (argument.startsWith("-pmemleaksample="))
+        return samplingAllocations_.parse(argument, "-pmemleaksample=");
+    if (argument.startsWith("-pmemleaktier="))
+        return parseTierArgument(argument);
+    if (argument.startsWith("-pmemleakstack="))
+        return parseStackTraceArgument(argument);
+    if (argument.startsWith("-pmaxallocs="))
+        return maximumAllocations_.parse(argument, "-pmaxallocs=");
+    if (argument.startsWith("-pmaxallocbytes="))
+        return maximumAllocatedBytes_.parse(argument, "-pmaxallocbytes=");
+    if (argument.startsWith("-pmemleakreport="))
+        return parseReportFileArgument(argument);
+    if (argument == "-pmemleakbysite") {
+        memLeakDetector_->reportLeaksBySite(true);
+        return true;
+    }
+    return false;
+}
+
+bool MemoryLeakWarningPlugin::parseReportFileArgument(const SimpleString& argument)
+{
+    reportFileName_ = argument.subString(sizeof("-pmemleakreport=") - 1);
+    if (reportFileName_.isEmpty()) return false;
+
+    FileMemoryLeakReportSink truncate(reportFileName_.asCharString(), "w");
+    return truncate.isOpen();
+}
+
+/* The complete report is streamed to the file, the failure itself only holds what fits in the report buffer. */
+void MemoryLeakWarningPlugin::writeReportToFile()
+{
+    FileMemoryLeakReportSink sink(reportFileName_.asCharString());
+    memLeakDetector_->report(mem_leak_period_checking, sink);
+}
+
+static bool isUnsignedNumber(const SimpleString& value)
+{
+    if (value.isEmpty()) return false;
+    for (const char* digit = value.asCharString(); *digit; digit++)
+        if (*digit < '0' || *digit > '9') return false;
+    return true;
+}
+
+bool MemoryLeakWarningPlugin::parseStackTraceArgument(const SimpleString& argument)
+{
+    SimpleString depth = argument.subString(sizeof("-pmemleakstack=") - 1);
+    if (!isUnsignedNumber(depth)) return false;
+
+    memLeakDetector_->captureStackTraces(SimpleString::AtoU(depth.asCharString()));
+    return true;
+}
+
+bool MemoryLeakWarningPlugin::parseTierArgument(const SimpleString& argument)
+{
+    SimpleString group, name;
+    MemLeakTier tier;
+    if (!MemoryLeakGroupSettings::split(argument, "-pmemleaktier=", group, name) || !parseTier(name, tier))
+        return false;
+
+    tiers_.add(group, (size_t) tier);
+    return true;
+}
+
 const char* MemoryLeakWarningPlugin::FinalReport(size_t toBeDeletedLeaks)
 {
     size_t leaks = memLeakDetector_->totalMemoryLeaks(mem_leak_period_enabled);
@@ -662,4 +841,174 @@ const char* MemoryLeakWarningPlugin::FinalReport(size_t toBeDeletedLeaks)
     return "";
 }
 
+void MemoryLeakWarningPlugin::printFinalReport(TestOutput& output, size_t toBeDeletedLeaks)
+{
+    size_t leaks = memLeakDetector_->totalMemoryLeaks(mem_leak_period_enabled);
+    if (leaks == toBeDeletedLeaks) return;
+
+    TestOutputMemoryLeakReportSink sink(output);
+    memLeakDetector_->report(mem_leak_period_enabled, sink);
+}
+
+
+
+MemoryLeakGroupSettings::MemoryLeakGroupSettings()
+    : count_(0), hasDefault_(false), default_(0)
+{
+}
+
+bool MemoryLeakGroupSettings::split(const SimpleString& argument, const SimpleString& option, SimpleString& group, SimpleString& value)
+{
+    SimpleString setting = argument.subString(option.size());
+    size_t separator = setting.find(':');
+
+    if (separator == SimpleString::npos) {
+        group = "";
+        value = setting;
+        return !value.isEmpty();
+    }
+
+    group = setting.subString(0, separator);
+    value = setting.subString(separator + 1);
+    return !group.isEmpty() && !value.isEmpty();
+}
+
+bool MemoryLeakGroupSettings::parse(const SimpleString& argument, const SimpleString& option)
+{
+    SimpleString group, value;
+    if (!split(argument, option, group, value) || !isUnsignedNumber(value)) return false;
+
+    add(group, SimpleString::AtoU(value.asCharString()));
+    return true;
+}
+
+void MemoryLeakGroupSettings::add(const SimpleString& group, size_t value)
+{
+    if (group.isEmpty()) {
+        hasDefault_ = true;
+        default_ = value;
+        return;
+    }
+
+    for (size_t i = 0; i < count_; i++) {
+        if (groups_[i] == group) {
+            values_[i] = value;
+            return;
+        }
+    }
+
+    if (count_ == MAX_GROUP_SETTINGS) return;
+    groups_[count_] = group;
+    values_[count_] = value;
+    count_++;
+}
+
+bool MemoryLeakGroupSettings::find(const SimpleString& group, size_t& value) const
+{
+    for (size_t i = 0; i < count_; i++) {
+        if (groups_[i] == group) {
+            value = values_[i];
+            return true;
+        }
+    }
+
+    if (hasDefault_) value = default_;
+    return hasDefault_;
+}
+
+bool MemoryLeakGroupSettings::isEmpty() const
+{
+    return count_ == 0 && !hasDefault_;
+}
+
+AllocationBudget::AllocationBudget(size_t maximumAllocations, const char* file, size_t line)
+    : maximumAllocations_(maximumAllocations), file_(file), line_(line), allocationNumberAtStart_(0), allocations_(0),
+      firstOverBudgetFile_(NULLPTR), firstOverBudgetLine_(0), started_(false),
+      outerWatchedAllocation_(0), outerWatchedAllocationFile_(NULLPTR), outerWatchedAllocationLine_(0)
+{
+}
+
+/* Failing from a destructor can't end the test, so the failure is only added. A test that already failed, and
+ * might be leaving the scope because of it, doesn't get a second failure */
+AllocationBudget::~AllocationBudget()
+{
+    if (!started_) return;
+    finishCounting();
+
+    UtestShell* test = UtestShell::getCurrent();
+    test->countCheck();
+    if (isExceeded() && !test->hasFailed())
+        test->addFailure(FailFailure(test, file_, line_, failureMessage()));
+}
+
+/* A nested budget takes over the watch and gives it back at stop. When the outer budget's first allocation over
+ * its budget falls inside the nested scope, its location is lost */
+void AllocationBudget::start()
+{
+    MemoryLeakDetector* detector = MemoryLeakWarningPlugin::getGlobalDetector();
+    if (!MemoryLeakWarningPlugin::areNewDeleteOverloaded())
+        UtestShell::getCurrent()->fail("Allocation budgets count the allocations of the memory leak detection, but its new and delete overloads are turned off", file_, line_);
+    if (detector->getTier() == mem_leak_tier_off)
+        UtestShell::getCurrent()->fail("Allocation budgets count the allocations of the memory leak detection, but its tier is off", file_, line_);
+
+    started_ = true;
+    outerWatchedAllocation_ = detector->getWatchedAllocation();
+    outerWatchedAllocationFile_ = detector->getWatchedAllocationFile();
+    outerWatchedAllocationLine_ = detector->getWatchedAllocationLine();
 
+    allocationNumberAtStart_ = detector->getCurrentAllocationNumber();
+    allocations_ = 0;
+    detector->watchAllocation(allocationNumberAtStart_ + (unsigned) maximumAllocations_);
+}
+
+void AllocationBudget::finishCounting()
+{
+    MemoryLeakDetector* detector = MemoryLeakWarningPlugin::getGlobalDetector();
+    allocations_ = getAllocations();
+    firstOverBudgetFile_ = detector->getWatchedAllocationFile();
+    firstOverBudgetLine_ = detector->getWatchedAllocationLine();
+    started_ = false;
+    detector->watchAllocation(outerWatchedAllocation_, outerWatchedAllocationFile_, outerWatchedAllocationLine_);
+}
+
+void AllocationBudget::stop()
+{
+    if (!started_) return;
+    finishCounting();
+
+    UtestShell::getCurrent()->countCheck();
+    if (isExceeded())
+        UtestShell::getCurrent()->fail(failureMessage().asCharString(), file_, line_);
+}
+
+SimpleString AllocationBudget::failureMessage() const
+{
+    SimpleString expected = (maximumAllocations_ == 0) ? SimpleString("no allocations") : StringFromFormat("at most %lu allocation(s)", (unsigned long) maximumAllocations_);
+    SimpleString location = (firstOverBudgetFile_ == NULLPTR) ? SimpleString("at an unknown location") :
+            StringFromFormat("at file: %s line: %lu", firstOverBudgetFile_, (unsigned long) firstOverBudgetLine_);
+    return StringFromFormat("Expected %s, but %lu were done. The first allocation over the budget was %s",
+            expected.asCharString(), (unsigned long) allocations_, location.asCharString());
+}
+
+size_t AllocationBudget::getAllocations() const
+{
+    if (!started_) return allocations_;
+    return MemoryLeakWarningPlugin::getGlobalDetector()->getCurrentAllocationNumber() - allocationNumberAtStart_;
+}
+
+bool AllocationBudget::isExceeded() const
+{
+    return allocations_ > maximumAllocations_;
+}
+
+AllocationBudgetScope::AllocationBudgetScope(size_t maximumAllocations, const char* file, size_t line)
+    : AllocationBudget(maximumAllocations, file, line)
+{
+    start();
+}
+
+/* Always false, so the scope after the macro runs as the else branch */
+AllocationBudgetScope::operator bool() const
+{
+    return false;
+}
@@ -127,13 +127,6 @@ void SimpleString::deallocStringBuffer(char* str, size_t size, const char* file,
     getStringAllocator()->free_memory(str, size, file, line);
 }
 
-char* SimpleString::getEmptyString() const
-{
-    char* empty = allocStringBuffer(1, __FILE__, __LINE__);
-    empty[0] = '\0';
-    return empty;
-}
-
 // does not support + or - prefixes
 unsigned SimpleString::AtoU(const char* str)
 {
@@ -203,15 +196,151 @@ char* SimpleString::StrNCpy(char* s1, const char* s2, size_t n)
     return result;
 }
 
-const char* SimpleString::StrStr(const char* s1, const char* s2)
+/*
+ * Two-way string matching (Crochemore and Perrin). The needle is split at its critical factorization once, after that
+ * the search is linear in the length of the haystack and needs no extra memory. findNext() continues after the last
+ * match, so finding all the (overlapping) matches is linear too. Needles of one or two characters are cheaper to find
+ * with a plain scan.
+ */
+class SimpleStringSearch
+{
+public:
+    SimpleStringSearch(const char* needle, size_t needleLength);
+
+    const char* findIn(const char* haystack, size_t haystackLength);
+    const char* findNext();
+
+private:
+    const char* needle_;
+    size_t needleLength_;
+    size_t criticalPosition_;
+    size_t period_;
+    bool periodic_;
+
+    const char* next_;
+    const char* end_;
+    size_t memory_;
+
+    const char* scan();
+    const char* twoWay();
+    size_t maximalSuffix(bool reversed, size_t& period) const;
+};
+
+SimpleStringSearch::SimpleStringSearch(const char* needle, size_t needleLength)
+    : needle_(needle), needleLength_(needleLength), criticalPosition_(0), period_(1), periodic_(false),
+      next_(NULLPTR), end_(NULLPTR), memory_(0)
+{
+    if (needleLength_ <= 2) return;
+
+    size_t period;
+    size_t reversedPeriod;
+    size_t suffix = maximalSuffix(false, period);
+    size_t reversedSuffix = maximalSuffix(true, reversedPeriod);
+    if (reversedSuffix + 1 > suffix + 1) {
+        suffix = reversedSuffix;
+        period = reversedPeriod;
+    }
+    criticalPosition_ = suffix + 1;
+
+    periodic_ = SimpleString::MemCmp(needle_, needle_ + period, criticalPosition_) == 0;
+    if (periodic_)
+        period_ = period;
+    else
+        period_ = ((criticalPosition_ - 1 > needleLength_ - criticalPosition_) ? criticalPosition_ - 1 : needleLength_ - criticalPosition_) + 1;
+}
+
+/* Returns the start of the maximal suffix minus one, wrapping to (size_t)-1 when the suffix is the whole needle */
+size_t SimpleStringSearch::maximalSuffix(bool reversed, size_t& period) const
+{
+    size_t suffix = (size_t) -1;
+    size_t candidate = 0;
+    size_t offset = 1;
+    period = 1;
+
+    while (candidate + offset < needleLength_) {
+        unsigned char a = (unsigned char) needle_[suffix + offset];
+        unsigned char b = (unsigned char) needle_[candidate + offset];
+        if (a == b) {
+            if (offset == period) {
+                candidate += period;
+                offset = 1;
+            }
+            else
+                offset++;
+        }
+        else if ((a > b) != reversed) {
+            candidate += offset;
+            offset = 1;
+            period = candidate - suffix;
+        }
+        else {
+            suffix = candidate++;
+            offset = period = 1;
+        }
+    }
+    return suffix;
+}
+
+const char* SimpleStringSearch::findIn(const char* haystack, size_t haystackLength)
+{
+    next_ = haystack;
+    end_ = haystack + haystackLength;
+    memory_ = 0;
+    return findNext();
+}
+
+const char* SimpleStringSearch::findNext()
+{
+    if (next_ == NULLPTR || (size_t) (end_ - next_) < needleLength_) return NULLPTR;
+    return (needleLength_ <= 2) ? scan() : twoWay();
+}
+
+const char* SimpleStringSearch::scan()
 {
-    if(!*s2) return s1;
-    for (; *s1; s1++)
-        if (StrNCmp(s1, s2, StrLen(s2)) == 0)
-            return s1;
+    const char* last = end_ - needleLength_;
+    for (const char* candidate = next_; candidate <= last; candidate++)
+        if (needleLength_ == 0 || (candidate[0] == needle_[0] && (needleLength_ == 1 || candidate[1] == needle_[1]))) {
+            next_ = (candidate < end_) ? candidate + 1 : NULLPTR;
+            return candidate;
+        }
+    next_ = NULLPTR;
+    return NULLPTR;
+}
+
+const char* SimpleStringSearch::twoWay()
+{
+    const char* last = end_ - needleLength_;
+    for (const char* candidate = next_; candidate <= last;) {
+        size_t i = (criticalPosition_ > memory_) ? criticalPosition_ : memory_;
+        while (i < needleLength_ && needle_[i] == candidate[i])
+            i++;
+        if (i < needleLength_) {
+            candidate += i - criticalPosition_ + 1;
+            memory_ = 0;
+            continue;
+        }
+
+        i = criticalPosition_;
+        while (i > memory_ && needle_[i - 1] == candidate[i - 1])
+            i--;
+
+        const char* match = (i <= memory_) ? candidate : NULLPTR;
+        candidate += period_;
+        memory_ = periodic_ ? needleLength_ - period_ : 0;
+        if (match) {
+            next_ = candidate;
+            return match;
+        }
+    }
+    next_ = NULLPTR;
     return NULLPTR;
 }
 
+const char* SimpleString::StrStr(const char* s1, const char* s2)
+{
+    return SimpleStringSearch(s2, StrLen(s2)).findIn(s1, StrLen(s1));
+}
+
 char SimpleString::ToLower(char ch)
 {
     return isUpper(ch) ? (char)((int)ch + ('a' - 'A')) : ch;
@@ -219,23 +348,45 @@ char SimpleString::ToLower(char ch)
 
 int SimpleString::MemCmp(const void* s1, const void *s2, size_t n)
 {
+    size_t difference = MemFirstDifference(s1, s2, n);
+    if (difference == n) return 0;
+    return ((const unsigned char*) s1)[difference] - ((const unsigned char*) s2)[difference];
+}
+
+/*
+ * Returns the offset of the first byte that differs, or n when the buffers are equal. The buffers are compared in
+ * chunks without an early exit, which compilers turn into vector instructions, and only the chunk that differs is
+ * searched byte by byte.
+ */
+size_t SimpleString::MemFirstDifference(const void* s1, const void *s2, size_t n)
+{
+    enum { chunkSize = 64 };
     const unsigned char* p1 = (const unsigned char*) s1;
     const unsigned char* p2 = (const unsigned char*) s2;
 
-    while (n--)
-        if (*p1 != *p2) {
-            return *p1 - *p2;
-        } else {
-            ++p1;
-            ++p2;
-        }
-    return 0;
+    size_t offset = 0;
+    for (; offset + chunkSize <= n; offset += chunkSize) {
+        unsigned char differentBits = 0;
+        for (size_t i = 0; i < chunkSize; i++)
+            differentBits |= (unsigned char) (p1[offset + i] ^ p2[offset + i]);
+        if (differentBits) break;
+    }
+
+    for (; offset < n; offset++)
+        if (p1[offset] != p2[offset]) return offset;
+    return n;
+}
+
+bool SimpleString::hasInlineBuffer() const
+{
+    return buffer_ == inlineBuffer_;
 }
 
 void SimpleString::deallocateInternalBuffer()
 {
     if (buffer_) {
-        deallocStringBuffer(buffer_, bufferSize_, __FILE__, __LINE__);
+        if (!hasInlineBuffer())
+            deallocStringBuffer(buffer_, bufferSize_, __FILE__, __LINE__);
         buffer_ = NULLPTR;
         bufferSize_ = 0;
     }
@@ -243,26 +394,29 @@ void SimpleString::deallocateInternalBuffer()
 
 void SimpleString::setInternalBufferAsEmptyString()
 {
-    deallocateInternalBuffer();
-
-    bufferSize_ = 1;
-    buffer_ = getEmptyString();
+    setInternalBufferToNewBuffer(1);
 }
 
 void SimpleString::copyBufferToNewInternalBuffer(const char* otherBuffer, size_t bufferSize)
 {
-    deallocateInternalBuffer();
+    setInternalBufferToNewBuffer(bufferSize);
 
-    bufferSize_ = bufferSize;
-    buffer_ = copyToNewBuffer(otherBuffer, bufferSize_);
+    StrNCpy(buffer_, otherBuffer, bufferSize);
+    buffer_[bufferSize-1] = '\0';
 }
 
 void SimpleString::setInternalBufferToNewBuffer(size_t bufferSize)
 {
     deallocateInternalBuffer();
 
-    bufferSize_ = bufferSize;
-    buffer_ = allocStringBuffer(bufferSize_, __FILE__, __LINE__);
+    if (bufferSize <= sizeof(inlineBuffer_)) {
+        bufferSize_ = sizeof(inlineBuffer_);
+        buffer_ = inlineBuffer_;
+    }
+    else {
+        bufferSize_ = bufferSize;
+        buffer_ = allocStringBuffer(bufferSize_, __FILE__, __LINE__);
+    }
     buffer_[0] = '\0';
 }
 
@@ -274,6 +428,26 @@ void SimpleString::setInternalBufferTo(char* buffer, size_t bufferSize)
     buffer_ = buffer;
 }
 
+/* The moved-from string is left empty. An inline buffer can't be taken over, so its characters are copied */
+void SimpleString::takeInternalBufferFrom(SimpleString& other)
+{
+    deallocateInternalBuffer();
+
+    if (other.hasInlineBuffer()) {
+        bufferSize_ = sizeof(inlineBuffer_);
+        buffer_ = inlineBuffer_;
+        StrNCpy(buffer_, other.buffer_, bufferSize_);
+    }
+    else {
+        bufferSize_ = other.bufferSize_;
+        buffer_ = other.buffer_;
+    }
+
+    other.bufferSize_ = sizeof(other.inlineBuffer_);
+    other.buffer_ = other.inlineBuffer_;
+    other.buffer_[0] = '\0';
+}
+
 void SimpleString::copyBufferToNewInternalBuffer(const SimpleString& otherBuffer)
 {
     copyBufferToNewInternalBuffer(otherBuffer.buffer_, otherBuffer.size() + 1);
@@ -325,9 +499,24 @@ SimpleString& SimpleString::operator=(const SimpleString& other)
     return *this;
 }
 
+#if CPPUTEST_HAVE_MOVE_SEMANTICS
+SimpleString::SimpleString(SimpleString&& other)
+    : buffer_(NULLPTR), bufferSize_(0)
+{
+    takeInternalBufferFrom(other);
+}
+
+SimpleString& SimpleString::operator=(SimpleString&& other)
+{
+    if (this != &other)
+        takeInternalBufferFrom(other);
+    return *this;
+}
+#endif
+
 bool SimpleString::contains(const SimpleString& other) const
 {
-    return StrStr(getBuffer(), other.getBuffer()) != NULLPTR;
+    return SimpleStringSearch(other.getBuffer(), other.size()).findIn(getBuffer(), size()) != NULLPTR;
 }
 
 bool SimpleString::containsNoCase(const SimpleString& other) const
@@ -339,7 +528,7 @@ bool SimpleString::startsWith(const SimpleString& other) const
 {
     if (other.size() == 0) return true;
     else if (size() == 0) return false;
-    else return StrStr(getBuffer(), other.getBuffer()) == getBuffer();
+    else return StrNCmp(getBuffer(), other.getBuffer(), other.size()) == 0;
 }
 
 bool SimpleString::endsWith(const SimpleString& other) const
@@ -356,18 +545,11 @@ bool SimpleString::endsWith(const SimpleString& other) const
 
 size_t SimpleString::count(const SimpleString& substr) const
 {
+    SimpleStringSearch search(substr.getBuffer(), substr.size());
+    const char* end = getBuffer() + size();
     size_t num = 0;
-    const char* str = getBuffer();
-    const char* strpart = NULLPTR;
-    if (*str){
-        strpart = StrStr(str, substr.getBuffer());
-    }
-    while (*str && strpart) {
-        str = strpart;
-        str++;
+    for (const char* strpart = search.findIn(getBuffer(), size()); strpart && strpart < end; strpart = search.findNext())
         num++;
-        strpart = StrStr(str, substr.getBuffer());
-    }
     return num;
 }
 
@@ -377,11 +559,12 @@ void SimpleString::split(const SimpleString& delimiter, SimpleStringCollection&
     size_t extraEndToken = (endsWith(delimiter)) ? 0 : 1U;
     col.allocate(num + extraEndToken);
 
+    SimpleStringSearch search(delimiter.getBuffer(), delimiter.size());
     const char* str = getBuffer();
     const char* prev;
     for (size_t i = 0; i < num; ++i) {
         prev = str;
-        str = StrStr(str, delimiter.getBuffer()) + 1;
+        str = ((i == 0) ? search.findIn(str, size()) : search.findNext()) + 1;
         col[i] = SimpleString(prev).subString(0, size_t (str - prev));
     }
     if (extraEndToken) {
@@ -410,7 +593,9 @@ void SimpleString::replace(const char* to, const char* with)
     size_t newsize = len + (withlen * c) - (tolen * c) + 1;
 
     if (newsize > 1) {
-        char* newbuf = allocStringBuffer(newsize, __FILE__, __LINE__);
+        SimpleString result;
+        result.setInternalBufferToNewBuffer(newsize);
+        char* newbuf = result.buffer_;
         for (size_t i = 0, j = 0; i < len;) {
             if (StrNCmp(&getBuffer()[i], to, tolen) == 0) {
                 StrNCpy(&newbuf[j], with, withlen + 1);
@@ -424,7 +609,7 @@ void SimpleString::replace(const char* to, const char* with)
             }
         }
         newbuf[newsize - 1] = '\0';
-        setInternalBufferTo(newbuf, newsize);
+        takeInternalBufferFrom(result);
     }
     else
         setInternalBufferAsEmptyString();
@@ -558,6 +743,15 @@ SimpleString& SimpleString::operator+=(const char* rhs)
     size_t originalSize = this->size();
     size_t additionalStringSize = StrLen(rhs) + 1;
     size_t sizeOfNewString = originalSize + additionalStringSize;
+
+    /* rhs can be (a part of) this string, it then ends where the appended characters start */
+    if (sizeOfNewString <= bufferSize_) {
+        for (size_t i = 0; i < additionalStringSize - 1; i++)
+            buffer_[originalSize + i] = rhs[i];
+        buffer_[sizeOfNewString - 1] = '\0';
+        return *this;
+    }
+
     char* tbuffer = copyToNewBuffer(this->getBuffer(), sizeOfNewString);
     StrNCpy(tbuffer + originalSize, rhs, additionalStringSize);
 
@@ -668,9 +862,72 @@ bool SimpleString::isControlWithShortEscapeSequence(char ch)
     return '\a' <= ch && '\r' >= ch;
 }
 
+/*
+ * The integer conversions write their digits backwards into a buffer on the stack, two decimal digits at a time,
+ * instead of going through PlatformSpecificVSNprintf. The output is the same as the printf formats they replace.
+ */
+#if CPPUTEST_USE_LONG_LONG
+typedef cpputest_ulonglong WidestUnsigned;
+#else
+typedef unsigned long WidestUnsigned;
+#endif
+
+enum { sizeOfDigitsBuffer = sizeof(WidestUnsigned) * CPPUTEST_CHAR_BIT / 3 + 3 };
+
+static const char decimalDigitPairs[] =
+    "0001020304050607080910111213141516171819202122232425262728293031323334353637383940414243444546474849"
+    "5051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+
+static char* writeDecimalDigitsBackwards(char* end, WidestUnsigned value)
+{
+    while (value >= 100) {
+        size_t pair = (size_t) (value % 100) * 2;
+        value /= 100;
+        *--end = decimalDigitPairs[pair + 1];
+        *--end = decimalDigitPairs[pair];
+    }
+    if (value >= 10) {
+        size_t pair = (size_t) value * 2;
+        *--end = decimalDigitPairs[pair + 1];
+        *--end = decimalDigitPairs[pair];
+    }
+    else
+        *--end = (char) ('0' + value);
+    return end;
+}
+
+static SimpleString decimalStringFrom(WidestUnsigned magnitude, bool negative)
+{
+    char buffer[sizeOfDigitsBuffer];
+    char* end = buffer + sizeOfDigitsBuffer - 1;
+    *end = '\0';
+
+    char* start = writeDecimalDigitsBackwards(end, magnitude);
+    if (negative) *--start = '-';
+    return SimpleString(start);
+}
+
+static WidestUnsigned magnitudeOf(long value)
+{
+    return (value < 0) ? 0 - (WidestUnsigned) value : (WidestUnsigned) value;
+}
+
+static SimpleString hexStringFrom(WidestUnsigned value)
+{
+    char buffer[sizeOfDigitsBuffer];
+    char* start = buffer + sizeOfDigitsBuffer - 1;
+    *start = '\0';
+
+    do {
+        *--start = "0123456789abcdef"[value & 0xf];
+        value >>= 4;
+    } while (value);
+    return SimpleString(start);
+}
+
 SimpleString StringFrom(bool value)
 {
-    return SimpleString(StringFromFormat("%s", value ? "true" : "false"));
+    return SimpleString(value ? "true" : "false");
 }
 
 SimpleString StringFrom(const char *value)
@@ -690,12 +947,12 @@ SimpleString PrintableStringFromOrNull(const char * expected)
 
 SimpleString StringFrom(int value)
 {
-    return StringFromFormat("%d", value);
+    return decimalStringFrom(magnitudeOf(value), value < 0);
 }
 
 SimpleString StringFrom(long value)
 {
-    return StringFromFormat("%ld", value);
+    return decimalStringFrom(magnitudeOf(value), value < 0);
 }
 
 SimpleString StringFrom(const void* value)
@@ -710,32 +967,27 @@ SimpleString StringFrom(void (*value)())
 
 SimpleString HexStringFrom(long value)
 {
-    return StringFromFormat("%lx", value);
+    return hexStringFrom((unsigned long) value);
 }
 
 SimpleString HexStringFrom(int value)
 {
-    return StringFromFormat("%x", value);
+    return hexStringFrom((unsigned int) value);
 }
 
 SimpleString HexStringFrom(signed char value)
 {
-    SimpleString result = StringFromFormat("%x", value);
-    if(value < 0) {
-        size_t size = result.size();
-        result = result.subString(size-(CPPUTEST_CHAR_BIT/4));
-    }
-    return result;
+    return hexStringFrom((unsigned char) value);
 }
 
 SimpleString HexStringFrom(unsigned long value)
 {
-    return StringFromFormat("%lx", value);
+    return hexStringFrom(value);
 }
 
 SimpleString HexStringFrom(unsigned int value)
 {
-    return StringFromFormat("%x", value);
+    return hexStringFrom(value);
 }
 
 SimpleString BracketsFormattedHexStringFrom(int value)
@@ -785,22 +1037,22 @@ SimpleString StringFrom(const std::nullptr_t value)
 
 SimpleString StringFrom(cpputest_longlong value)
 {
-    return StringFromFormat("%lld", value);
+    return decimalStringFrom((value < 0) ? 0 - (cpputest_ulonglong) value : (cpputest_ulonglong) value, value < 0);
 }
 
 SimpleString StringFrom(cpputest_ulonglong value)
 {
-    return StringFromFormat("%llu", value);
+    return decimalStringFrom(value, false);
 }
 
 SimpleString HexStringFrom(cpputest_longlong value)
 {
-    return StringFromFormat("%llx", value);
+    return hexStringFrom((cpputest_ulonglong) value);
 }
 
 SimpleString HexStringFrom(cpputest_ulonglong value)
 {
-    return StringFromFormat("%llx", value);
+    return hexStringFrom(value);
 }
 
 SimpleString HexStringFrom(const void* value)
@@ -870,12 +1122,12 @@ SimpleString HexStringFrom(cpputest_ulonglong)
 
 SimpleString HexStringFrom(const void* value)
 {
-    return StringFromFormat("%lx", convertPointerToLongValue(value));
+    return hexStringFrom((unsigned long) convertPointerToLongValue(value));
 }
 
 SimpleString HexStringFrom(void (*value)())
 {
-    return StringFromFormat("%lx", convertFunctionPointerToLongValue(value));
+    return hexStringFrom((unsigned long) convertFunctionPointerToLongValue(value));
 }
 
 SimpleString BracketsFormattedHexStringFrom(cpputest_longlong)
@@ -891,19 +1143,84 @@ SimpleString BracketsFormattedHexStringFrom(cpputest_ulonglong)
 
 #endif  /* CPPUTEST_USE_LONG_LONG */
 
+/*
+ * Formats what "%.*g" prints in fixed notation. The digits are the value scaled by an exact power of ten and rounded
+ * to an integer. That scaling rounds once, so when the value is that close to halfway between two roundings this
+ * gives up and leaves it to PlatformSpecificVSNprintf. It also gives up on exponent notation, which differs between
+ * platforms.
+ */
+static bool formatDoubleInFixedNotation(char* buffer, double value, int precision)
+{
+    static const double powersOfTen[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13,
+                                          1e14, 1e15, 1e16, 1e17, 1e18, 1e19 };
+    const int smallestExponent = -4;
+    const int maxPrecision = (sizeof(WidestUnsigned) >= 8) ? 15 : 9;
+
+    if (precision < 1 || precision > maxPrecision) return false;
+
+    bool negative = value < 0;
+    double magnitude = negative ? -value : value;
+    if (!(magnitude >= 1e-4 && magnitude < powersOfTen[precision])) return false;
+
+    int exponent = precision - 1;
+    while (exponent > smallestExponent && ((exponent >= 0) ? magnitude < powersOfTen[exponent] : magnitude * powersOfTen[-exponent] < 1.0))
+        exponent--;
+
+    double scaled = magnitude * powersOfTen[precision - 1 - exponent];
+    WidestUnsigned digits = (WidestUnsigned) scaled;
+    double fraction = scaled - (double) digits;
+    double uncertainty = scaled * 1e-15;
+    if (fraction > 0.5 - uncertainty && fraction < 0.5 + uncertainty) return false;
+    if (fraction > 0.5) digits++;
+
+    WidestUnsigned smallestDigits = (WidestUnsigned) powersOfTen[precision - 1];
+    if (digits == smallestDigits * 10) {
+        digits = smallestDigits;
+        exponent++;
+    }
+    if (digits < smallestDigits || exponent >= precision) return false;
+
+    char digitsBuffer[sizeOfDigitsBuffer];
+    char* digitsEnd = digitsBuffer + sizeOfDigitsBuffer - 1;
+    const char* significant = writeDecimalDigitsBackwards(digitsEnd, digits);
+    while (digitsEnd[-1] == '0')
+        digitsEnd--;
+
+    if (negative) *buffer++ = '-';
+    if (exponent < 0) {
+        *buffer++ = '0';
+        *buffer++ = '.';
+        for (int zeros = -exponent - 1; zeros > 0; zeros--)
+            *buffer++ = '0';
+    }
+    else {
+        for (int integerDigits = exponent + 1; integerDigits > 0; integerDigits--)
+            *buffer++ = (significant < digitsEnd) ? *significant++ : '0';
+        if (significant < digitsEnd) *buffer++ = '.';
+    }
+    while (significant < digitsEnd)
+        *buffer++ = *significant++;
+    *buffer = '\0';
+    return true;
+}
+
 SimpleString StringFrom(double value, int precision)
 {
+    char buffer[32];
     if (PlatformSpecificIsNan(value))
         return "Nan - Not a number";
     else if (PlatformSpecificIsInf(value))
         return "Inf - Infinity";
+    else if (formatDoubleInFixedNotation(buffer, value, precision))
+        return buffer;
     else
         return StringFromFormat("%.*g", precision, value);
 }
 
 SimpleString StringFrom(char value)
 {
-    return StringFromFormat("%c", value);
+    char buffer[2] = { value, '\0' };
+    return SimpleString(buffer);
 }
 
 SimpleString StringFrom(const SimpleString& value)
@@ -924,7 +1241,7 @@ SimpleString StringFromFormat(const char* format, ...)
 
 SimpleString StringFrom(unsigned int i)
 {
-    return StringFromFormat("%u", i);
+    return decimalStringFrom(i, false);
 }
 
 #if CPPUTEST_USE_STD_CPP_LIB
@@ -940,7 +1257,7 @@ SimpleString StringFrom(const std::string& value)
 
 SimpleString StringFrom(unsigned long i)
 {
-    return StringFromFormat("%lu", i);
+    return decimalStringFrom(i, false);
 }
 
 SimpleString VStringFromFormat(const char* format, va_list args)
@@ -972,14 +1289,14 @@ SimpleString VStringFromFormat(const char* format, va_list args)
 
 SimpleString StringFromBinary(const unsigned char* value, size_t size)
 {
-    SimpleString result;
+    SimpleStringBuilder result;
 
     for (size_t i = 0; i < size; i++) {
-        result += StringFromFormat("%02X ", value[i]);
+        if (i) result.append(" ");
+        result.appendFormatted("%02X", value[i]);
     }
-    result = result.subString(0, result.size() - 1);
 
-    return result;
+    return result.toString();
 }
 
 SimpleString StringFromBinaryOrNull(const unsigned char* value, size_t size)
@@ -1006,27 +1323,27 @@ SimpleString StringFromBinaryWithSizeOrNull(const unsigned char* value, size_t s
 
 SimpleString StringFromMaskedBits(unsigned long value, unsigned long mask, size_t byteCount)
 {
-    SimpleString result;
+    SimpleStringBuilder result;
     size_t bitCount = (byteCount > sizeof(unsigned long)) ? (sizeof(unsigned long) * CPPUTEST_CHAR_BIT) : (byteCount * CPPUTEST_CHAR_BIT);
     const unsigned long msbMask = (((unsigned long) 1) << (bitCount - 1));
 
     for (size_t i = 0; i < bitCount; i++) {
         if (mask & msbMask) {
-            result += (value & msbMask) ? "1" : "0";
+            result.append((value & msbMask) ? "1" : "0");
         }
         else {
-            result += "x";
+            result.append("x");
         }
 
         if (((i % 8) == 7) && (i != (bitCount - 1))) {
-            result += " ";
+            result.append(" ");
         }
 
         value <<= 1;
         mask <<= 1;
     }
 
-    return result;
+    return result.toString();
 }
 
 SimpleString StringFromOrdinalNumber(unsigned int number)
@@ -1080,3 +1397,107 @@ SimpleString& SimpleStringCollection::operator[](size_t index)
 
     return collection_[index];
 }
+
+SimpleStringBuilder::SimpleStringBuilder()
+    : buffer_(NULLPTR), size_(0), capacity_(0)
+{
+}
+
+SimpleStringBuilder::~SimpleStringBuilder()
+{
+    clear();
+}
+
+void SimpleStringBuilder::clear()
+{
+    if (buffer_)
+        SimpleString::deallocStringBuffer(buffer_, capacity_, __FILE__, __LINE__);
+    buffer_ = NULLPTR;
+    size_ = 0;
+    capacity_ = 0;
+}
+
+void SimpleStringBuilder::makeRoomFor(size_t length)
+{
+    size_t needed = size_ + length + 1;
+    if (needed <= capacity_) return;
+
+    size_t newCapacity = (capacity_ == 0) ? 64 : capacity_;
+    while (newCapacity < needed)
+        newCapacity *= 2;
+
+    char* newBuffer = SimpleString::allocStringBuffer(newCapacity, __FILE__, __LINE__);
+    for (size_t i = 0; i < size_; i++)
+        newBuffer[i] = buffer_[i];
+    newBuffer[size_] = '\0';
+
+    if (buffer_)
+        SimpleString::deallocStringBuffer(buffer_, capacity_, __FILE__, __LINE__);
+    buffer_ = newBuffer;
+    capacity_ = newCapacity;
+}
+
+SimpleStringBuilder& SimpleStringBuilder::append(const char* text, size_t length)
+{
+    makeRoomFor(length);
+    for (size_t i = 0; i < length; i++)
+        buffer_[size_ + i] = text[i];
+    size_ += length;
+    buffer_[size_] = '\0';
+    return *this;
+}
+
+SimpleStringBuilder& SimpleStringBuilder::append(const char* text)
+{
+    return append(text, SimpleString::StrLen(text));
+}
+
+SimpleStringBuilder& SimpleStringBuilder::append(const SimpleString& text)
+{
+    return append(text.asCharString(), text.size());
+}
+
+SimpleStringBuilder& SimpleStringBuilder::appendFormatted(const char* format, ...)
+{
+    va_list arguments;
+    va_start(arguments, format);
+    va_list argumentsCopy;
+    va_copy(argumentsCopy, arguments);
+
+    makeRoomFor(0);
+    size_t room = capacity_ - size_;
+    int result = PlatformSpecificVSNprintf(buffer_ + size_, room, format, arguments);
+    if (result >= 0) {
+        size_t length = (size_t) result;
+        if (length >= room) {
+            makeRoomFor(length);
+            PlatformSpecificVSNprintf(buffer_ + size_, length + 1, format, argumentsCopy);
+        }
+        size_ += length;
+    }
+    buffer_[size_] = '\0';
+
+    va_end(argumentsCopy);
+    va_end(arguments);
+    return *this;
+}
+
+size_t SimpleStringBuilder::size() const
+{
+    return size_;
+}
+
+bool SimpleStringBuilder::isEmpty() const
+{
+    return size_ == 0;
+}
+
+const char* SimpleStringBuilder::asCharString() const
+{
+    return (buffer_) ? buffer_ : "";
+}
+
+SimpleString SimpleStringBuilder::toString() const
+{
+    return SimpleString(asCharString());
+}
@@ -27,6 +27,7 @@
 
 #include "CppUTest/TestHarness.h"
 #include "CppUTest/SimpleStringInternalCache.h"
+#include "CppUTest/SimpleMutex.h"
 
 struct SimpleStringMemoryBlock
 {
@@ -39,18 +40,23 @@ struct SimpleStringInternalCacheNode
     size_t size_;
     SimpleStringMemoryBlock* freeMemoryHead_;
     SimpleStringMemoryBlock* usedMemoryHead_;
+    size_t hits_;
+    size_t misses_;
 };
 
 SimpleStringInternalCache::SimpleStringInternalCache()
-    : allocator_(defaultMallocAllocator()), cache_(NULLPTR), nonCachedAllocations_(NULLPTR), hasWarnedAboutDeallocations(false)
+    : allocator_(defaultMallocAllocator()), cache_(NULLPTR), amountOfInternalCacheNodes_(0), cacheIndexForSize_(NULLPTR), largestCachedSize_(0),
+      nonCachedAllocations_(NULLPTR), uncachedAllocations_(0), mutex_(NULLPTR), hasWarnedAboutDeallocations(false)
 {
-    cache_ = createInternalCacheNodes();
+    size_t sizes[] = { 32, 64, 96, 128, 256 };
+    createInternalCacheNodes(sizes, sizeof(sizes) / sizeof(sizes[0]));
 }
 
 SimpleStringInternalCache::~SimpleStringInternalCache()
 {
     allocator_ = defaultMallocAllocator();
-    destroyInternalCacheNode(cache_);
+    destroyInternalCacheNodes();
+    delete mutex_;
 }
 
 void SimpleStringInternalCache::setAllocator(TestMemoryAllocator* allocator)
@@ -58,33 +64,78 @@ void SimpleStringInternalCache::setAllocator(TestMemoryAllocator* allocator)
     allocator_ = allocator;
 }
 
-SimpleStringInternalCacheNode* SimpleStringInternalCache::createInternalCacheNodes()
+void SimpleStringInternalCache::useCacheSizes(size_t sizes[], size_t length)
 {
-    SimpleStringInternalCacheNode* node = (SimpleStringInternalCacheNode*) (void*) allocator_->alloc_memory(sizeof(SimpleStringInternalCacheNode) * amountOfInternalCacheNodes, __FILE__, __LINE__);
+    clearAllIncludingCurrentlyUsedMemory();
+    destroyInternalCacheNodes();
+    createInternalCacheNodes(sizes, length);
+}
+
+void SimpleStringInternalCache::turnOnThreadSafety()
+{
+    if (mutex_ == NULLPTR)
+        mutex_ = new SimpleMutex;
+}
+
+/* The nodes are kept sorted by size. A table with one entry per sizeGranularity bytes finds the node for a size */
+void SimpleStringInternalCache::createInternalCacheNodes(size_t sizes[], size_t length)
+{
+    amountOfInternalCacheNodes_ = 0;
+    largestCachedSize_ = 0;
+    if (length == 0) return;
 
-    for (int i = 0; i < amountOfInternalCacheNodes; i++) {
-        node[i].freeMemoryHead_ = NULLPTR;
-        node[i].usedMemoryHead_ = NULLPTR;
+    cache_ = (SimpleStringInternalCacheNode*) (void*) defaultMallocAllocator()->alloc_memory(sizeof(SimpleStringInternalCacheNode) * length, __FILE__, __LINE__);
+
+    for (size_t i = 0; i < length; i++) {
+        size_t size = (sizes[i] == 0) ? (size_t) sizeGranularity : (sizes[i] + sizeGranularity - 1) / sizeGranularity * sizeGranularity;
+
+        size_t position = amountOfInternalCacheNodes_;
+        while (position > 0 && cache_[position - 1].size_ > size)
+            position--;
+        if (position > 0 && cache_[position - 1].size_ == size)
+            continue;
+
+        for (size_t j = amountOfInternalCacheNodes_; j > position; j--)
+            cache_[j] = cache_[j - 1];
+        cache_[position].size_ = size;
+        cache_[position].freeMemoryHead_ = NULLPTR;
+        cache_[position].usedMemoryHead_ = NULLPTR;
+        cache_[position].hits_ = 0;
+        cache_[position].misses_ = 0;
+        amountOfInternalCacheNodes_++;
     }
-    node[0].size_ = 32;
-    node[1].size_ = 64;
-    node[2].size_ = 96;
-    node[3].size_ = 128;
-    node[4].size_ = 256;
-    return node;
+    largestCachedSize_ = cache_[amountOfInternalCacheNodes_ - 1].size_;
+
+    size_t slots = largestCachedSize_ / sizeGranularity + 1;
+    cacheIndexForSize_ = (size_t*) (void*) defaultMallocAllocator()->alloc_memory(sizeof(size_t) * slots, __FILE__, __LINE__);
+    size_t index = 0;
+    for (size_t slot = 0; slot < slots; slot++) {
+        while (cache_[index].size_ < slot * sizeGranularity)
+            index++;
+        cacheIndexForSize_[slot] = index;
+    }
+}
+
+void SimpleStringInternalCache::destroyInternalCacheNodes()
+{
+    if (cache_ == NULLPTR) return;
+
+    defaultMallocAllocator()->free_memory((char*) cacheIndexForSize_, sizeof(size_t) * (largestCachedSize_ / sizeGranularity + 1), __FILE__, __LINE__);
+    defaultMallocAllocator()->free_memory((char*) cache_, sizeof(SimpleStringInternalCacheNode) * amountOfInternalCacheNodes_, __FILE__, __LINE__);
+    cache_ = NULLPTR;
+    cacheIndexForSize_ = NULLPTR;
+    amountOfInternalCacheNodes_ = 0;
+    largestCachedSize_ = 0;
 }
 
 bool SimpleStringInternalCache::isCached(size_t size)
 {
-    return size <= 256;
+    return amountOfInternalCacheNodes_ != 0 && size <= largestCachedSize_;
 }
 
 size_t SimpleStringInternalCache::getIndexForCache(size_t size)
 {
-    for (size_t i = 0; i < amountOfInternalCacheNodes; i++)
-      if (size <= cache_[i].size_)
-        return i;
-    return 0; // LCOV_EXCL_LINE
+    return cacheIndexForSize_[(size + sizeGranularity - 1) / sizeGranularity];
 }
 
 SimpleStringInternalCacheNode* SimpleStringInternalCache::getCacheNodeFromSize(size_t size)
@@ -93,11 +144,6 @@ SimpleStringInternalCacheNode* SimpleStringInternalCache::getCacheNodeFromSize(s
     return &cache_[index];
 }
 
-void SimpleStringInternalCache::destroyInternalCacheNode(SimpleStringInternalCacheNode * node)
-{
-    allocator_->free_memory((char*) node, sizeof(SimpleStringInternalCacheNode) * amountOfInternalCacheNodes, __FILE__, __LINE__);
-}
-
 SimpleStringMemoryBlock* SimpleStringInternalCache::createSimpleStringMemoryBlock(size_t size, SimpleStringMemoryBlock* next)
 {
     SimpleStringMemoryBlock* block = (SimpleStringMemoryBlock*) (void*) allocator_->alloc_memory(sizeof(SimpleStringMemoryBlock) , __FILE__, __LINE__);
@@ -130,7 +176,7 @@ SimpleStringMemoryBlock* SimpleStringInternalCache::addToSimpleStringMemoryBlock
 
 bool SimpleStringInternalCache::hasFreeBlocksOfSize(size_t size)
 {
-    return getCacheNodeFromSize(size)->freeMemoryHead_ != NULLPTR;
+    return isCached(size) && getCacheNodeFromSize(size)->freeMemoryHead_ != NULLPTR;
 }
 
 SimpleStringMemoryBlock* SimpleStringInternalCache::reserveCachedBlockFrom(SimpleStringInternalCacheNode* node)
@@ -202,19 +248,42 @@ void SimpleStringInternalCache::releaseNonCachedMemory(char* memory, size_t size
 }
 
 char* SimpleStringInternalCache::alloc(size_t size)
+{
+    if (mutex_) {
+        ScopedMutexLock lock(mutex_);
+        return allocUnlocked(size);
+    }
+    return allocUnlocked(size);
+}
+
+void SimpleStringInternalCache::dealloc(char* memory, size_t size)
+{
+    if (mutex_) {
+        ScopedMutexLock lock(mutex_);
+        deallocUnlocked(memory, size);
+        return;
+    }
+    deallocUnlocked(memory, size);
+}
+
+char* SimpleStringInternalCache::allocUnlocked(size_t size)
 {
     if (isCached(size)) {
-        if (hasFreeBlocksOfSize(size))
-            return reserveCachedBlockFrom(getCacheNodeFromSize(size))->memory_;
-        else
-            return allocateNewCacheBlockFrom(getCacheNodeFromSize(size))->memory_;
+        SimpleStringInternalCacheNode* node = getCacheNodeFromSize(size);
+        if (node->freeMemoryHead_) {
+            node->hits_++;
+            return reserveCachedBlockFrom(node)->memory_;
+        }
+        node->misses_++;
+        return allocateNewCacheBlockFrom(node)->memory_;
     }
 
+    uncachedAllocations_++;
     nonCachedAllocations_ = createSimpleStringMemoryBlock(size, nonCachedAllocations_);
     return nonCachedAllocations_->memory_;
 }
 
-void SimpleStringInternalCache::dealloc(char* memory, size_t size)
+void SimpleStringInternalCache::deallocUnlocked(char* memory, size_t size)
 {
     if (isCached(size)) {
         size_t index = getIndexForCache(size);
@@ -227,7 +296,7 @@ void SimpleStringInternalCache::dealloc(char* memory, size_t size)
 
 void SimpleStringInternalCache::clearCache()
 {
-    for (size_t i = 0; i < amountOfInternalCacheNodes; i++) {
+    for (size_t i = 0; i < amountOfInternalCacheNodes_; i++) {
         destroySimpleStringMemoryBlockList(cache_[i].freeMemoryHead_, cache_[i].size_);
         cache_[i].freeMemoryHead_ = NULLPTR;
     }
@@ -235,7 +304,7 @@ void SimpleStringInternalCache::clearCache()
 
 void SimpleStringInternalCache::clearAllIncludingCurrentlyUsedMemory()
 {
-    for (size_t i = 0; i < amountOfInternalCacheNodes; i++) {
+    for (size_t i = 0; i < amountOfInternalCacheNodes_; i++) {
         destroySimpleStringMemoryBlockList(cache_[i].freeMemoryHead_, cache_[i].size_);
         destroySimpleStringMemoryBlockList(cache_[i].usedMemoryHead_, cache_[i].size_);
         cache_[i].freeMemoryHead_ = NULLPTR;
@@ -246,6 +315,54 @@ void SimpleStringInternalCache::clearAllIncludingCurrentlyUsedMemory()
     nonCachedAllocations_ = NULLPTR;
 }
 
+size_t SimpleStringInternalCache::cacheHits() const
+{
+    size_t hits = 0;
+    for (size_t i = 0; i < amountOfInternalCacheNodes_; i++)
+        hits += cache_[i].hits_;
+    return hits;
+}
+
+size_t SimpleStringInternalCache::cacheMisses() const
+{
+    size_t misses = 0;
+    for (size_t i = 0; i < amountOfInternalCacheNodes_; i++)
+        misses += cache_[i].misses_;
+    return misses;
+}
+
+size_t SimpleStringInternalCache::uncachedAllocations() const
+{
+    return uncachedAllocations_;
+}
+
+#define SIMPLE_STRING_CACHE_ROW_FORMAT "%s               %5d            %5d\n"
+
+SimpleString SimpleStringInternalCache::report() const
+{
+    /* Totals are summed from the rows as printed, as building the report may allocate from this cache */
+    size_t hits = 0;
+    size_t allocations = 0;
+
+    SimpleStringBuilder cacheReport;
+    cacheReport.append("CppUTest SimpleString cache report:\n");
+    cacheReport.append("Cache size          # hits           # misses\n");
+    for (size_t i = 0; i < amountOfInternalCacheNodes_; i++) {
+        size_t nodeHits = cache_[i].hits_;
+        size_t nodeMisses = cache_[i].misses_;
+        hits += nodeHits;
+        allocations += nodeHits + nodeMisses;
+        cacheReport.appendFormatted(SIMPLE_STRING_CACHE_ROW_FORMAT, StringFromFormat("%5d", (int) cache_[i].size_).asCharString(), (int) nodeHits, (int) nodeMisses);
+    }
+    size_t uncached = uncachedAllocations_;
+    allocations += uncached;
+    cacheReport.appendFormatted(SIMPLE_STRING_CACHE_ROW_FORMAT, "other", 0, (int) uncached);
+
+    size_t hitPercentage = (allocations == 0) ? 0 : hits * 100 / allocations;
+    cacheReport.appendFormatted("Hit rate %d%% of %d allocations\n", (int) hitPercentage, (int) allocations);
+    return cacheReport.toString();
+}
+
 GlobalSimpleStringCache::GlobalSimpleStringCache()
 {
     allocator_ = new SimpleStringCacheAllocator(cache_, SimpleString::getStringAllocator());
@@ -264,6 +381,11 @@ TestMemoryAllocator* GlobalSimpleStringCache::getAllocator()
     return allocator_;
 }
 
+SimpleStringInternalCache& GlobalSimpleStringCache::getCache()
+{
+    return cache_;
+}
+
 SimpleStringCacheAllocator::SimpleStringCacheAllocator(SimpleStringInternalCache& cache, TestMemoryAllocator* origAllocator)
     : cache_(cache), originalAllocator_(origAllocator)
 {
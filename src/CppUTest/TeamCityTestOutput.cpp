@@ -12,11 +12,11 @@ TeamCityTestOutput::~TeamCityTestOutput()
 void TeamCityTestOutput::printCurrentTestStarted(const UtestShell& test)
 {
     print("##teamcity[testStarted name='");
-    printEscaped(test.getName().asCharString());
+    printEscaped(test.getNameAsCharString());
     print("']\n");
     if (!test.willRun()) {
         print("##teamcity[testIgnored name='");
-        printEscaped(test.getName().asCharString());
+        printEscaped(test.getNameAsCharString());
         print("']\n");
     }
     currtest_ = &test;
@@ -28,7 +28,7 @@ void TeamCityTestOutput::printCurrentTestEnded(const TestResult& res)
         return;
 
     print("##teamcity[testFinished name='");
-    printEscaped(currtest_->getName().asCharString());
+    printEscaped(currtest_->getNameAsCharString());
     print("' duration='");
     print(res.getCurrentTestTotalExecutionTime());
     print("']\n");
@@ -36,7 +36,7 @@ void TeamCityTestOutput::printCurrentTestEnded(const TestResult& res)
 
 void TeamCityTestOutput::printCurrentGroupStarted(const UtestShell& test)
 {
-    currGroup_ = test.getGroup();
+    currGroup_ = test.getGroupAsCharString();
     print("##teamcity[testSuiteStarted name='");
     printEscaped(currGroup_.asCharString());
     print("']\n");
@@ -148,6 +148,254 @@ SimpleString TestFailure::createUserText(const SimpleString& text)
     return userMessage;
 }
 
+/*
+ * Strings longer than this are not shown in full. The failure shows a window around the first difference
+ * and a line diff of the lines that differ, which only ever looks at a bounded number of lines.
+ */
+static const size_t longStringFailureLength = 256;
+static const size_t longStringFailureWindowSize = 64;
+static const size_t longStringFailureContextLines = 2;
+static const size_t longStringFailureMaxDiffLines = 32;
+static const size_t longStringFailureMaxLineWidth = 100;
+
+struct StringFailureLine
+{
+    const char* start;
+    size_t length;
+};
+
+static size_t splitIntoLines(const char*& begin, const char* end, StringFailureLine* lines, size_t maxLines)
+{
+    size_t count = 0;
+    while (begin < end && count < maxLines) {
+        const char* lineEnd = begin;
+        while (lineEnd < end && *lineEnd != '\n') lineEnd++;
+        lines[count].start = begin;
+        lines[count].length = (size_t) (lineEnd - begin);
+        count++;
+        begin = (lineEnd < end) ? lineEnd + 1 : end;
+    }
+    return count;
+}
+
+static bool linesAreEqual(const StringFailureLine& first, const StringFailureLine& second)
+{
+    return first.length == second.length && SimpleString::MemCmp(first.start, second.start, first.length) == 0;
+}
+
+static SimpleString printableStringFrom(const char* value, size_t length)
+{
+    SimpleStringBuilder builder;
+    builder.append(value, length);
+    return builder.toString().printable();
+}
+
+struct StringFailureDiffLine
+{
+    char marker;
+    size_t lineNumber;
+    StringFailureLine line;
+};
+
+static const size_t longStringFailureMaxDiffOutputLines = 2 * longStringFailureContextLines + 2 * longStringFailureMaxDiffLines;
+
+static void addDiffLines(StringFailureDiffLine* diff, size_t& diffCount, char marker, size_t firstLineNumber, const StringFailureLine* lines, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        diff[diffCount].marker = marker;
+        diff[diffCount].lineNumber = firstLineNumber + i;
+        diff[diffCount].line = lines[i];
+        diffCount++;
+    }
+}
+
+static void addLineDifference(StringFailureDiffLine* diff, size_t& diffCount, const StringFailureLine* expected, size_t expectedCount,
+                              const StringFailureLine* actual, size_t actualCount, size_t firstLineNumber)
+{
+    unsigned char commonLines[longStringFailureMaxDiffLines + 1][longStringFailureMaxDiffLines + 1];
+    for (size_t i = expectedCount + 1; i-- > 0;) {
+        for (size_t j = actualCount + 1; j-- > 0;) {
+            if (i == expectedCount || j == actualCount)
+                commonLines[i][j] = 0;
+            else if (linesAreEqual(expected[i], actual[j]))
+                commonLines[i][j] = (unsigned char) (commonLines[i + 1][j + 1] + 1);
+            else
+                commonLines[i][j] = (commonLines[i + 1][j] > commonLines[i][j + 1]) ? commonLines[i + 1][j] : commonLines[i][j + 1];
+        }
+    }
+
+    size_t i = 0;
+    size_t j = 0;
+    while (i < expectedCount || j < actualCount) {
+        if (i < expectedCount && j < actualCount && linesAreEqual(expected[i], actual[j])) {
+            addDiffLines(diff, diffCount, ' ', firstLineNumber + i, expected + i, 1);
+            i++;
+            j++;
+        }
+        else if (i < expectedCount && (j == actualCount || commonLines[i + 1][j] >= commonLines[i][j + 1])) {
+            addDiffLines(diff, diffCount, '-', firstLineNumber + i, expected + i, 1);
+            i++;
+        }
+        else {
+            addDiffLines(diff, diffCount, '+', firstLineNumber + j, actual + j, 1);
+            j++;
+        }
+    }
+}
+
+static bool isNearADifferentLine(const StringFailureDiffLine* diff, size_t diffCount, size_t index)
+{
+    size_t first = (index > longStringFailureContextLines) ? index - longStringFailureContextLines : 0;
+    size_t last = index + longStringFailureContextLines;
+    for (size_t i = first; i <= last && i < diffCount; i++)
+        if (diff[i].marker != ' ') return true;
+    return false;
+}
+
+static SimpleString printableDiffLine(const StringFailureDiffLine& diffLine)
+{
+    size_t length = (diffLine.line.length > longStringFailureMaxLineWidth) ? longStringFailureMaxLineWidth : diffLine.line.length;
+    SimpleString result = StringFromFormat("\n\t%c %lu | ", diffLine.marker, (unsigned long) diffLine.lineNumber);
+    result += printableStringFrom(diffLine.line.start, length);
+    if (length < diffLine.line.length) result += "...";
+    return result;
+}
+
+static SimpleString longStringWindow(const char* value, size_t length, size_t windowStart)
+{
+    size_t windowSize = length - windowStart;
+    if (windowSize > longStringFailureWindowSize) windowSize = longStringFailureWindowSize;
+
+    SimpleString window = printableStringFrom(value + windowStart, windowSize);
+    if (windowStart > 0) window = SimpleString("...") + window;
+    if (windowStart + windowSize < length) window += "...";
+    return window;
+}
+
+static bool isLineStart(const char* value, size_t regionStart, size_t position)
+{
+    return position == regionStart || value[position - 1] == '\n';
+}
+
+static bool containsNewLine(const char* value)
+{
+    for (; *value; value++)
+        if (*value == '\n') return true;
+    return false;
+}
+
+static SimpleString longStringLinesString(const char* expected, size_t expectedLength, const char* actual, size_t actualLength, size_t failStart)
+{
+    size_t regionStart = failStart;
+    while (regionStart > 0 && expected[regionStart - 1] != '\n') regionStart--;
+
+    size_t commonSuffix = 0;
+    size_t maxCommonSuffix = ((expectedLength < actualLength) ? expectedLength : actualLength) - failStart;
+    while (commonSuffix < maxCommonSuffix && expected[expectedLength - commonSuffix - 1] == actual[actualLength - commonSuffix - 1])
+        commonSuffix++;
+
+    size_t expectedEnd = expectedLength - commonSuffix;
+    size_t actualEnd = actualLength - commonSuffix;
+    while (expectedEnd < expectedLength && !(isLineStart(expected, regionStart, expectedEnd) && isLineStart(actual, regionStart, actualEnd))) {
+        expectedEnd++;
+        actualEnd++;
+    }
+
+    size_t firstLineNumber = 1;
+    for (size_t i = 0; i < regionStart; i++)
+        if (expected[i] == '\n') firstLineNumber++;
+
+    size_t contextStart = regionStart;
+    for (size_t contextLines = 0; contextStart > 0 && contextLines < longStringFailureContextLines; contextLines++) {
+        contextStart--;
+        while (contextStart > 0 && expected[contextStart - 1] != '\n') contextStart--;
+    }
+
+    StringFailureLine contextBefore[longStringFailureContextLines];
+    const char* contextBeforeBegin = expected + contextStart;
+    size_t contextBeforeCount = splitIntoLines(contextBeforeBegin, expected + regionStart, contextBefore, longStringFailureContextLines);
+
+    StringFailureLine expectedLines[longStringFailureMaxDiffLines];
+    const char* expectedRest = expected + regionStart;
+    size_t expectedCount = splitIntoLines(expectedRest, expected + expectedEnd, expectedLines, longStringFailureMaxDiffLines);
+
+    StringFailureLine actualLines[longStringFailureMaxDiffLines];
+    const char* actualRest = actual + regionStart;
+    size_t actualCount = splitIntoLines(actualRest, actual + actualEnd, actualLines, longStringFailureMaxDiffLines);
+
+    bool isCutOff = expectedRest < expected + expectedEnd || actualRest < actual + actualEnd;
+
+    StringFailureDiffLine diff[longStringFailureMaxDiffOutputLines];
+    size_t diffCount = 0;
+    addDiffLines(diff, diffCount, ' ', firstLineNumber - contextBeforeCount, contextBefore, contextBeforeCount);
+    addLineDifference(diff, diffCount, expectedLines, expectedCount, actualLines, actualCount, firstLineNumber);
+    if (!isCutOff) {
+        StringFailureLine contextAfter[longStringFailureContextLines];
+        const char* contextAfterBegin = expected + expectedEnd;
+        size_t contextAfterCount = splitIntoLines(contextAfterBegin, expected + expectedLength, contextAfter, longStringFailureContextLines);
+        addDiffLines(diff, diffCount, ' ', firstLineNumber + expectedCount, contextAfter, contextAfterCount);
+    }
+
+    SimpleString result = StringFromFormat("\n\tdifference starts in line %lu, different lines are marked with - (expected) and + (actual):", (unsigned long) firstLineNumber);
+    bool skippedLines = false;
+    for (size_t i = 0; i < diffCount; i++) {
+        if (isNearADifferentLine(diff, diffCount, i)) {
+            if (skippedLines) result += "\n\t...";
+            result += printableDiffLine(diff[i]);
+            skippedLines = false;
+        }
+        else {
+            skippedLines = true;
+        }
+    }
+    if (isCutOff) result += "\n\t...";
+    return result;
+}
+
+bool TestFailure::isLongString(const char* value)
+{
+    return value != NULLPTR && SimpleString::StrLen(value) > longStringFailureLength;
+}
+
+SimpleString TestFailure::createStringDifferenceString(const char* expected, const char* actual)
+{
+    if (expected == NULLPTR || actual == NULLPTR)
+        return createButWasString(PrintableStringFromOrNull(expected), PrintableStringFromOrNull(actual));
+
+    size_t failStart;
+    for (failStart = 0; actual[failStart] == expected[failStart] && expected[failStart] != '\0'; failStart++)
+        ;
+
+    SimpleString printableExpected;
+    SimpleString printableActual;
+    SimpleString lines;
+    if (isLongString(expected) || isLongString(actual)) {
+        size_t expectedLength = SimpleString::StrLen(expected);
+        size_t actualLength = SimpleString::StrLen(actual);
+        size_t windowStart = (failStart > longStringFailureWindowSize / 2) ? failStart - longStringFailureWindowSize / 2 : 0;
+        printableExpected = longStringWindow(expected, expectedLength, windowStart);
+        printableActual = longStringWindow(actual, actualLength, windowStart);
+        if (containsNewLine(expected) || containsNewLine(actual))
+            lines = longStringLinesString(expected, expectedLength, actual, actualLength, failStart);
+        lines += StringFromFormat("\n\texpected has %lu characters, actual has %lu", (unsigned long) expectedLength, (unsigned long) actualLength);
+    }
+    else {
+        printableExpected = PrintableStringFromOrNull(expected);
+        printableActual = PrintableStringFromOrNull(actual);
+    }
+
+    size_t failStartPrintable;
+    for (failStartPrintable = 0;
+         printableActual.at(failStartPrintable) == printableExpected.at(failStartPrintable) && printableActual.at(failStartPrintable) != '\0';
+         failStartPrintable++)
+        ;
+
+    SimpleString result = createButWasString(printableExpected, printableActual);
+    result += createDifferenceAtPosString(printableActual, failStartPrintable, failStart);
+    result += lines;
+    return result;
+}
+
 EqualsFailure::EqualsFailure(UtestShell* test, const char* fileName, size_t lineNumber, const char* expected, const char* actual, const SimpleString& text) :
     TestFailure(test, fileName, lineNumber)
 {
@@ -182,19 +430,7 @@ CheckEqualFailure::CheckEqualFailure(UtestShell* test, const char* fileName, siz
 : TestFailure(test, fileName, lineNumber)
 {
     message_ = createUserText(text);
-
-    SimpleString printableExpected = PrintableStringFromOrNull(expected.asCharString());
-    SimpleString printableActual = PrintableStringFromOrNull(actual.asCharString());
-
-    message_ += createButWasString(printableExpected, printableActual);
-
-    size_t failStart;
-    for (failStart = 0; actual.at(failStart) == expected.at(failStart); failStart++)
-        ;
-    size_t failStartPrintable;
-    for (failStartPrintable = 0; printableActual.at(failStartPrintable) == printableExpected.at(failStartPrintable); failStartPrintable++)
-        ;
-    message_ += createDifferenceAtPosString(printableActual, failStartPrintable, failStart);
+    message_ += createStringDifferenceString(expected.asCharString(), actual.asCharString());
 }
 
 ComparisonFailure::ComparisonFailure(UtestShell *test, const char *fileName, size_t lineNumber, const SimpleString& checkString, const SimpleString &comparisonString, const SimpleString &text)
@@ -311,21 +547,7 @@ StringEqualFailure::StringEqualFailure(UtestShell* test, const char* fileName, s
 : TestFailure(test, fileName, lineNumber)
 {
     message_ = createUserText(text);
-
-    SimpleString printableExpected = PrintableStringFromOrNull(expected);
-    SimpleString printableActual = PrintableStringFromOrNull(actual);
-
-    message_ += createButWasString(printableExpected, printableActual);
-    if((expected) && (actual))
-    {
-        size_t failStart;
-        for (failStart = 0; actual[failStart] == expected[failStart]; failStart++)
-            ;
-        size_t failStartPrintable;
-        for (failStartPrintable = 0; printableActual.at(failStartPrintable) == printableExpected.at(failStartPrintable); failStartPrintable++)
-            ;
-        message_ += createDifferenceAtPosString(printableActual, failStartPrintable, failStart);
-    }
+    message_ += createStringDifferenceString(expected, actual);
 }
 
 StringEqualNoCaseFailure::StringEqualNoCaseFailure(UtestShell* test, const char* fileName, size_t lineNumber, const char* expected, const char* actual, const SimpleString& text)
@@ -351,24 +573,120 @@ StringEqualNoCaseFailure::StringEqualNoCaseFailure(UtestShell* test, const char*
     }
 }
 
+/* Longer buffers only show this many bytes around the first difference */
+static const size_t binaryEqualFailureWindowSize = 32;
+
+static SimpleString binaryWindowOrNull(const unsigned char* value, size_t size, size_t windowStart, size_t windowSize)
+{
+    if (value == NULLPTR) return "(null)";
+
+    SimpleString window = StringFromBinary(value + windowStart, windowSize);
+    if (windowStart > 0) window = SimpleString("...") + window;
+    if (windowStart + windowSize < size) window += "...";
+    return window;
+}
+
+static size_t countDifferentBytes(const unsigned char* expected, const unsigned char* actual, size_t size, size_t failStart)
+{
+    size_t count = 0;
+    for (size_t position = failStart; position < size; count++) {
+        position++;
+        position += SimpleString::MemFirstDifference(expected + position, actual + position, size - position);
+    }
+    return count;
+}
+
 BinaryEqualFailure::BinaryEqualFailure(UtestShell* test, const char* fileName, size_t lineNumber, const unsigned char* expected,
                                        const unsigned char* actual, size_t size, const SimpleString& text)
 : TestFailure(test, fileName, lineNumber)
 {
     message_ = createUserText(text);
 
-    SimpleString actualHex = StringFromBinaryOrNull(actual, size);
+    size_t failStart = ((expected) && (actual)) ? SimpleString::MemFirstDifference(expected, actual, size) : 0;
+    size_t windowStart = 0;
+    size_t windowSize = size;
+    if (size > binaryEqualFailureWindowSize) {
+        windowSize = binaryEqualFailureWindowSize;
+        windowStart = (failStart > windowSize / 2) ? failStart - windowSize / 2 : 0;
+        if (windowStart + windowSize > size) windowStart = size - windowSize;
+    }
+
+    SimpleString actualHex = binaryWindowOrNull(actual, size, windowStart, windowSize);
 
-	message_ += createButWasString(StringFromBinaryOrNull(expected, size), actualHex);
+	message_ += createButWasString(binaryWindowOrNull(expected, size, windowStart, windowSize), actualHex);
 	if ((expected) && (actual))
 	{
-		size_t failStart;
-		for (failStart = 0; actual[failStart] == expected[failStart]; failStart++)
-			;
-		message_ += createDifferenceAtPosString(actualHex, (failStart * 3 + 1), failStart);
+		size_t ellipsisLength = (windowStart > 0) ? 3 : 0;
+		message_ += createDifferenceAtPosString(actualHex, ellipsisLength + (failStart - windowStart) * 3 + 1, failStart);
+		if (size > binaryEqualFailureWindowSize)
+			message_ += StringFromFormat("\n\t%lu of %lu bytes differ", (unsigned long) countDifferentBytes(expected, actual, size, failStart), (unsigned long) size);
 	}
 }
 
+FileEqualFailure::FileEqualFailure(UtestShell* test, const char* fileName, size_t lineNumber, const char* goldenFileName, const char* problem, const SimpleString& text)
+: TestFailure(test, fileName, lineNumber)
+{
+    message_ = createUserText(text);
+
+    message_ += StringFromFormat("golden file <%s> %s", goldenFileName, problem);
+}
+
+FileEqualFailure::FileEqualFailure(UtestShell* test, const char* fileName, size_t lineNumber, const char* goldenFileName, const unsigned char* golden, size_t goldenSize,
+                                   const unsigned char* actual, size_t actualSize, size_t failStart, const SimpleString& text)
+: TestFailure(test, fileName, lineNumber)
+{
+    message_ = createUserText(text);
+
+    size_t windowStart = (failStart > binaryEqualFailureWindowSize / 2) ? failStart - binaryEqualFailureWindowSize / 2 : 0;
+    size_t goldenWindowSize = (goldenSize - windowStart < binaryEqualFailureWindowSize) ? goldenSize - windowStart : binaryEqualFailureWindowSize;
+    size_t actualWindowSize = (actualSize - windowStart < binaryEqualFailureWindowSize) ? actualSize - windowStart : binaryEqualFailureWindowSize;
+    SimpleString goldenHex = (goldenSize > 0) ? binaryWindowOrNull(golden, goldenSize, windowStart, goldenWindowSize) : "";
+    SimpleString actualHex = (actualSize > 0) ? binaryWindowOrNull(actual, actualSize, windowStart, actualWindowSize) : "";
+    size_t ellipsisLength = (windowStart > 0) ? 3 : 0;
+
+    message_ += StringFromFormat("golden file <%s> differs at offset %lu, it has %lu bytes and the actual contents have %lu\n\t",
+                                 goldenFileName, (unsigned long) failStart, (unsigned long) goldenSize, (unsigned long) actualSize);
+    message_ += createButWasString(goldenHex, actualHex);
+    message_ += createDifferenceAtPosString(actualHex, ellipsisLength + (failStart - windowStart) * 3 + 1, failStart);
+}
+
+/* The failure shows a few elements before and after the first difference */
+static const size_t arrayEqualFailureElementsBefore = 2;
+static const size_t arrayEqualFailureElementsAfter = 2;
+
+ArrayEqualFailure::ArrayEqualFailure(UtestShell* test, const char* fileName, size_t lineNumber, size_t failedIndex, size_t count,
+                                     const SimpleString& expectedWindow, const SimpleString& actualWindow, const SimpleString& text)
+: TestFailure(test, fileName, lineNumber)
+{
+    message_ = createUserText(text);
+
+    size_t start = windowStart(failedIndex);
+    size_t end = windowEnd(failedIndex, count);
+    SimpleString before = (start > 0) ? "..." : "";
+    SimpleString after = (end < count) ? "..." : "";
+
+    message_ += createButWasString(before + expectedWindow + after, before + actualWindow + after);
+    message_ += StringFromFormat("\n\tdifference at index %lu, showing elements %lu to %lu of %lu",
+                                 (unsigned long) failedIndex, (unsigned long) start, (unsigned long) (end - 1), (unsigned long) count);
+}
+
+size_t ArrayEqualFailure::windowStart(size_t failedIndex)
+{
+    return (failedIndex > arrayEqualFailureElementsBefore) ? failedIndex - arrayEqualFailureElementsBefore : 0;
+}
+
+size_t ArrayEqualFailure::windowEnd(size_t failedIndex, size_t count)
+{
+    size_t end = failedIndex + arrayEqualFailureElementsAfter + 1;
+    return (end < count) ? end : count;
+}
+
+void ArrayEqualFailure::addToWindow(SimpleString& window, const SimpleString& element)
+{
+    if (!window.isEmpty()) window += ", ";
+    window += element;
+}
+
 BitsEqualFailure::BitsEqualFailure(UtestShell* test, const char* fileName, size_t lineNumber, unsigned long expected, unsigned long actual,
                                    unsigned long mask, size_t byteCount, const SimpleString& text)
 : TestFailure(test, fileName, lineNumber)
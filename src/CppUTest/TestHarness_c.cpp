@@ -163,26 +163,31 @@ void cpputest_malloc_set_out_of_memory_countdown(int count)
 
 void* cpputest_malloc(size_t size)
 {
+    MemoryLeakAllocationCaller caller(MemoryLeakWarningPlugin::getGlobalDetectorIfCreated(), CPPUTEST_RETURN_ADDRESS());
     return cpputest_malloc_location(size, "<unknown>", 0);
 }
 
 char* cpputest_strdup(const char* str)
 {
+    MemoryLeakAllocationCaller caller(MemoryLeakWarningPlugin::getGlobalDetectorIfCreated(), CPPUTEST_RETURN_ADDRESS());
     return cpputest_strdup_location(str, "<unknown>", 0);
 }
 
 char* cpputest_strndup(const char* str, size_t n)
 {
+    MemoryLeakAllocationCaller caller(MemoryLeakWarningPlugin::getGlobalDetectorIfCreated(), CPPUTEST_RETURN_ADDRESS());
     return cpputest_strndup_location(str, n, "<unknown>", 0);
 }
 
 void* cpputest_calloc(size_t num, size_t size)
 {
+    MemoryLeakAllocationCaller caller(MemoryLeakWarningPlugin::getGlobalDetectorIfCreated(), CPPUTEST_RETURN_ADDRESS());
     return cpputest_calloc_location(num, size, "<unknown>", 0);
 }
 
 void* cpputest_realloc(void* ptr, size_t size)
 {
+    MemoryLeakAllocationCaller caller(MemoryLeakWarningPlugin::getGlobalDetectorIfCreated(), CPPUTEST_RETURN_ADDRESS());
     return cpputest_realloc_location(ptr, size, "<unknown>", 0);
 }
 
@@ -207,6 +212,7 @@ static void countdown()
 
 void* cpputest_malloc_location(size_t size, const char* file, size_t line)
 {
+    MemoryLeakAllocationCaller caller(MemoryLeakWarningPlugin::getGlobalDetectorIfCreated(), CPPUTEST_RETURN_ADDRESS());
     countdown();
     malloc_count++;
     return cpputest_malloc_location_with_leak_detection(size, file, line);
@@ -229,12 +235,14 @@ static char* strdup_alloc(const char * str, size_t size, const char* file, size_
 
 char* cpputest_strdup_location(const char * str, const char* file, size_t line)
 {
+    MemoryLeakAllocationCaller caller(MemoryLeakWarningPlugin::getGlobalDetectorIfCreated(), CPPUTEST_RETURN_ADDRESS());
     size_t length = 1 + test_harness_c_strlen(str);
     return strdup_alloc(str, length, file, line);
 }
 
 char* cpputest_strndup_location(const char * str, size_t n, const char* file, size_t line)
 {
+    MemoryLeakAllocationCaller caller(MemoryLeakWarningPlugin::getGlobalDetectorIfCreated(), CPPUTEST_RETURN_ADDRESS());
     size_t length = test_harness_c_strlen(str);
     length = length < n ? length : n;
     length = length + 1;
@@ -244,6 +252,7 @@ char* cpputest_strndup_location(const char * str, size_t n, const char* file, si
 
 void* cpputest_calloc_location(size_t num, size_t size, const char* file, size_t line)
 {
+    MemoryLeakAllocationCaller caller(MemoryLeakWarningPlugin::getGlobalDetectorIfCreated(), CPPUTEST_RETURN_ADDRESS());
     void* mem = cpputest_malloc_location(num * size, file, line);
     if (mem)
         PlatformSpecificMemset(mem, 0, num*size);
@@ -252,6 +261,7 @@ void* cpputest_calloc_location(size_t num, size_t size, const char* file, size_t
 
 void* cpputest_realloc_location(void* memory, size_t size, const char* file, size_t line)
 {
+    MemoryLeakAllocationCaller caller(MemoryLeakWarningPlugin::getGlobalDetectorIfCreated(), CPPUTEST_RETURN_ADDRESS());
     return cpputest_realloc_location_with_leak_detection(memory, size, file, line);
 }
 
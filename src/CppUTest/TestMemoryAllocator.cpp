@@ -189,6 +189,32 @@ TestMemoryAllocator* TestMemoryAllocator::actualAllocator()
     return this;
 }
 
+bool TestMemoryAllocator::guardsMemory()
+{
+    return false;
+}
+
+bool TestMemoryAllocator::isMemoryCorrupted(char*)
+{
+    return false;
+}
+
+bool TestMemoryAllocator::releasesMemoryInBulk()
+{
+    return false;
+}
+
+/* Only allocators that release their memory in bulk keep track of which memory is theirs */
+bool TestMemoryAllocator::ownsMemory(char*)
+{
+    return false;
+}
+
+size_t TestMemoryAllocator::sizeOfMemory(char*)
+{
+    return 0;
+}
+
 MemoryLeakAllocator::MemoryLeakAllocator(TestMemoryAllocator* originalAllocator)
     : originalAllocator_(originalAllocator)
 {
@@ -228,6 +254,378 @@ TestMemoryAllocator* MemoryLeakAllocator::actualAllocator()
     return originalAllocator_->actualAllocator();
 }
 
+static size_t roundUpToMultipleOf(size_t size, size_t boundary)
+{
+    return (size + boundary - 1) / boundary * boundary;
+}
+
+/* Guarded and arena memory is aligned like malloc aligns */
+static const size_t mallocAlignment = 2 * sizeof(void*);
+
+static const size_t guardCanaryWord = ((size_t) -1 / 0xFF) * 0xA5;
+static const unsigned char guardCanaryByte = 0xA5;
+
+enum
+{
+    guard_canary_words = 2
+};
+
+/* The size and at least guard_canary_words canaries, padded with canaries up to the alignment */
+static const size_t guardCanaryHeaderSize = ((guard_canary_words + 1) * sizeof(size_t) + mallocAlignment - 1) / mallocAlignment * mallocAlignment;
+static const size_t guardCanaryHeaderWords = guardCanaryHeaderSize / sizeof(size_t);
+
+GuardedTestMemoryAllocator::GuardedTestMemoryAllocator(TestMemoryAllocator* originalAllocator, GuardedMemoryMode mode)
+    : originalAllocator_(originalAllocator), mode_(mode)
+{
+    if (mode_ != guard_canaries && PlatformSpecificPageSize() == 0)
+        mode_ = guard_canaries;
+}
+
+GuardedTestMemoryAllocator::~GuardedTestMemoryAllocator()
+{
+}
+
+GuardedMemoryMode GuardedTestMemoryAllocator::mode() const
+{
+    return mode_;
+}
+
+char* GuardedTestMemoryAllocator::alloc_memory(size_t size, const char* file, size_t line)
+{
+    if (mode_ == guard_canaries) return allocWithCanaries(size, file, line);
+    return allocWithGuardPage(size);
+}
+
+void GuardedTestMemoryAllocator::free_memory(char* memory, size_t, const char* file, size_t line)
+{
+    if (mode_ == guard_canaries) freeWithCanaries(memory, file, line);
+    else freeWithGuardPage(memory);
+}
+
+/* A guard page allocation maps its own pages. The first page holds the length of the mapping, so it can be found back
+ * from the memory. With the guard after the memory, the memory ends at the protected page. The size is rounded up to
+ * the malloc alignment first, so the memory stays aligned, at the cost of not catching overruns into those few bytes
+ * of padding. With the guard before the memory, a second page is the protected one and the memory starts right after it.
+ */
+char* GuardedTestMemoryAllocator::allocWithGuardPage(size_t size)
+{
+    const size_t page = PlatformSpecificPageSize();
+    const size_t alignedSize = roundUpToMultipleOf(size, mallocAlignment);
+    const size_t accessible = roundUpToMultipleOf(alignedSize + sizeof(size_t), page);
+    const size_t length = (mode_ == guard_page_after_memory) ? accessible + page : accessible + 2 * page;
+
+    char* mapping = (char*) PlatformSpecificMapPages(length);
+    if (mapping == NULLPTR) return NULLPTR;
+    *(size_t*) (void*) mapping = length;
+
+    if (mode_ == guard_page_after_memory) {
+        PlatformSpecificProtectPages(mapping + accessible, page);
+        return mapping + accessible - alignedSize;
+    }
+    PlatformSpecificProtectPages(mapping + page, page);
+    return mapping + 2 * page;
+}
+
+void GuardedTestMemoryAllocator::freeWithGuardPage(char* memory)
+{
+    const size_t page = PlatformSpecificPageSize();
+    char* mapping = memory - 2 * page;
+    if (mode_ == guard_page_after_memory) {
+        char* length = memory - sizeof(size_t);
+        mapping = length - ((size_t) length % page);
+    }
+
+    PlatformSpecificUnmapPages(mapping, *(size_t*) (void*) mapping);
+}
+
+/* The canary mode keeps the size and a head canary before the memory and a tail canary after it. The head is padded to
+ * the malloc alignment, so the memory is aligned like the original allocator aligns. The canaries are compared a word at
+ * a time, only the bytes up to the first aligned tail word are compared one by one.
+ */
+char* GuardedTestMemoryAllocator::allocWithCanaries(size_t size, const char* file, size_t line)
+{
+    const size_t alignedSize = roundUpToMultipleOf(size, sizeof(size_t));
+    char* block = originalAllocator_->alloc_memory(guardCanaryHeaderSize + alignedSize + guard_canary_words * sizeof(size_t), file, line);
+    if (block == NULLPTR) return NULLPTR;
+
+    size_t* header = (size_t*) (void*) block;
+    header[0] = size;
+    for (size_t i = 1; i < guardCanaryHeaderWords; i++)
+        header[i] = guardCanaryWord;
+
+    char* memory = block + guardCanaryHeaderSize;
+    PlatformSpecificMemset(memory + size, guardCanaryByte, alignedSize - size);
+
+    size_t* tail = (size_t*) (void*) (memory + alignedSize);
+    for (size_t j = 0; j < guard_canary_words; j++)
+        tail[j] = guardCanaryWord;
+    return memory;
+}
+
+void GuardedTestMemoryAllocator::freeWithCanaries(char* memory, const char* file, size_t line)
+{
+    originalAllocator_->free_memory(memory - guardCanaryHeaderSize, 0, file, line);
+}
+
+bool GuardedTestMemoryAllocator::isMemoryCorrupted(char* memory)
+{
+    if (mode_ != guard_canaries) return false;
+
+    const size_t* header = (const size_t*) (void*) (memory - guardCanaryHeaderSize);
+    for (size_t i = 1; i < guardCanaryHeaderWords; i++)
+        if (header[i] != guardCanaryWord) return true;
+
+    const size_t size = header[0];
+    const size_t alignedSize = roundUpToMultipleOf(size, sizeof(size_t));
+    for (size_t b = size; b < alignedSize; b++)
+        if ((unsigned char) memory[b] != guardCanaryByte) return true;
+
+    const size_t* tail = (const size_t*) (void*) (memory + alignedSize);
+    for (size_t j = 0; j < guard_canary_words; j++)
+        if (tail[j] != guardCanaryWord) return true;
+    return false;
+}
+
+bool GuardedTestMemoryAllocator::guardsMemory()
+{
+    return true;
+}
+
+const char* GuardedTestMemoryAllocator::name() const
+{
+    return originalAllocator_->name();
+}
+
+const char* GuardedTestMemoryAllocator::alloc_name() const
+{
+    return originalAllocator_->alloc_name();
+}
+
+const char* GuardedTestMemoryAllocator::free_name() const
+{
+    return originalAllocator_->free_name();
+}
+
+TestMemoryAllocator* GuardedTestMemoryAllocator::actualAllocator()
+{
+    return originalAllocator_->actualAllocator();
+}
+
+struct ArenaTestMemoryAllocatorChunk
+{
+    ArenaTestMemoryAllocatorChunk* next_;
+    size_t size_;
+    bool mapped_;
+};
+
+/* Every block is preceded by its size, so it can be reallocated. Both are aligned like malloc aligns */
+static const size_t arenaAlignment = mallocAlignment;
+static const size_t arenaBlockHeaderSize = arenaAlignment;
+
+static size_t arenaChunkHeaderSize()
+{
+    return roundUpToMultipleOf(sizeof(ArenaTestMemoryAllocatorChunk), arenaAlignment);
+}
+
+static ArenaTestMemoryAllocator* arenas = NULLPTR;
+
+ArenaTestMemoryAllocator::ArenaTestMemoryAllocator(size_t chunkSize, bool useHugePages)
+    : TestMemoryAllocator("Arena Allocator", "arena alloc", "arena free"), chunkSize_(chunkSize), useHugePages_(useHugePages && PlatformSpecificPageSize() != 0),
+      chunks_(NULLPTR), currentChunk_(NULLPTR), currentChunkUsed_(0), allocations_(0), deallocations_(0), allocatedBytes_(0), reservedBytes_(0), numberOfChunks_(0),
+      nextArena_(arenas)
+{
+    if (chunkSize_ < 4 * arenaChunkHeaderSize()) chunkSize_ = 4 * arenaChunkHeaderSize();
+    if (useHugePages_) chunkSize_ = roundUpToMultipleOf(chunkSize_, HUGE_PAGE_SIZE);
+    arenas = this;
+}
+
+ArenaTestMemoryAllocator::~ArenaTestMemoryAllocator()
+{
+    ArenaTestMemoryAllocator** arena = &arenas;
+    while (*arena != this)
+        arena = &(*arena)->nextArena_;
+    *arena = nextArena_;
+
+    while (chunks_) {
+        ArenaTestMemoryAllocatorChunk* chunk = chunks_;
+        chunks_ = chunk->next_;
+        releaseChunk(chunk);
+    }
+}
+
+ArenaTestMemoryAllocatorChunk* ArenaTestMemoryAllocator::allocateChunk(size_t size)
+{
+    ArenaTestMemoryAllocatorChunk* chunk;
+    if (useHugePages_) {
+        size = roundUpToMultipleOf(size, HUGE_PAGE_SIZE);
+        chunk = (ArenaTestMemoryAllocatorChunk*) PlatformSpecificMapPages(size);
+        if (chunk == NULLPTR) return NULLPTR;
+        PlatformSpecificAdviseHugePages(chunk, size);
+    }
+    else {
+        chunk = (ArenaTestMemoryAllocatorChunk*) PlatformSpecificMalloc(size);
+        if (chunk == NULLPTR) return NULLPTR;
+    }
+
+    chunk->size_ = size;
+    chunk->mapped_ = useHugePages_;
+    chunk->next_ = chunks_;
+    chunks_ = chunk;
+    reservedBytes_ += size;
+    numberOfChunks_++;
+    return chunk;
+}
+
+void ArenaTestMemoryAllocator::releaseChunk(ArenaTestMemoryAllocatorChunk* chunk)
+{
+    reservedBytes_ -= chunk->size_;
+    numberOfChunks_--;
+    if (chunk->mapped_)
+        PlatformSpecificUnmapPages(chunk, chunk->size_);
+    else
+        PlatformSpecificFree(chunk);
+}
+
+/* Blocks that would waste more than a quarter of a chunk get a chunk of their own, the current chunk stays current */
+char* ArenaTestMemoryAllocator::alloc_memory(size_t size, const char*, size_t)
+{
+    size_t needed = arenaBlockHeaderSize + roundUpToMultipleOf(size, arenaAlignment);
+    char* block;
+
+    if (needed > chunkSize_ / 4) {
+        ArenaTestMemoryAllocatorChunk* chunk = allocateChunk(arenaChunkHeaderSize() + needed);
+        if (chunk == NULLPTR) return NULLPTR;
+        block = (char*) chunk + arenaChunkHeaderSize();
+    }
+    else {
+        if (currentChunk_ == NULLPTR || currentChunkUsed_ + needed > currentChunk_->size_) {
+            currentChunk_ = allocateChunk(chunkSize_);
+            if (currentChunk_ == NULLPTR) return NULLPTR;
+            currentChunkUsed_ = arenaChunkHeaderSize();
+        }
+        block = (char*) currentChunk_ + currentChunkUsed_;
+        currentChunkUsed_ += needed;
+    }
+
+    *(size_t*) (void*) block = size;
+    allocations_++;
+    allocatedBytes_ += size;
+    return block + arenaBlockHeaderSize;
+}
+
+void ArenaTestMemoryAllocator::free_memory(char*, size_t, const char*, size_t)
+{
+    deallocations_++;
+}
+
+bool ArenaTestMemoryAllocator::releasesMemoryInBulk()
+{
+    return true;
+}
+
+size_t ArenaTestMemoryAllocator::sizeOfMemory(char* memory)
+{
+    return *(size_t*) (void*) (memory - arenaBlockHeaderSize);
+}
+
+/* Keeps the current chunk for the next test, all other chunks are released */
+void ArenaTestMemoryAllocator::reset()
+{
+    while (chunks_) {
+        ArenaTestMemoryAllocatorChunk* chunk = chunks_;
+        chunks_ = chunk->next_;
+        if (chunk != currentChunk_) releaseChunk(chunk);
+    }
+    if (currentChunk_) {
+        currentChunk_->next_ = NULLPTR;
+        chunks_ = currentChunk_;
+        currentChunkUsed_ = arenaChunkHeaderSize();
+    }
+
+    allocations_ = 0;
+    deallocations_ = 0;
+    allocatedBytes_ = 0;
+}
+
+bool ArenaTestMemoryAllocator::ownsMemory(char* memory)
+{
+    for (ArenaTestMemoryAllocatorChunk* chunk = chunks_; chunk; chunk = chunk->next_) {
+        char* chunkMemory = (char*) chunk;
+        if (memory > chunkMemory && memory < chunkMemory + chunk->size_) return true;
+    }
+    return false;
+}
+
+/* Only used for memory the memory leak detector doesn't know, so walking all chunks of all arenas is fine */
+ArenaTestMemoryAllocator* ArenaTestMemoryAllocator::findArenaOwning(char* memory)
+{
+    for (ArenaTestMemoryAllocator* arena = arenas; arena; arena = arena->nextArena_)
+        if (arena->ownsMemory(memory)) return arena;
+    return NULLPTR;
+}
+
+size_t ArenaTestMemoryAllocator::getAllocations() const
+{
+    return allocations_;
+}
+
+size_t ArenaTestMemoryAllocator::getDeallocations() const
+{
+    return deallocations_;
+}
+
+size_t ArenaTestMemoryAllocator::getAllocatedBytes() const
+{
+    return allocatedBytes_;
+}
+
+size_t ArenaTestMemoryAllocator::getReservedBytes() const
+{
+    return reservedBytes_;
+}
+
+size_t ArenaTestMemoryAllocator::getNumberOfChunks() const
+{
+    return numberOfChunks_;
+}
+
+bool ArenaTestMemoryAllocator::usesHugePages() const
+{
+    return useHugePages_;
+}
+
+ArenaTestMemoryAllocator* defaultArenaTestMemoryAllocator()
+{
+    static ArenaTestMemoryAllocator arena;
+    return &arena;
+}
+
+ArenaTestMemoryAllocatorScope::ArenaTestMemoryAllocatorScope()
+    : arena_(*defaultArenaTestMemoryAllocator())
+{
+    install();
+}
+
+ArenaTestMemoryAllocatorScope::ArenaTestMemoryAllocatorScope(ArenaTestMemoryAllocator& arena)
+    : arena_(arena)
+{
+    install();
+}
+
+void ArenaTestMemoryAllocatorScope::install()
+{
+    stash_.save();
+    setCurrentMallocAllocator(&arena_);
+    setCurrentNewAllocator(&arena_);
+    setCurrentNewArrayAllocator(&arena_);
+}
+
+ArenaTestMemoryAllocatorScope::~ArenaTestMemoryAllocatorScope()
+{
+    stash_.restore();
+    arena_.reset();
+}
+
 CrashOnAllocationAllocator::CrashOnAllocationAllocator() : allocationToCrashOn_(0)
 {
 }
@@ -241,9 +639,10 @@ void CrashOnAllocationAllocator::setNumberToCrashOn(unsigned allocationToCrashOn
     allocationToCrashOn_ = allocationToCrashOn;
 }
 
+/* The detector has already counted the allocation in progress when the allocator is called */
 char* CrashOnAllocationAllocator::alloc_memory(size_t size, const char* file, size_t line)
 {
-    if (MemoryLeakWarningPlugin::getGlobalDetector()->getCurrentAllocationNumber() == allocationToCrashOn_)
+    if (MemoryLeakWarningPlugin::getGlobalDetector()->getCurrentAllocationNumber() - 1 == allocationToCrashOn_)
         UT_CRASH();
 
     return TestMemoryAllocator::alloc_memory(size, file, line);
@@ -402,17 +801,20 @@ struct MemoryAccountantAllocationNode
     size_t maxAllocations_;
     size_t currentAllocations_;
     MemoryAccountantAllocationNode* next_;
+    MemoryAccountantAllocationNode* sizeTableNext_;
 };
 
 MemoryAccountantAllocationNode* MemoryAccountant::createNewAccountantAllocationNode(size_t size, MemoryAccountantAllocationNode* next) const
 {
     MemoryAccountantAllocationNode* node = (MemoryAccountantAllocationNode*) (void*) allocator_->alloc_memory(sizeof(MemoryAccountantAllocationNode), __FILE__, __LINE__);
+    if (node == NULLPTR) return NULLPTR;
     node->size_ = size;
     node->allocations_ = 0;
     node->deallocations_ = 0;
     node->maxAllocations_ = 0;
     node->currentAllocations_ = 0;
     node->next_ = next;
+    node->sizeTableNext_ = NULLPTR;
     return node;
 }
 
@@ -422,8 +824,9 @@ void MemoryAccountant::destroyAccountantAllocationNode(MemoryAccountantAllocatio
 }
 
 MemoryAccountant::MemoryAccountant()
-    : head_(NULLPTR), allocator_(defaultMallocAllocator()), useCacheSizes_(false)
+    : head_(NULLPTR), sizeTable_(NULLPTR), sizeTableSize_(0), numberOfNodes_(0), allocator_(defaultMallocAllocator()), useCacheSizes_(false)
 {
+    clearHistogram();
 }
 
 MemoryAccountant::~MemoryAccountant()
@@ -431,23 +834,20 @@ MemoryAccountant::~MemoryAccountant()
     clear();
 }
 
+/* The cache size nodes are kept in a list sorted by size, the smallest cache an allocation fits in accounts for it */
 void MemoryAccountant::createCacheSizeNodes(size_t sizes[], size_t length)
 {
-    for (size_t i = 0; i < length; i++)
-        findOrCreateNodeOfSize(sizes[i]);
-
-    if (head_ == NULLPTR)
-        head_ = createNewAccountantAllocationNode(0, NULLPTR);
-    else {
-        for (MemoryAccountantAllocationNode* lastNode = head_; lastNode; lastNode = lastNode->next_) {
-            if (lastNode->next_ == NULLPTR) {
-                lastNode->next_ = createNewAccountantAllocationNode(0, NULLPTR);
-                break;
-            }
-        }
+    for (size_t i = 0; i < length; i++) {
+        MemoryAccountantAllocationNode** insertAt = &head_;
+        while (*insertAt && (*insertAt)->size_ < sizes[i]) insertAt = &(*insertAt)->next_;
+        if (*insertAt == NULLPTR || (*insertAt)->size_ != sizes[i])
+            *insertAt = createNewAccountantAllocationNode(sizes[i], *insertAt);
     }
-}
 
+    MemoryAccountantAllocationNode** lastNode = &head_;
+    while (*lastNode) lastNode = &(*lastNode)->next_;
+    *lastNode = createNewAccountantAllocationNode(0, NULLPTR);
+}
 
 void MemoryAccountant::useCacheSizes(size_t sizes[], size_t length)
 {
@@ -463,6 +863,17 @@ void MemoryAccountant::setAllocator(TestMemoryAllocator* allocator)
     allocator_ = allocator;
 }
 
+void MemoryAccountant::clearHistogram()
+{
+    totalAllocations_ = 0;
+    totalDeallocations_ = 0;
+    currentAllocations_ = 0;
+    maxAllocations_ = 0;
+    largestSize_ = 0;
+    for (size_t i = 0; i < HISTOGRAM_BUCKETS; i++)
+        histogram_[i] = 0;
+}
+
 void MemoryAccountant::clear()
 {
     MemoryAccountantAllocationNode* node = head_;
@@ -473,6 +884,12 @@ void MemoryAccountant::clear()
         destroyAccountantAllocationNode(to_be_deleted);
     }
     head_ = NULLPTR;
+    if (sizeTable_)
+        allocator_->free_memory((char*) sizeTable_, sizeTableSize_ * sizeof(*sizeTable_), __FILE__, __LINE__);
+    sizeTable_ = NULLPTR;
+    sizeTableSize_ = 0;
+    numberOfNodes_ = 0;
+    clearHistogram();
 }
 
 MemoryAccountantAllocationNode* MemoryAccountant::findNodeOfSize(size_t size) const
@@ -485,45 +902,114 @@ MemoryAccountantAllocationNode* MemoryAccountant::findNodeOfSize(size_t size) co
                 return node;
         }
     }
-    else
-        for (MemoryAccountantAllocationNode* node = head_; node; node = node->next_)
+    else if (sizeTableSize_)
+        for (MemoryAccountantAllocationNode* node = sizeTable_[sizeTableBucketOfSize(size)]; node; node = node->sizeTableNext_)
             if (node->size_ == size)
                 return node;
     return NULLPTR;
 }
 
-MemoryAccountantAllocationNode* MemoryAccountant::findOrCreateNodeOfSize(size_t size)
+size_t MemoryAccountant::sizeTableBucketOfSize(size_t size) const
 {
-    if (useCacheSizes_)
-      return findNodeOfSize(size);
+    return (size ^ (size >> 3)) & (sizeTableSize_ - 1);
+}
 
-    if (head_ && head_->size_ > size)
-        head_ = createNewAccountantAllocationNode(size, head_);
+/* The size table doubles when it holds more nodes than buckets. When that memory isn't there, the chains just get longer */
+void MemoryAccountant::growSizeTable()
+{
+    size_t newTableSize = (sizeTableSize_ == 0) ? 64 : sizeTableSize_ * 2;
+    MemoryAccountantAllocationNode** newTable = (MemoryAccountantAllocationNode**) (void*) allocator_->alloc_memory(newTableSize * sizeof(*newTable), __FILE__, __LINE__);
+    if (newTable == NULLPTR)
+        return;
+
+    if (sizeTable_)
+        allocator_->free_memory((char*) sizeTable_, sizeTableSize_ * sizeof(*sizeTable_), __FILE__, __LINE__);
+    sizeTable_ = newTable;
+    sizeTableSize_ = newTableSize;
+    for (size_t i = 0; i < sizeTableSize_; i++)
+        sizeTable_[i] = NULLPTR;
 
     for (MemoryAccountantAllocationNode* node = head_; node; node = node->next_) {
-        if (node->size_ == size)
-            return node;
-        if (node->next_ == NULLPTR || node->next_->size_ > size)
-            node->next_ = createNewAccountantAllocationNode(size, node->next_);
+        size_t bucket = sizeTableBucketOfSize(node->size_);
+        node->sizeTableNext_ = sizeTable_[bucket];
+        sizeTable_[bucket] = node;
     }
-    head_ = createNewAccountantAllocationNode(size, head_);
-    return head_;
+}
+
+/* Without cache sizes, the nodes are found through a hash on the size. The list from head_ is unsorted, the report sorts it */
+MemoryAccountantAllocationNode* MemoryAccountant::findOrCreateNodeOfSize(size_t size)
+{
+    MemoryAccountantAllocationNode* node = findNodeOfSize(size);
+    if (node || useCacheSizes_)
+        return node;
+
+    if (numberOfNodes_ >= sizeTableSize_)
+        growSizeTable();
+    if (sizeTableSize_ == 0)
+        return NULLPTR;
+
+    node = createNewAccountantAllocationNode(size, head_);
+    if (node == NULLPTR)
+        return NULLPTR;
+
+    size_t bucket = sizeTableBucketOfSize(size);
+    node->sizeTableNext_ = sizeTable_[bucket];
+    sizeTable_[bucket] = node;
+    head_ = node;
+    numberOfNodes_++;
+    return node;
+}
+
+size_t MemoryAccountant::histogramBucketOfSize(size_t size)
+{
+    if (size < HISTOGRAM_EXACT_SIZES)
+        return size;
+
+    size_t exponent = 0;
+    for (size_t remaining = size; remaining > 1; remaining >>= 1)
+        exponent++;
+    size_t subBucket = (size >> (exponent - 2)) & (HISTOGRAM_SUB_BUCKETS - 1);
+    return HISTOGRAM_EXACT_SIZES + (exponent - 4) * HISTOGRAM_SUB_BUCKETS + subBucket;
+}
+
+size_t MemoryAccountant::largestSizeInHistogramBucket(size_t bucket)
+{
+    if (bucket < HISTOGRAM_EXACT_SIZES)
+        return bucket;
+
+    size_t exponent = 4 + (bucket - HISTOGRAM_EXACT_SIZES) / HISTOGRAM_SUB_BUCKETS;
+    size_t subBucket = (bucket - HISTOGRAM_EXACT_SIZES) % HISTOGRAM_SUB_BUCKETS;
+    return ((HISTOGRAM_SUB_BUCKETS + subBucket + 1) << (exponent - 2)) - 1;
 }
 
 void MemoryAccountant::alloc(size_t size)
 {
     MemoryAccountantAllocationNode* node = findOrCreateNodeOfSize(size);
-    node->allocations_++;
-    node->currentAllocations_++;
-    node->maxAllocations_ = (node->currentAllocations_ > node->maxAllocations_) ? node->currentAllocations_ : node->maxAllocations_;
+    if (node) {
+        node->allocations_++;
+        node->currentAllocations_++;
+        node->maxAllocations_ = (node->currentAllocations_ > node->maxAllocations_) ? node->currentAllocations_ : node->maxAllocations_;
+    }
+
+    histogram_[histogramBucketOfSize(size)]++;
+    totalAllocations_++;
+    currentAllocations_++;
+    if (currentAllocations_ > maxAllocations_) maxAllocations_ = currentAllocations_;
+    if (size > largestSize_) largestSize_ = size;
 }
 
 void MemoryAccountant::dealloc(size_t size)
 {
     MemoryAccountantAllocationNode* node = findOrCreateNodeOfSize(size);
-    node->deallocations_++;
-    if (node->currentAllocations_)
-      node->currentAllocations_--;
+    if (node) {
+        node->deallocations_++;
+        if (node->currentAllocations_)
+          node->currentAllocations_--;
+    }
+
+    totalDeallocations_++;
+    if (currentAllocations_)
+      currentAllocations_--;
 }
 
 size_t MemoryAccountant::totalAllocationsOfSize(size_t size) const
@@ -552,22 +1038,40 @@ size_t MemoryAccountant::maximumAllocationAtATimeOfSize(size_t size) const
 
 size_t MemoryAccountant::totalAllocations() const
 {
-    size_t theTotalAllocations = 0;
+    return totalAllocations_;
+}
 
-    for (MemoryAccountantAllocationNode* node = head_; node; node = node->next_)
-        theTotalAllocations += node->allocations_;
+size_t MemoryAccountant::totalDeallocations() const
+{
+    return totalDeallocations_;
+}
 
-    return theTotalAllocations;
+size_t MemoryAccountant::currentAllocations() const
+{
+    return currentAllocations_;
 }
 
-size_t MemoryAccountant::totalDeallocations() const
+size_t MemoryAccountant::maximumAllocationsAtATime() const
 {
-    size_t theTotalDeallocations = 0;
+    return maxAllocations_;
+}
 
-    for (MemoryAccountantAllocationNode* node = head_; node; node = node->next_)
-        theTotalDeallocations += node->deallocations_;
+size_t MemoryAccountant::allocationSizePercentile(size_t percent) const
+{
+    if (totalAllocations_ == 0) return 0;
 
-    return theTotalDeallocations;
+    size_t wanted = (totalAllocations_ * percent + 99) / 100;
+    if (wanted == 0) wanted = 1;
+
+    size_t counted = 0;
+    for (size_t bucket = 0; bucket < HISTOGRAM_BUCKETS; bucket++) {
+        counted += histogram_[bucket];
+        if (counted >= wanted) {
+            size_t largestSize = largestSizeInHistogramBucket(bucket);
+            return (largestSize < largestSize_) ? largestSize : largestSize_;
+        }
+    }
+    return largestSize_;
 }
 
 SimpleString MemoryAccountant::reportNoAllocations() const
@@ -601,25 +1105,77 @@ SimpleString MemoryAccountant::stringSize(size_t size) const
     return (size == 0) ? StringFrom("other") : StringFromFormat("%5d", (int) size);
 }
 
+static void siftDownBySize(MemoryAccountantAllocationNode** nodes, size_t root, size_t length)
+{
+    for (size_t child = 2 * root + 1; child < length; root = child, child = 2 * root + 1) {
+        if (child + 1 < length && nodes[child + 1]->size_ > nodes[child]->size_) child++;
+        if (nodes[root]->size_ >= nodes[child]->size_) return;
+        MemoryAccountantAllocationNode* swap = nodes[root];
+        nodes[root] = nodes[child];
+        nodes[child] = swap;
+    }
+}
+
+static void sortBySize(MemoryAccountantAllocationNode** nodes, size_t length)
+{
+    for (size_t i = length / 2; i > 0; i--)
+        siftDownBySize(nodes, i - 1, length);
+    for (size_t end = length; end > 1; end--) {
+        MemoryAccountantAllocationNode* swap = nodes[0];
+        nodes[0] = nodes[end - 1];
+        nodes[end - 1] = swap;
+        siftDownBySize(nodes, 0, end - 1);
+    }
+}
+
 SimpleString MemoryAccountant::report() const
 {
     if (head_ == NULLPTR)
       return reportNoAllocations();
 
-    SimpleString accountantReport = reportTitle() + reportHeader();
+    SimpleStringBuilder accountantReport;
+    accountantReport.append(reportTitle());
+    accountantReport.append(reportHeader());
+
+    size_t bytes = numberOfNodes_ * sizeof(MemoryAccountantAllocationNode*);
+    MemoryAccountantAllocationNode** nodes = useCacheSizes_ ? NULLPTR : (MemoryAccountantAllocationNode**) (void*) allocator_->alloc_memory(bytes, __FILE__, __LINE__);
 
+    /* Cache sizes are kept sorted. Without memory to sort the other sizes, they are reported unsorted */
+    if (nodes == NULLPTR) {
+        for (MemoryAccountantAllocationNode* node = head_; node; node = node->next_)
+            accountantReport.appendFormatted(MEMORY_ACCOUNTANT_ROW_FORMAT, stringSize(node->size_).asCharString(), (int) node->allocations_, (int) node->deallocations_, (int) node->maxAllocations_);
+        accountantReport.append(reportFooter());
+        return accountantReport.toString();
+    }
+
+    size_t length = 0;
     for (MemoryAccountantAllocationNode* node = head_; node; node = node->next_)
-        accountantReport += StringFromFormat(MEMORY_ACCOUNTANT_ROW_FORMAT, stringSize(node->size_).asCharString(), (int) node->allocations_, (int) node->deallocations_, (int) node->maxAllocations_);
+        nodes[length++] = node;
+    sortBySize(nodes, length);
+
+    for (size_t i = 0; i < length; i++)
+        accountantReport.appendFormatted(MEMORY_ACCOUNTANT_ROW_FORMAT, stringSize(nodes[i]->size_).asCharString(), (int) nodes[i]->allocations_, (int) nodes[i]->deallocations_, (int) nodes[i]->maxAllocations_);
 
-    return accountantReport + reportFooter();
+    allocator_->free_memory((char*) nodes, bytes, __FILE__, __LINE__);
+    accountantReport.append(reportFooter());
+    return accountantReport.toString();
 }
 
-AccountingTestMemoryAllocator::AccountingTestMemoryAllocator(MemoryAccountant& accountant, TestMemoryAllocator* origAllocator)
-    : accountant_(accountant), originalAllocator_(origAllocator), head_(NULLPTR)
+SimpleString MemoryAccountant::reportPercentiles() const
 {
+    if (totalAllocations_ == 0)
+      return reportNoAllocations();
+
+    return StringFromFormat("CppUTest Memory Accountant allocation sizes:\n"
+                            "50%% <= %lu   90%% <= %lu   99%% <= %lu   largest %lu\n"
+                            "Current # allocations %lu, max # allocations at one time %lu\n",
+                            (unsigned long) allocationSizePercentile(50), (unsigned long) allocationSizePercentile(90),
+                            (unsigned long) allocationSizePercentile(99), (unsigned long) largestSize_,
+                            (unsigned long) currentAllocations_, (unsigned long) maxAllocations_);
 }
 
-AccountingTestMemoryAllocator::~AccountingTestMemoryAllocator()
+AccountingTestMemoryAllocator::AccountingTestMemoryAllocator(MemoryAccountant& accountant, TestMemoryAllocator* origAllocator)
+    : accountant_(accountant), originalAllocator_(origAllocator), table_(NULLPTR), tableSize_(0), numberOfNodes_(0)
 {
 }
 
@@ -630,43 +1186,78 @@ struct AccountingTestMemoryAllocatorMemoryNode
     AccountingTestMemoryAllocatorMemoryNode* next_;
 };
 
-void AccountingTestMemoryAllocator::addMemoryToMemoryTrackingToKeepTrackOfSize(char* memory, size_t size)
+AccountingTestMemoryAllocator::~AccountingTestMemoryAllocator()
 {
-    AccountingTestMemoryAllocatorMemoryNode* node = (AccountingTestMemoryAllocatorMemoryNode*) (void*) originalAllocator_->alloc_memory(sizeof(AccountingTestMemoryAllocatorMemoryNode), __FILE__, __LINE__);
-    node->memory_ = memory;
-    node->size_ = size;
-    node->next_ = head_;
-    head_ = node;
+    for (size_t i = 0; i < tableSize_; i++) {
+        while (table_[i]) {
+            AccountingTestMemoryAllocatorMemoryNode* node = table_[i];
+            table_[i] = node->next_;
+            originalAllocator_->free_memory((char*) node, sizeof(*node), __FILE__, __LINE__);
+        }
+    }
+    if (table_)
+        originalAllocator_->free_memory((char*) table_, tableSize_ * sizeof(*table_), __FILE__, __LINE__);
 }
 
-size_t AccountingTestMemoryAllocator::removeNextNodeAndReturnSize(AccountingTestMemoryAllocatorMemoryNode* node)
+/* The sizes are kept in a hash table on the memory pointer which doubles when it holds more nodes than buckets */
+size_t AccountingTestMemoryAllocator::hashOfMemory(char* memory) const
 {
-    AccountingTestMemoryAllocatorMemoryNode* foundNode = node->next_;
-    node->next_ = node->next_->next_;
+    size_t address = (size_t) memory;
+    return ((address >> 4) ^ (address >> 16)) & (tableSize_ - 1);
+}
+
+void AccountingTestMemoryAllocator::growMemoryTracking()
+{
+    AccountingTestMemoryAllocatorMemoryNode** oldTable = table_;
+    size_t oldTableSize = tableSize_;
+
+    tableSize_ = (oldTableSize == 0) ? 64 : oldTableSize * 2;
+    table_ = (AccountingTestMemoryAllocatorMemoryNode**) (void*) originalAllocator_->alloc_memory(tableSize_ * sizeof(*table_), __FILE__, __LINE__);
+    for (size_t i = 0; i < tableSize_; i++)
+        table_[i] = NULLPTR;
 
-    size_t size = foundNode->size_;
-    originalAllocator_->free_memory((char*) foundNode, size, __FILE__, __LINE__);
-    return size;
+    for (size_t i = 0; i < oldTableSize; i++) {
+        while (oldTable[i]) {
+            AccountingTestMemoryAllocatorMemoryNode* node = oldTable[i];
+            oldTable[i] = node->next_;
+            size_t bucket = hashOfMemory(node->memory_);
+            node->next_ = table_[bucket];
+            table_[bucket] = node;
+        }
+    }
+    if (oldTable)
+        originalAllocator_->free_memory((char*) oldTable, oldTableSize * sizeof(*oldTable), __FILE__, __LINE__);
 }
 
-size_t AccountingTestMemoryAllocator::removeHeadAndReturnSize()
+void AccountingTestMemoryAllocator::addMemoryToMemoryTrackingToKeepTrackOfSize(char* memory, size_t size)
 {
-    AccountingTestMemoryAllocatorMemoryNode* foundNode = head_;
-    head_ = head_->next_;
+    if (numberOfNodes_ >= tableSize_)
+        growMemoryTracking();
 
-    size_t size = foundNode->size_;
-    originalAllocator_->free_memory((char*) foundNode, size, __FILE__, __LINE__);
-    return size;
+    AccountingTestMemoryAllocatorMemoryNode* node = (AccountingTestMemoryAllocatorMemoryNode*) (void*) originalAllocator_->alloc_memory(sizeof(AccountingTestMemoryAllocatorMemoryNode), __FILE__, __LINE__);
+    size_t bucket = hashOfMemory(memory);
+    node->memory_ = memory;
+    node->size_ = size;
+    node->next_ = table_[bucket];
+    table_[bucket] = node;
+    numberOfNodes_++;
 }
 
 size_t AccountingTestMemoryAllocator::removeMemoryFromTrackingAndReturnAllocatedSize(char* memory)
 {
-    if (head_ && head_->memory_ == memory)
-        return removeHeadAndReturnSize();
+    if (tableSize_ == 0)
+        return 0;
 
-    for (AccountingTestMemoryAllocatorMemoryNode* node = head_; node; node = node->next_) {
-        if (node->next_ && node->next_->memory_ == memory)
-            return removeNextNodeAndReturnSize(node);
+    for (AccountingTestMemoryAllocatorMemoryNode** node = &table_[hashOfMemory(memory)]; *node; node = &(*node)->next_) {
+        if ((*node)->memory_ == memory) {
+            AccountingTestMemoryAllocatorMemoryNode* foundNode = *node;
+            *node = foundNode->next_;
+            numberOfNodes_--;
+
+            size_t size = foundNode->size_;
+            originalAllocator_->free_memory((char*) foundNode, sizeof(*foundNode), __FILE__, __LINE__);
+            return size;
+        }
     }
 
     return 0;
@@ -775,6 +1366,11 @@ SimpleString GlobalMemoryAccountant::report()
     return accountant_.report();
 }
 
+SimpleString GlobalMemoryAccountant::reportPercentiles()
+{
+    return accountant_.reportPercentiles();
+}
+
 TestMemoryAllocator* GlobalMemoryAccountant::getMallocAllocator()
 {
     return mallocAllocator_;
@@ -789,4 +1385,3 @@ TestMemoryAllocator* GlobalMemoryAccountant::getNewArrayAllocator()
 {
     return newArrayAllocator_;
 }
-
@@ -111,7 +111,13 @@ void TestOutput::printCurrentTestEnded(const TestResult& res)
     if (verbose_ > level_quiet) {
         print(" - ");
         print(res.getCurrentTestTotalExecutionTime());
-        print(" ms\n");
+        print(" ms");
+        if (res.getCurrentTestPeakMemory()) {
+            print(" - peak ");
+            print(res.getCurrentTestPeakMemory());
+            print(" bytes");
+        }
+        print("\n");
     }
     else {
         printProgressIndicator();
@@ -60,6 +60,18 @@ void TestPlugin::runAllPostTestAction(UtestShell& test, TestResult& result)
     if (enabled_) postTestAction(test, result);
 }
 
+void TestPlugin::runAllPreTestRunAction(TestResult& result)
+{
+    if (enabled_) preTestRunAction(result);
+    next_->runAllPreTestRunAction(result);
+}
+
+void TestPlugin::runAllPostTestRunAction(TestResult& result)
+{
+    next_->runAllPostTestRunAction(result);
+    if (enabled_) postTestRunAction(result);
+}
+
 bool TestPlugin::parseAllArguments(int ac, char** av, int index)
 {
     return parseAllArguments(ac, const_cast<const char *const *> (av), index);
@@ -167,3 +179,11 @@ void NullTestPlugin::runAllPreTestAction(UtestShell&, TestResult&)
 void NullTestPlugin::runAllPostTestAction(UtestShell&, TestResult&)
 {
 }
+
+void NullTestPlugin::runAllPreTestRunAction(TestResult&)
+{
+}
+
+void NullTestPlugin::runAllPostTestRunAction(TestResult&)
+{
+}
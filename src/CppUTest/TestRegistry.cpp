@@ -48,6 +48,7 @@ void TestRegistry::runAllTests(TestResult& result)
     bool groupStart = true;
 
     result.testsStarted();
+    firstPlugin_->runAllPreTestRunAction(result);
     for (UtestShell *test = tests_; test != NULLPTR; test = test->getNext()) {
         if (runInSeperateProcess_) test->setRunInSeperateProcess();
         if (runIgnored_) test->setRunIgnored();
@@ -69,6 +70,7 @@ void TestRegistry::runAllTests(TestResult& result)
             result.currentGroupEnded(test);
         }
     }
+    firstPlugin_->runAllPostTestRunAction(result);
     result.testsEnded();
     currentRepetition_++;
 }
@@ -80,7 +82,7 @@ void TestRegistry::listTestGroupNames(TestResult& result)
     for (UtestShell *test = tests_; test != NULLPTR; test = test->getNext()) {
         SimpleString gname;
         gname += "#";
-        gname += test->getGroup();
+        gname += test->getGroupAsCharString();
         gname += "#";
 
         if (!groupList.contains(gname)) {
@@ -104,9 +106,9 @@ void TestRegistry::listTestGroupAndCaseNames(TestResult& result)
         if (testShouldRun(test, result)) {
             SimpleString groupAndName;
             groupAndName += "#";
-            groupAndName += test->getGroup();
+            groupAndName += test->getGroupAsCharString();
             groupAndName += ".";
-            groupAndName += test->getName();
+            groupAndName += test->getNameAsCharString();
             groupAndName += "#";
 
             if (!groupAndNameList.contains(groupAndName)) {
@@ -129,11 +131,11 @@ void TestRegistry::listTestLocations(TestResult& result)
 
     for (UtestShell *test = tests_; test != NULLPTR; test = test->getNext()) {
             SimpleString testLocation;
-            testLocation += test->getGroup();
+            testLocation += test->getGroupAsCharString();
             testLocation += ".";
-            testLocation += test->getName();
+            testLocation += test->getNameAsCharString();
             testLocation += ".";
-            testLocation += test->getFile();
+            testLocation += test->getFileAsCharString();
             testLocation += ".";
             testLocation += StringFromFormat("%d\n",(int) test->getLineNumber());
 
@@ -145,7 +147,7 @@ void TestRegistry::listTestLocations(TestResult& result)
 
 bool TestRegistry::endOfGroup(UtestShell* test)
 {
-    return (!test || !test->getNext() || test->getGroup() != test->getNext()->getGroup());
+    return (!test || !test->getNext() || SimpleString::StrCmp(test->getGroupAsCharString(), test->getNext()->getGroupAsCharString()) != 0);
 }
 
 size_t TestRegistry::countTests()
@@ -273,7 +275,7 @@ UtestShell* TestRegistry::findTestWithName(const SimpleString& name)
 {
     UtestShell* current = tests_;
     while (current) {
-        if (current->getName() == name)
+        if (SimpleString::StrCmp(current->getNameAsCharString(), name.asCharString()) == 0)
             return current;
         current = current->getNext();
     }
@@ -284,7 +286,7 @@ UtestShell* TestRegistry::findTestWithGroup(const SimpleString& group)
 {
     UtestShell* current = tests_;
     while (current) {
-        if (current->getGroup() == group)
+        if (SimpleString::StrCmp(current->getGroupAsCharString(), group.asCharString()) == 0)
             return current;
         current = current->getNext();
     }
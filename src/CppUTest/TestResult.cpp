@@ -33,7 +33,7 @@
 
 TestResult::TestResult(TestOutput& p) :
     output_(p), testCount_(0), runCount_(0), checkCount_(0), failureCount_(0), filteredOutCount_(0), ignoredCount_(0), totalExecutionTime_(0), timeStarted_(0), currentTestTimeStarted_(0),
-            currentTestTotalExecutionTime_(0), currentGroupTimeStarted_(0), currentGroupTotalExecutionTime_(0)
+            currentTestTotalExecutionTime_(0), currentGroupTimeStarted_(0), currentGroupTotalExecutionTime_(0), currentTestPeakMemory_(0)
 {
 }
 
@@ -57,6 +57,7 @@ void TestResult::currentTestStarted(UtestShell* test)
 {
     output_.printCurrentTestStarted(*test);
     currentTestTimeStarted_ = (size_t) GetPlatformSpecificTimeInMillis();
+    currentTestPeakMemory_ = 0;
 }
 
 void TestResult::print(const char* text)
@@ -135,6 +136,16 @@ size_t TestResult::getCurrentTestTotalExecutionTime() const
     return currentTestTotalExecutionTime_;
 }
 
+size_t TestResult::getCurrentTestPeakMemory() const
+{
+    return currentTestPeakMemory_;
+}
+
+void TestResult::setCurrentTestPeakMemory(size_t bytes)
+{
+    currentTestPeakMemory_ = bytes;
+}
+
 size_t TestResult::getCurrentGroupTotalExecutionTime() const
 {
     return currentGroupTotalExecutionTime_;
@@ -29,6 +29,8 @@
 #include "CppUTest/TestRegistry.h"
 #include "CppUTest/PlatformSpecificFunctions.h"
 #include "CppUTest/TestOutput.h"
+#include "CppUTest/TestMemoryAllocator.h"
+#include "CppUTest/MemoryLeakDetector.h"
 
 #if defined(__GNUC__) && __GNUC__ >= 11
 # define NEEDS_DISABLE_NULL_WARNING
@@ -47,6 +49,132 @@ bool doubles_equal(double d1, double d2, double threshold)
     return PlatformSpecificFabs(d1 - d2) <= threshold;
 }
 
+/*
+ * The array assertions check a block of elements without an early exit, which compilers vectorise. Only a block that
+ * has a difference is searched element by element. For the threshold this is a quick check, the element check is
+ * doubles_equal, so that the arrays compare exactly like DOUBLES_EQUAL would.
+ */
+enum { arrayComparisonBlockSize = 16 };
+
+static bool outsideThreshold(double expected, double actual, double threshold)
+{
+    double difference = expected - actual;
+    return !(((difference < 0) ? -difference : difference) <= threshold);
+}
+
+static size_t firstDifferenceInDoubles(const double* expected, const double* actual, size_t count, double threshold)
+{
+    size_t index = 0;
+    for (; index + arrayComparisonBlockSize <= count; index += arrayComparisonBlockSize) {
+        bool blockDiffers = false;
+        for (size_t i = index; i < index + arrayComparisonBlockSize; i++)
+            blockDiffers |= outsideThreshold(expected[i], actual[i], threshold);
+        if (blockDiffers) break;
+    }
+    for (; index < count; index++)
+        if (outsideThreshold(expected[index], actual[index], threshold) && !doubles_equal(expected[index], actual[index], threshold))
+            return index;
+    return count;
+}
+
+static size_t firstDifferenceInFloats(const float* expected, const float* actual, size_t count, double threshold)
+{
+    size_t index = 0;
+    for (; index + arrayComparisonBlockSize <= count; index += arrayComparisonBlockSize) {
+        bool blockDiffers = false;
+        for (size_t i = index; i < index + arrayComparisonBlockSize; i++)
+            blockDiffers |= outsideThreshold(expected[i], actual[i], threshold);
+        if (blockDiffers) break;
+    }
+    for (; index < count; index++)
+        if (outsideThreshold(expected[index], actual[index], threshold) && !doubles_equal(expected[index], actual[index], threshold))
+            return index;
+    return count;
+}
+
+#if CPPUTEST_USE_LONG_LONG
+
+/* Reads the bits of a float or double as an integer of the same size. Negative values are mirrored below zero, so that
+ * the difference between two of these is the number of representable values between them.
+ */
+static cpputest_longlong orderedBitsOf(const void* value, size_t size)
+{
+    const unsigned char* from = (const unsigned char*) value;
+    if (size == sizeof(int)) {
+        int bits;
+        unsigned char* to = (unsigned char*) &bits;
+        for (size_t i = 0; i < sizeof(bits); i++) to[i] = from[i];
+        return (bits < 0) ? -(cpputest_longlong) (bits & (int) (~0U >> 1)) : bits;
+    }
+    if (size == sizeof(long)) {
+        long bits;
+        unsigned char* to = (unsigned char*) &bits;
+        for (size_t i = 0; i < sizeof(bits); i++) to[i] = from[i];
+        return (bits < 0) ? -(cpputest_longlong) (bits & (long) (~0UL >> 1)) : bits;
+    }
+    cpputest_longlong bits;
+    unsigned char* to = (unsigned char*) &bits;
+    for (size_t i = 0; i < sizeof(bits); i++) to[i] = from[i];
+    return (bits < 0) ? -(bits & (cpputest_longlong) (~0ULL >> 1)) : bits;
+}
+
+static bool moreUlpsApart(cpputest_longlong expected, cpputest_longlong actual, cpputest_ulonglong maxUlps)
+{
+    cpputest_ulonglong ulps = (expected > actual) ? (cpputest_ulonglong) expected - (cpputest_ulonglong) actual : (cpputest_ulonglong) actual - (cpputest_ulonglong) expected;
+    return ulps > maxUlps;
+}
+
+/* NaN doesn't equal itself, that check is inline so that the blocks vectorise */
+static bool doublesMoreUlpsApart(double expected, double actual, cpputest_ulonglong maxUlps)
+{
+    return expected != expected || actual != actual ||
+           moreUlpsApart(orderedBitsOf(&expected, sizeof(expected)), orderedBitsOf(&actual, sizeof(actual)), maxUlps);
+}
+
+static bool floatsMoreUlpsApart(float expected, float actual, cpputest_ulonglong maxUlps)
+{
+    return expected != expected || actual != actual ||
+           moreUlpsApart(orderedBitsOf(&expected, sizeof(expected)), orderedBitsOf(&actual, sizeof(actual)), maxUlps);
+}
+
+static size_t firstDifferenceInDoublesUlps(const double* expected, const double* actual, size_t count, cpputest_ulonglong maxUlps)
+{
+    size_t index = 0;
+    for (; index + arrayComparisonBlockSize <= count; index += arrayComparisonBlockSize) {
+        bool blockDiffers = false;
+        for (size_t i = index; i < index + arrayComparisonBlockSize; i++)
+            blockDiffers |= doublesMoreUlpsApart(expected[i], actual[i], maxUlps);
+        if (blockDiffers) break;
+    }
+    for (; index < count; index++)
+        if (doublesMoreUlpsApart(expected[index], actual[index], maxUlps))
+            return index;
+    return count;
+}
+
+static size_t firstDifferenceInFloatsUlps(const float* expected, const float* actual, size_t count, cpputest_ulonglong maxUlps)
+{
+    size_t index = 0;
+    for (; index + arrayComparisonBlockSize <= count; index += arrayComparisonBlockSize) {
+        bool blockDiffers = false;
+        for (size_t i = index; i < index + arrayComparisonBlockSize; i++)
+            blockDiffers |= floatsMoreUlpsApart(expected[i], actual[i], maxUlps);
+        if (blockDiffers) break;
+    }
+    for (; index < count; index++)
+        if (floatsMoreUlpsApart(expected[index], actual[index], maxUlps))
+            return index;
+    return count;
+}
+
+#endif
+
+static void addDoublesToWindows(SimpleString& expectedWindow, SimpleString& actualWindow, double expected, double actual)
+{
+    ArrayEqualFailure::addToWindow(expectedWindow, StringFrom(expected, 7));
+    ArrayEqualFailure::addToWindow(actualWindow, StringFrom(actual, 7));
+}
+
 /* Sometimes stubs use the CppUTest assertions.
  * Its not correct to do so, but this small helper class will prevent a segmentation fault and instead
  * will give an error message and also the file/line of the check that was executed outside the tests.
@@ -144,6 +272,8 @@ const TestTerminator *UtestShell::currentTestTerminator_ = &normalTestTerminator
 const TestTerminator *UtestShell::currentTestTerminatorWithoutExceptions_ = &normalTestTerminatorWithoutExceptions;
 
 bool UtestShell::rethrowExceptions_ = false;
+bool UtestShell::updateGoldenFiles_ = false;
+size_t UtestShell::allocationFailureSweepProcesses_ = 0;
 
 /******************************** */
 
@@ -350,6 +480,22 @@ const SimpleString UtestShell::getFile() const
     return SimpleString(file_);
 }
 
+/* These don't copy the names, use them when walking over all tests */
+const char* UtestShell::getNameAsCharString() const
+{
+    return name_;
+}
+
+const char* UtestShell::getGroupAsCharString() const
+{
+    return group_;
+}
+
+const char* UtestShell::getFileAsCharString() const
+{
+    return file_;
+}
+
 size_t UtestShell::getLineNumber() const
 {
     return lineNumber_;
@@ -523,6 +669,75 @@ void UtestShell::assertDoublesEqual(double expected, double actual, double thres
         failWith(DoublesEqualFailure(this, fileName, lineNumber, expected, actual, threshold, text), testTerminator);
 }
 
+void UtestShell::assertDoublesArrayEqual(const double* expected, const double* actual, size_t count, double threshold, const char* text, const char* fileName, size_t lineNumber, const TestTerminator& testTerminator)
+{
+    size_t failedIndex = firstDifferenceInDoubles(expected, actual, count, threshold);
+    SimpleString expectedWindow;
+    SimpleString actualWindow;
+    if (failedIndex < count)
+        for (size_t i = ArrayEqualFailure::windowStart(failedIndex); i < ArrayEqualFailure::windowEnd(failedIndex, count); i++)
+            addDoublesToWindows(expectedWindow, actualWindow, expected[i], actual[i]);
+    assertArrayEqual(failedIndex, count, expectedWindow, actualWindow, text, fileName, lineNumber, testTerminator);
+}
+
+void UtestShell::assertDoublesArrayEqual(const float* expected, const float* actual, size_t count, double threshold, const char* text, const char* fileName, size_t lineNumber, const TestTerminator& testTerminator)
+{
+    size_t failedIndex = firstDifferenceInFloats(expected, actual, count, threshold);
+    SimpleString expectedWindow;
+    SimpleString actualWindow;
+    if (failedIndex < count)
+        for (size_t i = ArrayEqualFailure::windowStart(failedIndex); i < ArrayEqualFailure::windowEnd(failedIndex, count); i++)
+            addDoublesToWindows(expectedWindow, actualWindow, expected[i], actual[i]);
+    assertArrayEqual(failedIndex, count, expectedWindow, actualWindow, text, fileName, lineNumber, testTerminator);
+}
+
+void UtestShell::assertDoublesArrayEqualUlps(const double* expected, const double* actual, size_t count, unsigned long maxUlps, const char* text, const char* fileName, size_t lineNumber, const TestTerminator& testTerminator)
+{
+#if CPPUTEST_USE_LONG_LONG
+    size_t failedIndex = firstDifferenceInDoublesUlps(expected, actual, count, maxUlps);
+    SimpleString expectedWindow;
+    SimpleString actualWindow;
+    if (failedIndex < count)
+        for (size_t i = ArrayEqualFailure::windowStart(failedIndex); i < ArrayEqualFailure::windowEnd(failedIndex, count); i++)
+            addDoublesToWindows(expectedWindow, actualWindow, expected[i], actual[i]);
+    assertArrayEqual(failedIndex, count, expectedWindow, actualWindow, text, fileName, lineNumber, testTerminator);
+#else
+    (void)expected;
+    (void)actual;
+    (void)count;
+    (void)maxUlps;
+    getTestResult()->countCheck();
+    failWith(FeatureUnsupportedFailure(this, fileName, lineNumber, "CPPUTEST_USE_LONG_LONG", text), testTerminator);
+#endif
+}
+
+void UtestShell::assertDoublesArrayEqualUlps(const float* expected, const float* actual, size_t count, unsigned long maxUlps, const char* text, const char* fileName, size_t lineNumber, const TestTerminator& testTerminator)
+{
+#if CPPUTEST_USE_LONG_LONG
+    size_t failedIndex = firstDifferenceInFloatsUlps(expected, actual, count, maxUlps);
+    SimpleString expectedWindow;
+    SimpleString actualWindow;
+    if (failedIndex < count)
+        for (size_t i = ArrayEqualFailure::windowStart(failedIndex); i < ArrayEqualFailure::windowEnd(failedIndex, count); i++)
+            addDoublesToWindows(expectedWindow, actualWindow, expected[i], actual[i]);
+    assertArrayEqual(failedIndex, count, expectedWindow, actualWindow, text, fileName, lineNumber, testTerminator);
+#else
+    (void)expected;
+    (void)actual;
+    (void)count;
+    (void)maxUlps;
+    getTestResult()->countCheck();
+    failWith(FeatureUnsupportedFailure(this, fileName, lineNumber, "CPPUTEST_USE_LONG_LONG", text), testTerminator);
+#endif
+}
+
+void UtestShell::assertArrayEqual(size_t failedIndex, size_t count, const SimpleString& expectedWindow, const SimpleString& actualWindow, const char* text, const char* fileName, size_t lineNumber, const TestTerminator& testTerminator)
+{
+    getTestResult()->countCheck();
+    if (failedIndex < count)
+        failWith(ArrayEqualFailure(this, fileName, lineNumber, failedIndex, count, expectedWindow, actualWindow, text), testTerminator);
+}
+
 void UtestShell::assertBinaryEqual(const void *expected, const void *actual, size_t length, const char* text, const char *fileName, size_t lineNumber, const TestTerminator& testTerminator)
 {
     getTestResult()->countCheck();
@@ -530,10 +745,97 @@ void UtestShell::assertBinaryEqual(const void *expected, const void *actual, siz
     if (actual == NULLPTR && expected == NULLPTR) return;
     if (actual == NULLPTR || expected == NULLPTR)
         failWith(BinaryEqualFailure(this, fileName, lineNumber, (const unsigned char *) expected, (const unsigned char *) actual, length, text), testTerminator);
-    if (SimpleString::MemCmp(expected, actual, length) != 0)
+    if (SimpleString::MemFirstDifference(expected, actual, length) != length)
         failWith(BinaryEqualFailure(this, fileName, lineNumber, (const unsigned char *) expected, (const unsigned char *) actual, length, text), testTerminator);
 }
 
+/*
+ * Golden files are mapped where the platform can map files. Empty files can't be mapped, and on platforms that can't map
+ * files at all the golden files go through the file operations instead.
+ */
+static bool writeGoldenFile(const char* goldenFileName, const void* contents, size_t length)
+{
+    if (length > 0) {
+        size_t mappedLength = length;
+        void* golden = PlatformSpecificMapFile(goldenFileName, &mappedLength, 1);
+        if (golden != NULLPTR) {
+            PlatformSpecificMemCpy(golden, contents, length);
+            PlatformSpecificUnmapPages(golden, length);
+            return true;
+        }
+    }
+
+    PlatformSpecificFile file = PlatformSpecificFOpen(goldenFileName, "wb");
+    if (file == NULLPTR) return false;
+    size_t written = (length > 0) ? PlatformSpecificFWrite(contents, length, file) : 0;
+    PlatformSpecificFClose(file);
+    return written == length;
+}
+
+/* Returns the contents of the file in memory from PlatformSpecificMalloc or NULLPTR when it can't be read */
+static unsigned char* readGoldenFile(const char* goldenFileName, size_t* length)
+{
+    PlatformSpecificFile file = PlatformSpecificFOpen(goldenFileName, "rb");
+    if (file == NULLPTR) return NULLPTR;
+
+    size_t capacity = 256;
+    size_t used = 0;
+    unsigned char* contents = (unsigned char*) PlatformSpecificMalloc(capacity);
+    while (contents != NULLPTR) {
+        size_t received = PlatformSpecificFRead(contents + used, capacity - used, file);
+        if (received == 0) break;
+        used += received;
+        if (used == capacity) {
+            unsigned char* grown = (unsigned char*) PlatformSpecificRealloc(contents, capacity * 2);
+            if (grown == NULLPTR) PlatformSpecificFree(contents);
+            contents = grown;
+            capacity *= 2;
+        }
+    }
+    PlatformSpecificFClose(file);
+    *length = used;
+    return contents;
+}
+
+static void releaseGoldenFile(const unsigned char* golden, size_t length, bool mapped)
+{
+    if (mapped)
+        PlatformSpecificUnmapPages((void*) golden, length);
+    else
+        PlatformSpecificFree((void*) golden);
+}
+
+void UtestShell::assertFileEqual(const char* goldenFileName, const void *actual, size_t length, const char* text, const char *fileName, size_t lineNumber, const TestTerminator& testTerminator)
+{
+    getTestResult()->countCheck();
+    if (isUpdatingGoldenFiles()) {
+        if (!writeGoldenFile(goldenFileName, actual, length))
+            failWith(FileEqualFailure(this, fileName, lineNumber, goldenFileName, "could not be written", text), testTerminator);
+        return;
+    }
+
+    /* A file that can't be mapped keeps this size, an empty file can't be mapped but sets it to 0 */
+    size_t goldenLength = 1;
+    const unsigned char* golden = (const unsigned char*) PlatformSpecificMapFile(goldenFileName, &goldenLength, 0);
+    bool mapped = (golden != NULLPTR);
+    if (!mapped && goldenLength != 0) {
+        golden = readGoldenFile(goldenFileName, &goldenLength);
+        if (golden == NULLPTR)
+            failWith(FileEqualFailure(this, fileName, lineNumber, goldenFileName, "could not be read (run with -ug to create it)", text), testTerminator);
+    }
+
+    size_t comparedLength = (goldenLength < length) ? goldenLength : length;
+    size_t failStart = (actual && comparedLength > 0) ? SimpleString::MemFirstDifference(golden, actual, comparedLength) : 0;
+    if (failStart == comparedLength && goldenLength == length) {
+        if (golden) releaseGoldenFile(golden, goldenLength, mapped);
+        return;
+    }
+
+    FileEqualFailure failure(this, fileName, lineNumber, goldenFileName, golden, goldenLength, (const unsigned char*) actual, length, failStart, text);
+    if (golden) releaseGoldenFile(golden, goldenLength, mapped);
+    failWith(failure, testTerminator);
+}
+
 void UtestShell::assertBitsEqual(unsigned long expected, unsigned long actual, unsigned long mask, size_t byteCount, const char* text, const char *fileName, size_t lineNumber, const TestTerminator& testTerminator)
 {
     getTestResult()->countCheck();
@@ -635,6 +937,310 @@ bool UtestShell::isRethrowingExceptions()
     return rethrowExceptions_;
 }
 
+void UtestShell::setUpdateGoldenFiles(bool updateGoldenFiles)
+{
+    updateGoldenFiles_ = updateGoldenFiles;
+}
+
+bool UtestShell::isUpdatingGoldenFiles()
+{
+    return updateGoldenFiles_;
+}
+
+void UtestShell::setAllocationFailureSweep(size_t parallelProcesses)
+{
+    allocationFailureSweepProcesses_ = parallelProcesses;
+}
+
+size_t UtestShell::getAllocationFailureSweep()
+{
+    return allocationFailureSweepProcesses_;
+}
+
+////////////// Allocation failure sweep ////////////
+
+/*
+ * The sweep reruns the body and teardown of a test once per allocation, each time in a child process started after
+ * setup, with a FailableMemoryAllocator failing that allocation. The children return how the test dealt with it. The
+ * outcomes are above any exit status, so a test that exits in a child is reported as such. The first child whose
+ * failing allocation was never reached tells how many allocations there were.
+ */
+
+enum AllocationFailureSweepOutcome
+{
+    sweep_passed = 0x100,
+    sweep_failed,
+    sweep_leaked,
+    sweep_allocation_not_reached
+};
+
+static const size_t maximumReportedSweepProblems = 10;
+
+class AllocationFailureSweepOutput : public TestOutput
+{
+public:
+    virtual void printBuffer(const char*) CPPUTEST_OVERRIDE {}
+    virtual void flush() CPPUTEST_OVERRIDE {}
+};
+
+class AllocationFailureSweepAllocator : public FailableMemoryAllocator
+{
+public:
+    AllocationFailureSweepAllocator(int allocationToFail)
+    {
+        failAllocNumber(allocationToFail);
+    }
+
+    virtual ~AllocationFailureSweepAllocator() CPPUTEST_DESTRUCTOR_OVERRIDE
+    {
+        clearFailedAllocs();
+    }
+
+    bool failingAllocationWasDone() const
+    {
+        return head_ == NULLPTR;
+    }
+};
+
+struct AllocationFailureSweepChild
+{
+    UtestShell* shell_;
+    Utest* test_;
+    int allocationToFail_;
+};
+
+class AllocationFailureSweep
+{
+public:
+    AllocationFailureSweep(size_t parallelProcesses)
+        : parallelProcesses_(parallelProcesses), runningChildren_(0), outcomes_(NULLPTR), outcomesSize_(0),
+          allocations_(-1), nextAllocationToFail_(1)
+    {
+        children_ = (int*) PlatformSpecificMalloc(parallelProcesses_ * sizeof(int));
+        childAllocations_ = (int*) PlatformSpecificMalloc(parallelProcesses_ * sizeof(int));
+        for (size_t i = 0; i < parallelProcesses_; i++)
+            children_[i] = 0;
+    }
+
+    ~AllocationFailureSweep()
+    {
+        PlatformSpecificFree(children_);
+        PlatformSpecificFree(childAllocations_);
+        PlatformSpecificFree(outcomes_);
+    }
+
+    bool canStartChild() const
+    {
+        return allocations_ < 0 && runningChildren_ < parallelProcesses_;
+    }
+
+    bool hasRunningChildren() const
+    {
+        return runningChildren_ > 0;
+    }
+
+    const int* children() const
+    {
+        return children_;
+    }
+
+    size_t maximumChildren() const
+    {
+        return parallelProcesses_;
+    }
+
+    int nextAllocationToFail() const
+    {
+        return nextAllocationToFail_;
+    }
+
+    void childStarted(int child)
+    {
+        size_t slot = 0;
+        while (children_[slot] != 0) slot++;
+        children_[slot] = child;
+        childAllocations_[slot] = nextAllocationToFail_++;
+        runningChildren_++;
+    }
+
+    void childEnded(int child, int outcome)
+    {
+        for (size_t slot = 0; slot < parallelProcesses_; slot++) {
+            if (children_[slot] == child) {
+                children_[slot] = 0;
+                runningChildren_--;
+                recordOutcome(childAllocations_[slot], outcome);
+                return;
+            }
+        }
+    }
+
+    SimpleString summary(const SimpleString& testName) const
+    {
+        return StringFromFormat("\nAllocation failure sweep of %s: %d allocations, %d passed, %d failed, %d leaked, %d crashed\n",
+            testName.asCharString(), allocations_, count(sweep_passed), count(sweep_failed), count(sweep_leaked), allocations_ - count(sweep_passed) - count(sweep_failed) - count(sweep_leaked));
+    }
+
+    bool foundProblems() const
+    {
+        return count(sweep_passed) + count(sweep_failed) < allocations_;
+    }
+
+    SimpleString problems() const
+    {
+        SimpleString text("Allocation failure sweep found problems");
+        size_t reported = 0;
+        for (int allocation = 1; allocation <= allocations_; allocation++) {
+            int outcome = outcomes_[allocation];
+            if (outcome == sweep_passed || outcome == sweep_failed) continue;
+            if (reported++ == maximumReportedSweepProblems) {
+                text += "\n\t...";
+                break;
+            }
+            text += StringFromFormat("\n\tfailing allocation %d ", allocation);
+            if (outcome == sweep_leaked)
+                text += "leaked memory";
+            else if (outcome < 0)
+                text += StringFromFormat("crashed with signal %d", -outcome);
+            else
+                text += StringFromFormat("crashed with exit code %d", outcome);
+        }
+        return text;
+    }
+
+private:
+    size_t parallelProcesses_;
+    size_t runningChildren_;
+    int* children_;
+    int* childAllocations_;
+    int* outcomes_;
+    int outcomesSize_;
+    int allocations_;
+    int nextAllocationToFail_;
+
+    void recordOutcome(int allocation, int outcome)
+    {
+        if (outcome == sweep_allocation_not_reached) {
+            if (allocations_ < 0 || allocation - 1 < allocations_)
+                allocations_ = allocation - 1;
+            return;
+        }
+
+        if (allocation >= outcomesSize_) {
+            int newSize = (outcomesSize_ == 0) ? 64 : outcomesSize_;
+            while (newSize <= allocation) newSize *= 2;
+            outcomes_ = (int*) PlatformSpecificRealloc(outcomes_, (size_t) newSize * sizeof(int));
+            outcomesSize_ = newSize;
+        }
+        outcomes_[allocation] = outcome;
+    }
+
+    int count(int outcome) const
+    {
+        int total = 0;
+        for (int allocation = 1; allocation <= allocations_; allocation++)
+            if (outcomes_[allocation] == outcome) total++;
+        return total;
+    }
+};
+
+static void runCatchingFailures(void (*function)(void*), Utest* test)
+{
+#if CPPUTEST_HAVE_EXCEPTIONS
+    try {
+#endif
+        PlatformSpecificSetJmp(function, test);
+#if CPPUTEST_HAVE_EXCEPTIONS
+    }
+    catch (CppUTestFailedException&)
+    {
+        PlatformSpecificRestoreJumpBuffer();
+    }
+    catch (...)
+    {
+        UtestShell::getCurrent()->addFailure(UnexpectedExceptionFailure(UtestShell::getCurrent()));
+        PlatformSpecificRestoreJumpBuffer();
+    }
+#endif
+}
+
+int UtestShell::runWithFailingAllocation(void* data)
+{
+    AllocationFailureSweepChild* child = (AllocationFailureSweepChild*) data;
+    UtestShell* shell = child->shell_;
+
+    AllocationFailureSweepOutput output;
+    TestResult result(output);
+    TestResult* savedResult = testResult_;
+    bool savedHasFailed = shell->hasFailed_;
+    shell->setTestResult(&result);
+    shell->hasFailed_ = false;
+
+    /* Only what is allocated from here on and isn't freed by the body or teardown counts as leaked */
+    MemoryLeakDetector* detector = MemoryLeakWarningPlugin::getGlobalDetector();
+    detector->markCheckingPeriodLeaksAsNonCheckingPeriod();
+    AllocationFailureSweepAllocator allocator(child->allocationToFail_);
+    GlobalMemoryAllocatorStash stash;
+    stash.save();
+    detector->disableAllocationTypeChecking();
+    setCurrentMallocAllocator(&allocator);
+    setCurrentNewAllocator(&allocator);
+    setCurrentNewArrayAllocator(&allocator);
+
+    runCatchingFailures(helperDoTestBody, child->test_);
+    runCatchingFailures(helperDoTestTeardown, child->test_);
+
+    stash.restore();
+    detector->enableAllocationTypeChecking();
+
+    int outcome = sweep_passed;
+    if (!allocator.failingAllocationWasDone())
+        outcome = sweep_allocation_not_reached;
+    else if (shell->hasFailed_)
+        outcome = sweep_failed;
+    else if (detector->totalMemoryLeaks(mem_leak_period_checking) > 0)
+        outcome = sweep_leaked;
+
+    shell->hasFailed_ = savedHasFailed;
+    shell->setTestResult(savedResult);
+    return outcome;
+}
+
+void UtestShell::sweepAllocationFailures(Utest* test)
+{
+    if (allocationFailureSweepProcesses_ == 0 || hasFailed()) return;
+
+    AllocationFailureSweep sweep(allocationFailureSweepProcesses_);
+    AllocationFailureSweepChild child = { this, test, 0 };
+
+    do {
+        while (sweep.canStartChild()) {
+            child.allocationToFail_ = sweep.nextAllocationToFail();
+            int childId = PlatformSpecificStartChildProcess(runWithFailingAllocation, &child);
+            if (childId > 0)
+                sweep.childStarted(childId);
+            else if (sweep.hasRunningChildren())
+                break;
+            else {
+                addFailure(TestFailure(this, "-af doesn't work on this platform, as it can't start child processes"));
+                return;
+            }
+        }
+
+        int outcome = 0;
+        int childId = PlatformSpecificWaitForChildProcess(sweep.children(), sweep.maximumChildren(), &outcome);
+        if (childId < 0) {
+            addFailure(TestFailure(this, "Waiting for the allocation failure sweep processes failed"));
+            return;
+        }
+        sweep.childEnded(childId, outcome);
+    } while (sweep.hasRunningChildren() || sweep.canStartChild());
+
+    getTestResult()->print(sweep.summary(getFormattedName()).asCharString());
+    if (sweep.foundProblems())
+        addFailure(TestFailure(this, sweep.problems()));
+}
+
 ExecFunctionTestShell::~ExecFunctionTestShell()
 {
 }
@@ -661,6 +1267,7 @@ void Utest::run()
         current->printVeryVerbose("\n-------- after  setup: ");
 
         if (jumpResult) {
+            current->sweepAllocationFailures(this);
             current->printVeryVerbose("\n----------  before body: ");
             PlatformSpecificSetJmp(helperDoTestBody, this);
             current->printVeryVerbose("\n----------  after body: ");
@@ -726,6 +1333,7 @@ void Utest::run()
 void Utest::run()
 {
     if (PlatformSpecificSetJmp(helperDoTestSetup, this)) {
+        UtestShell::getCurrent()->sweepAllocationFailures(this);
         PlatformSpecificSetJmp(helperDoTestBody, this);
     }
     PlatformSpecificSetJmp(helperDoTestTeardown, this);
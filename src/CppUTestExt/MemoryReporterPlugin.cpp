@@ -29,9 +29,11 @@
 #include "CppUTestExt/MemoryReporterPlugin.h"
 #include "CppUTestExt/MemoryReportFormatter.h"
 #include "CppUTestExt/CodeMemoryReportFormatter.h"
+#include "CppUTestExt/TraceMemoryReportFormatter.h"
+#include "CppUTestExt/SitesMemoryReportFormatter.h"
 
 MemoryReporterPlugin::MemoryReporterPlugin()
-    : TestPlugin("MemoryReporterPlugin"), formatter_(NULLPTR)
+    : TestPlugin("MemoryReporterPlugin"), formatter_(NULLPTR), lastTestOfOpenGroup_(NULLPTR)
 {
 }
 
@@ -62,6 +64,18 @@ MemoryReportFormatter* MemoryReporterPlugin::createMemoryFormatter(const SimpleS
     else if (type == "code") {
         return new CodeMemoryReportFormatter(defaultMallocAllocator());
     }
+    else if (type == "trace") {
+        return new TraceMemoryReportFormatter("cpputest_memory.trace");
+    }
+    else if (type.startsWith("trace:")) {
+        return new TraceMemoryReportFormatter(type.subString(6).asCharString());
+    }
+    else if (type == "sites") {
+        return new SitesMemoryReportFormatter;
+    }
+    else if (type.startsWith("sites:")) {
+        return new SitesMemoryReportFormatter((size_t) SimpleString::AtoU(type.subString(6).asCharString()));
+    }
     return NULLPTR;
 }
 
@@ -127,6 +141,9 @@ void MemoryReporterPlugin::preTestAction(UtestShell& test, TestResult& result)
     setGlobalMemoryReportAllocators();
 
     if (test.getGroup() != currentTestGroup_) {
+        if (lastTestOfOpenGroup_)
+            formatter_->report_testgroup_end(&result, *lastTestOfOpenGroup_);
+        lastTestOfOpenGroup_ = NULLPTR;
         formatter_->report_testgroup_start(&result, test);
         currentTestGroup_ = test.getGroup();
     }
@@ -141,6 +158,29 @@ void MemoryReporterPlugin::postTestAction(UtestShell& test, TestResult& result)
     removeGlobalMemoryReportAllocators();
     formatter_->report_test_end(&result, test);
 
-    if (test.getNext() == NULLPTR || test.getNext()->getGroup() != currentTestGroup_)
+    lastTestOfOpenGroup_ = &test;
+    if (test.getNext() == NULLPTR || test.getNext()->getGroup() != currentTestGroup_) {
         formatter_->report_testgroup_end(&result, test);
+        lastTestOfOpenGroup_ = NULLPTR;
+    }
+}
+
+void MemoryReporterPlugin::preTestRunAction(TestResult& result)
+{
+    if (formatter_ == NULLPTR) return;
+
+    currentTestGroup_ = "";
+    lastTestOfOpenGroup_ = NULLPTR;
+    formatter_->report_testrun_start(&result);
+}
+
+/* A group stays open when the test after its last one that ran is of the same group, but was filtered out */
+void MemoryReporterPlugin::postTestRunAction(TestResult& result)
+{
+    if (formatter_ == NULLPTR) return;
+
+    if (lastTestOfOpenGroup_)
+        formatter_->report_testgroup_end(&result, *lastTestOfOpenGroup_);
+    lastTestOfOpenGroup_ = NULLPTR;
+    formatter_->report_testrun_end(&result);
 }
@@ -675,57 +675,57 @@ MockActualCallTrace::~MockActualCallTrace()
 
 MockActualCall& MockActualCallTrace::withName(const SimpleString& name)
 {
-    traceBuffer_ += "\nFunction name:";
-    traceBuffer_ += name;
+    traceBuffer_.append("\nFunction name:");
+    traceBuffer_.append(name);
     return *this;
 }
 
 MockActualCall& MockActualCallTrace::withCallOrder(unsigned int callOrder)
 {
-    traceBuffer_ += " withCallOrder:";
-    traceBuffer_ += StringFrom(callOrder);
+    traceBuffer_.append(" withCallOrder:");
+    traceBuffer_.append(StringFrom(callOrder));
     return *this;
 }
 
 void MockActualCallTrace::addParameterName(const SimpleString& name)
 {
-    traceBuffer_ += " ";
-    traceBuffer_ += name;
-    traceBuffer_ += ":";
+    traceBuffer_.append(" ");
+    traceBuffer_.append(name);
+    traceBuffer_.append(":");
 }
 
 MockActualCall& MockActualCallTrace::withBoolParameter(const SimpleString& name, bool value)
 {
     addParameterName(name);
-    traceBuffer_ += StringFrom(value);
+    traceBuffer_.append(StringFrom(value));
     return *this;
 }
 
 MockActualCall& MockActualCallTrace::withUnsignedIntParameter(const SimpleString& name, unsigned int value)
 {
     addParameterName(name);
-    traceBuffer_ += StringFrom(value) + " " + BracketsFormattedHexStringFrom(value);
+    traceBuffer_.append(StringFrom(value)).append(" ").append(BracketsFormattedHexStringFrom(value));
     return *this;
 }
 
 MockActualCall& MockActualCallTrace::withIntParameter(const SimpleString& name, int value)
 {
     addParameterName(name);
-    traceBuffer_ += StringFrom(value) + " " + BracketsFormattedHexStringFrom(value);
+    traceBuffer_.append(StringFrom(value)).append(" ").append(BracketsFormattedHexStringFrom(value));
     return *this;
 }
 
 MockActualCall& MockActualCallTrace::withUnsignedLongIntParameter(const SimpleString& name, unsigned long int value)
 {
     addParameterName(name);
-    traceBuffer_ += StringFrom(value) + " " + BracketsFormattedHexStringFrom(value);
+    traceBuffer_.append(StringFrom(value)).append(" ").append(BracketsFormattedHexStringFrom(value));
     return *this;
 }
 
 MockActualCall& MockActualCallTrace::withLongIntParameter(const SimpleString& name, long int value)
 {
     addParameterName(name);
-    traceBuffer_ += StringFrom(value) + " " + BracketsFormattedHexStringFrom(value);
+    traceBuffer_.append(StringFrom(value)).append(" ").append(BracketsFormattedHexStringFrom(value));
     return *this;
 }
 
@@ -734,14 +734,14 @@ MockActualCall& MockActualCallTrace::withLongIntParameter(const SimpleString& na
 MockActualCall& MockActualCallTrace::withUnsignedLongLongIntParameter(const SimpleString& name, cpputest_ulonglong value)
 {
     addParameterName(name);
-    traceBuffer_ += StringFrom(value) + " " + BracketsFormattedHexStringFrom(value);
+    traceBuffer_.append(StringFrom(value)).append(" ").append(BracketsFormattedHexStringFrom(value));
     return *this;
 }
 
 MockActualCall& MockActualCallTrace::withLongLongIntParameter(const SimpleString& name, cpputest_longlong value)
 {
     addParameterName(name);
-    traceBuffer_ += StringFrom(value) + " " + BracketsFormattedHexStringFrom(value);
+    traceBuffer_.append(StringFrom(value)).append(" ").append(BracketsFormattedHexStringFrom(value));
     return *this;
 }
 
@@ -764,67 +764,67 @@ MockActualCall& MockActualCallTrace::withLongLongIntParameter(const SimpleString
 MockActualCall& MockActualCallTrace::withDoubleParameter(const SimpleString& name, double value)
 {
     addParameterName(name);
-    traceBuffer_ += StringFrom(value);
+    traceBuffer_.append(StringFrom(value));
     return *this;
 }
 
 MockActualCall& MockActualCallTrace::withStringParameter(const SimpleString& name, const char* value)
 {
     addParameterName(name);
-    traceBuffer_ += StringFrom(value);
+    traceBuffer_.append(StringFrom(value));
     return *this;
 }
 
 MockActualCall& MockActualCallTrace::withPointerParameter(const SimpleString& name, void* value)
 {
     addParameterName(name);
-    traceBuffer_ += StringFrom(value);
+    traceBuffer_.append(StringFrom(value));
     return *this;
 }
 
 MockActualCall& MockActualCallTrace::withConstPointerParameter(const SimpleString& name, const void* value)
 {
     addParameterName(name);
-    traceBuffer_ += StringFrom(value);
+    traceBuffer_.append(StringFrom(value));
     return *this;
 }
 
 MockActualCall& MockActualCallTrace::withFunctionPointerParameter(const SimpleString& name, void (*value)())
 {
     addParameterName(name);
-    traceBuffer_ += StringFrom(value);
+    traceBuffer_.append(StringFrom(value));
     return *this;
 }
 
 MockActualCall& MockActualCallTrace::withMemoryBufferParameter(const SimpleString& name, const unsigned char* value, size_t size)
 {
     addParameterName(name);
-    traceBuffer_ += StringFromBinaryWithSizeOrNull(value, size);
+    traceBuffer_.append(StringFromBinaryWithSizeOrNull(value, size));
     return *this;
 }
 
 MockActualCall& MockActualCallTrace::withParameterOfType(const SimpleString& typeName, const SimpleString& name, const void* value)
 {
-    traceBuffer_ += " ";
-    traceBuffer_ += typeName;
+    traceBuffer_.append(" ");
+    traceBuffer_.append(typeName);
     addParameterName(name);
-    traceBuffer_ += StringFrom(value);
+    traceBuffer_.append(StringFrom(value));
     return *this;
 }
 
 MockActualCall& MockActualCallTrace::withOutputParameter(const SimpleString& name, void* output)
 {
     addParameterName(name);
-    traceBuffer_ += StringFrom(output);
+    traceBuffer_.append(StringFrom(output));
     return *this;
 }
 
 MockActualCall& MockActualCallTrace::withOutputParameterOfType(const SimpleString& typeName, const SimpleString& name, void* output)
 {
-    traceBuffer_ += " ";
-    traceBuffer_ += typeName;
+    traceBuffer_.append(" ");
+    traceBuffer_.append(typeName);
     addParameterName(name);
-    traceBuffer_ += StringFrom(output);
+    traceBuffer_.append(StringFrom(output));
     return *this;
 }
 
@@ -994,14 +994,14 @@ unsigned int MockActualCallTrace::returnUnsignedIntValueOrDefault(unsigned int)
 
 MockActualCall& MockActualCallTrace::onObject(const void* objectPtr)
 {
-    traceBuffer_ += " onObject:";
-    traceBuffer_ += StringFrom(objectPtr);
+    traceBuffer_.append(" onObject:");
+    traceBuffer_.append(StringFrom(objectPtr));
     return *this;
 }
 
 void MockActualCallTrace::clear()
 {
-    traceBuffer_ = "";
+    traceBuffer_.clear();
 }
 
 const char* MockActualCallTrace::getTraceOutput()
@@ -235,6 +235,11 @@ MockCheckedExpectedCall* MockExpectedCallsList::getFirstMatchingExpectation()
     return NULLPTR;
 }
 
+MockCheckedExpectedCall* MockExpectedCallsList::getFirstExpectation()
+{
+    return (head_) ? head_->expectedCall_ : NULLPTR;
+}
+
 MockCheckedExpectedCall* MockExpectedCallsList::removeFirstMatchingExpectation()
 {
     for (MockExpectedCallsListNode* p = head_; p; p = p->next_) {
@@ -305,41 +310,36 @@ void MockExpectedCallsList::outputParameterWasPassed(const SimpleString& paramet
         p->expectedCall_->outputParameterWasPassed(parameterName);
 }
 
-static SimpleString stringOrNoneTextWhenEmpty(const SimpleString& inputString, const SimpleString& linePrefix)
+static SimpleString stringOrNoneTextWhenEmpty(const SimpleStringBuilder& str, const SimpleString& linePrefix)
 {
-    SimpleString str = inputString;
-    if (str == "") {
-        str += linePrefix;
-        str += "<none>";
-    }
-    return str;
+    if (str.isEmpty())
+        return linePrefix + "<none>";
+    return str.toString();
 }
 
-static SimpleString appendStringOnANewLine(const SimpleString& inputString, const SimpleString& linePrefix, const SimpleString& stringToAppend)
+static void appendStringOnANewLine(SimpleStringBuilder& str, const SimpleString& linePrefix, const SimpleString& stringToAppend)
 {
-    SimpleString str = inputString;
-    if (str != "") str += "\n";
-    str += linePrefix;
-    str += stringToAppend;
-    return str;
+    if (!str.isEmpty()) str.append("\n");
+    str.append(linePrefix);
+    str.append(stringToAppend);
 }
 
 SimpleString MockExpectedCallsList::unfulfilledCallsToString(const SimpleString& linePrefix) const
 {
-    SimpleString str;
+    SimpleStringBuilder str;
     for (MockExpectedCallsListNode* p = head_; p; p = p->next_)
         if (!p->expectedCall_->isFulfilled())
-            str = appendStringOnANewLine(str, linePrefix, p->expectedCall_->callToString());
+            appendStringOnANewLine(str, linePrefix, p->expectedCall_->callToString());
     return stringOrNoneTextWhenEmpty(str, linePrefix);
 }
 
 SimpleString MockExpectedCallsList::fulfilledCallsToString(const SimpleString& linePrefix) const
 {
-    SimpleString str;
+    SimpleStringBuilder str;
 
     for (MockExpectedCallsListNode* p = head_; p; p = p->next_)
         if (p->expectedCall_->isFulfilled())
-            str = appendStringOnANewLine(str, linePrefix, p->expectedCall_->callToString());
+            appendStringOnANewLine(str, linePrefix, p->expectedCall_->callToString());
 
     return stringOrNoneTextWhenEmpty(str, linePrefix);
 }
@@ -347,11 +347,12 @@ SimpleString MockExpectedCallsList::fulfilledCallsToString(const SimpleString& l
 SimpleString MockExpectedCallsList::callsWithMissingParametersToString(const SimpleString& linePrefix, 
                                                                        const SimpleString& missingParametersPrefix) const
 {
-    SimpleString str;
+    SimpleStringBuilder str;
+    SimpleString missingParametersLinePrefix = linePrefix + missingParametersPrefix;
     for (MockExpectedCallsListNode* p = head_; p; p = p->next_)
     {
-        str = appendStringOnANewLine(str, linePrefix, p->expectedCall_->callToString());
-        str = appendStringOnANewLine(str, linePrefix + missingParametersPrefix, p->expectedCall_->missingParametersToString());
+        appendStringOnANewLine(str, linePrefix, p->expectedCall_->callToString());
+        appendStringOnANewLine(str, missingParametersLinePrefix, p->expectedCall_->missingParametersToString());
     }
 
     return stringOrNoneTextWhenEmpty(str, linePrefix);
@@ -28,6 +28,7 @@
 #include "CppUTest/TestHarness.h"
 #include "CppUTestExt/MockFailure.h"
 #include "CppUTestExt/MockExpectedCall.h"
+#include "CppUTestExt/MockCheckedExpectedCall.h"
 #include "CppUTestExt/MockExpectedCallsList.h"
 #include "CppUTestExt/MockNamedValue.h"
 
@@ -71,10 +72,13 @@ MockFailure::MockFailure(UtestShell* test) : TestFailure(test, "Test failed with
 
 void MockFailure::addExpectationsAndCallHistory(const MockExpectedCallsList& expectations)
 {
-    message_ += "\tEXPECTED calls that WERE NOT fulfilled:\n";
-    message_ += expectations.unfulfilledCallsToString("\t\t");
-    message_ += "\n\tEXPECTED calls that WERE fulfilled:\n";
-    message_ += expectations.fulfilledCallsToString("\t\t");
+    SimpleStringBuilder message;
+    message.append(message_);
+    message.append("\tEXPECTED calls that WERE NOT fulfilled:\n");
+    message.append(expectations.unfulfilledCallsToString("\t\t"));
+    message.append("\n\tEXPECTED calls that WERE fulfilled:\n");
+    message.append(expectations.fulfilledCallsToString("\t\t"));
+    message_ = message.toString();
 }
 
 void MockFailure::addExpectationsAndCallHistoryRelatedTo(const SimpleString& name, const MockExpectedCallsList& expectations)
@@ -82,17 +86,20 @@ void MockFailure::addExpectationsAndCallHistoryRelatedTo(const SimpleString& nam
     MockExpectedCallsList expectationsForFunction;
     expectationsForFunction.addExpectationsRelatedTo(name, expectations);
 
-    message_ += "\tEXPECTED calls that WERE NOT fulfilled related to function: ";
-    message_ += name;
-    message_ += "\n";
+    SimpleStringBuilder message;
+    message.append(message_);
+    message.append("\tEXPECTED calls that WERE NOT fulfilled related to function: ");
+    message.append(name);
+    message.append("\n");
 
-    message_ += expectationsForFunction.unfulfilledCallsToString("\t\t");
+    message.append(expectationsForFunction.unfulfilledCallsToString("\t\t"));
 
-    message_ += "\n\tEXPECTED calls that WERE fulfilled related to function: ";
-    message_ += name;
-    message_ += "\n";
+    message.append("\n\tEXPECTED calls that WERE fulfilled related to function: ");
+    message.append(name);
+    message.append("\n");
 
-    message_ += expectationsForFunction.fulfilledCallsToString("\t\t");
+    message.append(expectationsForFunction.fulfilledCallsToString("\t\t"));
+    message_ = message.toString();
 }
 
 MockExpectedCallsDidntHappenFailure::MockExpectedCallsDidntHappenFailure(UtestShell* test, const MockExpectedCallsList& expectations) : MockFailure(test)
@@ -162,6 +169,15 @@ MockUnexpectedInputParameterFailure::MockUnexpectedInputParameterFailure(UtestSh
     message_ += ": <";
     message_ += StringFrom(parameter);
     message_ += ">";
+
+    MockCheckedExpectedCall* firstExpectation = expectationsForFunctionWithParameterName.getFirstExpectation();
+    if (firstExpectation && parameter.getType() == "const char*" && firstExpectation->getInputParameterType(parameter.getName()) == "const char*") {
+        const char* expectedValue = firstExpectation->getInputParameter(parameter.getName()).getStringValue();
+        if (isLongString(expectedValue) || isLongString(parameter.getStringValue())) {
+            message_ += "\n\tDIFFERENCE to the first expected call:\n\t\t";
+            message_ += createStringDifferenceString(expectedValue, parameter.getStringValue());
+        }
+    }
 }
 
 MockUnexpectedOutputParameterFailure::MockUnexpectedOutputParameterFailure(UtestShell* test, const SimpleString& functionName, const MockNamedValue& parameter, const MockExpectedCallsList& expectations)  : MockFailure(test)
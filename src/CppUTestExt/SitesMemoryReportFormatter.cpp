@@ -0,0 +1,373 @@
+/*
+ * Copyright (c) 2007, Michael Feathers, James Grenning and Bas Vodde
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE EARLIER MENTIONED AUTHORS ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <copyright holder> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTest/PlatformSpecificFunctions.h"
+#include "CppUTestExt/SitesMemoryReportFormatter.h"
+
+static const size_t initialHashSize = 256;
+static const char* const unknownFile = "<unknown>";
+static const size_t noSite = (size_t) -1;
+
+static size_t hashOfSite(const char* file, size_t line)
+{
+    size_t address = (size_t) file;
+    return (address >> 4) ^ (address >> 16) ^ (line * 2654435761u);
+}
+
+static size_t hashOfMemory(const char* memory)
+{
+    size_t address = (size_t) memory;
+    return (address >> 4) ^ (address >> 16);
+}
+
+SitesMemoryReportFormatter::SitesMemoryReportFormatter(size_t topSites)
+    : topSites_(topSites), allocationNumber_(0), currentGroup_(0), currentTest_(0), test_(NULLPTR),
+      outOfMemory_(false), warnedAboutMemory_(false), sites_(NULLPTR), numberOfSites_(0), siteHashSize_(initialHashSize), liveSize_(initialHashSize), numberOfLive_(0)
+{
+    siteHash_ = (size_t*) PlatformSpecificMalloc(siteHashSize_ * sizeof(size_t));
+    sites_ = (MemoryAllocationSite*) PlatformSpecificMalloc(siteHashSize_ / 2 * sizeof(MemoryAllocationSite));
+    live_ = (LiveAllocation*) PlatformSpecificMalloc(liveSize_ * sizeof(LiveAllocation));
+
+    if (siteHash_ == NULLPTR || sites_ == NULLPTR || live_ == NULLPTR) {
+        PlatformSpecificFree(siteHash_);
+        PlatformSpecificFree(sites_);
+        PlatformSpecificFree(live_);
+        siteHash_ = NULLPTR;
+        sites_ = NULLPTR;
+        live_ = NULLPTR;
+        outOfMemory_ = true;
+        return;
+    }
+
+    PlatformSpecificMemset(siteHash_, 0, siteHashSize_ * sizeof(size_t));
+    PlatformSpecificMemset(live_, 0, liveSize_ * sizeof(LiveAllocation));
+}
+
+SitesMemoryReportFormatter::~SitesMemoryReportFormatter()
+{
+    PlatformSpecificFree(siteHash_);
+    PlatformSpecificFree(sites_);
+    PlatformSpecificFree(live_);
+}
+
+/* The sites stay, so they keep their place in the order of appearance, but their counts start over */
+void SitesMemoryReportFormatter::report_testrun_start(TestResult*)
+{
+    for (size_t i = 0; i < numberOfSites_; i++) {
+        MemoryAllocationSite& site = sites_[i];
+        site.allocations_ = 0;
+        site.bytes_ = 0;
+        site.frees_ = 0;
+        site.lifetimes_ = 0;
+        site.busiestTest_ = NULLPTR;
+        site.busiestTestAllocations_ = 0;
+    }
+}
+
+void SitesMemoryReportFormatter::report_testrun_end(TestResult* result)
+{
+    printTopSites(result, "the test run", false);
+}
+
+void SitesMemoryReportFormatter::report_testgroup_start(TestResult*, UtestShell&)
+{
+    currentGroup_++;
+}
+
+void SitesMemoryReportFormatter::report_testgroup_end(TestResult* result, UtestShell& test)
+{
+    printTopSites(result, StringFromFormat("TEST_GROUP(%s)", test.getGroup().asCharString()), true);
+}
+
+void SitesMemoryReportFormatter::report_test_start(TestResult*, UtestShell& test)
+{
+    currentTest_++;
+    test_ = &test;
+}
+
+void SitesMemoryReportFormatter::report_alloc_memory(TestResult* result, TestMemoryAllocator*, size_t size, char* memory, const char* file, size_t line)
+{
+    if (memory == NULLPTR) return;
+
+    allocationNumber_++;
+    size_t index = (outOfMemory_) ? noSite : siteOf(file, line);
+    if (index == noSite || !addLive(memory, index)) {
+        warnOnceAboutMemory(result);
+        return;
+    }
+
+    MemoryAllocationSite& site = sites_[index];
+    touch(site);
+
+    site.allocations_++;
+    site.bytes_ += size;
+    site.groupAllocations_++;
+    site.groupBytes_ += size;
+    if (++site.testAllocations_ > site.busiestTestAllocations_) {
+        site.busiestTestAllocations_ = site.testAllocations_;
+        site.busiestTest_ = test_;
+    }
+}
+
+void SitesMemoryReportFormatter::report_free_memory(TestResult*, TestMemoryAllocator*, char* memory, const char*, size_t)
+{
+    if (live_ == NULLPTR) return;
+
+    size_t index = findLive(memory);
+    if (live_[index].memory_ == NULLPTR) return;
+
+    size_t lifetime = allocationNumber_ - live_[index].allocationNumber_;
+    MemoryAllocationSite& site = sites_[live_[index].site_];
+    touch(site);
+
+    site.frees_++;
+    site.lifetimes_ += lifetime;
+    site.groupFrees_++;
+    site.groupLifetimes_ += lifetime;
+
+    removeLiveAt(index);
+}
+
+size_t SitesMemoryReportFormatter::numberOfSites() const
+{
+    return numberOfSites_;
+}
+
+const MemoryAllocationSite* SitesMemoryReportFormatter::findSite(const char* file, size_t line) const
+{
+    if (siteHash_ == NULLPTR) return NULLPTR;
+
+    size_t index = siteHash_[findSiteIndex(file, line)];
+    return (index == 0) ? NULLPTR : &sites_[index - 1];
+}
+
+size_t SitesMemoryReportFormatter::findSiteIndex(const char* file, size_t line) const
+{
+    size_t mask = siteHashSize_ - 1;
+    size_t index = hashOfSite(file, line) & mask;
+    while (siteHash_[index] != 0) {
+        const MemoryAllocationSite& site = sites_[siteHash_[index] - 1];
+        if (site.file_ == file && site.line_ == line) break;
+        index = (index + 1) & mask;
+    }
+    return index;
+}
+
+size_t SitesMemoryReportFormatter::siteOf(const char* file, size_t line)
+{
+    if (file == NULLPTR) file = unknownFile;
+
+    size_t index = findSiteIndex(file, line);
+    if (siteHash_[index] != 0)
+        return siteHash_[index] - 1;
+
+    if (2 * (numberOfSites_ + 1) > siteHashSize_) {
+        if (!growSites()) return noSite;
+        index = findSiteIndex(file, line);
+    }
+
+    MemoryAllocationSite& site = sites_[numberOfSites_];
+    PlatformSpecificMemset(&site, 0, sizeof(MemoryAllocationSite));
+    site.file_ = file;
+    site.line_ = line;
+    site.group_ = currentGroup_;
+    site.test_ = currentTest_;
+    siteHash_[index] = ++numberOfSites_;
+    return numberOfSites_ - 1;
+}
+
+/* The old tables stay as they are when the new ones can't be allocated, so what was collected can still be printed */
+bool SitesMemoryReportFormatter::growSites()
+{
+    size_t* newHash = (size_t*) PlatformSpecificMalloc(siteHashSize_ * 2 * sizeof(size_t));
+    MemoryAllocationSite* newSites = (newHash) ? (MemoryAllocationSite*) PlatformSpecificRealloc(sites_, siteHashSize_ * sizeof(MemoryAllocationSite)) : NULLPTR;
+    if (newSites == NULLPTR) {
+        PlatformSpecificFree(newHash);
+        outOfMemory_ = true;
+        return false;
+    }
+
+    PlatformSpecificFree(siteHash_);
+    siteHash_ = newHash;
+    sites_ = newSites;
+    siteHashSize_ *= 2;
+    PlatformSpecificMemset(siteHash_, 0, siteHashSize_ * sizeof(size_t));
+
+    for (size_t i = 0; i < numberOfSites_; i++)
+        siteHash_[findSiteIndex(sites_[i].file_, sites_[i].line_)] = i + 1;
+    return true;
+}
+
+size_t SitesMemoryReportFormatter::findLive(char* memory) const
+{
+    size_t mask = liveSize_ - 1;
+    size_t index = hashOfMemory(memory) & mask;
+    while (live_[index].memory_ != NULLPTR && live_[index].memory_ != memory)
+        index = (index + 1) & mask;
+    return index;
+}
+
+bool SitesMemoryReportFormatter::addLive(char* memory, size_t site)
+{
+    if (2 * (numberOfLive_ + 1) > liveSize_ && !growLive())
+        return false;
+
+    size_t index = findLive(memory);
+    if (live_[index].memory_ == NULLPTR)
+        numberOfLive_++;
+
+    live_[index].memory_ = memory;
+    live_[index].site_ = site;
+    live_[index].allocationNumber_ = allocationNumber_;
+    return true;
+}
+
+bool SitesMemoryReportFormatter::growLive()
+{
+    LiveAllocation* grown = (LiveAllocation*) PlatformSpecificMalloc(liveSize_ * 2 * sizeof(LiveAllocation));
+    if (grown == NULLPTR) {
+        outOfMemory_ = true;
+        return false;
+    }
+
+    LiveAllocation* old = live_;
+    size_t oldSize = liveSize_;
+
+    live_ = grown;
+    liveSize_ *= 2;
+    PlatformSpecificMemset(live_, 0, liveSize_ * sizeof(LiveAllocation));
+
+    for (size_t i = 0; i < oldSize; i++)
+        if (old[i].memory_ != NULLPTR)
+            live_[findLive(old[i].memory_)] = old[i];
+    PlatformSpecificFree(old);
+    return true;
+}
+
+void SitesMemoryReportFormatter::warnOnceAboutMemory(TestResult* result)
+{
+    if (warnedAboutMemory_) return;
+
+    result->print("Could not allocate memory for the allocation sites, the allocations from here on are not counted\n");
+    warnedAboutMemory_ = true;
+}
+
+/* Linear probing without tombstones, entries after the removed one move back when their probe sequence allows */
+void SitesMemoryReportFormatter::removeLiveAt(size_t index)
+{
+    size_t mask = liveSize_ - 1;
+    size_t next = index;
+    numberOfLive_--;
+
+    for (;;) {
+        live_[index].memory_ = NULLPTR;
+        for (;;) {
+            next = (next + 1) & mask;
+            if (live_[next].memory_ == NULLPTR) return;
+
+            size_t home = hashOfMemory(live_[next].memory_) & mask;
+            bool homeBetween = (index <= next) ? (index < home && home <= next) : (index < home || home <= next);
+            if (!homeBetween) break;
+        }
+        live_[index] = live_[next];
+        index = next;
+    }
+}
+
+void SitesMemoryReportFormatter::touch(MemoryAllocationSite& site)
+{
+    if (site.group_ != currentGroup_) {
+        site.group_ = currentGroup_;
+        site.groupAllocations_ = 0;
+        site.groupBytes_ = 0;
+        site.groupFrees_ = 0;
+        site.groupLifetimes_ = 0;
+    }
+    if (site.test_ != currentTest_) {
+        site.test_ = currentTest_;
+        site.testAllocations_ = 0;
+    }
+}
+
+size_t SitesMemoryReportFormatter::allocationsOf(const MemoryAllocationSite& site, bool groupOnly) const
+{
+    if (!groupOnly) return site.allocations_;
+    return (site.group_ == currentGroup_) ? site.groupAllocations_ : 0;
+}
+
+static SimpleString averageLifetime(size_t lifetimes, size_t frees)
+{
+    if (frees == 0) return "-";
+    return StringFromFormat("%.1f", (double) lifetimes / (double) frees);
+}
+
+void SitesMemoryReportFormatter::printTopSites(TestResult* result, const SimpleString& title, bool groupOnly)
+{
+    size_t* top = (size_t*) PlatformSpecificMalloc((topSites_ + 1) * sizeof(size_t));
+    if (top == NULLPTR) {
+        result->print(StringFromFormat("\nCould not allocate memory to print the allocation sites of %s\n", title.asCharString()).asCharString());
+        return;
+    }
+
+    size_t numberOfTop = 0;
+    size_t sitesWithAllocations = 0;
+
+    for (size_t i = 0; i < numberOfSites_; i++) {
+        size_t allocations = allocationsOf(sites_[i], groupOnly);
+        if (allocations == 0) continue;
+        sitesWithAllocations++;
+
+        size_t position = numberOfTop;
+        while (position > 0 && allocationsOf(sites_[top[position - 1]], groupOnly) < allocations) {
+            top[position] = top[position - 1];
+            position--;
+        }
+        top[position] = i;
+        if (numberOfTop < topSites_) numberOfTop++;
+    }
+
+    if (numberOfTop > 0) {
+        result->print(StringFromFormat("\nAllocation sites of %s, top %d of %d:\n", title.asCharString(), (int) numberOfTop, (int) sitesWithAllocations).asCharString());
+        result->print("    allocs        bytes  lifetime  site\n");
+    }
+
+    for (size_t i = 0; i < numberOfTop; i++) {
+        const MemoryAllocationSite& site = sites_[top[i]];
+        SimpleString line;
+        if (groupOnly)
+            line = StringFromFormat("%10lu %12lu %9s  %s:%d\n", (unsigned long) site.groupAllocations_, (unsigned long) site.groupBytes_,
+                                    averageLifetime(site.groupLifetimes_, site.groupFrees_).asCharString(), site.file_, (int) site.line_);
+        else
+            line = StringFromFormat("%10lu %12lu %9s  %s:%d  busiest %s with %lu\n", (unsigned long) site.allocations_, (unsigned long) site.bytes_,
+                                    averageLifetime(site.lifetimes_, site.frees_).asCharString(), site.file_, (int) site.line_,
+                                    (site.busiestTest_) ? site.busiestTest_->getFormattedName().asCharString() : "?", (unsigned long) site.busiestTestAllocations_);
+        result->print(line.asCharString());
+    }
+
+    PlatformSpecificFree(top);
+}
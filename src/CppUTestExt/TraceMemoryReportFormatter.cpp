@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) 2007, Michael Feathers, James Grenning and Bas Vodde
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE EARLIER MENTIONED AUTHORS ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <copyright holder> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTest/PlatformSpecificFunctions.h"
+#include "CppUTestExt/TraceMemoryReportFormatter.h"
+
+static const char memoryTraceMagic[8] = { 'C', 'P', 'P', 'U', 'T', 'R', 'C', '\0' };
+static char noStrings[] = "";
+
+static size_t roundUpToWord(size_t size)
+{
+    return (size + sizeof(size_t) - 1) / sizeof(size_t) * sizeof(size_t);
+}
+
+TraceMemoryReportFormatter::TraceMemoryReportFormatter(const char* filename, size_t capacity, size_t stringTableSize)
+    : filename_(filename), trace_(NULLPTR), traceSize_(0), mappedToFile_(true), warnedAboutMapping_(false), stringTableFull_(false),
+      warnedAboutStringTable_(false), warnedAboutNotTracing_(false), startTime_(GetPlatformSpecificTimeInMicros()), currentTest_(0)
+{
+    if (capacity == 0) capacity = 1;
+    if (stringTableSize < 2) stringTableSize = 2;
+
+    size_t stringsOffset = roundUpToWord(sizeof(MemoryTraceHeader));
+    size_t recordsOffset = roundUpToWord(stringsOffset + stringTableSize);
+    traceSize_ = recordsOffset + capacity * sizeof(MemoryTraceRecord);
+
+    trace_ = (char*) PlatformSpecificMapFile(filename, &traceSize_, 1);
+    if (trace_ == NULLPTR) {
+        mappedToFile_ = false;
+        trace_ = (char*) PlatformSpecificMalloc(traceSize_);
+    }
+    nameCache_ = (NameCacheEntry*) PlatformSpecificMalloc(NAME_CACHE_SIZE * sizeof(NameCacheEntry));
+
+    PlatformSpecificMemset(&emptyHeader_, 0, sizeof(MemoryTraceHeader));
+    if (trace_ == NULLPTR || nameCache_ == NULLPTR) {
+        releaseTrace();
+        header_ = &emptyHeader_;
+        strings_ = noStrings;
+        records_ = NULLPTR;
+        return;
+    }
+
+    header_ = (MemoryTraceHeader*) (void*) trace_;
+    strings_ = trace_ + stringsOffset;
+    records_ = (MemoryTraceRecord*) (void*) (trace_ + recordsOffset);
+
+    PlatformSpecificMemset(header_, 0, sizeof(MemoryTraceHeader));
+    PlatformSpecificMemCpy(header_->magic_, memoryTraceMagic, sizeof(memoryTraceMagic));
+    header_->version_ = 1;
+    header_->byteOrder_ = 0x01020304;
+    header_->wordSize_ = (unsigned) sizeof(size_t);
+    header_->recordSize_ = (unsigned) sizeof(MemoryTraceRecord);
+    header_->stringTableSize_ = stringTableSize;
+    header_->capacity_ = capacity;
+
+    addString("?");
+
+    PlatformSpecificMemset(nameCache_, 0, NAME_CACHE_SIZE * sizeof(NameCacheEntry));
+}
+
+TraceMemoryReportFormatter::~TraceMemoryReportFormatter()
+{
+    releaseTrace();
+}
+
+void TraceMemoryReportFormatter::releaseTrace()
+{
+    if (nameCache_) PlatformSpecificFree(nameCache_);
+    if (trace_ && mappedToFile_)
+        PlatformSpecificUnmapPages(trace_, traceSize_);
+    else if (trace_)
+        PlatformSpecificFree(trace_);
+    nameCache_ = NULLPTR;
+    trace_ = NULLPTR;
+    mappedToFile_ = false;
+}
+
+unsigned TraceMemoryReportFormatter::addString(const char* str)
+{
+    size_t length = 0;
+    while (str[length]) length++;
+
+    if (header_->stringTableUsed_ + length + 1 > header_->stringTableSize_) {
+        stringTableFull_ = true;
+        return 0;
+    }
+
+    unsigned offset = (unsigned) header_->stringTableUsed_;
+    PlatformSpecificMemCpy(strings_ + offset, str, length + 1);
+    header_->stringTableUsed_ += length + 1;
+    return offset;
+}
+
+/* Returns the entry of the key or the empty entry where it goes, NULLPTR when the cache is full */
+TraceMemoryReportFormatter::NameCacheEntry* TraceMemoryReportFormatter::findNameCacheEntry(const void* key)
+{
+    size_t index = ((size_t) key >> 3) % NAME_CACHE_SIZE;
+    for (size_t probe = 0; probe < NAME_CACHE_SIZE; probe++) {
+        if (nameCache_[index].key_ == key || nameCache_[index].key_ == NULLPTR) return &nameCache_[index];
+        index = (index + 1) % NAME_CACHE_SIZE;
+    }
+    return NULLPTR;
+}
+
+/* Names that didn't fit in the string table aren't cached, so they are tried again */
+unsigned TraceMemoryReportFormatter::cacheName(NameCacheEntry* entry, const void* key, unsigned offset)
+{
+    if (entry && offset != 0) {
+        entry->key_ = key;
+        entry->offset_ = offset;
+    }
+    return offset;
+}
+
+/* File names are nearly always __FILE__ literals, so they are cached on their pointer */
+unsigned TraceMemoryReportFormatter::fileNameOffset(const char* file)
+{
+    if (file == NULLPTR) return 0;
+
+    NameCacheEntry* entry = findNameCacheEntry(file);
+    if (entry && entry->key_ == file) return entry->offset_;
+    return cacheName(entry, file, addString(file));
+}
+
+/* Tests are cached on their shell, so a repeated or many times run test is stored once */
+unsigned TraceMemoryReportFormatter::testNameOffset(UtestShell& test)
+{
+    NameCacheEntry* entry = findNameCacheEntry(&test);
+    if (entry && entry->key_ == &test) return entry->offset_;
+    return cacheName(entry, &test, addString(StringFromFormat("%s.%s", test.getGroup().asCharString(), test.getName().asCharString()).asCharString()));
+}
+
+void TraceMemoryReportFormatter::warnAboutFullStringTable(TestResult* result)
+{
+    if (!stringTableFull_ || warnedAboutStringTable_) return;
+
+    result->print(StringFromFormat("The memory trace string table of %lu bytes is full, later file and test names are traced as ?\n",
+            (unsigned long) header_->stringTableSize_).asCharString());
+    warnedAboutStringTable_ = true;
+}
+
+/* The trace and its name cache are allocated once, when that fails nothing is traced and that is only told once */
+bool TraceMemoryReportFormatter::warnWhenNotTracing(TestResult* result)
+{
+    if (isTracing()) return false;
+    if (warnedAboutNotTracing_) return true;
+
+    result->print(StringFromFormat("Could not allocate memory trace %s, memory is not traced\n", filename_.asCharString()).asCharString());
+    warnedAboutNotTracing_ = true;
+    return true;
+}
+
+void TraceMemoryReportFormatter::addRecord(unsigned kind, size_t address, size_t size, unsigned file, size_t line)
+{
+    MemoryTraceRecord& record = records_[header_->recordsWritten_ % header_->capacity_];
+    record.timestamp_ = (size_t) (GetPlatformSpecificTimeInMicros() - startTime_);
+    record.address_ = address;
+    record.size_ = size;
+    record.file_ = file;
+    record.line_ = (unsigned) line;
+    record.test_ = currentTest_;
+    record.kind_ = kind;
+    header_->recordsWritten_++;
+}
+
+void TraceMemoryReportFormatter::report_testgroup_start(TestResult* result, UtestShell&)
+{
+    if (warnWhenNotTracing(result) || mappedToFile_ || warnedAboutMapping_) return;
+
+    result->print(StringFromFormat("Could not map memory trace file %s, the trace is only kept in memory\n", filename_.asCharString()).asCharString());
+    warnedAboutMapping_ = true;
+}
+
+void TraceMemoryReportFormatter::report_test_start(TestResult* result, UtestShell& test)
+{
+    if (warnWhenNotTracing(result)) return;
+    currentTest_ = testNameOffset(test);
+    addRecord(memory_trace_test_start, 0, 0, 0, test.getLineNumber());
+    warnAboutFullStringTable(result);
+}
+
+void TraceMemoryReportFormatter::report_test_end(TestResult* result, UtestShell&)
+{
+    if (warnWhenNotTracing(result)) return;
+    addRecord(memory_trace_test_end, 0, 0, 0, 0);
+    currentTest_ = 0;
+}
+
+void TraceMemoryReportFormatter::report_alloc_memory(TestResult* result, TestMemoryAllocator*, size_t size, char* memory, const char* file, size_t line)
+{
+    if (warnWhenNotTracing(result)) return;
+    addRecord(memory_trace_alloc, (size_t) memory, size, fileNameOffset(file), line);
+    warnAboutFullStringTable(result);
+}
+
+void TraceMemoryReportFormatter::report_free_memory(TestResult* result, TestMemoryAllocator*, char* memory, const char* file, size_t line)
+{
+    if (warnWhenNotTracing(result)) return;
+    addRecord(memory_trace_free, (size_t) memory, 0, fileNameOffset(file), line);
+    warnAboutFullStringTable(result);
+}
+
+bool TraceMemoryReportFormatter::isMappedToFile() const
+{
+    return mappedToFile_;
+}
+
+bool TraceMemoryReportFormatter::isTracing() const
+{
+    return trace_ != NULLPTR;
+}
+
+const MemoryTraceHeader& TraceMemoryReportFormatter::header() const
+{
+    return *header_;
+}
+
+size_t TraceMemoryReportFormatter::numberOfRecords() const
+{
+    return (header_->recordsWritten_ < header_->capacity_) ? header_->recordsWritten_ : header_->capacity_;
+}
+
+/* Index 0 is the oldest record that is still in the ring */
+const MemoryTraceRecord& TraceMemoryReportFormatter::record(size_t index) const
+{
+    size_t oldest = header_->recordsWritten_ - numberOfRecords();
+    return records_[(oldest + index) % header_->capacity_];
+}
+
+const char* TraceMemoryReportFormatter::stringAt(unsigned offset) const
+{
+    return strings_ + offset;
+}
@@ -41,6 +41,7 @@
 #include <unistd.h>
 #include <sys/wait.h>
 #include <errno.h>
+#include <poll.h>
 #endif
 
 #include <time.h>
@@ -83,6 +84,16 @@ static int PlatformSpecificWaitPidImplementation(int, int*, int)
     return 0;
 }
 
+static int BorlandPlatformSpecificStartChildProcess(int (*)(void*), void*)
+{
+    return -1;
+}
+
+static int BorlandPlatformSpecificWaitForChildProcess(const int*, size_t, int*)
+{
+    return -1;
+}
+
 #else
 
 static void SetTestFailureByStatusCode(UtestShell* shell, TestResult* result, int status)
@@ -151,6 +162,119 @@ static pid_t PlatformSpecificWaitPidImplementation(int pid, int* status, int opt
     return waitpid(pid, status, options);
 }
 
+/*
+ * A child sends what the function returned through its own pipe, so a child that exits in the function is never taken
+ * for one that returned. The end of the pipe is also what tells the parent that one of the children it waits for ended.
+ */
+struct BorlandChildProcess
+{
+    pid_t pid_;
+    int channel_;
+};
+
+static BorlandChildProcess* childProcesses = NULLPTR;
+static size_t childProcessesSize = 0;
+
+static BorlandChildProcess* findBorlandChildProcess(int pid)
+{
+    for (size_t i = 0; i < childProcessesSize; i++)
+        if (childProcesses[i].pid_ == pid) return &childProcesses[i];
+    return NULLPTR;
+}
+
+static BorlandChildProcess* freeBorlandChildProcess()
+{
+    BorlandChildProcess* child = findBorlandChildProcess(0);
+    if (child != NULLPTR) return child;
+
+    size_t newSize = (childProcessesSize == 0) ? 8 : childProcessesSize * 2;
+    BorlandChildProcess* grown = (BorlandChildProcess*) realloc(childProcesses, newSize * sizeof(BorlandChildProcess));
+    if (grown == NULLPTR) return NULLPTR;
+    for (size_t i = childProcessesSize; i < newSize; i++)
+        grown[i].pid_ = 0;
+    child = &grown[childProcessesSize];
+    childProcesses = grown;
+    childProcessesSize = newSize;
+    return child;
+}
+
+static int BorlandPlatformSpecificStartChildProcess(int (*function)(void*), void* data)
+{
+    BorlandChildProcess* child = freeBorlandChildProcess();
+    int channel[2];
+    if (child == NULLPTR || pipe(channel) == -1) return -1;
+
+    pid_t cpid = PlatformSpecificFork();
+    if (cpid == 0) {
+        close(channel[0]); // LCOV_EXCL_LINE
+        int result = function(data); // LCOV_EXCL_LINE
+        _exit(write(channel[1], &result, sizeof(result)) == (ssize_t) sizeof(result) ? 0 : 1); // LCOV_EXCL_LINE
+    }
+    close(channel[1]);
+
+    if (cpid == -1) {
+        close(channel[0]);
+        return -1;
+    }
+    child->pid_ = cpid;
+    child->channel_ = channel[0];
+    return cpid;
+}
+
+static int BorlandPlatformSpecificWaitForChildProcess(const int* children, size_t count, int* result)
+{
+    struct pollfd* polled = (struct pollfd*) malloc(count * sizeof(struct pollfd));
+    if (polled == NULLPTR) return -1;
+
+    nfds_t polledCount = 0;
+    for (size_t i = 0; i < count; i++) {
+        BorlandChildProcess* child = (children[i] > 0) ? findBorlandChildProcess(children[i]) : NULLPTR;
+        if (child == NULLPTR) continue;
+        polled[polledCount].fd = child->channel_;
+        polled[polledCount].events = POLLIN;
+        polled[polledCount].revents = 0;
+        polledCount++;
+    }
+
+    int ready;
+    do {
+        ready = (polledCount == 0) ? -1 : poll(polled, polledCount, -1);
+    } while (ready == -1 && errno == EINTR);
+
+    int channel = -1;
+    for (nfds_t i = 0; ready > 0 && channel == -1 && i < polledCount; i++)
+        if (polled[i].revents != 0) channel = polled[i].fd;
+    free(polled);
+    if (channel == -1) return -1;
+
+    BorlandChildProcess* child = NULLPTR;
+    for (size_t i = 0; i < childProcessesSize && child == NULLPTR; i++)
+        if (childProcesses[i].pid_ != 0 && childProcesses[i].channel_ == channel) child = &childProcesses[i];
+
+    int returned = 0;
+    ssize_t received;
+    do {
+        received = read(channel, &returned, sizeof(returned));
+    } while (received == -1 && errno == EINTR);
+    close(channel);
+
+    pid_t pid = child->pid_;
+    child->pid_ = 0;
+
+    int status = 0;
+    pid_t w;
+    do {
+        w = PlatformSpecificWaitPid(pid, &status, 0);
+    } while (w == -1 && errno == EINTR);
+    if (w == -1) return -1;
+
+    if (received == (ssize_t) sizeof(returned))
+        *result = returned;
+    else
+        *result = WIFSIGNALED(status) ? -WTERMSIG(status) : WEXITSTATUS(status);
+    return w;
+}
+
 #endif
 
 TestOutput::WorkingEnvironment PlatformSpecificGetWorkingEnvironment()
@@ -162,6 +286,8 @@ void (*PlatformSpecificRunTestInASeperateProcess)(UtestShell* shell, TestPlugin*
         BorlandPlatformSpecificRunTestInASeperateProcess;
 int (*PlatformSpecificFork)(void) = PlatformSpecificForkImplementation;
 int (*PlatformSpecificWaitPid)(int, int*, int) = PlatformSpecificWaitPidImplementation;
+int (*PlatformSpecificStartChildProcess)(int (*)(void*), void*) = BorlandPlatformSpecificStartChildProcess;
+int (*PlatformSpecificWaitForChildProcess)(const int*, size_t, int*) = BorlandPlatformSpecificWaitForChildProcess;
 
 extern "C" {
 
@@ -216,6 +342,13 @@ static const char* TimeStringImplementation()
 unsigned long (*GetPlatformSpecificTimeInMillis)() = TimeInMillisImplementation;
 const char* (*GetPlatformSpecificTimeString)() = TimeStringImplementation;
 
+static unsigned long TimeInMicrosImplementation()
+{
+    return TimeInMillisImplementation() * 1000;
+}
+
+unsigned long (*GetPlatformSpecificTimeInMicros)() = TimeInMicrosImplementation;
+
 static int BorlandVSNprintf(char *str, size_t size, const char* format, va_list args)
 {
     int result = vsnprintf( str, size, format, args);
@@ -235,6 +368,16 @@ static void PlatformSpecificFPutsImplementation(const char* str, PlatformSpecifi
    fputs(str, (FILE*)file);
 }
 
+static size_t PlatformSpecificFReadImplementation(void* buffer, size_t size, PlatformSpecificFile file)
+{
+   return fread(buffer, 1, size, (FILE*)file);
+}
+
+static size_t PlatformSpecificFWriteImplementation(const void* buffer, size_t size, PlatformSpecificFile file)
+{
+   return fwrite(buffer, 1, size, (FILE*)file);
+}
+
 static void PlatformSpecificFCloseImplementation(PlatformSpecificFile file)
 {
    fclose((FILE*)file);
@@ -248,6 +391,8 @@ static void PlatformSpecificFlushImplementation()
 PlatformSpecificFile PlatformSpecificStdOut = stdout;
 PlatformSpecificFile (*PlatformSpecificFOpen)(const char*, const char*) = PlatformSpecificFOpenImplementation;
 void (*PlatformSpecificFPuts)(const char*, PlatformSpecificFile) = PlatformSpecificFPutsImplementation;
+size_t (*PlatformSpecificFRead)(void*, size_t, PlatformSpecificFile) = PlatformSpecificFReadImplementation;
+size_t (*PlatformSpecificFWrite)(const void*, size_t, PlatformSpecificFile) = PlatformSpecificFWriteImplementation;
 void (*PlatformSpecificFClose)(PlatformSpecificFile) = PlatformSpecificFCloseImplementation;
 
 void (*PlatformSpecificFlush)() = PlatformSpecificFlushImplementation;
@@ -329,4 +474,43 @@ void (*PlatformSpecificMutexUnlock)(PlatformSpecificMutex) = PThreadMutexUnlock;
 void (*PlatformSpecificMutexDestroy)(PlatformSpecificMutex) = PThreadMutexDestroy;
 void (*PlatformSpecificAbort)(void) = abort;
 
+static int DummyBacktrace(void**, int)
+{
+    return 0;
+}
+
+static void DummySymbolize(void*, char* name, size_t size)
+{
+    if (size > 0) name[0] = '\0';
+}
+
+int (*PlatformSpecificBacktrace)(void**, int) = DummyBacktrace;
+void (*PlatformSpecificSymbolize)(void*, char*, size_t) = DummySymbolize;
+
+static size_t DummyPageSize(void)
+{
+    return 0;
+}
+
+static void* DummyMapPages(size_t)
+{
+    return NULLPTR;
+}
+
+static void* DummyMapFile(const char*, size_t*, int)
+{
+    return NULLPTR;
+}
+
+static void DummyPageOperation(void*, size_t)
+{
+}
+
+size_t (*PlatformSpecificPageSize)(void) = DummyPageSize;
+void* (*PlatformSpecificMapPages)(size_t) = DummyMapPages;
+void (*PlatformSpecificProtectPages)(void*, size_t) = DummyPageOperation;
+void (*PlatformSpecificUnmapPages)(void*, size_t) = DummyPageOperation;
+void (*PlatformSpecificAdviseHugePages)(void*, size_t) = DummyPageOperation;
+void* (*PlatformSpecificMapFile)(const char*, size_t*, int) = DummyMapFile;
+
 }
@@ -69,8 +69,20 @@ static void C2000RunTestInASeperateProcess(UtestShell* shell, TestPlugin* plugin
     result->addFailure(TestFailure(shell, "-p doesn't work on this platform, as it is lacking fork.\b"));
 }
 
+static int C2000StartChildProcess(int (*)(void*), void*)
+{
+    return -1;
+}
+
+static int C2000WaitForChildProcess(const int*, size_t, int*)
+{
+    return -1;
+}
+
 void (*PlatformSpecificRunTestInASeperateProcess)(UtestShell*, TestPlugin*, TestResult*) =
     C2000RunTestInASeperateProcess;
+int (*PlatformSpecificStartChildProcess)(int (*)(void*), void*) = C2000StartChildProcess;
+int (*PlatformSpecificWaitForChildProcess)(const int*, size_t, int*) = C2000WaitForChildProcess;
 
 extern "C" {
 
@@ -126,6 +138,13 @@ static const char* TimeStringImplementation()
 unsigned long (*GetPlatformSpecificTimeInMillis)() = C2000TimeInMillis;
 const char* (*GetPlatformSpecificTimeString)() = TimeStringImplementation;
 
+static unsigned long C2000TimeInMicros()
+{
+    return C2000TimeInMillis() * 1000;
+}
+
+unsigned long (*GetPlatformSpecificTimeInMicros)() = C2000TimeInMicros;
+
 extern int vsnprintf(char*, size_t, const char*, va_list); // not std::vsnprintf()
 
 extern int (*PlatformSpecificVSNprintf)(char *, size_t, const char*, va_list) = vsnprintf;
@@ -150,6 +169,16 @@ static void C2000FPuts(const char* str, PlatformSpecificFile file)
     }
 }
 
+static size_t C2000FRead(void* buffer, size_t size, PlatformSpecificFile file)
+{
+   return fread(buffer, 1, size, (FILE*)file);
+}
+
+static size_t C2000FWrite(const void* buffer, size_t size, PlatformSpecificFile file)
+{
+   return fwrite(buffer, 1, size, (FILE*)file);
+}
+
 static void C2000FClose(PlatformSpecificFile file)
 {
    fclose((FILE*)file);
@@ -158,6 +187,8 @@ static void C2000FClose(PlatformSpecificFile file)
 PlatformSpecificFile PlatformSpecificStdOut = stdout;
 PlatformSpecificFile (*PlatformSpecificFOpen)(const char* filename, const char* flag) = C2000FOpen;
 void (*PlatformSpecificFPuts)(const char* str, PlatformSpecificFile file) = C2000FPuts;
+size_t (*PlatformSpecificFRead)(void* buffer, size_t size, PlatformSpecificFile file) = C2000FRead;
+size_t (*PlatformSpecificFWrite)(const void* buffer, size_t size, PlatformSpecificFile file) = C2000FWrite;
 void (*PlatformSpecificFClose)(PlatformSpecificFile file) = C2000FClose;
 
 static void CL2000Flush()
@@ -247,4 +278,43 @@ void (*PlatformSpecificMutexUnlock)(PlatformSpecificMutex) = DummyMutexUnlock;
 void (*PlatformSpecificMutexDestroy)(PlatformSpecificMutex) = DummyMutexDestroy;
 void (*PlatformSpecificAbort)(void) = abort;
 
+static int DummyBacktrace(void**, int)
+{
+    return 0;
+}
+
+static void DummySymbolize(void*, char* name, size_t size)
+{
+    if (size > 0) name[0] = '\0';
+}
+
+int (*PlatformSpecificBacktrace)(void**, int) = DummyBacktrace;
+void (*PlatformSpecificSymbolize)(void*, char*, size_t) = DummySymbolize;
+
+static size_t DummyPageSize(void)
+{
+    return 0;
+}
+
+static void* DummyMapPages(size_t)
+{
+    return NULLPTR;
+}
+
+static void* DummyMapFile(const char*, size_t*, int)
+{
+    return NULLPTR;
+}
+
+static void DummyPageOperation(void*, size_t)
+{
+}
+
+size_t (*PlatformSpecificPageSize)(void) = DummyPageSize;
+void* (*PlatformSpecificMapPages)(size_t) = DummyMapPages;
+void (*PlatformSpecificProtectPages)(void*, size_t) = DummyPageOperation;
+void (*PlatformSpecificUnmapPages)(void*, size_t) = DummyPageOperation;
+void (*PlatformSpecificAdviseHugePages)(void*, size_t) = DummyPageOperation;
+void* (*PlatformSpecificMapFile)(const char*, size_t*, int) = DummyMapFile;
+
 }
@@ -72,9 +72,21 @@ static int DummyPlatformSpecificWaitPid(int, int*, int)
     return 0;
 }
 
+static int DummyPlatformSpecificStartChildProcess(int (*)(void*), void*)
+{
+    return -1;
+}
+
+static int DummyPlatformSpecificWaitForChildProcess(const int*, size_t, int*)
+{
+    return -1;
+}
+
 void (*PlatformSpecificRunTestInASeperateProcess)(UtestShell*, TestPlugin*, TestResult*) = DummyRunTestInASeperateProcess;
 int (*PlatformSpecificFork)() = DummyPlatformSpecificFork;
 int (*PlatformSpecificWaitPid)(int, int*, int) = DummyPlatformSpecificWaitPid;
+int (*PlatformSpecificStartChildProcess)(int (*)(void*), void*) = DummyPlatformSpecificStartChildProcess;
+int (*PlatformSpecificWaitForChildProcess)(const int*, size_t, int*) = DummyPlatformSpecificWaitForChildProcess;
 
 extern "C" {
 
@@ -123,6 +135,13 @@ unsigned long (*GetPlatformSpecificTimeInMillis)() = DosTimeInMillis;
 const char* (*GetPlatformSpecificTimeString)() = DosTimeString;
 int (*PlatformSpecificVSNprintf)(char *, size_t, const char*, va_list) = DosVSNprintf;
 
+static unsigned long DosTimeInMicros()
+{
+    return DosTimeInMillis() * 1000;
+}
+
+unsigned long (*GetPlatformSpecificTimeInMicros)() = DosTimeInMicros;
+
 PlatformSpecificFile DosFOpen(const char* filename, const char* flag)
 {
     return fopen(filename, flag);
@@ -133,6 +152,16 @@ static void DosFPuts(const char* str, PlatformSpecificFile file)
    fputs(str, (FILE*)file);
 }
 
+static size_t DosFRead(void* buffer, size_t size, PlatformSpecificFile file)
+{
+   return fread(buffer, 1, size, (FILE*)file);
+}
+
+static size_t DosFWrite(const void* buffer, size_t size, PlatformSpecificFile file)
+{
+   return fwrite(buffer, 1, size, (FILE*)file);
+}
+
 static void DosFClose(PlatformSpecificFile file)
 {
    fclose((FILE*)file);
@@ -141,6 +170,8 @@ static void DosFClose(PlatformSpecificFile file)
 PlatformSpecificFile PlatformSpecificStdOut = stdout;
 PlatformSpecificFile (*PlatformSpecificFOpen)(const char* filename, const char* flag) = DosFOpen;
 void (*PlatformSpecificFPuts)(const char* str, PlatformSpecificFile file) = DosFPuts;
+size_t (*PlatformSpecificFRead)(void* buffer, size_t size, PlatformSpecificFile file) = DosFRead;
+size_t (*PlatformSpecificFWrite)(const void* buffer, size_t size, PlatformSpecificFile file) = DosFWrite;
 void (*PlatformSpecificFClose)(PlatformSpecificFile file) = DosFClose;
 
 static void DosFlush()
@@ -241,4 +272,43 @@ static void DosAbort()
 
 void (*PlatformSpecificAbort)(void) = DosAbort;
 
+static int DummyBacktrace(void**, int)
+{
+    return 0;
+}
+
+static void DummySymbolize(void*, char* name, size_t size)
+{
+    if (size > 0) name[0] = '\0';
+}
+
+int (*PlatformSpecificBacktrace)(void**, int) = DummyBacktrace;
+void (*PlatformSpecificSymbolize)(void*, char*, size_t) = DummySymbolize;
+
+static size_t DummyPageSize(void)
+{
+    return 0;
+}
+
+static void* DummyMapPages(size_t)
+{
+    return NULLPTR;
+}
+
+static void* DummyMapFile(const char*, size_t*, int)
+{
+    return NULLPTR;
+}
+
+static void DummyPageOperation(void*, size_t)
+{
+}
+
+size_t (*PlatformSpecificPageSize)(void) = DummyPageSize;
+void* (*PlatformSpecificMapPages)(size_t) = DummyMapPages;
+void (*PlatformSpecificProtectPages)(void*, size_t) = DummyPageOperation;
+void (*PlatformSpecificUnmapPages)(void*, size_t) = DummyPageOperation;
+void (*PlatformSpecificAdviseHugePages)(void*, size_t) = DummyPageOperation;
+void* (*PlatformSpecificMapFile)(const char*, size_t*, int) = DummyMapFile;
+
 }
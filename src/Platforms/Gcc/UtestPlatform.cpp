@@ -41,6 +41,7 @@
 #include <unistd.h>
 #include <sys/wait.h>
 #include <errno.h>
+#include <poll.h>
 #endif
 
 #include <time.h>
@@ -56,6 +57,17 @@
 #include <pthread.h>
 #endif
 
+#ifdef CPPUTEST_HAVE_BACKTRACE
+#include <execinfo.h>
+#endif
+
+#ifdef CPPUTEST_HAVE_MPROTECT
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 #include "CppUTest/PlatformSpecificFunctions.h"
 
 static jmp_buf test_exit_jmp_buf[10];
@@ -79,6 +91,16 @@ static int PlatformSpecificWaitPidImplementation(int, int*, int)
     return 0;
 }
 
+static int GccPlatformSpecificStartChildProcess(int (*)(void*), void*)
+{
+    return -1;
+}
+
+static int GccPlatformSpecificWaitForChildProcess(const int*, size_t, int*)
+{
+    return -1;
+}
+
 #else
 
 static void SetTestFailureByStatusCode(UtestShell* shell, TestResult* result, int status)
@@ -147,6 +169,119 @@ static pid_t PlatformSpecificWaitPidImplementation(int pid, int* status, int opt
     return waitpid(pid, status, options);
 }
 
+/*
+ * A child sends what the function returned through its own pipe, so a child that exits in the function is never taken
+ * for one that returned. The end of the pipe is also what tells the parent that one of the children it waits for ended.
+ */
+struct GccChildProcess
+{
+    pid_t pid_;
+    int channel_;
+};
+
+static GccChildProcess* childProcesses = NULLPTR;
+static size_t childProcessesSize = 0;
+
+static GccChildProcess* findGccChildProcess(int pid)
+{
+    for (size_t i = 0; i < childProcessesSize; i++)
+        if (childProcesses[i].pid_ == pid) return &childProcesses[i];
+    return NULLPTR;
+}
+
+static GccChildProcess* freeGccChildProcess()
+{
+    GccChildProcess* child = findGccChildProcess(0);
+    if (child != NULLPTR) return child;
+
+    size_t newSize = (childProcessesSize == 0) ? 8 : childProcessesSize * 2;
+    GccChildProcess* grown = (GccChildProcess*) realloc(childProcesses, newSize * sizeof(GccChildProcess));
+    if (grown == NULLPTR) return NULLPTR;
+    for (size_t i = childProcessesSize; i < newSize; i++)
+        grown[i].pid_ = 0;
+    child = &grown[childProcessesSize];
+    childProcesses = grown;
+    childProcessesSize = newSize;
+    return child;
+}
+
+static int GccPlatformSpecificStartChildProcess(int (*function)(void*), void* data)
+{
+    GccChildProcess* child = freeGccChildProcess();
+    int channel[2];
+    if (child == NULLPTR || pipe(channel) == -1) return -1;
+
+    pid_t cpid = PlatformSpecificFork();
+    if (cpid == 0) {
+        close(channel[0]); // LCOV_EXCL_LINE
+        int result = function(data); // LCOV_EXCL_LINE
+        _exit(write(channel[1], &result, sizeof(result)) == (ssize_t) sizeof(result) ? 0 : 1); // LCOV_EXCL_LINE
+    }
+    close(channel[1]);
+
+    if (cpid == -1) {
+        close(channel[0]);
+        return -1;
+    }
+    child->pid_ = cpid;
+    child->channel_ = channel[0];
+    return cpid;
+}
+
+static int GccPlatformSpecificWaitForChildProcess(const int* children, size_t count, int* result)
+{
+    struct pollfd* polled = (struct pollfd*) malloc(count * sizeof(struct pollfd));
+    if (polled == NULLPTR) return -1;
+
+    nfds_t polledCount = 0;
+    for (size_t i = 0; i < count; i++) {
+        GccChildProcess* child = (children[i] > 0) ? findGccChildProcess(children[i]) : NULLPTR;
+        if (child == NULLPTR) continue;
+        polled[polledCount].fd = child->channel_;
+        polled[polledCount].events = POLLIN;
+        polled[polledCount].revents = 0;
+        polledCount++;
+    }
+
+    int ready;
+    do {
+        ready = (polledCount == 0) ? -1 : poll(polled, polledCount, -1);
+    } while (ready == -1 && errno == EINTR);
+
+    int channel = -1;
+    for (nfds_t i = 0; ready > 0 && channel == -1 && i < polledCount; i++)
+        if (polled[i].revents != 0) channel = polled[i].fd;
+    free(polled);
+    if (channel == -1) return -1;
+
+    GccChildProcess* child = NULLPTR;
+    for (size_t i = 0; i < childProcessesSize && child == NULLPTR; i++)
+        if (childProcesses[i].pid_ != 0 && childProcesses[i].channel_ == channel) child = &childProcesses[i];
+
+    int returned = 0;
+    ssize_t received;
+    do {
+        received = read(channel, &returned, sizeof(returned));
+    } while (received == -1 && errno == EINTR);
+    close(channel);
+
+    pid_t pid = child->pid_;
+    child->pid_ = 0;
+
+    int status = 0;
+    pid_t w;
+    do {
+        w = PlatformSpecificWaitPid(pid, &status, 0);
+    } while (w == -1 && errno == EINTR);
+    if (w == -1) return -1;
+
+    if (received == (ssize_t) sizeof(returned))
+        *result = returned;
+    else
+        *result = WIFSIGNALED(status) ? -WTERMSIG(status) : WEXITSTATUS(status);
+    return w;
+}
+
 #endif
 
 TestOutput::WorkingEnvironment PlatformSpecificGetWorkingEnvironment()
@@ -158,6 +293,8 @@ void (*PlatformSpecificRunTestInASeperateProcess)(UtestShell* shell, TestPlugin*
         GccPlatformSpecificRunTestInASeperateProcess;
 int (*PlatformSpecificFork)(void) = PlatformSpecificForkImplementation;
 int (*PlatformSpecificWaitPid)(int, int*, int) = PlatformSpecificWaitPidImplementation;
+int (*PlatformSpecificStartChildProcess)(int (*)(void*), void*) = GccPlatformSpecificStartChildProcess;
+int (*PlatformSpecificWaitForChildProcess)(const int*, size_t, int*) = GccPlatformSpecificWaitForChildProcess;
 
 extern "C" {
 
@@ -209,6 +346,17 @@ static unsigned long TimeInMillisImplementation()
 #endif
 }
 
+static unsigned long TimeInMicrosImplementation()
+{
+#ifdef CPPUTEST_HAVE_GETTIMEOFDAY
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (((unsigned long)tv.tv_sec * 1000000) + (unsigned long)tv.tv_usec);
+#else
+    return 0;
+#endif
+}
+
 static const char* TimeStringImplementation()
 {
     time_t theTime = time(NULLPTR);
@@ -225,6 +373,7 @@ static const char* TimeStringImplementation()
 }
 
 unsigned long (*GetPlatformSpecificTimeInMillis)() = TimeInMillisImplementation;
+unsigned long (*GetPlatformSpecificTimeInMicros)() = TimeInMicrosImplementation;
 const char* (*GetPlatformSpecificTimeString)() = TimeStringImplementation;
 
 /* Wish we could add an attribute to the format for discovering mis-use... but the __attribute__(format) seems to not work on va_list */
@@ -253,6 +402,16 @@ static void PlatformSpecificFPutsImplementation(const char* str, PlatformSpecifi
    fputs(str, (FILE*)file);
 }
 
+static size_t PlatformSpecificFReadImplementation(void* buffer, size_t size, PlatformSpecificFile file)
+{
+   return fread(buffer, 1, size, (FILE*)file);
+}
+
+static size_t PlatformSpecificFWriteImplementation(const void* buffer, size_t size, PlatformSpecificFile file)
+{
+   return fwrite(buffer, 1, size, (FILE*)file);
+}
+
 static void PlatformSpecificFCloseImplementation(PlatformSpecificFile file)
 {
    fclose((FILE*)file);
@@ -267,6 +426,8 @@ PlatformSpecificFile PlatformSpecificStdOut = stdout;
 
 PlatformSpecificFile (*PlatformSpecificFOpen)(const char*, const char*) = PlatformSpecificFOpenImplementation;
 void (*PlatformSpecificFPuts)(const char*, PlatformSpecificFile) = PlatformSpecificFPutsImplementation;
+size_t (*PlatformSpecificFRead)(void*, size_t, PlatformSpecificFile) = PlatformSpecificFReadImplementation;
+size_t (*PlatformSpecificFWrite)(const void*, size_t, PlatformSpecificFile) = PlatformSpecificFWriteImplementation;
 void (*PlatformSpecificFClose)(PlatformSpecificFile) = PlatformSpecificFCloseImplementation;
 
 void (*PlatformSpecificFlush)() = PlatformSpecificFlushImplementation;
@@ -355,4 +516,121 @@ void (*PlatformSpecificMutexUnlock)(PlatformSpecificMutex) = PThreadMutexUnlock;
 void (*PlatformSpecificMutexDestroy)(PlatformSpecificMutex) = PThreadMutexDestroy;
 void (*PlatformSpecificAbort)(void) = abort;
 
+#ifdef CPPUTEST_HAVE_BACKTRACE
+static int GccBacktrace(void** addresses, int maxAddresses)
+{
+    return backtrace(addresses, maxAddresses);
+}
+
+static void GccSymbolize(void* address, char* name, size_t size)
+{
+    if (size == 0) return;
+    name[0] = '\0';
+
+    char** symbols = backtrace_symbols(&address, 1);
+    if (symbols == NULLPTR) return;
+    strncpy(name, symbols[0], size - 1);
+    name[size - 1] = '\0';
+    free(symbols);
+}
+#else
+static int GccBacktrace(void**, int)
+{
+    return 0;
+}
+
+static void GccSymbolize(void*, char* name, size_t size)
+{
+    if (size > 0) name[0] = '\0';
+}
+#endif
+
+int (*PlatformSpecificBacktrace)(void**, int) = GccBacktrace;
+void (*PlatformSpecificSymbolize)(void*, char*, size_t) = GccSymbolize;
+
+#ifdef CPPUTEST_HAVE_MPROTECT
+static size_t GccPageSize(void)
+{
+    long size = sysconf(_SC_PAGESIZE);
+    return (size > 0) ? (size_t) size : 0;
+}
+
+static void* GccMapPages(size_t size)
+{
+    void* memory = mmap(NULLPTR, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+    return (memory == MAP_FAILED) ? NULLPTR : memory;
+}
+
+static void GccProtectPages(void* memory, size_t size)
+{
+    mprotect(memory, size, PROT_NONE);
+}
+
+static void GccUnmapPages(void* memory, size_t size)
+{
+    munmap(memory, size);
+}
+
+static void GccAdviseHugePages(void* memory, size_t size)
+{
+#ifdef MADV_HUGEPAGE
+    madvise(memory, size, MADV_HUGEPAGE);
+#else
+    (void) memory;
+    (void) size;
+#endif
+}
+
+static void* GccMapFile(const char* filename, size_t* size, int writable)
+{
+    int fd = open(filename, writable ? (O_RDWR | O_CREAT | O_TRUNC) : O_RDONLY, 0644);
+    if (fd < 0) return NULLPTR;
+
+    struct stat status;
+    if (writable ? (ftruncate(fd, (off_t) *size) != 0) : (fstat(fd, &status) != 0)) {
+        close(fd);
+        return NULLPTR;
+    }
+    if (!writable) *size = (size_t) status.st_size;
+
+    void* memory = (*size == 0) ? MAP_FAILED : mmap(NULLPTR, *size, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    return (memory == MAP_FAILED) ? NULLPTR : memory;
+}
+#else
+static size_t GccPageSize(void)
+{
+    return 0;
+}
+
+static void* GccMapPages(size_t)
+{
+    return NULLPTR;
+}
+
+static void GccProtectPages(void*, size_t)
+{
+}
+
+static void GccUnmapPages(void*, size_t)
+{
+}
+
+static void GccAdviseHugePages(void*, size_t)
+{
+}
+
+static void* GccMapFile(const char*, size_t*, int)
+{
+    return NULLPTR;
+}
+#endif
+
+size_t (*PlatformSpecificPageSize)(void) = GccPageSize;
+void* (*PlatformSpecificMapPages)(size_t) = GccMapPages;
+void (*PlatformSpecificProtectPages)(void*, size_t) = GccProtectPages;
+void (*PlatformSpecificUnmapPages)(void*, size_t) = GccUnmapPages;
+void (*PlatformSpecificAdviseHugePages)(void*, size_t) = GccAdviseHugePages;
+void* (*PlatformSpecificMapFile)(const char*, size_t*, int) = GccMapFile;
+
 }
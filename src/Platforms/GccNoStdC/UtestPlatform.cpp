@@ -38,6 +38,8 @@
 void (*PlatformSpecificRunTestInASeperateProcess)(UtestShell*, TestPlugin*, TestResult*) = NULLPTR;
 int (*PlatformSpecificFork)() = NULLPTR;
 int (*PlatformSpecificWaitPid)(int, int*, int) = NULLPTR;
+int (*PlatformSpecificStartChildProcess)(int (*)(void*), void*) = NULLPTR;
+int (*PlatformSpecificWaitForChildProcess)(const int*, size_t, int*) = NULLPTR;
 
 TestOutput::WorkingEnvironment PlatformSpecificGetWorkingEnvironment()
 {
@@ -49,12 +51,15 @@ int (*PlatformSpecificSetJmp)(void (*)(void*), void*) = NULLPTR;
 void (*PlatformSpecificRestoreJumpBuffer)() = NULLPTR;
 
 unsigned long (*GetPlatformSpecificTimeInMillis)() = NULLPTR;
+unsigned long (*GetPlatformSpecificTimeInMicros)() = NULLPTR;
 const char* (*GetPlatformSpecificTimeString)() = NULLPTR;
 
 /* IO operations */
 PlatformSpecificFile PlatformSpecificStdOut = NULLPTR;
 PlatformSpecificFile (*PlatformSpecificFOpen)(const char* filename, const char* flag) = NULLPTR;
 void (*PlatformSpecificFPuts)(const char* str, PlatformSpecificFile file) = NULLPTR;
+size_t (*PlatformSpecificFRead)(void* buffer, size_t size, PlatformSpecificFile file) = NULLPTR;
+size_t (*PlatformSpecificFWrite)(const void* buffer, size_t size, PlatformSpecificFile file) = NULLPTR;
 void (*PlatformSpecificFClose)(PlatformSpecificFile file) = NULLPTR;
 
 void (*PlatformSpecificFlush)(void) = NULLPTR;
@@ -81,3 +86,13 @@ void (*PlatformSpecificMutexDestroy)(PlatformSpecificMutex mtx) = NULLPTR;
 void (*PlatformSpecificSrand)(unsigned int) = NULLPTR;
 int (*PlatformSpecificRand)(void) = NULLPTR;
 void (*PlatformSpecificAbort)(void) = NULLPTR;
+
+int (*PlatformSpecificBacktrace)(void**, int) = NULLPTR;
+void (*PlatformSpecificSymbolize)(void*, char*, size_t) = NULLPTR;
+
+size_t (*PlatformSpecificPageSize)(void) = NULLPTR;
+void* (*PlatformSpecificMapPages)(size_t) = NULLPTR;
+void (*PlatformSpecificProtectPages)(void*, size_t) = NULLPTR;
+void (*PlatformSpecificUnmapPages)(void*, size_t) = NULLPTR;
+void (*PlatformSpecificAdviseHugePages)(void*, size_t) = NULLPTR;
+void* (*PlatformSpecificMapFile)(const char*, size_t*, int) = NULLPTR;
@@ -66,10 +66,22 @@ static int DummyPlatformSpecificWaitPid(int, int*, int)
     return 0;
 }
 
+static int DummyPlatformSpecificStartChildProcess(int (*)(void*), void*)
+{
+    return -1;
+}
+
+static int DummyPlatformSpecificWaitForChildProcess(const int*, size_t, int*)
+{
+    return -1;
+}
+
 void (*PlatformSpecificRunTestInASeperateProcess)(UtestShell* shell, TestPlugin* plugin, TestResult* result) =
         DummyPlatformSpecificRunTestInASeperateProcess;
 int (*PlatformSpecificFork)(void) = DummyPlatformSpecificFork;
 int (*PlatformSpecificWaitPid)(int, int*, int) = DummyPlatformSpecificWaitPid;
+int (*PlatformSpecificStartChildProcess)(int (*)(void*), void*) = DummyPlatformSpecificStartChildProcess;
+int (*PlatformSpecificWaitForChildProcess)(const int*, size_t, int*) = DummyPlatformSpecificWaitForChildProcess;
 
 extern "C" {
 
@@ -124,6 +136,13 @@ static const char* TimeStringImplementation()
 unsigned long (*GetPlatformSpecificTimeInMillis)() = TimeInMillisImplementation;
 const char* (*GetPlatformSpecificTimeString)() = TimeStringImplementation;
 
+static unsigned long TimeInMicrosImplementation()
+{
+    return TimeInMillisImplementation() * 1000;
+}
+
+unsigned long (*GetPlatformSpecificTimeInMicros)() = TimeInMicrosImplementation;
+
 int (*PlatformSpecificVSNprintf)(char *str, size_t size, const char* format, va_list args) = vsnprintf;
 
 static PlatformSpecificFile PlatformSpecificFOpenImplementation(const char* filename, const char* flag)
@@ -142,6 +161,22 @@ static void PlatformSpecificFPutsImplementation(const char* str, PlatformSpecifi
     printf("FILE%d:%s",(int)file, str);
 }
 
+static size_t PlatformSpecificFReadImplementation(void* buffer, size_t size, PlatformSpecificFile file)
+{
+    (void)buffer;
+    (void)size;
+    (void)file;
+    return 0;
+}
+
+static size_t PlatformSpecificFWriteImplementation(const void* buffer, size_t size, PlatformSpecificFile file)
+{
+    (void)buffer;
+    (void)size;
+    (void)file;
+    return 0;
+}
+
 static void PlatformSpecificFCloseImplementation(PlatformSpecificFile file)
 {
     (void)file;
@@ -154,6 +189,8 @@ static void PlatformSpecificFlushImplementation()
 PlatformSpecificFile PlatformSpecificStdOut = stdout;
 PlatformSpecificFile (*PlatformSpecificFOpen)(const char*, const char*) = PlatformSpecificFOpenImplementation;
 void (*PlatformSpecificFPuts)(const char*, PlatformSpecificFile) = PlatformSpecificFPutsImplementation;
+size_t (*PlatformSpecificFRead)(void*, size_t, PlatformSpecificFile) = PlatformSpecificFReadImplementation;
+size_t (*PlatformSpecificFWrite)(const void*, size_t, PlatformSpecificFile) = PlatformSpecificFWriteImplementation;
 void (*PlatformSpecificFClose)(PlatformSpecificFile) = PlatformSpecificFCloseImplementation;
 
 void (*PlatformSpecificFlush)() = PlatformSpecificFlushImplementation;
@@ -203,4 +240,43 @@ void (*PlatformSpecificMutexDestroy)(PlatformSpecificMutex) = DummyMutexDestroy;
 void (*PlatformSpecificSrand)(unsigned int) = srand;
 int (*PlatformSpecificRand)(void) = rand;
 void (*PlatformSpecificAbort)(void) = abort;
+
+static int DummyBacktrace(void**, int)
+{
+    return 0;
+}
+
+static void DummySymbolize(void*, char* name, size_t size)
+{
+    if (size > 0) name[0] = '\0';
+}
+
+int (*PlatformSpecificBacktrace)(void**, int) = DummyBacktrace;
+void (*PlatformSpecificSymbolize)(void*, char*, size_t) = DummySymbolize;
+
+static size_t DummyPageSize(void)
+{
+    return 0;
+}
+
+static void* DummyMapPages(size_t)
+{
+    return NULLPTR;
+}
+
+static void* DummyMapFile(const char*, size_t*, int)
+{
+    return NULLPTR;
+}
+
+static void DummyPageOperation(void*, size_t)
+{
+}
+
+size_t (*PlatformSpecificPageSize)(void) = DummyPageSize;
+void* (*PlatformSpecificMapPages)(size_t) = DummyMapPages;
+void (*PlatformSpecificProtectPages)(void*, size_t) = DummyPageOperation;
+void (*PlatformSpecificUnmapPages)(void*, size_t) = DummyPageOperation;
+void (*PlatformSpecificAdviseHugePages)(void*, size_t) = DummyPageOperation;
+void* (*PlatformSpecificMapFile)(const char*, size_t*, int) = DummyMapFile;
 }
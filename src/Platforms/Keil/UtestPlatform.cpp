@@ -68,9 +68,21 @@ static int DummyPlatformSpecificWaitPid(int, int*, int)
     return 0;
 }
 
+static int DummyPlatformSpecificStartChildProcess(int (*)(void*), void*)
+{
+    return -1;
+}
+
+static int DummyPlatformSpecificWaitForChildProcess(const int*, size_t, int*)
+{
+    return -1;
+}
+
 void (*PlatformSpecificRunTestInASeperateProcess)(UtestShell*, TestPlugin*, TestResult*) = DummyRunTestInASeperateProcess;
 int (*PlatformSpecificFork)() = DummyPlatformSpecificFork;
 int (*PlatformSpecificWaitPid)(int, int*, int) = DummyPlatformSpecificWaitPid;
+int (*PlatformSpecificStartChildProcess)(int (*)(void*), void*) = DummyPlatformSpecificStartChildProcess;
+int (*PlatformSpecificWaitForChildProcess)(const int*, size_t, int*) = DummyPlatformSpecificWaitForChildProcess;
 
 extern "C"
 {
@@ -119,6 +131,13 @@ extern "C"
 
     unsigned long (*GetPlatformSpecificTimeInMillis)() = TimeInMillisImplementation;
 
+    static unsigned long TimeInMicrosImplementation()
+    {
+        return TimeInMillisImplementation() * 1000;
+    }
+
+    unsigned long (*GetPlatformSpecificTimeInMicros)() = TimeInMicrosImplementation;
+
     static const char* TimeStringImplementation()
     {
         time_t tm = 0;//time(NULL); // todo
@@ -147,6 +166,16 @@ extern "C"
         printf("%s", str);
     }
 
+    static size_t PlatformSpecificFReadImplementation(void* buffer, size_t size, PlatformSpecificFile file)
+    {
+        return 0;
+    }
+
+    static size_t PlatformSpecificFWriteImplementation(const void* buffer, size_t size, PlatformSpecificFile file)
+    {
+        return 0;
+    }
+
     static void PlatformSpecificFCloseImplementation(PlatformSpecificFile file)
     {
     }
@@ -158,6 +187,8 @@ extern "C"
     PlatformSpecificFile PlatformSpecificStdOut = stdout;
     PlatformSpecificFile (*PlatformSpecificFOpen)(const char*, const char*) = PlatformSpecificFOpenImplementation;
     void (*PlatformSpecificFPuts)(const char*, PlatformSpecificFile) = PlatformSpecificFPutsImplementation;
+    size_t (*PlatformSpecificFRead)(void*, size_t, PlatformSpecificFile) = PlatformSpecificFReadImplementation;
+    size_t (*PlatformSpecificFWrite)(const void*, size_t, PlatformSpecificFile) = PlatformSpecificFWriteImplementation;
     void (*PlatformSpecificFClose)(PlatformSpecificFile) = PlatformSpecificFCloseImplementation;
 
     void (*PlatformSpecificFlush)() = PlatformSpecificFlushImplementation;
@@ -218,4 +249,43 @@ extern "C"
     void (*PlatformSpecificMutexDestroy)(PlatformSpecificMutex) = DummyMutexDestroy;
     void (*PlatformSpecificAbort)(void) = abort;
 
+    static int DummyBacktrace(void**, int)
+    {
+        return 0;
+    }
+
+    static void DummySymbolize(void*, char* name, size_t size)
+    {
+        if (size > 0) name[0] = '\0';
+    }
+
+    int (*PlatformSpecificBacktrace)(void**, int) = DummyBacktrace;
+    void (*PlatformSpecificSymbolize)(void*, char*, size_t) = DummySymbolize;
+
+    static size_t DummyPageSize(void)
+    {
+        return 0;
+    }
+
+    static void* DummyMapPages(size_t)
+    {
+        return NULLPTR;
+    }
+
+    static void* DummyMapFile(const char*, size_t*, int)
+    {
+        return NULLPTR;
+    }
+
+    static void DummyPageOperation(void*, size_t)
+    {
+    }
+
+    size_t (*PlatformSpecificPageSize)(void) = DummyPageSize;
+    void* (*PlatformSpecificMapPages)(size_t) = DummyMapPages;
+    void (*PlatformSpecificProtectPages)(void*, size_t) = DummyPageOperation;
+    void (*PlatformSpecificUnmapPages)(void*, size_t) = DummyPageOperation;
+    void (*PlatformSpecificAdviseHugePages)(void*, size_t) = DummyPageOperation;
+    void* (*PlatformSpecificMapFile)(const char*, size_t*, int) = DummyMapFile;
+
 }
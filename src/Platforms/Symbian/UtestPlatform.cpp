@@ -67,6 +67,19 @@ void PlatformSpecificRunTestInASeperateProcess(UtestShell* shell, TestPlugin* pl
    shell->runOneTest(plugin, *result);
 }
 
+static int SymbianStartChildProcess(int (*)(void*), void*)
+{
+    return -1;
+}
+
+static int SymbianWaitForChildProcess(const int*, size_t, int*)
+{
+    return -1;
+}
+
+int (*PlatformSpecificStartChildProcess)(int (*)(void*), void*) = SymbianStartChildProcess;
+int (*PlatformSpecificWaitForChildProcess)(const int*, size_t, int*) = SymbianWaitForChildProcess;
+
 static unsigned long TimeInMillisImplementation() {
     struct timeval tv;
     struct timezone tz;
@@ -76,6 +89,13 @@ static unsigned long TimeInMillisImplementation() {
 
 unsigned long (*GetPlatformSpecificTimeInMillis)() = TimeInMillisImplementation;
 
+static unsigned long TimeInMicrosImplementation()
+{
+    return TimeInMillisImplementation() * 1000;
+}
+
+unsigned long (*GetPlatformSpecificTimeInMicros)() = TimeInMicrosImplementation;
+
 TestOutput::WorkingEnvironment PlatformSpecificGetWorkingEnvironment()
 {
     return TestOutput::eclipse;
@@ -131,6 +151,14 @@ void PlatformSpecificFPuts(const char* str, PlatformSpecificFile file) {
     fputs(str, (FILE*)file);
 }
 
+size_t PlatformSpecificFRead(void* buffer, size_t size, PlatformSpecificFile file) {
+    return fread(buffer, 1, size, (FILE*)file);
+}
+
+size_t PlatformSpecificFWrite(const void* buffer, size_t size, PlatformSpecificFile file) {
+    return fwrite(buffer, 1, size, (FILE*)file);
+}
+
 void PlatformSpecificFClose(PlatformSpecificFile file) {
     fclose((FILE*)file);
 }
@@ -179,3 +207,42 @@ void (*PlatformSpecificMutexUnlock)(PlatformSpecificMutex) = DummyMutexUnlock;
 void (*PlatformSpecificMutexDestroy)(PlatformSpecificMutex) = DummyMutexDestroy;
 void (*PlatformSpecificAbort)(void) = abort;
 
+static int DummyBacktrace(void**, int)
+{
+    return 0;
+}
+
+static void DummySymbolize(void*, char* name, size_t size)
+{
+    if (size > 0) name[0] = '\0';
+}
+
+int (*PlatformSpecificBacktrace)(void**, int) = DummyBacktrace;
+void (*PlatformSpecificSymbolize)(void*, char*, size_t) = DummySymbolize;
+
+static size_t DummyPageSize(void)
+{
+    return 0;
+}
+
+static void* DummyMapPages(size_t)
+{
+    return NULLPTR;
+}
+
+static void* DummyMapFile(const char*, size_t*, int)
+{
+    return NULLPTR;
+}
+
+static void DummyPageOperation(void*, size_t)
+{
+}
+
+size_t (*PlatformSpecificPageSize)(void) = DummyPageSize;
+void* (*PlatformSpecificMapPages)(size_t) = DummyMapPages;
+void (*PlatformSpecificProtectPages)(void*, size_t) = DummyPageOperation;
+void (*PlatformSpecificUnmapPages)(void*, size_t) = DummyPageOperation;
+void (*PlatformSpecificAdviseHugePages)(void*, size_t) = DummyPageOperation;
+void* (*PlatformSpecificMapFile)(const char*, size_t*, int) = DummyMapFile;
+
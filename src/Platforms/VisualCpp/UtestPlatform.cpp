@@ -65,8 +65,20 @@ static void VisualCppRunTestInASeperateProcess(UtestShell* shell, TestPlugin* /*
     result->addFailure(TestFailure(shell, "-p doesn't work on this platform, as it is lacking fork.\b"));
 }
 
+static int VisualCppStartChildProcess(int (*)(void*), void*)
+{
+    return -1;
+}
+
+static int VisualCppWaitForChildProcess(const int*, size_t, int*)
+{
+    return -1;
+}
+
 void (*PlatformSpecificRunTestInASeperateProcess)(UtestShell* shell, TestPlugin* plugin, TestResult* result) =
         VisualCppRunTestInASeperateProcess;
+int (*PlatformSpecificStartChildProcess)(int (*)(void*), void*) = VisualCppStartChildProcess;
+int (*PlatformSpecificWaitForChildProcess)(const int*, size_t, int*) = VisualCppWaitForChildProcess;
 
 TestOutput::WorkingEnvironment PlatformSpecificGetWorkingEnvironment()
 {
@@ -101,6 +113,22 @@ static unsigned long VisualCppTimeInMillis()
 
 unsigned long (*GetPlatformSpecificTimeInMillis)() = VisualCppTimeInMillis;
 
+/* The performance counter is split in seconds and the remainder, so the multiplication doesn't overflow */
+static unsigned long VisualCppTimeInMicros()
+{
+	static LARGE_INTEGER s_frequency;
+	static const BOOL s_use_qpc = QueryPerformanceFrequency(&s_frequency);
+	if (s_use_qpc)
+	{
+		LARGE_INTEGER now;
+		QueryPerformanceCounter(&now);
+		return (unsigned long)((now.QuadPart / s_frequency.QuadPart) * 1000000 + (now.QuadPart % s_frequency.QuadPart) * 1000000 / s_frequency.QuadPart);
+	}
+	return VisualCppTimeInMillis() * 1000;
+}
+
+unsigned long (*GetPlatformSpecificTimeInMicros)() = VisualCppTimeInMicros;
+
 ///////////// Time in String
 
 static const char* VisualCppTimeString()
@@ -153,6 +181,16 @@ static void VisualCppFPuts(const char* str, PlatformSpecificFile file)
     fputs(str, (FILE*)file);
 }
 
+static size_t VisualCppFRead(void* buffer, size_t size, PlatformSpecificFile file)
+{
+    return fread(buffer, 1, size, (FILE*)file);
+}
+
+static size_t VisualCppFWrite(const void* buffer, size_t size, PlatformSpecificFile file)
+{
+    return fwrite(buffer, 1, size, (FILE*)file);
+}
+
 static void VisualCppFClose(PlatformSpecificFile file)
 {
     fclose((FILE*)file);
@@ -161,6 +199,8 @@ static void VisualCppFClose(PlatformSpecificFile file)
 PlatformSpecificFile PlatformSpecificStdOut = stdout;
 PlatformSpecificFile (*PlatformSpecificFOpen)(const char* filename, const char* flag) = VisualCppFOpen;
 void (*PlatformSpecificFPuts)(const char* str, PlatformSpecificFile file) = VisualCppFPuts;
+size_t (*PlatformSpecificFRead)(void* buffer, size_t size, PlatformSpecificFile file) = VisualCppFRead;
+size_t (*PlatformSpecificFWrite)(const void* buffer, size_t size, PlatformSpecificFile file) = VisualCppFWrite;
 void (*PlatformSpecificFClose)(PlatformSpecificFile file) = VisualCppFClose;
 
 static void VisualCppFlush()
@@ -232,3 +272,42 @@ void (*PlatformSpecificMutexLock)(PlatformSpecificMutex) = VisualCppMutexLock;
 void (*PlatformSpecificMutexUnlock)(PlatformSpecificMutex) = VisualCppMutexUnlock;
 void (*PlatformSpecificMutexDestroy)(PlatformSpecificMutex) = VisualCppMutexDestroy;
 void (*PlatformSpecificAbort)(void) = abort;
+
+static int DummyBacktrace(void**, int)
+{
+    return 0;
+}
+
+static void DummySymbolize(void*, char* name, size_t size)
+{
+    if (size > 0) name[0] = '\0';
+}
+
+int (*PlatformSpecificBacktrace)(void**, int) = DummyBacktrace;
+void (*PlatformSpecificSymbolize)(void*, char*, size_t) = DummySymbolize;
+
+static size_t DummyPageSize(void)
+{
+    return 0;
+}
+
+static void* DummyMapPages(size_t)
+{
+    return NULLPTR;
+}
+
+static void* DummyMapFile(const char*, size_t*, int)
+{
+    return NULLPTR;
+}
+
+static void DummyPageOperation(void*, size_t)
+{
+}
+
+size_t (*PlatformSpecificPageSize)(void) = DummyPageSize;
+void* (*PlatformSpecificMapPages)(size_t) = DummyMapPages;
+void (*PlatformSpecificProtectPages)(void*, size_t) = DummyPageOperation;
+void (*PlatformSpecificUnmapPages)(void*, size_t) = DummyPageOperation;
+void (*PlatformSpecificAdviseHugePages)(void*, size_t) = DummyPageOperation;
+void* (*PlatformSpecificMapFile)(const char*, size_t*, int) = DummyMapFile;
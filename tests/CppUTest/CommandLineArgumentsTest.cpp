@@ -117,6 +117,30 @@ TEST(CommandLineArguments, repeatSetDefaultsToTwoAndShuffleDisabled)
     LONGS_EQUAL(2, args->getRepeatCount());
 }
 
+TEST(CommandLineArguments, allocationFailureSweepSet)
+{
+    int argc = 2;
+    const char* argv[] = { "tests.exe", "-af8" };
+    CHECK(newArgumentParser(argc, argv));
+    LONGS_EQUAL(8, args->getAllocationFailureSweepProcesses());
+}
+
+TEST(CommandLineArguments, allocationFailureSweepSetDifferentParameter)
+{
+    int argc = 3;
+    const char* argv[] = { "tests.exe", "-af", "2" };
+    CHECK(newArgumentParser(argc, argv));
+    LONGS_EQUAL(2, args->getAllocationFailureSweepProcesses());
+}
+
+TEST(CommandLineArguments, allocationFailureSweepDefaultsToFourProcesses)
+{
+    int argc = 2;
+    const char* argv[] = { "tests.exe", "-af" };
+    CHECK(newArgumentParser(argc, argv));
+    LONGS_EQUAL(4, args->getAllocationFailureSweepProcesses());
+}
+
 TEST(CommandLineArguments, reverseEnabled)
 {
     int argc = 2;
@@ -528,7 +552,7 @@ TEST(CommandLineArguments, printUsage)
 {
     STRCMP_EQUAL(
             "use -h for more extensive help\n"
-            "usage [-h] [-v] [-vv] [-c] [-p] [-lg] [-ln] [-ll] [-ri] [-r[<#>]] [-f] [-e] [-ci]\n"
+            "usage [-h] [-v] [-vv] [-c] [-p] [-lg] [-ln] [-ll] [-ri] [-r[<#>]] [-af[<#>]] [-f] [-e] [-ci] [-sc] [-ug]\n"
             "      [-g|sg|xg|xsg <groupName>]... [-n|sn|xn|xsn <testName>]... [-t|st|xt|xst <groupName>.<testName>]...\n"
             "      [-b] [-s [<seed>]] [\"[IGNORE_]TEST(<groupName>, <testName>)\"]...\n"
             "      [-o{normal|eclipse|junit|teamcity}] [-k <packageName>]\n",
@@ -561,12 +585,40 @@ TEST(CommandLineArguments, checkDefaultArguments)
     CHECK(newArgumentParser(argc, argv));
     CHECK(!args->isVerbose());
     LONGS_EQUAL(1, args->getRepeatCount());
+    LONGS_EQUAL(0, args->getAllocationFailureSweepProcesses());
     CHECK(NULLPTR == args->getGroupFilters());
     CHECK(NULLPTR == args->getNameFilters());
     CHECK(args->isEclipseOutput());
     CHECK(SimpleString("") == args->getPackageName());
     CHECK(!args->isCrashingOnFail());
     CHECK(args->isRethrowingExceptions());
+    CHECK(!args->isUsingStringCache());
+    CHECK(!args->isUpdatingGoldenFiles());
+}
+
+TEST(CommandLineArguments, stringCache)
+{
+    int argc = 2;
+    const char* argv[] = { "tests.exe", "-sc" };
+    CHECK(newArgumentParser(argc, argv));
+    CHECK(args->isUsingStringCache());
+}
+
+TEST(CommandLineArguments, stringCacheOptionAsTheValueOfAnotherOptionDoesNotTurnOnTheCache)
+{
+    int argc = 3;
+    const char* argv[] = { "tests.exe", "-g", "-sc" };
+    CHECK(newArgumentParser(argc, argv));
+    CHECK(!args->isUsingStringCache());
+    CHECK_EQUAL(TestFilter("-sc"), *args->getGroupFilters());
+}
+
+TEST(CommandLineArguments, updateGoldenFiles)
+{
+    int argc = 2;
+    const char* argv[] = { "tests.exe", "-ug" };
+    CHECK(newArgumentParser(argc, argv));
+    CHECK(args->isUpdatingGoldenFiles());
 }
 
 TEST(CommandLineArguments, checkContinuousIntegrationMode)
@@ -158,12 +158,13 @@ class JUnitTestOutputTestRunner
     bool firstTestInGroup_;
     unsigned int timeTheTestTakes_;
     unsigned int numberOfChecksInTest_;
+    size_t peakMemoryOfTest_;
     TestFailure* testFailure_;
 
 public:
 
     explicit JUnitTestOutputTestRunner(const TestResult& result) :
-        result_(result), currentGroupName_(NULLPTR), currentTest_(NULLPTR), firstTestInGroup_(true), timeTheTestTakes_(0), numberOfChecksInTest_(0), testFailure_(NULLPTR)
+        result_(result), currentGroupName_(NULLPTR), currentTest_(NULLPTR), firstTestInGroup_(true), timeTheTestTakes_(0), numberOfChecksInTest_(0), peakMemoryOfTest_(0), testFailure_(NULLPTR)
     {
         millisTime = 0;
         theTime =  "1978-10-03T00:00:00";
@@ -270,6 +271,8 @@ public:
             testFailure_ = NULLPTR;
         }
 
+        result_.setCurrentTestPeakMemory(peakMemoryOfTest_);
+        peakMemoryOfTest_ = 0;
         result_.currentTestEnded(currentTest_);
     }
 
@@ -285,6 +288,12 @@ public:
         return *this;
     }
 
+    JUnitTestOutputTestRunner& thatPeaksAt(size_t bytes)
+    {
+        peakMemoryOfTest_ = bytes;
+        return *this;
+    }
+
     JUnitTestOutputTestRunner& seconds()
     {
         return *this;
@@ -664,6 +673,20 @@ TEST(JUnitOutputTest, TestCaseBlockForIgnoredTest)
    STRCMP_EQUAL("</testcase>\n", outputFile->line(7));
 }
 
+TEST(JUnitOutputTest, testCaseWithPeakMemoryHasAPeakMemoryProperty)
+{
+    testCaseRunner->start()
+            .withGroup("memoryGroup").withTest("testname").thatPeaksAt(1234)
+            .end();
+
+    outputFile = fileSystem.file("cpputest_memoryGroup.xml");
+
+    STRCMP_EQUAL("<properties>\n", outputFile->line(6));
+    STRCMP_EQUAL("<property name=\"peak_memory\" value=\"1234\"/>\n", outputFile->line(7));
+    STRCMP_EQUAL("</properties>\n", outputFile->line(8));
+    STRCMP_EQUAL("</testcase>\n", outputFile->line(9));
+}
+
 TEST(JUnitOutputTest, TestCaseWithTestLocation)
 {
     junitOutput->setPackageName("packagename");
@@ -362,8 +362,58 @@ TEST(MemoryLeakDetectorTest, OneRealloc)
     detector->stopChecking();
     LONGS_EQUAL(1, testAllocator->alloc_called);
     LONGS_EQUAL(1, testAllocator->free_called);
-    LONGS_EQUAL(2, testAllocator->allocMemoryLeakNodeCalled);
-    LONGS_EQUAL(2, testAllocator->freeMemoryLeakNodeCalled);
+    LONGS_EQUAL(1, testAllocator->allocMemoryLeakNodeCalled);
+    LONGS_EQUAL(1, testAllocator->freeMemoryLeakNodeCalled);
+}
+
+TEST(MemoryLeakDetectorTest, ReallocMovesTheCorruptionInformationBehindTheNewEnd)
+{
+    char* mem = detector->allocMemory(defaultMallocAllocator(), 10, "ALLOC.c", 10, true);
+    mem = detector->reallocMemory(defaultMallocAllocator(), mem, 1000, "REALLOC.c", 20, true);
+    mem[999] = 'O';
+    mem[1000] = 'H';
+    detector->deallocMemory(defaultMallocAllocator(), mem, "FREE.c", 100, true);
+    CHECK(reporter->message->contains("Memory corruption"));
+    CHECK(reporter->message->contains("   allocated at file: REALLOC.c line: 20 size: 1000 type: malloc"));
+}
+
+TEST(MemoryLeakDetectorTest, CorruptionOfReallocatedMemoryStillFreesTheSeparateNode)
+{
+    char* mem = detector->allocMemory(testAllocator, 10, "ALLOC.c", 10, true);
+    mem = detector->reallocMemory(testAllocator, mem, 1000, "REALLOC.c", 20, true);
+    mem[1000] = 'H';
+    detector->deallocMemory(testAllocator, mem, "FREE.c", 100, true);
+    CHECK(reporter->message->contains("Memory corruption"));
+    LONGS_EQUAL(1, testAllocator->allocMemoryLeakNodeCalled);
+    LONGS_EQUAL(1, testAllocator->freeMemoryLeakNodeCalled);
+}
+
+TEST(MemoryLeakDetectorTest, ReallocShrinkingEmbeddedNodeKeepsTracking)
+{
+    char* mem = detector->allocMemory(defaultNewAllocator(), 100);
+    mem = detector->reallocMemory(defaultNewAllocator(), mem, 5, "file", 1);
+    mem[4] = 'O';
+    LONGS_EQUAL(1, detector->totalMemoryLeaks(mem_leak_period_checking));
+    detector->deallocMemory(defaultNewAllocator(), mem);
+    LONGS_EQUAL(0, detector->totalMemoryLeaks(mem_leak_period_checking));
+    STRCMP_EQUAL("", reporter->message->asCharString());
+}
+
+static void* failingRealloc_(void*, size_t)
+{
+    return NULLPTR;
+}
+
+TEST(MemoryLeakDetectorTest, FailingReallocKeepsTheOriginalMemoryTracked)
+{
+    char* mem = detector->allocMemory(testAllocator, 10, "file.cpp", 1234, true);
+    UT_PTR_SET(PlatformSpecificRealloc, failingRealloc_);
+    POINTERS_EQUAL(NULLPTR, detector->reallocMemory(testAllocator, mem, 1000, "other.cpp", 5678, true));
+    LONGS_EQUAL(1, detector->totalMemoryLeaks(mem_leak_period_checking));
+    STRCMP_CONTAINS("file.cpp", detector->report(mem_leak_period_checking));
+    detector->deallocMemory(testAllocator, mem, true);
+    LONGS_EQUAL(0, detector->totalMemoryLeaks(mem_leak_period_checking));
+    STRCMP_EQUAL("", reporter->message->asCharString());
 }
 
 TEST(MemoryLeakDetectorTest, ReallocNonAllocatedMemory)
@@ -542,6 +592,587 @@ TEST(MemoryLeakDetectorTest, invalidateMemoryNULLShouldWork)
   detector->invalidateMemory(NULLPTR);
 }
 
+TEST(MemoryLeakDetectorTest, samplingEveryNthAllocationTracksOneInNOnAverage)
+{
+    detector->sampleEveryNthAllocation(10);
+    char* mem[1000];
+    for (int i = 0; i < 1000; i++)
+        mem[i] = detector->allocMemory(testAllocator, 4);
+
+    size_t tracked = detector->totalMemoryLeaks(mem_leak_period_checking);
+    CHECK(tracked > 50 && tracked < 200);
+    LONGS_EQUAL(1000 - tracked, detector->getUntrackedAllocations());
+    LONGS_EQUAL(1001, detector->getCurrentAllocationNumber());
+
+    for (int j = 0; j < 1000; j++)
+        detector->deallocMemory(testAllocator, mem[j]);
+
+    LONGS_EQUAL(0, detector->totalMemoryLeaks(mem_leak_period_all));
+    LONGS_EQUAL(0, detector->getUntrackedAllocations());
+    LONGS_EQUAL(1000, testAllocator->free_called);
+    STRCMP_EQUAL("", reporter->message->asCharString());
+}
+
+static size_t sampleAndCountIntervals(MemoryLeakDetector* detector, TestMemoryAllocator* allocator, char** mem, size_t* intervals)
+{
+    size_t count = 0;
+    size_t sinceLastTracked = 0;
+    for (int i = 0; i < 64; i++) {
+        size_t trackedBefore = detector->totalMemoryLeaks(mem_leak_period_checking);
+        mem[i] = detector->allocMemory(allocator, 4);
+        sinceLastTracked++;
+        if (detector->totalMemoryLeaks(mem_leak_period_checking) != trackedBefore) {
+            intervals[count++] = sinceLastTracked;
+            sinceLastTracked = 0;
+        }
+    }
+    return count;
+}
+
+TEST(MemoryLeakDetectorTest, samplingIntervalsVaryButAreTheSameEverytimeSamplingIsSet)
+{
+    char* mem[128];
+    size_t intervals[64];
+    size_t repeatedIntervals[64];
+
+    detector->sampleEveryNthAllocation(4);
+    size_t count = sampleAndCountIntervals(detector, testAllocator, mem, intervals);
+    detector->sampleEveryNthAllocation(4);
+    size_t repeatedCount = sampleAndCountIntervals(detector, testAllocator, mem + 64, repeatedIntervals);
+
+    bool allIntervalsEqual = true;
+    for (size_t i = 1; i < count; i++)
+        if (intervals[i] != intervals[0]) allIntervalsEqual = false;
+    CHECK_FALSE(allIntervalsEqual);
+    LONGS_EQUAL(count, repeatedCount);
+    for (size_t i = 0; i < count; i++)
+        LONGS_EQUAL(intervals[i], repeatedIntervals[i]);
+
+    for (int j = 0; j < 128; j++)
+        detector->deallocMemory(testAllocator, mem[j]);
+}
+
+TEST(MemoryLeakDetectorTest, samplingEveryNBytesTracksAllocationsCrossingTheByteCount)
+{
+    detector->sampleEveryNBytes(100);
+    char* small1 = detector->allocMemory(testAllocator, 40);
+    char* small2 = detector->allocMemory(testAllocator, 40);
+    char* large = detector->allocMemory(testAllocator, 200);
+
+    SimpleString output = detector->report(mem_leak_period_checking);
+    STRCMP_CONTAINS("size: 200", output.asCharString());
+
+    detector->deallocMemory(testAllocator, small1);
+    detector->deallocMemory(testAllocator, small2);
+    detector->deallocMemory(testAllocator, large);
+    LONGS_EQUAL(0, detector->getUntrackedAllocations());
+}
+
+TEST(MemoryLeakDetectorTest, samplingReportMentionsTheSamplingRate)
+{
+    detector->sampleEveryNthAllocation(2);
+    char* mem[8];
+    for (int i = 0; i < 8; i++)
+        mem[i] = detector->allocMemory(testAllocator, 4);
+    SimpleString output = detector->report(mem_leak_period_checking);
+    STRCMP_CONTAINS("only one in every 2 allocations was tracked", output.asCharString());
+    for (int j = 0; j < 8; j++)
+        detector->deallocMemory(testAllocator, mem[j]);
+}
+
+TEST(MemoryLeakDetectorTest, reallocOfUntrackedMemoryStaysUntrackedAndUsesTheAllocatorThatAllocatedIt)
+{
+    detector->setTier(mem_leak_tier_count_only);
+    char* mem = detector->allocMemory(testAllocator, 10, "file", 1);
+    SimpleString::StrNCpy(mem, "untracked", 10);
+    mem = detector->reallocMemory(defaultMallocAllocator(), mem, 1000, "file", 2, true);
+
+    STRCMP_EQUAL("untracked", mem);
+    LONGS_EQUAL(2, testAllocator->alloc_called);
+    LONGS_EQUAL(1, testAllocator->free_called);
+    LONGS_EQUAL(0, detector->totalMemoryLeaks(mem_leak_period_checking));
+    LONGS_EQUAL(1, detector->getUntrackedAllocations());
+
+    detector->deallocMemory(defaultMallocAllocator(), mem, true);
+    LONGS_EQUAL(2, testAllocator->free_called);
+    LONGS_EQUAL(0, detector->getUntrackedAllocations());
+    STRCMP_EQUAL("", reporter->message->asCharString());
+}
+
+TEST(MemoryLeakDetectorTest, deallocatingNonAllocatedMemoryIsReportedWhileThereIsUntrackedMemory)
+{
+    char nonAllocated[10];
+    detector->setTier(mem_leak_tier_count_only);
+    char* mem = detector->allocMemory(testAllocator, 4);
+
+    detector->deallocMemory(testAllocator, nonAllocated);
+    CHECK(reporter->message->contains("Deallocating non-allocated memory\n"));
+    LONGS_EQUAL(0, testAllocator->free_called);
+
+    detector->deallocMemory(testAllocator, mem);
+    LONGS_EQUAL(1, testAllocator->free_called);
+}
+
+TEST(MemoryLeakDetectorTest, deallocatingNonAllocatedMemoryIsReportedAgainAfterUntrackedMemoryIsFreed)
+{
+    char nonAllocated;
+    detector->sampleEveryNthAllocation(2);
+    char* mem = detector->allocMemory(testAllocator, 4);
+    detector->deallocMemory(testAllocator, mem);
+    detector->disableSampling();
+
+    detector->deallocMemory(testAllocator, &nonAllocated);
+    CHECK(reporter->message->contains("Deallocating non-allocated memory\n"));
+}
+
+TEST(MemoryLeakDetectorTest, reallocatingNonAllocatedMemoryIsReportedWhileThereIsUntrackedMemory)
+{
+    char nonAllocated[10];
+    detector->setTier(mem_leak_tier_count_only);
+    char* mem = detector->allocMemory(testAllocator, 4);
+
+    POINTERS_EQUAL(NULLPTR, detector->reallocMemory(testAllocator, nonAllocated, 20, "file", 1));
+    CHECK(reporter->message->contains("Deallocating non-allocated memory\n"));
+
+    detector->deallocMemory(testAllocator, mem);
+}
+
+TEST(MemoryLeakDetectorTest, deallocatingNonAllocatedMemoryThroughAnArenaIsReported)
+{
+    char nonAllocated[10];
+    ArenaTestMemoryAllocator arena(1024);
+
+    detector->deallocMemory(&arena, nonAllocated);
+    CHECK(reporter->message->contains("Deallocating non-allocated memory\n"));
+    LONGS_EQUAL(0, arena.getDeallocations());
+}
+
+TEST(MemoryLeakDetectorTest, reallocOfUntrackedMemoryThroughAnArenaMovesItIntoTheArena)
+{
+    ArenaTestMemoryAllocator arena(1024);
+    detector->setTier(mem_leak_tier_count_only);
+    char* mem = detector->allocMemory(testAllocator, 10, "file", 1);
+    SimpleString::StrNCpy(mem, "untracked", 10);
+
+    mem = detector->reallocMemory(&arena, mem, 100, "file", 2);
+    STRCMP_EQUAL("untracked", mem);
+    CHECK(arena.ownsMemory(mem));
+    LONGS_EQUAL(1, testAllocator->free_called);
+    LONGS_EQUAL(0, detector->getUntrackedAllocations());
+    STRCMP_EQUAL("", reporter->message->asCharString());
+    detector->deallocMemory(&arena, mem);
+}
+
+TEST(MemoryLeakDetectorTest, samplingRateOfOneDisablesSampling)
+{
+    detector->sampleEveryNthAllocation(1);
+    LONGS_EQUAL(mem_leak_sampling_none, detector->getSampling());
+    detector->sampleEveryNBytes(0);
+    LONGS_EQUAL(mem_leak_sampling_none, detector->getSampling());
+}
+
+TEST(MemoryLeakDetectorTest, tierOffPassesAllocationsStraightThroughWithoutNumberingThem)
+{
+    detector->setTier(mem_leak_tier_off);
+    char* mem = detector->allocMemory(testAllocator, 4);
+    LONGS_EQUAL(0, detector->totalMemoryLeaks(mem_leak_period_checking));
+    LONGS_EQUAL(1, detector->getCurrentAllocationNumber());
+    LONGS_EQUAL(0, detector->getTotalAllocatedBytes());
+    LONGS_EQUAL(0, detector->getUntrackedAllocations());
+    detector->deallocMemory(testAllocator, mem);
+    LONGS_EQUAL(1, testAllocator->free_called);
+    STRCMP_EQUAL("", reporter->message->asCharString());
+}
+
+TEST(MemoryLeakDetectorTest, tierOffPassesReallocStraightThrough)
+{
+    detector->setTier(mem_leak_tier_off);
+    char* mem = detector->reallocMemory(testAllocator, NULLPTR, 4, "file", 1);
+    SimpleString::StrNCpy(mem, "abc", 4);
+    mem = detector->reallocMemory(testAllocator, mem, 100, "file", 2);
+    STRCMP_EQUAL("abc", mem);
+    LONGS_EQUAL(1, detector->getCurrentAllocationNumber());
+    LONGS_EQUAL(0, detector->getUntrackedAllocations());
+    detector->deallocMemory(testAllocator, mem);
+    STRCMP_EQUAL("", reporter->message->asCharString());
+}
+
+TEST(MemoryLeakDetectorTest, tierOffStillFreesMemoryAllocatedBeforeItWasTurnedOffTheWayItWasAllocated)
+{
+    detector->setTier(mem_leak_tier_count_only);
+    char* untracked = detector->allocMemory(testAllocator, 4);
+    detector->setTier(mem_leak_tier_full);
+    char* tracked = detector->allocMemory(defaultNewArrayAllocator(), 4);
+
+    detector->setTier(mem_leak_tier_off);
+    detector->deallocMemory(testAllocator, untracked);
+    LONGS_EQUAL(0, detector->getUntrackedAllocations());
+    detector->deallocMemory(defaultNewArrayAllocator(), tracked);
+    LONGS_EQUAL(0, detector->totalMemoryLeaks(mem_leak_period_checking));
+}
+
+TEST(MemoryLeakDetectorTest, tierCountOnlyReportsDeallocatingNonAllocatedMemory)
+{
+    char nonAllocated[10];
+    detector->setTier(mem_leak_tier_count_only);
+    char* mem = detector->allocMemory(testAllocator, 4);
+    LONGS_EQUAL(1, detector->getUntrackedAllocations());
+
+    detector->deallocMemory(testAllocator, nonAllocated);
+    CHECK(reporter->message->contains("Deallocating non-allocated memory\n"));
+    LONGS_EQUAL(0, testAllocator->free_called);
+
+    detector->deallocMemory(testAllocator, mem);
+}
+
+TEST(MemoryLeakDetectorTest, tierCountOnlyCountsAllocationsWithoutTrackingThem)
+{
+    detector->setTier(mem_leak_tier_count_only);
+    CHECK_FALSE(detector->isTrackingLeaks());
+    char* mem = detector->allocMemory(testAllocator, 4);
+    LONGS_EQUAL(0, detector->totalMemoryLeaks(mem_leak_period_checking));
+    LONGS_EQUAL(2, detector->getCurrentAllocationNumber());
+    detector->deallocMemory(testAllocator, mem);
+    LONGS_EQUAL(0, detector->getUntrackedAllocations());
+}
+
+TEST(MemoryLeakDetectorTest, tierLeakOnlyTracksLeaksWithoutCorruptionOrTypeChecks)
+{
+    detector->setTier(mem_leak_tier_leak_only);
+    CHECK(detector->isTrackingLeaks());
+    char* mem = detector->allocMemory(defaultNewArrayAllocator(), 10, "ALLOC.c", 10);
+    LONGS_EQUAL(1, detector->totalMemoryLeaks(mem_leak_period_checking));
+    mem[10] = 'O';
+    detector->deallocMemory(defaultNewAllocator(), mem, "FREE.c", 100);
+    LONGS_EQUAL(0, detector->totalMemoryLeaks(mem_leak_period_checking));
+    STRCMP_EQUAL("", reporter->message->asCharString());
+}
+
+TEST(MemoryLeakDetectorTest, memoryAllocatedWithoutGuardIsNotCorruptWhenFreedUnderTierFull)
+{
+    detector->setTier(mem_leak_tier_leak_only);
+    char* mem = detector->allocMemory(defaultMallocAllocator(), 10, "ALLOC.c", 10);
+    detector->setTier(mem_leak_tier_full);
+    detector->deallocMemory(defaultMallocAllocator(), mem, "FREE.c", 100);
+    STRCMP_EQUAL("", reporter->message->asCharString());
+}
+
+TEST(MemoryLeakDetectorTest, guardedMemoryCorruptionIsReportedByTheGuardingAllocator)
+{
+    GuardedTestMemoryAllocator guarded(defaultMallocAllocator(), guard_canaries);
+    char* mem = detector->allocMemory(&guarded, 10, "ALLOC.c", 10);
+    mem[10] = 'O';
+    detector->deallocMemory(&guarded, mem, "FREE.c", 100);
+    CHECK(reporter->message->contains("Memory corruption"));
+    CHECK(reporter->message->contains("   allocated at file: ALLOC.c line: 10 size: 10 type: malloc"));
+}
+
+TEST(MemoryLeakDetectorTest, guardedMemoryIsTrackedAndFreedWithoutFalsePositives)
+{
+    GuardedTestMemoryAllocator guarded(defaultMallocAllocator());
+    char* mem = detector->allocMemory(&guarded, 10, "ALLOC.c", 10);
+    mem[9] = 'O';
+    LONGS_EQUAL(1, detector->totalMemoryLeaks(mem_leak_period_checking));
+    detector->deallocMemory(&guarded, mem, "FREE.c", 100);
+    LONGS_EQUAL(0, detector->totalMemoryLeaks(mem_leak_period_checking));
+    STRCMP_EQUAL("", reporter->message->asCharString());
+}
+
+TEST(MemoryLeakDetectorTest, guardedMemoryIsTrackedEvenWhenLeaksAreNotTracked)
+{
+    GuardedTestMemoryAllocator guarded(defaultMallocAllocator(), guard_canaries);
+    detector->setTier(mem_leak_tier_off);
+    char* mem = detector->allocMemory(&guarded, 10);
+    LONGS_EQUAL(1, detector->totalMemoryLeaks(mem_leak_period_checking));
+    LONGS_EQUAL(0, detector->getUntrackedAllocations());
+    detector->deallocMemory(&guarded, mem);
+}
+
+TEST(MemoryLeakDetectorTest, reallocGuardedMemoryMovesTheContents)
+{
+    GuardedTestMemoryAllocator guarded(defaultMallocAllocator(), guard_canaries);
+    char* mem = detector->allocMemory(&guarded, 4);
+    SimpleString::StrNCpy(mem, "abc", 4);
+    mem = detector->reallocMemory(&guarded, mem, 100, "REALLOC.c", 1);
+    STRCMP_EQUAL("abc", mem);
+    mem[99] = 'x';
+    LONGS_EQUAL(1, detector->totalMemoryLeaks(mem_leak_period_checking));
+    detector->deallocMemory(&guarded, mem);
+    STRCMP_EQUAL("", reporter->message->asCharString());
+}
+
+TEST(MemoryLeakDetectorTest, liveAndPeakBytesFollowAllocationsAndDeallocations)
+{
+    char* mem1 = detector->allocMemory(testAllocator, 10);
+    char* mem2 = detector->allocMemory(testAllocator, 20);
+    detector->deallocMemory(testAllocator, mem1);
+    LONGS_EQUAL(20, detector->getLiveBytes(mem_leak_period_checking));
+    LONGS_EQUAL(30, detector->getPeakBytes(mem_leak_period_checking));
+
+    mem2 = detector->reallocMemory(testAllocator, mem2, 50, "file", 1);
+    LONGS_EQUAL(50, detector->getLiveBytes(mem_leak_period_checking));
+    LONGS_EQUAL(50, detector->getPeakBytes(mem_leak_period_checking));
+
+    detector->deallocMemory(testAllocator, mem2);
+    LONGS_EQUAL(0, detector->getLiveBytes(mem_leak_period_all));
+    LONGS_EQUAL(50, detector->getPeakBytes(mem_leak_period_all));
+}
+
+TEST(MemoryLeakDetectorTest, totalAllocatedBytesOnlyGrows)
+{
+    char* mem = detector->allocMemory(testAllocator, 10);
+    detector->deallocMemory(testAllocator, mem);
+    mem = detector->reallocMemory(testAllocator, NULLPTR, 20, "file", 1);
+    mem = detector->reallocMemory(testAllocator, mem, 40, "file", 2);
+    detector->deallocMemory(testAllocator, mem);
+    LONGS_EQUAL(70, detector->getTotalAllocatedBytes());
+}
+
+TEST(MemoryLeakDetectorTest, resetPeakBytesStartsFromTheLiveBytes)
+{
+    char* mem1 = detector->allocMemory(testAllocator, 10);
+    char* mem2 = detector->allocMemory(testAllocator, 20);
+    detector->deallocMemory(testAllocator, mem2);
+    detector->resetPeakBytes();
+    LONGS_EQUAL(10, detector->getPeakBytes(mem_leak_period_checking));
+    detector->deallocMemory(testAllocator, mem1);
+}
+
+TEST(MemoryLeakDetectorTest, liveBytesArePerPeriod)
+{
+    char* mem1 = detector->allocMemory(testAllocator, 10);
+    detector->markCheckingPeriodLeaksAsNonCheckingPeriod();
+    detector->disable();
+    char* mem2 = detector->allocMemory(testAllocator, 20);
+    detector->startChecking();
+    char* mem3 = detector->allocMemory(testAllocator, 40);
+
+    LONGS_EQUAL(40, detector->getLiveBytes(mem_leak_period_checking));
+    LONGS_EQUAL(50, detector->getLiveBytes(mem_leak_period_enabled));
+    LONGS_EQUAL(20, detector->getLiveBytes(mem_leak_period_disabled));
+    LONGS_EQUAL(70, detector->getLiveBytes(mem_leak_period_all));
+
+    detector->clearAllAccounting(mem_leak_period_checking);
+    LONGS_EQUAL(30, detector->getLiveBytes(mem_leak_period_all));
+
+    detector->deallocMemory(testAllocator, mem1);
+    detector->deallocMemory(testAllocator, mem2);
+    PlatformSpecificFree(mem3);
+}
+
+class MemoryLeakReportSinkForTest : public MemoryLeakReportSink
+{
+public:
+    MemoryLeakReportSinkForTest() : chunks(0)
+    {
+    }
+
+    virtual void write(const char* chunk) CPPUTEST_OVERRIDE
+    {
+        output += chunk;
+        chunks++;
+    }
+
+    SimpleString output;
+    size_t chunks;
+};
+
+TEST(MemoryLeakDetectorTest, streamedReportIsNotCutOff)
+{
+    char* mem[100];
+    for (int i = 0; i < 100; i++)
+        mem[i] = detector->allocMemory(testAllocator, 10);
+
+    MemoryLeakReportSinkForTest sink;
+    detector->report(mem_leak_period_checking, sink);
+    STRCMP_CONTAINS("Total number of leaks:  100", sink.output.asCharString());
+    CHECK_FALSE(sink.output.contains("Too many memory leaks"));
+    CHECK(sink.chunks > 1);
+
+    for (int j = 0; j < 100; j++)
+        detector->deallocMemory(testAllocator, mem[j]);
+}
+
+TEST(MemoryLeakDetectorTest, reportBySiteAggregatesLeaksFromTheSameLine)
+{
+    detector->reportLeaksBySite(true);
+    char* mem1 = detector->allocMemory(testAllocator, 10, "foo.cpp", 88);
+    char* mem2 = detector->allocMemory(testAllocator, 10, "foo.cpp", 88);
+    char* mem3 = detector->allocMemory(testAllocator, 10, "foo.cpp", 88);
+    char* mem4 = detector->allocMemory(testAllocator, 100, "bar.cpp", 12);
+
+    SimpleString output = detector->report(mem_leak_period_checking);
+    STRCMP_CONTAINS("3 leak(s), 30 bytes allocated at: foo.cpp and line: 88", output.asCharString());
+    STRCMP_CONTAINS("1 leak(s), 100 bytes allocated at: bar.cpp and line: 12", output.asCharString());
+    STRCMP_CONTAINS("Total number of leaks:  4", output.asCharString());
+    CHECK(SimpleString::StrStr(output.asCharString(), "bar.cpp") < SimpleString::StrStr(output.asCharString(), "foo.cpp"));
+
+    detector->deallocMemory(testAllocator, mem1);
+    detector->deallocMemory(testAllocator, mem2);
+    detector->deallocMemory(testAllocator, mem3);
+    detector->deallocMemory(testAllocator, mem4);
+}
+
+static size_t fakeCallSite;
+static int backtraceRequestedDepth;
+static int symbolizeCalls;
+
+static int fakeBacktrace_(void** addresses, int maxAddresses)
+{
+    backtraceRequestedDepth = maxAddresses;
+    for (int i = 0; i < maxAddresses; i++)
+        addresses[i] = (void*) (fakeCallSite + (size_t) i);
+    return maxAddresses;
+}
+
+static void* firstSymbolizedAddress;
+
+static void fakeSymbolize_(void* address, char* name, size_t size)
+{
+    if (symbolizeCalls == 0) firstSymbolizedAddress = address;
+    symbolizeCalls++;
+    SimpleString::StrNCpy(name, "fakeSymbol", size);
+}
+
+TEST_GROUP(MemoryLeakDetectorStackTraceTest)
+{
+    MemoryLeakDetector* detector;
+    MemoryLeakFailureForTest *reporter;
+
+    void setup() CPPUTEST_OVERRIDE
+    {
+        reporter = new MemoryLeakFailureForTest;
+        reporter->message = new SimpleString();
+        detector = new MemoryLeakDetector(reporter);
+        detector->enable();
+        detector->startChecking();
+
+        fakeCallSite = 0x1000;
+        backtraceRequestedDepth = 0;
+        symbolizeCalls = 0;
+        firstSymbolizedAddress = NULLPTR;
+        UT_PTR_SET(PlatformSpecificBacktrace, fakeBacktrace_);
+        UT_PTR_SET(PlatformSpecificSymbolize, fakeSymbolize_);
+    }
+    void teardown() CPPUTEST_OVERRIDE
+    {
+        delete reporter->message;
+        delete detector;
+        delete reporter;
+    }
+};
+
+TEST(MemoryLeakDetectorStackTraceTest, noStackTracesAreCapturedByDefault)
+{
+    char* mem = detector->allocMemory(defaultMallocAllocator(), 4);
+    LONGS_EQUAL(0, backtraceRequestedDepth);
+    SimpleString output = detector->report(mem_leak_period_checking);
+    CHECK_FALSE(output.contains("Allocation stack"));
+    detector->deallocMemory(defaultMallocAllocator(), mem);
+}
+
+TEST(MemoryLeakDetectorStackTraceTest, captureDepthIsBounded)
+{
+    detector->captureStackTraces(1000);
+    LONGS_EQUAL(MemoryLeakStackTrace::MAX_DEPTH, detector->getStackTraceDepth());
+
+    detector->captureStackTraces(4);
+    char* mem = detector->allocMemory(defaultMallocAllocator(), 4);
+    LONGS_EQUAL(4 + MemoryLeakStackTrace::MAX_DETECTOR_DEPTH, backtraceRequestedDepth);
+    detector->deallocMemory(defaultMallocAllocator(), mem);
+}
+
+TEST(MemoryLeakDetectorStackTraceTest, identicalStacksAreStoredOnce)
+{
+    detector->captureStackTraces(4);
+    char* mem1 = detector->allocMemory(defaultMallocAllocator(), 4);
+    char* mem2 = detector->allocMemory(defaultMallocAllocator(), 8);
+    fakeCallSite = 0x2000;
+    char* mem3 = detector->allocMemory(defaultMallocAllocator(), 8);
+
+    LONGS_EQUAL(2, detector->getNumberOfStackTraces());
+
+    detector->deallocMemory(defaultMallocAllocator(), mem1);
+    detector->deallocMemory(defaultMallocAllocator(), mem2);
+    detector->deallocMemory(defaultMallocAllocator(), mem3);
+}
+
+TEST(MemoryLeakDetectorStackTraceTest, stacksAreOnlySymbolizedWhenReported)
+{
+    detector->captureStackTraces(2);
+    char* mem = detector->allocMemory(defaultMallocAllocator(), 4);
+    LONGS_EQUAL(0, symbolizeCalls);
+
+    SimpleString output = detector->report(mem_leak_period_checking);
+    LONGS_EQUAL(2, symbolizeCalls);
+    STRCMP_CONTAINS("Allocation stack:", output.asCharString());
+    STRCMP_CONTAINS("#1 <", output.asCharString());
+    STRCMP_CONTAINS("fakeSymbol", output.asCharString());
+    detector->deallocMemory(defaultMallocAllocator(), mem);
+}
+
+TEST(MemoryLeakDetectorStackTraceTest, stackStartsAtTheMarkedAllocationCaller)
+{
+    detector->captureStackTraces(2);
+    MemoryLeakAllocationCaller caller(detector, (void*) (fakeCallSite + 5));
+    char* mem = detector->allocMemory(defaultMallocAllocator(), 4);
+
+    detector->report(mem_leak_period_checking);
+    POINTERS_EQUAL((void*) (fakeCallSite + 5), firstSymbolizedAddress);
+    detector->deallocMemory(defaultMallocAllocator(), mem);
+}
+
+TEST(MemoryLeakDetectorStackTraceTest, nestedAllocationCallersKeepTheOutermostCaller)
+{
+    detector->captureStackTraces(2);
+    MemoryLeakAllocationCaller outer(detector, (void*) (fakeCallSite + 7));
+    char* mem;
+    {
+        MemoryLeakAllocationCaller inner(detector, (void*) (fakeCallSite + 4));
+        mem = detector->allocMemory(defaultMallocAllocator(), 4);
+    }
+    POINTERS_EQUAL((void*) (fakeCallSite + 7), detector->getAllocationCaller());
+
+    detector->report(mem_leak_period_checking);
+    POINTERS_EQUAL((void*) (fakeCallSite + 7), firstSymbolizedAddress);
+    detector->deallocMemory(defaultMallocAllocator(), mem);
+}
+
+TEST(MemoryLeakDetectorStackTraceTest, allocationCallerIsOnlyMarkedWhileCapturingStackTraces)
+{
+    {
+        MemoryLeakAllocationCaller caller(detector, (void*) (fakeCallSite + 5));
+        POINTERS_EQUAL(NULLPTR, detector->getAllocationCaller());
+    }
+    detector->captureStackTraces(2);
+    {
+        MemoryLeakAllocationCaller caller(detector, (void*) (fakeCallSite + 5));
+        POINTERS_EQUAL((void*) (fakeCallSite + 5), detector->getAllocationCaller());
+    }
+    POINTERS_EQUAL(NULLPTR, detector->getAllocationCaller());
+}
+
+TEST(MemoryLeakDetectorStackTraceTest, unknownAllocationCallerSkipsTheFramesOfTheDetector)
+{
+    detector->captureStackTraces(2);
+    MemoryLeakAllocationCaller caller(detector, (void*) 0x42);
+    char* mem = detector->allocMemory(defaultMallocAllocator(), 4);
+
+    detector->report(mem_leak_period_checking);
+    POINTERS_EQUAL((void*) (fakeCallSite + 3), firstSymbolizedAddress);
+    detector->deallocMemory(defaultMallocAllocator(), mem);
+}
+
+TEST(MemoryLeakDetectorStackTraceTest, corruptionReportContainsTheAllocationStack)
+{
+    detector->captureStackTraces(2);
+    char* mem = detector->allocMemory(defaultMallocAllocator(), 10, "ALLOC.c", 10);
+    mem[10] = 'O';
+    detector->deallocMemory(defaultMallocAllocator(), mem, "FREE.c", 100);
+    CHECK(reporter->message->contains("Memory corruption"));
+    CHECK(reporter->message->contains("Allocation stack:"));
+}
+
 TEST_GROUP(MemoryLeakDetectorListTest)
 {
 };
@@ -561,6 +1192,49 @@ TEST(MemoryLeakDetectorListTest, clearAllAccountingIsWorkingProperly)
     CHECK(&node3 == listForTesting.getFirstLeak(mem_leak_period_disabled));
 }
 
+TEST_GROUP(MemoryLeakUntrackedMemoryTableTest)
+{
+    MemoryLeakUntrackedMemoryTable table;
+
+    char* fakeMemory(size_t i)
+    {
+        return (char*) ((i + 1) * 16);
+    }
+};
+
+TEST(MemoryLeakUntrackedMemoryTableTest, unknownMemoryIsNotFound)
+{
+    POINTERS_EQUAL(NULLPTR, table.retrieve(fakeMemory(0)));
+    CHECK_FALSE(table.remove(fakeMemory(0)));
+}
+
+TEST(MemoryLeakUntrackedMemoryTableTest, addedMemoryIsFoundWithItsSizeAndAllocator)
+{
+    table.add(fakeMemory(0), 10, defaultMallocAllocator());
+    MemoryLeakUntrackedMemory* untracked = table.retrieve(fakeMemory(0));
+    CHECK(untracked != NULLPTR);
+    LONGS_EQUAL(10, untracked->size_);
+    POINTERS_EQUAL(defaultMallocAllocator(), untracked->allocator_);
+    LONGS_EQUAL(1, table.size());
+}
+
+TEST(MemoryLeakUntrackedMemoryTableTest, memoryStaysFindableWhenTheTableGrowsAndEntriesAreRemoved)
+{
+    for (size_t i = 0; i < 1000; i++)
+        CHECK(table.add(fakeMemory(i), i, defaultMallocAllocator()));
+    for (size_t i = 0; i < 1000; i += 2)
+        CHECK(table.remove(fakeMemory(i)));
+
+    LONGS_EQUAL(500, table.size());
+    for (size_t i = 0; i < 1000; i++) {
+        MemoryLeakUntrackedMemory* untracked = table.retrieve(fakeMemory(i));
+        if (i % 2 == 0)
+            POINTERS_EQUAL(NULLPTR, untracked);
+        else
+            LONGS_EQUAL(i, untracked->size_);
+    }
+}
+
 TEST_GROUP(SimpleStringBuffer)
 {
 };
@@ -621,6 +1295,67 @@ TEST(SimpleStringBuffer, resetWriteLimit)
     STRCMP_EQUAL(str.asCharString(), buffer.toString());
 }
 
+TEST(SimpleStringBuffer, streamingFlushesAFullBufferToTheSink)
+{
+    MemoryLeakReportSinkForTest sink;
+    SimpleStringBuffer buffer;
+    buffer.setSink(&sink);
+    for (int i = 0; i < SimpleStringBuffer::SIMPLE_STRING_BUFFER_LEN * 2; i++)
+        buffer.add("h");
+    buffer.flush();
+
+    LONGS_EQUAL(SimpleStringBuffer::SIMPLE_STRING_BUFFER_LEN * 2, sink.output.size());
+    LONGS_EQUAL(3, sink.chunks);
+}
+
+TEST(SimpleStringBuffer, streamingDoesNotSplitAnAdd)
+{
+    MemoryLeakReportSinkForTest sink;
+    SimpleStringBuffer buffer;
+    buffer.setSink(&sink);
+    buffer.add("%s", SimpleString("h", SimpleStringBuffer::SIMPLE_STRING_BUFFER_LEN - 5).asCharString());
+    buffer.add("0123456789");
+
+    LONGS_EQUAL(1, sink.chunks);
+    STRCMP_EQUAL("0123456789", buffer.toString());
+}
+
+TEST(SimpleStringBuffer, fillingTheBufferExactlyDoesNotTruncate)
+{
+    SimpleStringBuffer buffer;
+    buffer.setWriteLimit(10);
+    buffer.add("0123456789");
+    CHECK(buffer.reachedItsCapacity());
+    CHECK_FALSE(buffer.wasTruncated());
+
+    buffer.add("a");
+    CHECK(buffer.wasTruncated());
+    STRCMP_EQUAL("0123456789", buffer.toString());
+}
+
+TEST(SimpleStringBuffer, streamingIsNotTruncatedWhenTheLastAddFillsTheBufferExactly)
+{
+    MemoryLeakReportSinkForTest sink;
+    SimpleStringBuffer buffer;
+    buffer.setSink(&sink);
+    buffer.add("%s", SimpleString("h", SimpleStringBuffer::SIMPLE_STRING_BUFFER_LEN - 11).asCharString());
+    buffer.add("0123456789");
+    CHECK(buffer.reachedItsCapacity());
+    CHECK_FALSE(buffer.wasTruncated());
+
+    buffer.flush();
+    LONGS_EQUAL(SimpleStringBuffer::SIMPLE_STRING_BUFFER_LEN - 1, sink.output.size());
+}
+
+TEST(SimpleStringBuffer, streamingTruncatesOnlyAnAddLargerThanTheWholeBuffer)
+{
+    MemoryLeakReportSinkForTest sink;
+    SimpleStringBuffer buffer;
+    buffer.setSink(&sink);
+    buffer.add("%s", SimpleString("h", SimpleStringBuffer::SIMPLE_STRING_BUFFER_LEN).asCharString());
+    CHECK(buffer.wasTruncated());
+}
+
 TEST(SimpleStringBuffer, addMemoryDumpOneLinePlusOnePartial)
 {
     SimpleStringBuffer buffer;
@@ -34,6 +34,7 @@
 #include "CppUTest/TestTestingFixture.h"
 #include "CppUTest/TestHarness_c.h"
 #include "CppUTest/SimpleMutex.h"
+#include "CppUTest/PlatformSpecificFunctions.h"
 #include "DummyMemoryLeakDetector.h"
 
 TEST_GROUP(MemoryLeakWarningLocalDetectorTest)
@@ -178,6 +179,331 @@ TEST(MemoryLeakWarningTest, FailingTestDoesNotReportMemoryLeaks)
     LONGS_EQUAL(1, fixture->getFailureCount());
 }
 
+static MemLeakSampling samplingInTest;
+static size_t samplingRateInTest;
+
+static void recordSampling_()
+{
+    samplingInTest = detector->getSampling();
+    samplingRateInTest = detector->getSamplingRate();
+}
+
+TEST(MemoryLeakWarningTest, samplingFromCommandLineAppliesToAllGroups)
+{
+    const char* argv[] = { "tests.exe", "-pmemleaksample=16" };
+    CHECK(memPlugin->parseArguments(2, argv, 1));
+    fixture->setTestFunction(recordSampling_);
+    fixture->runAllTests();
+
+    LONGS_EQUAL(mem_leak_sampling_allocations, samplingInTest);
+    LONGS_EQUAL(16, samplingRateInTest);
+    LONGS_EQUAL(mem_leak_sampling_none, detector->getSampling());
+}
+
+TEST(MemoryLeakWarningTest, samplingFromCommandLineForAnotherGroupDoesNotApply)
+{
+    const char* argv[] = { "tests.exe", "-pmemleaksamplebytes=OtherGroup:4096" };
+    CHECK(memPlugin->parseArguments(2, argv, 1));
+    fixture->setTestFunction(recordSampling_);
+    fixture->runAllTests();
+
+    LONGS_EQUAL(mem_leak_sampling_none, samplingInTest);
+}
+
+TEST(MemoryLeakWarningTest, samplingFromCommandLineForTheGroupOverridesTheDefault)
+{
+    const char* argv[] = { "tests.exe", "-pmemleaksample=16", "-pmemleaksample=ExecFunction:4" };
+    CHECK(memPlugin->parseArguments(3, argv, 1));
+    CHECK(memPlugin->parseArguments(3, argv, 2));
+    fixture->setTestFunction(recordSampling_);
+    fixture->runAllTests();
+
+    LONGS_EQUAL(4, samplingRateInTest);
+}
+
+TEST(MemoryLeakWarningTest, samplingArgumentWithoutValueIsRejected)
+{
+    const char* argv[] = { "tests.exe", "-pmemleaksample=", "-pmemleaksample=Group:" };
+    CHECK_FALSE(memPlugin->parseArguments(3, argv, 1));
+    CHECK_FALSE(memPlugin->parseArguments(3, argv, 2));
+}
+
+TEST(MemoryLeakWarningTest, samplingArgumentThatIsNotANumberIsRejected)
+{
+    const char* argv[] = { "tests.exe", "-pmemleaksample=often", "-pmemleaksample=Group:4k", "-pmemleakstack=deep" };
+    CHECK_FALSE(memPlugin->parseArguments(4, argv, 1));
+    CHECK_FALSE(memPlugin->parseArguments(4, argv, 2));
+    CHECK_FALSE(memPlugin->parseArguments(4, argv, 3));
+}
+
+#if CPPUTEST_USE_MEM_LEAK_DETECTION
+
+static void sampleAndLeak_()
+{
+    memPlugin->sampleLeaksEveryNthAllocationInTest(2);
+    leak1 = detector->allocMemory(allocator, 10);
+    leak2 = (long*) (void*) detector->allocMemory(allocator, 4);
+    recordSampling_();
+}
+
+TEST(MemoryLeakWarningTest, samplingInTestOnlyReportsTheSampledLeaks)
+{
+    fixture->setTestFunction(sampleAndLeak_);
+    fixture->runAllTests();
+
+    LONGS_EQUAL(2, samplingRateInTest);
+    LONGS_EQUAL(1, fixture->getFailureCount());
+    fixture->assertPrintContains("Total number of leaks:  1");
+    fixture->assertPrintContains("only one in every 2 allocations was tracked");
+}
+
+#endif
+
+static MemLeakTier tierInTest;
+
+static void recordTier_()
+{
+    tierInTest = detector->getTier();
+}
+
+TEST(MemoryLeakWarningTest, tierFromCommandLineForTheGroupIsApplied)
+{
+    const char* argv[] = { "tests.exe", "-pmemleaktier=leak-only", "-pmemleaktier=ExecFunction:count-only" };
+    CHECK(memPlugin->parseArguments(3, argv, 1));
+    CHECK(memPlugin->parseArguments(3, argv, 2));
+    fixture->setTestFunction(recordTier_);
+    fixture->runAllTests();
+
+    LONGS_EQUAL(mem_leak_tier_count_only, tierInTest);
+    LONGS_EQUAL(mem_leak_tier_full, detector->getTier());
+}
+
+TEST(MemoryLeakWarningTest, unknownTierIsRejected)
+{
+    const char* argv[] = { "tests.exe", "-pmemleaktier=verbose", "-pmemleaktier=Group:" };
+    CHECK_FALSE(memPlugin->parseArguments(3, argv, 1));
+    CHECK_FALSE(memPlugin->parseArguments(3, argv, 2));
+}
+
+static void leakWithTierOff_()
+{
+    memPlugin->setTierInTest(mem_leak_tier_off);
+    leak1 = detector->allocMemory(allocator, 10);
+    recordTier_();
+}
+
+TEST(MemoryLeakWarningTest, leaksAreNotReportedWhenTheTierDoesNotTrackThem)
+{
+    fixture->setTestFunction(leakWithTierOff_);
+    fixture->runAllTests();
+
+    LONGS_EQUAL(mem_leak_tier_off, tierInTest);
+    LONGS_EQUAL(0, fixture->getFailureCount());
+
+    detector->setTier(mem_leak_tier_off);
+    detector->deallocMemory(allocator, leak1);
+    leak1 = NULLPTR;
+}
+
+static void allocateThreeTimes_()
+{
+    for (int i = 0; i < 3; i++)
+        detector->deallocMemory(allocator, detector->allocMemory(allocator, 100));
+}
+
+TEST(MemoryLeakWarningTest, allocationsOverTheMaximumFromCommandLineFail)
+{
+    const char* argv[] = { "tests.exe", "-pmaxallocs=2" };
+    CHECK(memPlugin->parseArguments(2, argv, 1));
+    fixture->setTestFunction(allocateThreeTimes_);
+    fixture->runAllTests();
+
+    LONGS_EQUAL(1, fixture->getFailureCount());
+    fixture->assertPrintContains("Test made 3 allocations, the maximum is 2 allocations per test");
+}
+
+TEST(MemoryLeakWarningTest, allocationsWithinTheMaximumFromCommandLinePass)
+{
+    const char* argv[] = { "tests.exe", "-pmaxallocs=3", "-pmaxallocbytes=300" };
+    CHECK(memPlugin->parseArguments(3, argv, 1));
+    CHECK(memPlugin->parseArguments(3, argv, 2));
+    fixture->setTestFunction(allocateThreeTimes_);
+    fixture->runAllTests();
+
+    LONGS_EQUAL(0, fixture->getFailureCount());
+}
+
+TEST(MemoryLeakWarningTest, allocatedBytesOverTheMaximumForTheGroupFail)
+{
+    const char* argv[] = { "tests.exe", "-pmaxallocbytes=1000", "-pmaxallocbytes=ExecFunction:299" };
+    CHECK(memPlugin->parseArguments(3, argv, 1));
+    CHECK(memPlugin->parseArguments(3, argv, 2));
+    fixture->setTestFunction(allocateThreeTimes_);
+    fixture->runAllTests();
+
+    LONGS_EQUAL(1, fixture->getFailureCount());
+    fixture->assertPrintContains("Test allocated 300 bytes, the maximum is 299 bytes per test");
+}
+
+TEST(MemoryLeakWarningTest, maximumForAnotherGroupDoesNotApply)
+{
+    const char* argv[] = { "tests.exe", "-pmaxallocs=OtherGroup:1" };
+    CHECK(memPlugin->parseArguments(2, argv, 1));
+    fixture->setTestFunction(allocateThreeTimes_);
+    fixture->runAllTests();
+
+    LONGS_EQUAL(0, fixture->getFailureCount());
+}
+
+TEST(MemoryLeakWarningTest, maximumCountsAllocationsThatSamplingLeavesUntracked)
+{
+    const char* argv[] = { "tests.exe", "-pmaxallocs=2", "-pmemleaksample=1000" };
+    CHECK(memPlugin->parseArguments(3, argv, 1));
+    CHECK(memPlugin->parseArguments(3, argv, 2));
+    fixture->setTestFunction(allocateThreeTimes_);
+    fixture->runAllTests();
+
+    LONGS_EQUAL(1, fixture->getFailureCount());
+    fixture->assertPrintContains("Test made 3 allocations, the maximum is 2 allocations per test");
+}
+
+TEST(MemoryLeakWarningTest, maximumBytesCountAllocationsThatTheTierLeavesUntracked)
+{
+    const char* argv[] = { "tests.exe", "-pmaxallocbytes=299", "-pmemleaktier=count-only" };
+    CHECK(memPlugin->parseArguments(3, argv, 1));
+    CHECK(memPlugin->parseArguments(3, argv, 2));
+    fixture->setTestFunction(allocateThreeTimes_);
+    fixture->runAllTests();
+
+    LONGS_EQUAL(1, fixture->getFailureCount());
+    fixture->assertPrintContains("Test allocated 300 bytes, the maximum is 299 bytes per test");
+}
+
+static size_t liveBytesInTest;
+
+static void allocateWithinBudget_()
+{
+    char* memory = detector->allocMemory(allocator, 100);
+    leak1 = detector->allocMemory(allocator, 10);
+    liveBytesInTest = memPlugin->getLiveBytesInTest();
+    detector->deallocMemory(allocator, memory);
+    memPlugin->checkPeakInTest(111, __FILE__, __LINE__);
+    detector->deallocMemory(allocator, leak1);
+    leak1 = NULLPTR;
+}
+
+TEST(MemoryLeakWarningTest, peakWithinBudgetPassesAndIsReportedToTheResult)
+{
+    fixture->setOutputVerbose();
+    fixture->setTestFunction(allocateWithinBudget_);
+    fixture->runAllTests();
+
+    LONGS_EQUAL(110, liveBytesInTest);
+    LONGS_EQUAL(0, fixture->getFailureCount());
+    LONGS_EQUAL(0, memPlugin->getLiveBytesInTest());
+    fixture->assertPrintContains("- peak 110 bytes");
+}
+
+static void allocateOverBudget_()
+{
+    leak1 = detector->allocMemory(allocator, 100);
+    memPlugin->checkPeakInTest(100, "file", 7);
+}
+
+TEST(MemoryLeakWarningTest, peakOverBudgetFails)
+{
+    fixture->setTestFunction(allocateOverBudget_);
+    fixture->runAllTests();
+
+    LONGS_EQUAL(1, fixture->getFailureCount());
+    fixture->assertPrintContains("Memory peak of 100 bytes is not less than 100 bytes");
+}
+
+#if CPPUTEST_USE_MEM_LEAK_DETECTION
+
+TEST(MemoryLeakWarningTest, memoryMacrosUseTheFirstPlugin)
+{
+    size_t before = MEMORY_LIVE_BYTES();
+    char* memory = new char[100];
+    CHECK(MEMORY_LIVE_BYTES() >= before + 100);
+    delete [] memory;
+    MEMORY_PEAK_LESS_THAN(1000000);
+}
+
+static SimpleString* reportFileName;
+static SimpleString* reportFileContents;
+static void (*originalFPuts_)(const char*, PlatformSpecificFile);
+static void (*originalFClose_)(PlatformSpecificFile);
+
+static PlatformSpecificFile mockFOpen_(const char* filename, const char*)
+{
+    *reportFileName = filename;
+    return reportFileContents;
+}
+
+static void mockFPuts_(const char* str, PlatformSpecificFile file)
+{
+    if (file == reportFileContents)
+        *reportFileContents += str;
+    else
+        originalFPuts_(str, file);
+}
+
+static void mockFClose_(PlatformSpecificFile file)
+{
+    if (file != reportFileContents)
+        originalFClose_(file);
+}
+
+TEST(MemoryLeakWarningTest, reportFileReceivesTheLeakReport)
+{
+    originalFPuts_ = PlatformSpecificFPuts;
+    originalFClose_ = PlatformSpecificFClose;
+    UT_PTR_SET(PlatformSpecificFOpen, mockFOpen_);
+    UT_PTR_SET(PlatformSpecificFPuts, mockFPuts_);
+    UT_PTR_SET(PlatformSpecificFClose, mockFClose_);
+    SimpleString fileName;
+    SimpleString fileContents;
+    reportFileName = &fileName;
+    reportFileContents = &fileContents;
+
+    const char* argv[] = { "tests.exe", "-pmemleakreport=leaks.txt", "-pmemleakreport=" };
+    CHECK(memPlugin->parseArguments(3, argv, 1));
+    CHECK_FALSE(memPlugin->parseArguments(3, argv, 2));
+    CHECK(memPlugin->parseArguments(2, argv, 1));
+    fixture->setTestFunction(testTwoLeaks_);
+    fixture->runAllTests();
+
+    LONGS_EQUAL(1, fixture->getFailureCount());
+    STRCMP_EQUAL("leaks.txt", fileName.asCharString());
+    STRCMP_CONTAINS("Total number of leaks:  2", fileContents.asCharString());
+}
+
+#endif
+
+TEST(MemoryLeakWarningTest, reportBySiteFromCommandLine)
+{
+    const char* argv[] = { "tests.exe", "-pmemleakbysite" };
+    CHECK(memPlugin->parseArguments(2, argv, 1));
+    CHECK(detector->isReportingLeaksBySite());
+}
+
+TEST(MemoryLeakWarningTest, finalReportIsStreamedToTheOutput)
+{
+    StringBufferTestOutput output;
+    leak1 = detector->allocMemory(allocator, 10);
+    memPlugin->printFinalReport(output);
+    STRCMP_CONTAINS("Total number of leaks:  1", output.getOutput().asCharString());
+}
+
+TEST(MemoryLeakWarningTest, stackTraceDepthFromCommandLine)
+{
+    const char* argv[] = { "tests.exe", "-pmemleakstack=8", "-pmemleakstack=" };
+    CHECK(memPlugin->parseArguments(3, argv, 1));
+    CHECK_FALSE(memPlugin->parseArguments(3, argv, 2));
+    LONGS_EQUAL(8, detector->getStackTraceDepth());
+}
+
 static bool cpputestHasCrashed;
 
 TEST_GROUP(MemoryLeakWarningGlobalDetectorTest)
@@ -369,6 +695,231 @@ TEST(MemoryLeakWarningGlobalDetectorTest, threadSafeMemoryLeakDetectorOverloadsA
 
 #endif
 
+#if CPPUTEST_USE_MEM_LEAK_DETECTION
+
+TEST_GROUP(AllocationBudget)
+{
+    TestTestingFixture fixture;
+};
+
+TEST(AllocationBudget, scopeWithoutAllocationsPasses)
+{
+    int value = 0;
+    CHECK_NO_ALLOCATIONS {
+        value++;
+    }
+    LONGS_EQUAL(1, value);
+}
+
+TEST(AllocationBudget, allocatorsAreNotReplacedInTheScope)
+{
+    TestMemoryAllocator* mallocAllocator = getCurrentMallocAllocator();
+    TestMemoryAllocator* newAllocator = getCurrentNewAllocator();
+    TestMemoryAllocator* newArrayAllocator = getCurrentNewArrayAllocator();
+    CHECK_ALLOCATIONS_AT_MOST(1) {
+        POINTERS_EQUAL(mallocAllocator, getCurrentMallocAllocator());
+        POINTERS_EQUAL(newAllocator, getCurrentNewAllocator());
+        POINTERS_EQUAL(newArrayAllocator, getCurrentNewArrayAllocator());
+    }
+}
+
+TEST(AllocationBudget, memoryAllocatedInTheScopeCanBeFreedAfterIt)
+{
+    char* memory = NULLPTR;
+    CHECK_ALLOCATIONS_AT_MOST(1) {
+        memory = new char[10];
+    }
+    delete [] memory;
+}
+
+TEST(AllocationBudget, countsNewNewArrayAndMalloc)
+{
+    AllocationBudget budget(3, __FILE__, __LINE__);
+    budget.start();
+    delete new int;
+    delete [] new char[10];
+    cpputest_free_location_with_leak_detection(cpputest_malloc_location_with_leak_detection(10, __FILE__, __LINE__), __FILE__, __LINE__);
+    budget.stop();
+    LONGS_EQUAL(3, budget.getAllocations());
+    CHECK_FALSE(budget.isExceeded());
+}
+
+TEST(AllocationBudget, canBeUsedInsideLoops)
+{
+    for (int i = 0; i < 100; i++) {
+        CHECK_ALLOCATIONS_AT_MOST(1) {
+            delete new int;
+        }
+    }
+}
+
+TEST(AllocationBudget, countsAllocationsThatSamplingLeavesUntracked)
+{
+    MemoryLeakDetector* globalDetector = MemoryLeakWarningPlugin::getGlobalDetector();
+    AllocationBudget budget(3, __FILE__, __LINE__);
+    globalDetector->sampleEveryNthAllocation(1000);
+    budget.start();
+    delete new int;
+    delete new int;
+    budget.stop();
+    globalDetector->disableSampling();
+    LONGS_EQUAL(2, budget.getAllocations());
+}
+
+TEST(AllocationBudget, nestedBudgetsCountTheirOwnScope)
+{
+    AllocationBudget outer(3, __FILE__, __LINE__);
+    AllocationBudget inner(1, __FILE__, __LINE__);
+    outer.start();
+    delete new int;
+    inner.start();
+    delete new int;
+    inner.stop();
+    outer.stop();
+    LONGS_EQUAL(1, inner.getAllocations());
+    LONGS_EQUAL(2, outer.getAllocations());
+}
+
+static void allocateInNestedBudget_()
+{
+    CHECK_ALLOCATIONS_AT_MOST(1) {
+        delete new int;
+    }
+}
+
+static void allocateOverOuterBudgetBeforeNestedBudget_()
+{
+    CHECK_NO_ALLOCATIONS {
+        delete new int;
+        allocateInNestedBudget_();
+    }
+}
+
+TEST(AllocationBudget, outerBudgetKeepsTheLocationOfTheAllocationOverItsBudgetMadeBeforeANestedBudget)
+{
+    fixture.setTestFunction(allocateOverOuterBudgetBeforeNestedBudget_);
+    fixture.runAllTests();
+    LONGS_EQUAL(1, fixture.getFailureCount());
+    fixture.assertPrintContains("Expected no allocations, but 2 were done");
+    fixture.assertPrintContains(StringFromFormat("at file: %s line: %d", __FILE__, __LINE__ - 11));
+}
+
+static void allocateOverOuterBudgetInNestedBudget_()
+{
+    CHECK_ALLOCATIONS_AT_MOST(1) {
+        delete new int;
+        allocateInNestedBudget_();
+    }
+}
+
+TEST(AllocationBudget, outerBudgetLosesTheLocationOfTheAllocationOverItsBudgetMadeInANestedBudget)
+{
+    fixture.setTestFunction(allocateOverOuterBudgetInNestedBudget_);
+    fixture.runAllTests();
+    LONGS_EQUAL(1, fixture.getFailureCount());
+    fixture.assertPrintContains("Expected at most 1 allocation(s), but 2 were done");
+    fixture.assertPrintContains("at an unknown location");
+}
+
+static void allocateInNoAllocationScope_()
+{
+    CHECK_NO_ALLOCATIONS {
+        char* memory = new char[10];
+        delete [] memory;
+    }
+}
+
+TEST(AllocationBudget, allocationInNoAllocationScopeFailsWithTheLocationOfTheAllocation)
+{
+    fixture.setTestFunction(allocateInNoAllocationScope_);
+    fixture.runAllTests();
+    LONGS_EQUAL(1, fixture.getFailureCount());
+    fixture.assertPrintContains("Expected no allocations, but 1 were done");
+    fixture.assertPrintContains(StringFromFormat("at file: %s line: %d", __FILE__, __LINE__ - 11));
+}
+
+static void allocateMoreThanTheBudget_()
+{
+    CHECK_ALLOCATIONS_AT_MOST(2) {
+        delete new int;
+        delete new int;
+        delete new int;
+    }
+}
+
+TEST(AllocationBudget, allocationsOverTheBudgetFail)
+{
+    fixture.setTestFunction(allocateMoreThanTheBudget_);
+    fixture.runAllTests();
+    LONGS_EQUAL(1, fixture.getFailureCount());
+    fixture.assertPrintContains("Expected at most 2 allocation(s), but 3 were done");
+    fixture.assertPrintContains(StringFromFormat("at file: %s line: %d", __FILE__, __LINE__ - 10));
+}
+
+static void returnFromScopeOverBudget_()
+{
+    CHECK_NO_ALLOCATIONS {
+        delete new int;
+        return;
+    }
+}
+
+TEST(AllocationBudget, scopeLeftByReturnIsStillChecked)
+{
+    fixture.setTestFunction(returnFromScopeOverBudget_);
+    fixture.runAllTests();
+    LONGS_EQUAL(1, fixture.getFailureCount());
+    fixture.assertPrintContains("Expected no allocations, but 1 were done");
+}
+
+TEST(AllocationBudget, breakInTheScopeLeavesTheEnclosingLoop)
+{
+    int iterations = 0;
+    for (int i = 0; i < 10; i++) {
+        CHECK_NO_ALLOCATIONS {
+            iterations++;
+            if (i == 2) break;
+        }
+    }
+    LONGS_EQUAL(3, iterations);
+}
+
+static void budgetWithoutNewDeleteOverloads_()
+{
+    CHECK_NO_ALLOCATIONS {
+    }
+}
+
+TEST(AllocationBudget, failsWhenTheNewDeleteOverloadsAreOff)
+{
+    fixture.setTestFunction(budgetWithoutNewDeleteOverloads_);
+    MemoryLeakWarningPlugin::saveAndDisableNewDeleteOverloads();
+    fixture.runAllTests();
+    MemoryLeakWarningPlugin::restoreNewDeleteOverloads();
+    LONGS_EQUAL(1, fixture.getFailureCount());
+    fixture.assertPrintContains("new and delete overloads are turned off");
+}
+
+static void budgetWithTheTierOff_()
+{
+    CHECK_NO_ALLOCATIONS {
+    }
+}
+
+TEST(AllocationBudget, failsWhenTheTierIsOff)
+{
+    MemoryLeakDetector* globalDetector = MemoryLeakWarningPlugin::getGlobalDetector();
+    MemLeakTier tier = globalDetector->getTier();
+    fixture.setTestFunction(budgetWithTheTierOff_);
+    globalDetector->setTier(mem_leak_tier_off);
+    fixture.runAllTests();
+    globalDetector->setTier(tier);
+    LONGS_EQUAL(1, fixture.getFailureCount());
+    fixture.assertPrintContains("but its tier is off");
+}
+
+#endif
+
 #if CPPUTEST_USE_STD_CPP_LIB
 
 TEST(MemoryLeakWarningGlobalDetectorTest, turnOffNewOverloadsNoThrowCausesNoAdditionalLeaks)
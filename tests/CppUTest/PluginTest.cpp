@@ -40,7 +40,7 @@ class DummyPlugin: public TestPlugin
 {
 public:
     DummyPlugin(const SimpleString& name) :
-        TestPlugin(name), preAction(0), preActionSequence(0), postAction(0), postActionSequence(0)
+        TestPlugin(name), preAction(0), preActionSequence(0), postAction(0), postActionSequence(0), preRunAction(0), postRunAction(0)
     {
     }
 
@@ -56,10 +56,22 @@ public:
         postActionSequence = sequenceNumber++;
     }
 
+    virtual void preTestRunAction(TestResult&) CPPUTEST_OVERRIDE
+    {
+        preRunAction++;
+    }
+
+    virtual void postTestRunAction(TestResult&) CPPUTEST_OVERRIDE
+    {
+        postRunAction++;
+    }
+
     int preAction;
     int preActionSequence;
     int postAction;
     int postActionSequence;
+    int preRunAction;
+    int postRunAction;
 };
 
 class DummyPluginWhichAcceptsParameters: public DummyPlugin
@@ -138,6 +150,24 @@ TEST(PluginTest, ActionsAllRun)
     CHECK_EQUAL(2, firstPlugin->postAction);
 }
 
+TEST(PluginTest, TestRunActionsRunOncePerTestRun)
+{
+    UtestShell test("group", "test", "file", 1);
+    genFixture->addTest(&test);
+    genFixture->runAllTests();
+    CHECK_EQUAL(2, firstPlugin->preAction);
+    CHECK_EQUAL(1, firstPlugin->preRunAction);
+    CHECK_EQUAL(1, firstPlugin->postRunAction);
+}
+
+TEST(PluginTest, DisabledPluginsDontRunTheirTestRunActions)
+{
+    firstPlugin->disable();
+    genFixture->runAllTests();
+    CHECK_EQUAL(0, firstPlugin->preRunAction);
+    CHECK_EQUAL(0, firstPlugin->postRunAction);
+}
+
 TEST(PluginTest, Sequence)
 {
     registry->installPlugin(thirdPlugin);
@@ -323,6 +323,85 @@ TEST(SimpleStringInternalCache, deallocatingLargeMemoryThatWasntAllocatedWhileCa
     LONGS_EQUAL(1, fixture.getOutput().count("WARNING"));
 }
 
+TEST(SimpleStringInternalCache, useCacheSizes)
+{
+    size_t sizes[] = { 100, 20 };
+    cache.useCacheSizes(sizes, 2);
+    cache.setAllocator(allocator);
+
+    cache.dealloc(cache.alloc(20), 20);
+    cache.dealloc(cache.alloc(40), 40);
+    cache.dealloc(cache.alloc(120), 120);
+
+    cache.setAllocator(allocator->originalAllocator());
+
+    LONGS_EQUAL(1, accountant.totalAllocationsOfSize(32));
+    LONGS_EQUAL(1, accountant.totalAllocationsOfSize(112));
+    LONGS_EQUAL(1, accountant.totalDeallocationsOfSize(120));
+    CHECK(cache.hasFreeBlocksOfSize(20));
+    CHECK(cache.hasFreeBlocksOfSize(100));
+    CHECK_FALSE(cache.hasFreeBlocksOfSize(120));
+
+    cache.setAllocator(allocator);
+}
+
+TEST(SimpleStringInternalCache, useNoCacheSizesCachesNothing)
+{
+    cache.useCacheSizes(NULLPTR, 0);
+    cache.setAllocator(allocator);
+
+    cache.dealloc(cache.alloc(10), 10);
+
+    cache.setAllocator(allocator->originalAllocator());
+
+    LONGS_EQUAL(1, accountant.totalDeallocationsOfSize(10));
+    CHECK_FALSE(cache.hasFreeBlocksOfSize(10));
+
+    cache.setAllocator(allocator);
+}
+
+TEST(SimpleStringInternalCache, countsHitsAndMisses)
+{
+    cache.dealloc(cache.alloc(10), 10);
+    cache.dealloc(cache.alloc(10), 10);
+    cache.dealloc(cache.alloc(20), 20);
+    cache.dealloc(cache.alloc(1000), 1000);
+
+    LONGS_EQUAL(2, cache.cacheHits());
+    LONGS_EQUAL(1, cache.cacheMisses());
+    LONGS_EQUAL(1, cache.uncachedAllocations());
+}
+
+TEST(SimpleStringInternalCache, report)
+{
+    cache.dealloc(cache.alloc(10), 10);
+    cache.dealloc(cache.alloc(10), 10);
+    cache.dealloc(cache.alloc(100), 100);
+    cache.dealloc(cache.alloc(1000), 1000);
+
+    SimpleString report = cache.report();
+
+    STRCMP_CONTAINS("Cache size          # hits           # misses\n", report.asCharString());
+    STRCMP_CONTAINS("   32                   1                1\n", report.asCharString());
+    STRCMP_CONTAINS("  128                   0                1\n", report.asCharString());
+    STRCMP_CONTAINS("other                   0                1\n", report.asCharString());
+    STRCMP_CONTAINS("Hit rate 25% of 4 allocations\n", report.asCharString());
+}
+
+TEST(SimpleStringInternalCache, threadSafeCacheAllocatesTheSame)
+{
+    cache.turnOnThreadSafety();
+    cache.setAllocator(allocator);
+
+    char* memory = cache.alloc(10);
+    cache.dealloc(memory, 10);
+    POINTERS_EQUAL(memory, cache.alloc(10));
+
+    cache.setAllocator(allocator->originalAllocator());
+    LONGS_EQUAL(1, accountant.totalAllocationsOfSize(32));
+    cache.setAllocator(allocator);
+}
+
 TEST_GROUP(SimpleStringCacheAllocator)
 {
     SimpleStringCacheAllocator* allocator;
@@ -384,6 +463,8 @@ TEST(GlobalSimpleStringCache, installsAndRemovedCache)
         GlobalSimpleStringCache cache;
         STRCMP_EQUAL("SimpleStringCacheAllocator", SimpleString::getStringAllocator()->name());
         POINTERS_EQUAL(cache.getAllocator(), SimpleString::getStringAllocator());
+        SimpleString string("a string too long to be stored inside the SimpleString itself");
+        CHECK(cache.getCache().cacheMisses() + cache.getCache().cacheHits() > 0);
     }
     POINTERS_EQUAL(originalStringAllocator, SimpleString::getStringAllocator());
 }
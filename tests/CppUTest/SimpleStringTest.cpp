@@ -135,21 +135,22 @@ TEST(GlobalSimpleStringMemoryAccountant, stopFailsWhenAllocatorWasChangedInBetwe
 TEST(GlobalSimpleStringMemoryAccountant, report)
 {
     SimpleString str;
+    SimpleString more("More", CPPUTEST_SIMPLESTRING_INLINE_BUFFER_SIZE);
     accountant.start();
-    str += "More";
+    str += more;
     accountant.stop();
     STRCMP_CONTAINS(" 1                0                 1", accountant.report().asCharString());
 }
 
 TEST(GlobalSimpleStringMemoryAccountant, reportUseCaches)
 {
-    size_t caches[] = {32};
+    size_t caches[] = {64};
     accountant.useCacheSizes(caches, 1);
-    SimpleString str;
+    SimpleString str("S", CPPUTEST_SIMPLESTRING_INLINE_BUFFER_SIZE);
     accountant.start();
     str += "More";
     accountant.stop();
-    STRCMP_CONTAINS("32                   1                1                 1", accountant.report().asCharString());
+    STRCMP_CONTAINS("64                   1                1                 1", accountant.report().asCharString());
 }
 
 
@@ -192,11 +193,88 @@ TEST(SimpleString, allocatorForSimpleStringCanBeReplaced)
 {
     MyOwnStringAllocator myOwnAllocator;
     SimpleString::setStringAllocator(&myOwnAllocator);
-    SimpleString simpleString;
+    SimpleString simpleString("x", CPPUTEST_SIMPLESTRING_INLINE_BUFFER_SIZE);
     CHECK(myOwnAllocator.memoryWasAllocated);
     SimpleString::setStringAllocator(NULLPTR);
 }
 
+#if CPPUTEST_SIMPLESTRING_INLINE_BUFFER_SIZE > 2
+
+TEST(SimpleString, shortStringsAreNotAllocated)
+{
+    MyOwnStringAllocator myOwnAllocator;
+    SimpleString::setStringAllocator(&myOwnAllocator);
+    SimpleString empty;
+    SimpleString shortString("x", CPPUTEST_SIMPLESTRING_INLINE_BUFFER_SIZE - 1);
+    SimpleString copy(shortString);
+    empty = copy;
+    CHECK_FALSE(myOwnAllocator.memoryWasAllocated);
+    SimpleString::setStringAllocator(NULLPTR);
+}
+
+TEST(SimpleString, appendingToAShortStringCanMakeItLong)
+{
+    SimpleString s("x", CPPUTEST_SIMPLESTRING_INLINE_BUFFER_SIZE - 2);
+    s += "y";
+    s += "z";
+
+    CHECK_EQUAL(SimpleString("x", CPPUTEST_SIMPLESTRING_INLINE_BUFFER_SIZE - 2) + "yz", s);
+    LONGS_EQUAL(CPPUTEST_SIMPLESTRING_INLINE_BUFFER_SIZE, s.size());
+}
+
+#endif
+
+TEST(SimpleString, replaceMakingALongStringShort)
+{
+    SimpleString s("ab", CPPUTEST_SIMPLESTRING_INLINE_BUFFER_SIZE);
+    s.replace("ab", "a");
+
+    CHECK_EQUAL(SimpleString("a", CPPUTEST_SIMPLESTRING_INLINE_BUFFER_SIZE), s);
+}
+
+#if CPPUTEST_HAVE_MOVE_SEMANTICS
+
+TEST(SimpleString, moveConstructionTakesOverTheBuffer)
+{
+    SimpleString longString("x", CPPUTEST_SIMPLESTRING_INLINE_BUFFER_SIZE);
+    const char* buffer = longString.asCharString();
+    SimpleString moved(static_cast<SimpleString&&>(longString));
+
+    POINTERS_EQUAL(buffer, moved.asCharString());
+    CHECK(longString.isEmpty());
+}
+
+TEST(SimpleString, moveConstructionOfAShortString)
+{
+    SimpleString shortString("hello");
+    SimpleString moved(static_cast<SimpleString&&>(shortString));
+
+    STRCMP_EQUAL("hello", moved.asCharString());
+    CHECK(shortString.isEmpty());
+}
+
+TEST(SimpleString, moveAssignment)
+{
+    SimpleString longString("x", CPPUTEST_SIMPLESTRING_INLINE_BUFFER_SIZE);
+    SimpleString s("y", CPPUTEST_SIMPLESTRING_INLINE_BUFFER_SIZE);
+    const char* buffer = longString.asCharString();
+    s = static_cast<SimpleString&&>(longString);
+
+    POINTERS_EQUAL(buffer, s.asCharString());
+    CHECK(longString.isEmpty());
+}
+
+TEST(SimpleString, moveAssignmentToItself)
+{
+    SimpleString s("hello");
+    SimpleString& same = s;
+    s = static_cast<SimpleString&&>(same);
+
+    STRCMP_EQUAL("hello", s.asCharString());
+}
+
+#endif
+
 TEST(SimpleString, CreateSequence)
 {
     SimpleString expected("hellohello");
@@ -663,6 +741,58 @@ TEST(SimpleString, Doubles)
     STRCMP_EQUAL("1.2", s.asCharString());
 }
 
+TEST(SimpleString, DoublesAreFormattedLikePrintf)
+{
+    const double values[] = { 1.0, 0.5, 2.5, 0.1, 0.3, 1e-4, 0.00009999995, 0.000123456789, 999999.5, 999999.4, 9.9999996,
+                              123456.0, 1234567.0, 1e15, 123456789012345.0, 0.30000000000000004, 1.0 / 3, 2.0 / 3, 1e-5,
+                              4.35, 1e22, 12345.678901234567 };
+    const int precisions[] = { 0, 1, 2, 3, 6, 8, 10, 15, 17 };
+
+    for (size_t v = 0; v < sizeof(values) / sizeof(values[0]); v++)
+        for (size_t p = 0; p < sizeof(precisions) / sizeof(precisions[0]); p++)
+            for (double sign = -1.0; sign <= 1.0; sign += 2.0) {
+                double value = sign * values[v];
+                STRCMP_EQUAL(StringFromFormat("%.*g", precisions[p], value).asCharString(), StringFrom(value, precisions[p]).asCharString());
+            }
+
+    for (int i = 1; i < 20000; i++) {
+        double value = i * 0.0137;
+        STRCMP_EQUAL(StringFromFormat("%.*g", 6, value).asCharString(), StringFrom(value).asCharString());
+        STRCMP_EQUAL(StringFromFormat("%.*g", 3, value / 1000).asCharString(), StringFrom(value / 1000, 3).asCharString());
+    }
+}
+
+TEST(SimpleString, IntegersAreFormattedLikePrintf)
+{
+    int largestInt = (int) (~0U >> 1);
+    long largestLong = (long) (~0UL >> 1);
+
+    STRCMP_EQUAL(StringFromFormat("%d", largestInt).asCharString(), StringFrom(largestInt).asCharString());
+    STRCMP_EQUAL(StringFromFormat("%d", -largestInt - 1).asCharString(), StringFrom(-largestInt - 1).asCharString());
+    STRCMP_EQUAL(StringFromFormat("%ld", -largestLong - 1).asCharString(), StringFrom(-largestLong - 1).asCharString());
+    STRCMP_EQUAL(StringFromFormat("%lu", ~0UL).asCharString(), StringFrom(~0UL).asCharString());
+    STRCMP_EQUAL(StringFromFormat("%u", 0U).asCharString(), StringFrom(0U).asCharString());
+    STRCMP_EQUAL(StringFromFormat("%x", -1).asCharString(), HexStringFrom(-1).asCharString());
+    STRCMP_EQUAL(StringFromFormat("%lx", -2L).asCharString(), HexStringFrom(-2L).asCharString());
+    STRCMP_EQUAL("0", HexStringFrom(0U).asCharString());
+
+    for (int i = -1000; i < 1000; i += 7)
+        STRCMP_EQUAL(StringFromFormat("%d", i * 1009).asCharString(), StringFrom(i * 1009).asCharString());
+}
+
+#if CPPUTEST_USE_LONG_LONG
+
+TEST(SimpleString, LongLongIntsAreFormattedLikePrintf)
+{
+    cpputest_longlong largest = (cpputest_longlong) (~0ULL >> 1);
+
+    STRCMP_EQUAL(StringFromFormat("%lld", -largest - 1).asCharString(), StringFrom(-largest - 1).asCharString());
+    STRCMP_EQUAL(StringFromFormat("%llu", ~0ULL).asCharString(), StringFrom((cpputest_ulonglong) ~0ULL).asCharString());
+    STRCMP_EQUAL(StringFromFormat("%llx", -3LL).asCharString(), HexStringFrom((cpputest_longlong) -3).asCharString());
+}
+
+#endif
+
 extern "C" {
     static int alwaysTrue(double) { return true; }
 }
@@ -1045,6 +1175,68 @@ TEST(SimpleString, StrStr)
     CHECK(SimpleString::StrStr(foo, foo) == foo);
 }
 
+TEST(SimpleString, StrStrPeriodicNeedle)
+{
+    char haystack[] = "abababababcabc";
+    CHECK(SimpleString::StrStr(haystack, "ababc") == haystack+6);
+    CHECK(SimpleString::StrStr(haystack, "abcabc") == haystack+8);
+    CHECK(SimpleString::StrStr(haystack, "aaa") == NULLPTR);
+    CHECK(SimpleString::StrStr(haystack, "ababababab") == haystack);
+}
+
+static const char* naiveStrStr(const char* s1, const char* s2)
+{
+    for (; ; s1++) {
+        if (SimpleString::StrNCmp(s1, s2, SimpleString::StrLen(s2)) == 0) return s1;
+        if (!*s1) return NULLPTR;
+    }
+}
+
+static size_t naiveCount(const char* s1, const char* s2)
+{
+    size_t num = 0;
+    for (; *s1; s1++)
+        if (SimpleString::StrNCmp(s1, s2, SimpleString::StrLen(s2)) == 0) num++;
+    return num;
+}
+
+static void fillFromBits(char* str, size_t length, unsigned bits)
+{
+    for (size_t i = 0; i < length; i++)
+        str[i] = (bits & (1U << i)) ? 'b' : 'a';
+    str[length] = '\0';
+}
+
+TEST(SimpleString, StrStrAndCountFindTheSameAsANaiveSearch)
+{
+    char haystack[10];
+    char needle[7];
+    for (size_t haystackLength = 0; haystackLength < sizeof(haystack); haystackLength++)
+        for (unsigned haystackBits = 0; haystackBits < (1U << haystackLength); haystackBits++)
+            for (size_t needleLength = 1; needleLength < sizeof(needle); needleLength++)
+                for (unsigned needleBits = 0; needleBits < (1U << needleLength); needleBits++) {
+                    fillFromBits(haystack, haystackLength, haystackBits);
+                    fillFromBits(needle, needleLength, needleBits);
+                    if (SimpleString::StrStr(haystack, needle) != naiveStrStr(haystack, needle) ||
+                        SimpleString(haystack).count(needle) != naiveCount(haystack, needle))
+                        FAIL(StringFromFormat("searching \"%s\" in \"%s\"", needle, haystack).asCharString());
+                }
+}
+
+/* A naive search compares about a billion characters here */
+TEST(SimpleString, searchingALongHaystackIsLinear)
+{
+    SimpleString haystack("a", 1024 * 1024);
+    SimpleString needle = SimpleString("a", 1000) + "b";
+
+    CHECK(!haystack.contains(needle));
+    LONGS_EQUAL(0, haystack.count(needle));
+    haystack += "b";
+    CHECK(haystack.contains(needle));
+    LONGS_EQUAL(1, haystack.count(needle));
+    LONGS_EQUAL(1024 * 1024 - 999, haystack.count(SimpleString("a", 1000)));
+}
+
 TEST(SimpleString, AtoI)
 {
     char max_short_str[] = "32767";
@@ -1130,6 +1322,31 @@ TEST(SimpleString, MemCmpFirstLastNotMatching)
     CHECK(0 != SimpleString::MemCmp(base, lastNotMatching, sizeof(base)));
 }
 
+TEST(SimpleString, MemFirstDifference)
+{
+    unsigned char base[] = { 0x00, 0x01, 0x2A, 0xFF };
+    unsigned char lastNotMatching[] = { 0x00, 0x01, 0x2A, 0x00 };
+
+    LONGS_EQUAL(4, SimpleString::MemFirstDifference(base, base, sizeof(base)));
+    LONGS_EQUAL(3, SimpleString::MemFirstDifference(base, lastNotMatching, sizeof(base)));
+    LONGS_EQUAL(0, SimpleString::MemFirstDifference(NULLPTR, NULLPTR, 0));
+}
+
+TEST(SimpleString, MemFirstDifferenceInLongUnalignedBuffers)
+{
+    unsigned char buffer1[301];
+    unsigned char buffer2[300];
+    for (size_t i = 0; i < sizeof(buffer2); i++)
+        buffer1[i + 1] = buffer2[i] = (unsigned char) i;
+
+    LONGS_EQUAL(299, SimpleString::MemFirstDifference(buffer1 + 1, buffer2, 299));
+    buffer2[299] = 0;
+    LONGS_EQUAL(299, SimpleString::MemFirstDifference(buffer1 + 1, buffer2, 300));
+    buffer2[130] = 0;
+    LONGS_EQUAL(130, SimpleString::MemFirstDifference(buffer1 + 1, buffer2, 300));
+    CHECK(SimpleString::MemCmp(buffer1 + 1, buffer2, 300) > 0);
+}
+
 #if (CPPUTEST_CHAR_BIT == 16)
 TEST(SimpleString, MaskedBitsChar)
 {
@@ -1275,3 +1492,64 @@ TEST(SimpleString, BracketsFormattedHexStringFromForULongLong)
 }
 
 #endif
+
+TEST_GROUP(SimpleStringBuilder)
+{
+    SimpleStringBuilder builder;
+};
+
+TEST(SimpleStringBuilder, isEmptyWhenCreated)
+{
+    CHECK(builder.isEmpty());
+    LONGS_EQUAL(0, builder.size());
+    STRCMP_EQUAL("", builder.asCharString());
+    STRCMP_EQUAL("", builder.toString().asCharString());
+}
+
+TEST(SimpleStringBuilder, append)
+{
+    builder.append("hello").append(SimpleString(", ")).append("world!!", 5);
+
+    CHECK_FALSE(builder.isEmpty());
+    LONGS_EQUAL(12, builder.size());
+    STRCMP_EQUAL("hello, world", builder.toString().asCharString());
+}
+
+TEST(SimpleStringBuilder, clear)
+{
+    builder.append("hello");
+    builder.clear();
+
+    CHECK(builder.isEmpty());
+    STRCMP_EQUAL("", builder.asCharString());
+    builder.append("world");
+    STRCMP_EQUAL("world", builder.asCharString());
+}
+
+TEST(SimpleStringBuilder, appendFormatted)
+{
+    builder.append("value ").appendFormatted("<%d> and <%s>", 42, "text");
+
+    STRCMP_EQUAL("value <42> and <text>", builder.asCharString());
+}
+
+TEST(SimpleStringBuilder, appendFormattedLongerThanTheFreeSpace)
+{
+    SimpleString longText("x", 200);
+    builder.append("a");
+    builder.appendFormatted("%s", longText.asCharString());
+
+    STRCMP_EQUAL((SimpleString("a") + longText).asCharString(), builder.asCharString());
+}
+
+TEST(SimpleStringBuilder, manyAppendsGrowTheBuffer)
+{
+    SimpleString expected;
+    for (int i = 0; i < 1000; i++) {
+        builder.append("ab");
+        expected += "ab";
+    }
+
+    LONGS_EQUAL(2000, builder.size());
+    CHECK_EQUAL(expected, builder.toString());
+}
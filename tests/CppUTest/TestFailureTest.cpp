@@ -250,6 +250,85 @@ TEST(TestFailure, StringsEqualFailureWithNullAsExpected)
                 "\tbut was  <abd>", f);
 }
 
+static SimpleString logLines(size_t first, size_t last)
+{
+    SimpleString lines;
+    for (size_t i = first; i <= last; i++)
+        lines += StringFromFormat("log line %lu\n", (unsigned long) i);
+    return lines;
+}
+
+TEST(TestFailure, LongStringsEqualFailureOnlyShowsAWindow)
+{
+    SimpleString expected("a", 300);
+    SimpleString actual = SimpleString("a", 150) + "b" + SimpleString("a", 149);
+    StringEqualFailure f(test, failFileName, failLineNumber, expected.asCharString(), actual.asCharString(), "");
+    FAILURE_EQUAL("expected <...aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa...>\n"
+                "\tbut was  <...aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaabaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa...>\n"
+                "\tdifference starts at position 150 at: <aaaaaaaaaabaaaaaaaaa>\n"
+                "\t                                                 ^\n"
+                "\texpected has 300 characters, actual has 300", f);
+}
+
+TEST(TestFailure, LongStringsEqualFailureShowsTheDifferentLines)
+{
+    SimpleString expected = logLines(1, 30);
+    SimpleString actual = logLines(1, 9) + "log line ten\n" + logLines(11, 12) + "new line\n" + logLines(13, 30);
+    StringEqualFailure f(test, failFileName, failLineNumber, expected.asCharString(), actual.asCharString(), "");
+    FAILURE_EQUAL("expected <...\\nlog line 8\\nlog line 9\\nlog line 10\\nlog line 11\\nlog line 12\\nlog l...>\n"
+                "\tbut was  <...\\nlog line 8\\nlog line 9\\nlog line ten\\nlog line 11\\nlog line 12\\nnew ...>\n"
+                "\tdifference starts at position 108 at: <nlog line ten\\nlog l>\n"
+                "\t                                                 ^\n"
+                "\tdifference starts in line 10, different lines are marked with - (expected) and + (actual):\n"
+                "\t  8 | log line 8\n"
+                "\t  9 | log line 9\n"
+                "\t- 10 | log line 10\n"
+                "\t+ 10 | log line ten\n"
+                "\t  11 | log line 11\n"
+                "\t  12 | log line 12\n"
+                "\t+ 13 | new line\n"
+                "\t  13 | log line 13\n"
+                "\t  14 | log line 14\n"
+                "\texpected has 351 characters, actual has 361", f);
+}
+
+TEST(TestFailure, LongStringsEqualFailureCutsOffManyDifferentLines)
+{
+    SimpleString expected = logLines(1, 30);
+    SimpleString actual = logLines(1, 5) + logLines(106, 200);
+    StringEqualFailure f(test, failFileName, failLineNumber, expected.asCharString(), actual.asCharString(), "");
+    STRCMP_CONTAINS("\t- 30 | log line 30\n"
+                    "\t+ 6 | log line 106\n", f.getMessage().asCharString());
+    STRCMP_CONTAINS("\t+ 37 | log line 137\n"
+                    "\t...\n"
+                    "\texpected has 351 characters, actual has 1290", f.getMessage().asCharString());
+}
+
+TEST(TestFailure, LongStringsEqualFailureCutsOffLongLines)
+{
+    SimpleString expected = SimpleString("x", 150) + "\n" + logLines(1, 30);
+    SimpleString actual = SimpleString("y", 150) + "\n" + logLines(1, 30);
+    StringEqualFailure f(test, failFileName, failLineNumber, expected.asCharString(), actual.asCharString(), "");
+    SimpleString differentLines = SimpleString("\t- 1 | ") + SimpleString("x", 100) + "...\n"
+                                  "\t+ 1 | " + SimpleString("y", 100) + "...\n"
+                                  "\t  2 | log line 1\n"
+                                  "\t  3 | log line 2\n"
+                                  "\texpected has";
+    STRCMP_CONTAINS(differentLines.asCharString(), f.getMessage().asCharString());
+}
+
+TEST(TestFailure, CheckEqualFailureWithLongStrings)
+{
+    SimpleString expected = logLines(1, 30);
+    SimpleString actual = logLines(1, 29);
+    CheckEqualFailure f(test, failFileName, failLineNumber, expected, actual, "");
+    STRCMP_CONTAINS("difference starts in line 30, different lines are marked with - (expected) and + (actual):\n"
+                    "\t  28 | log line 28\n"
+                    "\t  29 | log line 29\n"
+                    "\t- 30 | log line 30\n"
+                    "\texpected has 351 characters, actual has 339", f.getMessage().asCharString());
+}
+
 TEST(TestFailure, StringsEqualNoCaseFailureWithText)
 {
     StringEqualNoCaseFailure f(test, failFileName, failLineNumber, "ABC", "abd", "text");
@@ -374,6 +453,54 @@ TEST(TestFailure, BinaryEqualLast)
     			"\t                                               ^", f);
 }
 
+TEST(TestFailure, BinaryEqualLongBuffersShowTheBytesAroundTheDifference)
+{
+    unsigned char expectedData[100] = { 0 };
+    unsigned char actualData[100] = { 0 };
+    actualData[50] = 0x01;
+    actualData[60] = 0x02;
+    actualData[99] = 0x03;
+    BinaryEqualFailure f(test, failFileName, failLineNumber, expectedData, actualData, sizeof(expectedData), "");
+    FAILURE_EQUAL("expected <...00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00...>\n"
+                  "\tbut was  <...00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 01 00 00 00 00 00 00 00 00 00 02 00 00 00 00 00...>\n"
+                  "\tdifference starts at position 50 at: <00 00 00 01 00 00 00>\n"
+                  "\t                                                ^\n"
+                  "\t3 of 100 bytes differ", f);
+}
+
+TEST(TestFailure, BinaryEqualLongBuffersWithTheDifferenceAtTheStart)
+{
+    unsigned char expectedData[100] = { 0 };
+    unsigned char actualData[100] = { 0 };
+    actualData[0] = 0x01;
+    BinaryEqualFailure f(test, failFileName, failLineNumber, expectedData, actualData, sizeof(expectedData), "");
+    FAILURE_EQUAL("expected <00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00...>\n"
+                  "\tbut was  <01 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00...>\n"
+                  "\tdifference starts at position 0 at: <         01 00 00 00>\n"
+                  "\t                                               ^\n"
+                  "\t1 of 100 bytes differ", f);
+}
+
+TEST(TestFailure, BinaryEqualLongBuffersWithTheDifferenceAtTheEnd)
+{
+    unsigned char expectedData[100] = { 0 };
+    unsigned char actualData[100] = { 0 };
+    actualData[99] = 0x01;
+    BinaryEqualFailure f(test, failFileName, failLineNumber, expectedData, actualData, sizeof(expectedData), "");
+    FAILURE_EQUAL("expected <...00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00>\n"
+                  "\tbut was  <...00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 01>\n"
+                  "\tdifference starts at position 99 at: <00 00 00 01         >\n"
+                  "\t                                                ^\n"
+                  "\t1 of 100 bytes differ", f);
+}
+
+TEST(TestFailure, BinaryEqualLongBufferActualNull)
+{
+    unsigned char expectedData[100] = { 0 };
+    BinaryEqualFailure f(test, failFileName, failLineNumber, expectedData, NULLPTR, sizeof(expectedData), "");
+    FAILURE_EQUAL("expected <00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00...>\n\tbut was  <(null)>", f);
+}
+
 TEST(TestFailure, BinaryEqualActualNull)
 {
     const unsigned char expectedData[] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
@@ -388,6 +515,57 @@ TEST(TestFailure, BinaryEqualExpectedNull)
     FAILURE_EQUAL("expected <(null)>\n\tbut was  <00 00 00 00 00 00 01>", f);
 }
 
+TEST(TestFailure, ArrayEqualWithText)
+{
+    ArrayEqualFailure f(test, failFileName, failLineNumber, 0, 2, "1, 2", "3, 2", "text");
+    FAILURE_EQUAL("Message: text\n"
+                  "\texpected <1, 2>\n"
+                  "\tbut was  <3, 2>\n"
+                  "\tdifference at index 0, showing elements 0 to 1 of 2", f);
+}
+
+TEST(TestFailure, ArrayEqualInTheMiddleOfALongArray)
+{
+    ArrayEqualFailure f(test, failFileName, failLineNumber, 50, 100, "a, b, c, d, e", "a, b, x, d, e", "");
+    FAILURE_EQUAL("expected <...a, b, c, d, e...>\n"
+                  "\tbut was  <...a, b, x, d, e...>\n"
+                  "\tdifference at index 50, showing elements 48 to 52 of 100", f);
+}
+
+TEST(TestFailure, FileEqualFailureInTheMiddleOfALongFile)
+{
+    unsigned char golden[100];
+    unsigned char actual[90];
+    for (unsigned char i = 0; i < 100; i++) golden[i] = i;
+    for (unsigned char i = 0; i < 90; i++) actual[i] = i;
+    actual[50] = 0xFF;
+    FileEqualFailure f(test, failFileName, failLineNumber, "golden.bin", golden, sizeof(golden), actual, sizeof(actual), 50, "");
+    FAILURE_EQUAL("golden file <golden.bin> differs at offset 50, it has 100 bytes and the actual contents have 90\n"
+                  "\texpected <...22 23 24 25 26 27 28 29 2A 2B 2C 2D 2E 2F 30 31 32 33 34 35 36 37 38 39 3A 3B 3C 3D 3E 3F 40 41...>\n"
+                  "\tbut was  <...22 23 24 25 26 27 28 29 2A 2B 2C 2D 2E 2F 30 31 FF 33 34 35 36 37 38 39 3A 3B 3C 3D 3E 3F 40 41...>\n"
+                  "\tdifference starts at position 50 at: <2F 30 31 FF 33 34 35>\n"
+                  "\t                                                ^", f);
+}
+
+TEST(TestFailure, FileEqualFailureWithAnEmptyGoldenFile)
+{
+    unsigned char actual[] = { 0x01 };
+    FileEqualFailure f(test, failFileName, failLineNumber, "golden.bin", NULLPTR, 0, actual, sizeof(actual), 0, "");
+    FAILURE_EQUAL("golden file <golden.bin> differs at offset 0, it has 0 bytes and the actual contents have 1\n"
+                  "\texpected <>\n"
+                  "\tbut was  <01>\n"
+                  "\tdifference starts at position 0 at: <         01         >\n"
+                  "\t                                               ^", f);
+}
+
+TEST(TestFailure, ArrayEqualWindow)
+{
+    LONGS_EQUAL(0, ArrayEqualFailure::windowStart(1));
+    LONGS_EQUAL(8, ArrayEqualFailure::windowStart(10));
+    LONGS_EQUAL(13, ArrayEqualFailure::windowEnd(10, 100));
+    LONGS_EQUAL(11, ArrayEqualFailure::windowEnd(10, 11));
+}
+
 TEST(TestFailure, BitsEqualWithText)
 {
     BitsEqualFailure f(test, failFileName, failLineNumber, 0x0001, 0x0003, 0x00FF, 2*8/CPPUTEST_CHAR_BIT, "text");
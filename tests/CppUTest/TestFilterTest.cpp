@@ -57,6 +57,15 @@ TEST(TestFilter, strictMatching)
     CHECK(!filter.match(" filter"));
 }
 
+TEST(TestFilter, matchingSimpleStrings)
+{
+    TestFilter filter("filter");
+    CHECK(filter.match(SimpleString("a filter")));
+    filter.strictMatching();
+    CHECK(!filter.match(SimpleString("a filter")));
+    CHECK(filter.match(SimpleString("filter")));
+}
+
 TEST(TestFilter, invertMatching)
 {
     TestFilter filter("filter");
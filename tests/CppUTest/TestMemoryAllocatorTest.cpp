@@ -189,6 +189,360 @@ TEST(MemoryLeakAllocator, name)
     STRCMP_EQUAL("MemoryLeakAllocator", allocator->name());
 }
 
+static size_t pageSizeZero_()
+{
+    return 0;
+}
+
+TEST_GROUP(GuardedTestMemoryAllocator)
+{
+};
+
+TEST(GuardedTestMemoryAllocator, forwardsNamesToTheOriginalAllocator)
+{
+    GuardedTestMemoryAllocator allocator(defaultMallocAllocator());
+    POINTERS_EQUAL(defaultMallocAllocator(), allocator.actualAllocator());
+    STRCMP_EQUAL(defaultMallocAllocator()->name(), allocator.name());
+    STRCMP_EQUAL(defaultMallocAllocator()->alloc_name(), allocator.alloc_name());
+    STRCMP_EQUAL(defaultMallocAllocator()->free_name(), allocator.free_name());
+    CHECK(allocator.guardsMemory());
+    CHECK_FALSE(defaultMallocAllocator()->guardsMemory());
+}
+
+TEST(GuardedTestMemoryAllocator, fallsBackToCanariesWhenPagesCantBeProtected)
+{
+    UT_PTR_SET(PlatformSpecificPageSize, pageSizeZero_);
+    GuardedTestMemoryAllocator allocator(defaultMallocAllocator(), guard_page_before_memory);
+    LONGS_EQUAL(guard_canaries, allocator.mode());
+}
+
+TEST(GuardedTestMemoryAllocator, guardPageAfterMemoryEndsTheMemoryOnAPageBoundary)
+{
+    GuardedTestMemoryAllocator allocator(defaultMallocAllocator(), guard_page_after_memory);
+    if (allocator.mode() == guard_canaries) return;
+
+    char* memory = allocator.alloc_memory(16, __FILE__, __LINE__);
+    LONGS_EQUAL(0, (size_t) (memory + 16) % PlatformSpecificPageSize());
+    PlatformSpecificMemset(memory, 'a', 16);
+    CHECK_FALSE(allocator.isMemoryCorrupted(memory));
+    allocator.free_memory(memory, 16, __FILE__, __LINE__);
+}
+
+TEST(GuardedTestMemoryAllocator, guardPageAfterMemoryKeepsOddSizedMemoryAligned)
+{
+    GuardedTestMemoryAllocator allocator(defaultMallocAllocator(), guard_page_after_memory);
+    if (allocator.mode() == guard_canaries) return;
+
+    char* memory = allocator.alloc_memory(13, __FILE__, __LINE__);
+    LONGS_EQUAL(0, (size_t) memory % (2 * sizeof(void*)));
+    LONGS_EQUAL(0, (size_t) (memory + 16) % PlatformSpecificPageSize());
+    memory[15] = 'a';
+    allocator.free_memory(memory, 13, __FILE__, __LINE__);
+}
+
+#if defined(CPPUTEST_HAVE_FORK) && defined(CPPUTEST_HAVE_WAITPID) && defined(CPPUTEST_HAVE_MPROTECT) && !CPPUTEST_SANITIZE_ADDRESS
+
+static void overrunIntoTheGuardPage_()
+{
+    GuardedTestMemoryAllocator allocator(defaultMallocAllocator(), guard_page_after_memory);
+    volatile char* memory = allocator.alloc_memory(13, __FILE__, __LINE__);
+    memory[16] = 'a';
+}
+
+TEST(GuardedTestMemoryAllocator, overrunIntoTheGuardPageCrashes)
+{
+    TestTestingFixture fixture;
+    fixture.setRunTestsInSeperateProcess();
+    fixture.setTestFunction(overrunIntoTheGuardPage_);
+    fixture.runAllTests();
+    fixture.assertPrintContains("Failed in separate process - killed by signal");
+    LONGS_EQUAL(1, fixture.getFailureCount());
+}
+
+#endif
+
+TEST(GuardedTestMemoryAllocator, guardPageBeforeMemoryStartsTheMemoryOnAPageBoundary)
+{
+    GuardedTestMemoryAllocator allocator(defaultMallocAllocator(), guard_page_before_memory);
+    if (allocator.mode() == guard_canaries) return;
+
+    char* memory = allocator.alloc_memory(10, __FILE__, __LINE__);
+    LONGS_EQUAL(0, (size_t) memory % PlatformSpecificPageSize());
+    PlatformSpecificMemset(memory, 'a', 10);
+    allocator.free_memory(memory, 10, __FILE__, __LINE__);
+}
+
+TEST(GuardedTestMemoryAllocator, canariesKeepTheMemoryAligned)
+{
+    GuardedTestMemoryAllocator allocator(defaultMallocAllocator(), guard_canaries);
+    char* memory = allocator.alloc_memory(13, __FILE__, __LINE__);
+    LONGS_EQUAL(0, (size_t) memory % (2 * sizeof(void*)));
+    allocator.free_memory(memory, 13, __FILE__, __LINE__);
+}
+
+TEST(GuardedTestMemoryAllocator, canariesAreIntactAfterInBoundsWrites)
+{
+    GuardedTestMemoryAllocator allocator(defaultMallocAllocator(), guard_canaries);
+    char* memory = allocator.alloc_memory(13, __FILE__, __LINE__);
+    PlatformSpecificMemset(memory, 'a', 13);
+    CHECK_FALSE(allocator.isMemoryCorrupted(memory));
+    allocator.free_memory(memory, 13, __FILE__, __LINE__);
+}
+
+TEST(GuardedTestMemoryAllocator, canariesDetectAnOverrunOfOneByte)
+{
+    GuardedTestMemoryAllocator allocator(defaultMallocAllocator(), guard_canaries);
+    char* memory = allocator.alloc_memory(13, __FILE__, __LINE__);
+    memory[13] = 'a';
+    CHECK(allocator.isMemoryCorrupted(memory));
+    allocator.free_memory(memory, 13, __FILE__, __LINE__);
+}
+
+TEST(GuardedTestMemoryAllocator, canariesDetectAnOverrunPastTheAlignment)
+{
+    GuardedTestMemoryAllocator allocator(defaultMallocAllocator(), guard_canaries);
+    char* memory = allocator.alloc_memory(16, __FILE__, __LINE__);
+    memory[16 + sizeof(size_t)] = 'a';
+    CHECK(allocator.isMemoryCorrupted(memory));
+    allocator.free_memory(memory, 16, __FILE__, __LINE__);
+}
+
+TEST(GuardedTestMemoryAllocator, canariesDetectAnUnderrun)
+{
+    GuardedTestMemoryAllocator allocator(defaultMallocAllocator(), guard_canaries);
+    char* memory = allocator.alloc_memory(8, __FILE__, __LINE__);
+    memory[-1] = 'a';
+    CHECK(allocator.isMemoryCorrupted(memory));
+    allocator.free_memory(memory, 8, __FILE__, __LINE__);
+}
+
+TEST_GROUP(ArenaTestMemoryAllocator)
+{
+};
+
+TEST(ArenaTestMemoryAllocator, allocatesAlignedMemoryFromOneChunk)
+{
+    ArenaTestMemoryAllocator arena(1024);
+    char* memory1 = arena.alloc_memory(3, __FILE__, __LINE__);
+    char* memory2 = arena.alloc_memory(5, __FILE__, __LINE__);
+
+    LONGS_EQUAL(1, arena.getNumberOfChunks());
+    LONGS_EQUAL(0, (size_t) memory1 % (2 * sizeof(void*)));
+    LONGS_EQUAL(0, (size_t) memory2 % (2 * sizeof(void*)));
+    CHECK(memory2 > memory1);
+    LONGS_EQUAL(2, arena.getAllocations());
+    LONGS_EQUAL(8, arena.getAllocatedBytes());
+    LONGS_EQUAL(5, arena.sizeOfMemory(memory2));
+    CHECK(arena.releasesMemoryInBulk());
+    CHECK_FALSE(defaultMallocAllocator()->releasesMemoryInBulk());
+}
+
+TEST(ArenaTestMemoryAllocator, freeingMemoryOnlyCountsTheFree)
+{
+    ArenaTestMemoryAllocator arena(1024);
+    char* memory = arena.alloc_memory(10, __FILE__, __LINE__);
+    arena.free_memory(memory, 10, __FILE__, __LINE__);
+
+    LONGS_EQUAL(1, arena.getDeallocations());
+    CHECK(arena.alloc_memory(10, __FILE__, __LINE__) != memory);
+}
+
+TEST(ArenaTestMemoryAllocator, startsANewChunkWhenTheCurrentOneIsFull)
+{
+    ArenaTestMemoryAllocator arena(1024);
+    for (int i = 0; i < 20; i++)
+        arena.alloc_memory(100, __FILE__, __LINE__);
+
+    CHECK(arena.getNumberOfChunks() > 1);
+    LONGS_EQUAL(arena.getNumberOfChunks() * 1024, arena.getReservedBytes());
+}
+
+TEST(ArenaTestMemoryAllocator, largeAllocationsGetAChunkOfTheirOwn)
+{
+    ArenaTestMemoryAllocator arena(1024);
+    char* small1 = arena.alloc_memory(10, __FILE__, __LINE__);
+    arena.alloc_memory(4000, __FILE__, __LINE__);
+    char* small2 = arena.alloc_memory(10, __FILE__, __LINE__);
+
+    LONGS_EQUAL(2, arena.getNumberOfChunks());
+    CHECK(small2 - small1 < 1024);
+}
+
+TEST(ArenaTestMemoryAllocator, resetKeepsOnlyTheCurrentChunk)
+{
+    ArenaTestMemoryAllocator arena(1024);
+    char* first = NULLPTR;
+    for (int i = 0; i < 20; i++)
+        first = arena.alloc_memory(100, __FILE__, __LINE__);
+    arena.alloc_memory(4000, __FILE__, __LINE__);
+
+    arena.reset();
+
+    LONGS_EQUAL(1, arena.getNumberOfChunks());
+    LONGS_EQUAL(1024, arena.getReservedBytes());
+    LONGS_EQUAL(0, arena.getAllocations());
+    LONGS_EQUAL(0, arena.getAllocatedBytes());
+    CHECK(arena.alloc_memory(100, __FILE__, __LINE__) <= first);
+}
+
+static size_t arenaAdvisedBytes_ = 0;
+
+static size_t pageSize4096_()
+{
+    return 4096;
+}
+
+static void* mapPagesWithMalloc_(size_t size)
+{
+    return PlatformSpecificMalloc(size);
+}
+
+static void unmapPagesWithFree_(void* memory, size_t)
+{
+    PlatformSpecificFree(memory);
+}
+
+static void recordAdvisedHugePages_(void*, size_t size)
+{
+    arenaAdvisedBytes_ += size;
+}
+
+TEST(ArenaTestMemoryAllocator, hugePagesMapChunksOfWholeHugePages)
+{
+    UT_PTR_SET(PlatformSpecificPageSize, pageSize4096_);
+    UT_PTR_SET(PlatformSpecificMapPages, mapPagesWithMalloc_);
+    UT_PTR_SET(PlatformSpecificUnmapPages, unmapPagesWithFree_);
+    UT_PTR_SET(PlatformSpecificAdviseHugePages, recordAdvisedHugePages_);
+    arenaAdvisedBytes_ = 0;
+
+    ArenaTestMemoryAllocator arena(1024, true);
+    arena.alloc_memory(10, __FILE__, __LINE__);
+
+    CHECK(arena.usesHugePages());
+    LONGS_EQUAL(ArenaTestMemoryAllocator::HUGE_PAGE_SIZE, arena.getReservedBytes());
+    LONGS_EQUAL(ArenaTestMemoryAllocator::HUGE_PAGE_SIZE, arenaAdvisedBytes_);
+}
+
+TEST(ArenaTestMemoryAllocator, hugePagesAreNotUsedWhenPagesCantBeMapped)
+{
+    UT_PTR_SET(PlatformSpecificPageSize, pageSizeZero_);
+    ArenaTestMemoryAllocator arena(1024, true);
+    CHECK_FALSE(arena.usesHugePages());
+}
+
+#if CPPUTEST_USE_MEM_LEAK_DETECTION
+
+TEST_GROUP(ArenaTestMemoryAllocatorInstalled)
+{
+    ArenaTestMemoryAllocatorScope scope;
+    ArenaTestMemoryAllocator* arena;
+
+    void setup() CPPUTEST_OVERRIDE
+    {
+        arena = defaultArenaTestMemoryAllocator();
+    }
+};
+
+TEST(ArenaTestMemoryAllocatorInstalled, memoryThatIsNeverFreedIsNoLeak)
+{
+    new int;
+    cpputest_malloc_location_with_leak_detection(10, __FILE__, __LINE__);
+
+    LONGS_EQUAL(2, arena->getAllocations());
+}
+
+TEST(ArenaTestMemoryAllocatorInstalled, freedMemoryIsReturnedToTheArena)
+{
+    delete new int;
+    cpputest_free_location_with_leak_detection(cpputest_malloc_location_with_leak_detection(10, __FILE__, __LINE__), __FILE__, __LINE__);
+
+    LONGS_EQUAL(2, arena->getDeallocations());
+}
+
+TEST(ArenaTestMemoryAllocatorInstalled, reallocKeepsTheContents)
+{
+    char* memory = (char*) cpputest_malloc_location_with_leak_detection(4, __FILE__, __LINE__);
+    PlatformSpecificMemCpy(memory, "abc", 4);
+    memory = (char*) cpputest_realloc_location_with_leak_detection(memory, 100, __FILE__, __LINE__);
+
+    STRCMP_EQUAL("abc", memory);
+    LONGS_EQUAL(2, arena->getAllocations());
+}
+
+TEST(ArenaTestMemoryAllocatorInstalled, memoryAllocatedBeforeTheArenaIsFreedByItsOwnAllocator)
+{
+    setCurrentMallocAllocator(defaultMallocAllocator());
+    char* memory = (char*) cpputest_malloc_location_with_leak_detection(10, __FILE__, __LINE__);
+    setCurrentMallocAllocator(arena);
+
+    cpputest_free_location_with_leak_detection(memory, __FILE__, __LINE__);
+    LONGS_EQUAL(0, arena->getDeallocations());
+}
+
+TEST_GROUP(ArenaTestMemoryAllocatorScope)
+{
+    ArenaTestMemoryAllocator arena;
+};
+
+TEST(ArenaTestMemoryAllocatorScope, installsTheArenaAndRestoresTheAllocatorsAndResetsTheArenaAfterwards)
+{
+    TestMemoryAllocator* mallocAllocator = getCurrentMallocAllocator();
+    TestMemoryAllocator* newAllocator = getCurrentNewAllocator();
+    TestMemoryAllocator* newArrayAllocator = getCurrentNewArrayAllocator();
+    {
+        ArenaTestMemoryAllocatorScope scope(arena);
+        POINTERS_EQUAL(&arena, getCurrentMallocAllocator());
+        POINTERS_EQUAL(&arena, getCurrentNewAllocator());
+        POINTERS_EQUAL(&arena, getCurrentNewArrayAllocator());
+        new int;
+    }
+    POINTERS_EQUAL(mallocAllocator, getCurrentMallocAllocator());
+    POINTERS_EQUAL(newAllocator, getCurrentNewAllocator());
+    POINTERS_EQUAL(newArrayAllocator, getCurrentNewArrayAllocator());
+    LONGS_EQUAL(0, arena.getAllocations());
+}
+
+TEST(ArenaTestMemoryAllocatorScope, memoryFreedAfterTheArenaIsUninstalledIsReturnedToTheArena)
+{
+    char* memory;
+    {
+        ArenaTestMemoryAllocatorScope scope(arena);
+        memory = new char[10];
+    }
+    delete [] memory;
+    LONGS_EQUAL(1, arena.getDeallocations());
+}
+
+TEST(ArenaTestMemoryAllocatorScope, memoryReallocatedAfterTheArenaIsUninstalledMovesToTheCurrentAllocator)
+{
+    char* memory;
+    {
+        ArenaTestMemoryAllocatorScope scope(arena);
+        memory = (char*) cpputest_malloc_location_with_leak_detection(4, __FILE__, __LINE__);
+        PlatformSpecificMemCpy(memory, "abc", 4);
+    }
+    memory = (char*) cpputest_realloc_location_with_leak_detection(memory, 100, __FILE__, __LINE__);
+
+    STRCMP_EQUAL("abc", memory);
+    CHECK_FALSE(arena.ownsMemory(memory));
+    LONGS_EQUAL(1, arena.getDeallocations());
+    cpputest_free_location_with_leak_detection(memory, __FILE__, __LINE__);
+}
+
+TEST(ArenaTestMemoryAllocatorScope, memoryOfADestroyedArenaIsNotFound)
+{
+    char* memory;
+    {
+        ArenaTestMemoryAllocator otherArena;
+        ArenaTestMemoryAllocatorScope scope(otherArena);
+        memory = new char[10];
+        POINTERS_EQUAL(&otherArena, ArenaTestMemoryAllocator::findArenaOwning(memory));
+    }
+    POINTERS_EQUAL(NULLPTR, ArenaTestMemoryAllocator::findArenaOwning(memory));
+}
+
+#endif
+
 #if CPPUTEST_USE_MEM_LEAK_DETECTION
 #if CPPUTEST_USE_MALLOC_MACROS
 
@@ -465,6 +819,126 @@ TEST(TestMemoryAccountant, reportAllocationsWithSizeZero)
 }
 
 
+TEST(TestMemoryAccountant, reportIsSortedBySizeAlsoForSizesWithTheSameHash)
+{
+    accountant.alloc(260);
+    accountant.alloc(4);
+    accountant.alloc(20);
+
+    STRCMP_EQUAL("CppUTest Memory Accountant report:\n"
+                 "Allocation size     # allocations    # deallocations   max # allocations at one time\n"
+                 "    4                   1                0                 1\n"
+                 "   20                   1                0                 1\n"
+                 "  260                   1                0                 1\n"
+                 "   Thank you for your business\n"
+                 , accountant.report().asCharString());
+    LONGS_EQUAL(1, accountant.totalAllocationsOfSize(260));
+    LONGS_EQUAL(1, accountant.totalAllocationsOfSize(4));
+}
+
+TEST(TestMemoryAccountant, sizeTableGrowsWithTheNumberOfSizes)
+{
+    for (size_t size = 1; size <= 1000; size++)
+        accountant.alloc(size * 8);
+
+    for (size_t size = 1; size <= 1000; size++)
+        LONGS_EQUAL(1, accountant.totalAllocationsOfSize(size * 8));
+    LONGS_EQUAL(0, accountant.totalAllocationsOfSize(12));
+    STRCMP_CONTAINS("Allocation size     # allocations    # deallocations   max # allocations at one time\n"
+                    "    8                   1                0                 1\n"
+                    "   16                   1                0                 1\n", accountant.report().asCharString());
+}
+
+TEST(TestMemoryAccountant, reportIsUnsortedWhenThereIsNoMemoryToSort)
+{
+    FailableMemoryAllocator allocator("Failable Malloc Allocator", "malloc", "free");
+    accountant.setAllocator(&allocator);
+    accountant.alloc(4);
+    accountant.alloc(8);
+    allocator.failAllocNumber(4);
+
+    STRCMP_EQUAL("CppUTest Memory Accountant report:\n"
+                 "Allocation size     # allocations    # deallocations   max # allocations at one time\n"
+                 "    8                   1                0                 1\n"
+                 "    4                   1                0                 1\n"
+                 "   Thank you for your business\n"
+                 , accountant.report().asCharString());
+    accountant.clear();
+}
+
+TEST(TestMemoryAccountant, sizesWithoutMemoryForTheirNodeAreOnlyCountedInTheTotals)
+{
+    FailableMemoryAllocator allocator("Failable Malloc Allocator", "malloc", "free");
+    accountant.setAllocator(&allocator);
+    allocator.failAllocNumber(2);
+    accountant.alloc(4);
+    accountant.dealloc(4);
+
+    LONGS_EQUAL(0, accountant.totalAllocationsOfSize(4));
+    LONGS_EQUAL(1, accountant.totalAllocations());
+    LONGS_EQUAL(1, accountant.totalDeallocations());
+    accountant.clear();
+}
+
+TEST(TestMemoryAccountant, countCurrentAndMaximumAllocationsOfAllSizes)
+{
+    accountant.alloc(4);
+    accountant.alloc(8);
+    accountant.dealloc(4);
+    accountant.alloc(16);
+    LONGS_EQUAL(2, accountant.currentAllocations());
+    LONGS_EQUAL(2, accountant.maximumAllocationsAtATime());
+}
+
+TEST(TestMemoryAccountant, histogramBucketsAreExactForSmallSizes)
+{
+    for (size_t size = 0; size < MemoryAccountant::HISTOGRAM_EXACT_SIZES; size++) {
+        LONGS_EQUAL(size, MemoryAccountant::histogramBucketOfSize(size));
+        LONGS_EQUAL(size, MemoryAccountant::largestSizeInHistogramBucket(size));
+    }
+}
+
+TEST(TestMemoryAccountant, histogramBucketsSplitEachPowerOfTwoInFour)
+{
+    LONGS_EQUAL(16, MemoryAccountant::histogramBucketOfSize(16));
+    LONGS_EQUAL(16, MemoryAccountant::histogramBucketOfSize(19));
+    LONGS_EQUAL(17, MemoryAccountant::histogramBucketOfSize(20));
+    LONGS_EQUAL(19, MemoryAccountant::histogramBucketOfSize(31));
+    LONGS_EQUAL(20, MemoryAccountant::histogramBucketOfSize(32));
+    LONGS_EQUAL(19, MemoryAccountant::largestSizeInHistogramBucket(16));
+    LONGS_EQUAL(31, MemoryAccountant::largestSizeInHistogramBucket(19));
+    LONGS_EQUAL(39, MemoryAccountant::largestSizeInHistogramBucket(20));
+    LONGS_EQUAL(MemoryAccountant::HISTOGRAM_BUCKETS - 1, MemoryAccountant::histogramBucketOfSize((size_t) -1));
+    CHECK((size_t) -1 == MemoryAccountant::largestSizeInHistogramBucket(MemoryAccountant::HISTOGRAM_BUCKETS - 1));
+}
+
+TEST(TestMemoryAccountant, allocationSizePercentiles)
+{
+    LONGS_EQUAL(0, accountant.allocationSizePercentile(50));
+    for (int i = 0; i < 8; i++)
+        accountant.alloc(8);
+    accountant.alloc(100);
+    accountant.alloc(1000);
+
+    LONGS_EQUAL(8, accountant.allocationSizePercentile(50));
+    LONGS_EQUAL(8, accountant.allocationSizePercentile(80));
+    LONGS_EQUAL(111, accountant.allocationSizePercentile(90));
+    LONGS_EQUAL(1000, accountant.allocationSizePercentile(99));
+}
+
+TEST(TestMemoryAccountant, reportPercentiles)
+{
+    accountant.alloc(4);
+    accountant.alloc(4);
+    accountant.dealloc(4);
+    accountant.alloc(64);
+
+    STRCMP_EQUAL("CppUTest Memory Accountant allocation sizes:\n"
+                 "50% <= 4   90% <= 64   99% <= 64   largest 64\n"
+                 "Current # allocations 2, max # allocations at one time 2\n"
+                 , accountant.reportPercentiles().asCharString());
+}
+
 static void failUseCacheSizesAfterAllocation_(MemoryAccountant* accountant)
 {
     size_t cacheSizes[] = {0};
@@ -601,6 +1075,22 @@ TEST(AccountingTestMemoryAllocator, useOriginalAllocatorWhenDeallocatingMemoryNo
     LONGS_EQUAL(1, accountant.totalDeallocations());
 }
 
+TEST(AccountingTestMemoryAllocator, keepsTrackOfSizesOfManyAllocationsFreedInAnyOrder)
+{
+    char* memory[200];
+    for (size_t i = 0; i < 200; i++)
+        memory[i] = allocator->alloc_memory(i % 10 + 1, __FILE__, __LINE__);
+
+    for (size_t i = 1; i < 200; i += 2)
+        allocator->free_memory(memory[i], i % 10 + 1, __FILE__, __LINE__);
+    for (size_t i = 200; i > 0; i -= 2)
+        allocator->free_memory(memory[i - 2], (i - 2) % 10 + 1, __FILE__, __LINE__);
+
+    LONGS_EQUAL(200, accountant.totalAllocations());
+    LONGS_EQUAL(200, accountant.totalDeallocations());
+    LONGS_EQUAL(20, accountant.totalDeallocationsOfSize(7));
+}
+
 TEST(AccountingTestMemoryAllocator, allocatorForwardsAllocAndFreeName)
 {
     STRCMP_EQUAL("malloc", allocator->alloc_name());
@@ -679,6 +1169,16 @@ TEST(GlobalMemoryAccountant, report)
     STRCMP_CONTAINS("1                1                 1", accountant.report().asCharString());
 }
 
+TEST(GlobalMemoryAccountant, reportPercentiles)
+{
+    accountant.start();
+    char* memory = new char[185];
+    delete [] memory;
+    accountant.stop();
+
+    STRCMP_CONTAINS("Current # allocations 0, max # allocations at one time 1", accountant.reportPercentiles().asCharString());
+}
+
 TEST(GlobalMemoryAccountant, reportWithCacheSizes)
 {
     size_t cacheSizes[] = {512};
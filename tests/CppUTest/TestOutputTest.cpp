@@ -178,6 +178,16 @@ TEST(TestOutput, PrintTestVerboseEnded)
     STRCMP_EQUAL("TEST(group, test) - 5 ms\n", mock->getOutput().asCharString());
 }
 
+TEST(TestOutput, PrintTestVerboseEndedWithPeakMemory)
+{
+    mock->verbose(TestOutput::level_verbose);
+    result->currentTestStarted(tst);
+    millisTime = 5;
+    result->setCurrentTestPeakMemory(1234);
+    result->currentTestEnded(tst);
+    STRCMP_EQUAL("TEST(group, test) - 5 ms - peak 1234 bytes\n", mock->getOutput().asCharString());
+}
+
 TEST(TestOutput, printColorWithSuccess)
 {
     mock->color();
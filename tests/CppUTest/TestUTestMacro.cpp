@@ -28,6 +28,11 @@
 #include "CppUTest/TestHarness.h"
 #include "CppUTest/TestOutput.h"
 #include "CppUTest/TestTestingFixture.h"
+#include "CppUTest/PlatformSpecificFunctions.h"
+
+#if CPPUTEST_USE_STD_C_LIB
+#include <stdio.h>
+#endif
 
 #define CHECK_TEST_FAILS_PROPER_WITH_TEXT(text) fixture.checkTestFailsWithProperTestLocation(text, __FILE__, __LINE__)
 
@@ -46,6 +51,11 @@
 TEST_GROUP(UnitTestMacros)
 {
     TestTestingFixture fixture;
+
+    void teardown() CPPUTEST_OVERRIDE
+    {
+        UtestShell::setUpdateGoldenFiles(false);
+    }
 };
 
 static void failingTestMethodWithFAIL_()
@@ -1011,6 +1021,233 @@ IGNORE_TEST(UnitTestMacros, MEMCMP_EQUALWorksInAnIgnoredTest)
     MEMCMP_EQUAL("TEST", "test", 5); // LCOV_EXCL_LINE
 } // LCOV_EXCL_LINE
 
+static void CHECK_ARRAY_EQUALFailingTestMethod_()
+{
+    const int expectedData[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    const int actualData[] = { 0, 1, 2, 3, 4, 5, 42, 7, 8, 9 };
+
+    CHECK_ARRAY_EQUAL(expectedData, actualData, 10);
+    TestTestingFixture::lineExecutedAfterCheck(); // LCOV_EXCL_LINE
+} // LCOV_EXCL_LINE
+
+TEST(UnitTestMacros, CHECK_ARRAY_EQUALFailureShowsTheElementsAroundTheDifference)
+{
+    fixture.runTestWithMethod(CHECK_ARRAY_EQUALFailingTestMethod_);
+    CHECK_TEST_FAILS_PROPER_WITH_TEXT("expected <...4, 5, 6, 7, 8...>");
+    CHECK_TEST_FAILS_PROPER_WITH_TEXT("but was  <...4, 5, 42, 7, 8...>");
+    CHECK_TEST_FAILS_PROPER_WITH_TEXT("difference at index 6, showing elements 4 to 8 of 10");
+}
+
+static void CHECK_ARRAY_EQUAL_TEXTFailingTestMethod_()
+{
+    const long expectedData[] = { 1, 2 };
+    const long actualData[] = { 2, 2 };
+
+    CHECK_ARRAY_EQUAL_TEXT(expectedData, actualData, 2, "Failed because it failed");
+    TestTestingFixture::lineExecutedAfterCheck(); // LCOV_EXCL_LINE
+} // LCOV_EXCL_LINE
+
+TEST(UnitTestMacros, CHECK_ARRAY_EQUAL_TEXTFailure)
+{
+    fixture.runTestWithMethod(CHECK_ARRAY_EQUAL_TEXTFailingTestMethod_);
+    CHECK_TEST_FAILS_PROPER_WITH_TEXT("expected <1, 2>");
+    CHECK_TEST_FAILS_PROPER_WITH_TEXT("but was  <2, 2>");
+    CHECK_TEST_FAILS_PROPER_WITH_TEXT("Failed because it failed");
+}
+
+static void CHECK_ARRAY_EQUALSucceedingTestMethod_()
+{
+    short data[100];
+    for (short i = 0; i < 100; i++) data[i] = i;
+
+    CHECK_ARRAY_EQUAL(data, data, 100);
+    CHECK_ARRAY_EQUAL((const short*) NULLPTR, (const short*) NULLPTR, 0);
+}
+
+TEST(UnitTestMacros, CHECK_ARRAY_EQUALCountsAsOneCheck)
+{
+    fixture.runTestWithMethod(CHECK_ARRAY_EQUALSucceedingTestMethod_);
+    LONGS_EQUAL(0, fixture.getFailureCount());
+    LONGS_EQUAL(2, fixture.getCheckCount());
+}
+
+TEST(UnitTestMacros, CHECK_ARRAY_EQUALBehavesAsProperMacro)
+{
+    const int data[] = { 1, 2 };
+    if (false) CHECK_ARRAY_EQUAL(data, data + 1, 1);
+    else CHECK_ARRAY_EQUAL(data, data, 2);
+}
+
+IGNORE_TEST(UnitTestMacros, CHECK_ARRAY_EQUALWorksInAnIgnoredTest)
+{
+    const int data[] = { 1, 2 }; // LCOV_EXCL_LINE
+    CHECK_ARRAY_EQUAL(data, data + 1, 1); // LCOV_EXCL_LINE
+} // LCOV_EXCL_LINE
+
+static void DOUBLES_ARRAY_EQUALFailingTestMethod_()
+{
+    double expectedData[40];
+    double actualData[40];
+    for (int i = 0; i < 40; i++) expectedData[i] = actualData[i] = i * 0.5;
+    actualData[33] = 17.0;
+
+    DOUBLES_ARRAY_EQUAL(expectedData, actualData, 40, 0.1);
+    TestTestingFixture::lineExecutedAfterCheck(); // LCOV_EXCL_LINE
+} // LCOV_EXCL_LINE
+
+TEST(UnitTestMacros, DOUBLES_ARRAY_EQUALFailure)
+{
+    fixture.runTestWithMethod(DOUBLES_ARRAY_EQUALFailingTestMethod_);
+    CHECK_TEST_FAILS_PROPER_WITH_TEXT("expected <...15.5, 16, 16.5, 17, 17.5...>");
+    CHECK_TEST_FAILS_PROPER_WITH_TEXT("but was  <...15.5, 16, 17, 17, 17.5...>");
+    CHECK_TEST_FAILS_PROPER_WITH_TEXT("difference at index 33, showing elements 31 to 35 of 40");
+}
+
+static void DOUBLES_ARRAY_EQUAL_TEXTFailingTestMethodWithFloats_()
+{
+    const float expectedData[] = { 1.0f, 2.0f, 3.0f };
+    const float actualData[] = { 1.0f, 2.0f, 3.5f };
+
+    DOUBLES_ARRAY_EQUAL_TEXT(expectedData, actualData, 3, 0.25, "Failed because it failed");
+    TestTestingFixture::lineExecutedAfterCheck(); // LCOV_EXCL_LINE
+} // LCOV_EXCL_LINE
+
+TEST(UnitTestMacros, DOUBLES_ARRAY_EQUAL_TEXTFailureWithFloats)
+{
+    fixture.runTestWithMethod(DOUBLES_ARRAY_EQUAL_TEXTFailingTestMethodWithFloats_);
+    CHECK_TEST_FAILS_PROPER_WITH_TEXT("expected <1, 2, 3>");
+    CHECK_TEST_FAILS_PROPER_WITH_TEXT("but was  <1, 2, 3.5>");
+    CHECK_TEST_FAILS_PROPER_WITH_TEXT("Failed because it failed");
+}
+
+static double zero = 0.0;
+
+static void DOUBLES_ARRAY_EQUALFailingTestMethodWithNaN_()
+{
+    double expectedData[20] = { 0.0 };
+    double actualData[20] = { 0.0 };
+    expectedData[19] = actualData[19] = zero / zero;
+
+    DOUBLES_ARRAY_EQUAL(expectedData, actualData, 20, 0.1);
+    TestTestingFixture::lineExecutedAfterCheck(); // LCOV_EXCL_LINE
+} // LCOV_EXCL_LINE
+
+TEST(UnitTestMacros, DOUBLES_ARRAY_EQUALFailsOnNaN)
+{
+    fixture.runTestWithMethod(DOUBLES_ARRAY_EQUALFailingTestMethodWithNaN_);
+    CHECK_TEST_FAILS_PROPER_WITH_TEXT("difference at index 19");
+}
+
+static void DOUBLES_ARRAY_EQUALSucceedingTestMethod_()
+{
+    double expectedData[50];
+    float actualData[50];
+    for (int i = 0; i < 50; i++) {
+        expectedData[i] = i / 3.0;
+        actualData[i] = (float) (i / 3.0);
+    }
+    expectedData[49] = actualData[49] = 1.0f / (float) zero;
+
+    DOUBLES_ARRAY_EQUAL(expectedData, expectedData, 50, 0.0);
+    DOUBLES_ARRAY_EQUAL(actualData, actualData, 50, 0.0);
+    DOUBLES_ARRAY_EQUAL_TEXT(expectedData, expectedData, 50, 0.0, "Shouldn't fail");
+}
+
+TEST(UnitTestMacros, DOUBLES_ARRAY_EQUALCountsAsOneCheck)
+{
+    fixture.runTestWithMethod(DOUBLES_ARRAY_EQUALSucceedingTestMethod_);
+    LONGS_EQUAL(0, fixture.getFailureCount());
+    LONGS_EQUAL(3, fixture.getCheckCount());
+}
+
+TEST(UnitTestMacros, DOUBLES_ARRAY_EQUALBehavesAsProperMacro)
+{
+    const double data[] = { 1.0, 2.0 };
+    if (false) DOUBLES_ARRAY_EQUAL(data, data + 1, 1, 0.1);
+    else DOUBLES_ARRAY_EQUAL(data, data, 2, 0.1);
+}
+
+IGNORE_TEST(UnitTestMacros, DOUBLES_ARRAY_EQUALWorksInAnIgnoredTest)
+{
+    const double data[] = { 1.0, 2.0 }; // LCOV_EXCL_LINE
+    DOUBLES_ARRAY_EQUAL(data, data + 1, 1, 0.1); // LCOV_EXCL_LINE
+} // LCOV_EXCL_LINE
+
+#if CPPUTEST_USE_LONG_LONG
+
+static void DOUBLES_ARRAY_EQUAL_ULPSSucceedingTestMethod_()
+{
+    const double expectedData[] = { 1.0, 0.1 + 0.2, -0.0, 1e300 };
+    const double actualData[] = { 1.0, 0.3, 0.0, 1e300 };
+    const float expectedFloats[] = { 1.0f, 0.1f + 0.2f, -0.0f };
+    const float actualFloats[] = { 1.0f, 0.3f, 0.0f };
+
+    DOUBLES_ARRAY_EQUAL_ULPS(expectedData, actualData, 4, 1);
+    DOUBLES_ARRAY_EQUAL_ULPS_TEXT(expectedFloats, actualFloats, 3, 1, "Shouldn't fail");
+}
+
+TEST(UnitTestMacros, DOUBLES_ARRAY_EQUAL_ULPSAllowsNeighbouringValues)
+{
+    fixture.runTestWithMethod(DOUBLES_ARRAY_EQUAL_ULPSSucceedingTestMethod_);
+    LONGS_EQUAL(0, fixture.getFailureCount());
+    LONGS_EQUAL(2, fixture.getCheckCount());
+}
+
+static void DOUBLES_ARRAY_EQUAL_ULPSFailingTestMethod_()
+{
+    const double expectedData[] = { 1.0, 0.1 + 0.2 };
+    const double actualData[] = { 1.0, 0.3 };
+
+    DOUBLES_ARRAY_EQUAL_ULPS(expectedData, actualData, 2, 0);
+    TestTestingFixture::lineExecutedAfterCheck(); // LCOV_EXCL_LINE
+} // LCOV_EXCL_LINE
+
+TEST(UnitTestMacros, DOUBLES_ARRAY_EQUAL_ULPSFailure)
+{
+    fixture.runTestWithMethod(DOUBLES_ARRAY_EQUAL_ULPSFailingTestMethod_);
+    CHECK_TEST_FAILS_PROPER_WITH_TEXT("difference at index 1, showing elements 0 to 1 of 2");
+}
+
+static void DOUBLES_ARRAY_EQUAL_ULPSFailingTestMethodWithNaN_()
+{
+    float expectedData[20] = { 0.0f };
+    float actualData[20] = { 0.0f };
+    expectedData[7] = actualData[7] = (float) (zero / zero);
+
+    DOUBLES_ARRAY_EQUAL_ULPS(expectedData, actualData, 20, 4);
+    TestTestingFixture::lineExecutedAfterCheck(); // LCOV_EXCL_LINE
+} // LCOV_EXCL_LINE
+
+TEST(UnitTestMacros, DOUBLES_ARRAY_EQUAL_ULPSFailsOnNaN)
+{
+    fixture.runTestWithMethod(DOUBLES_ARRAY_EQUAL_ULPSFailingTestMethodWithNaN_);
+    CHECK_TEST_FAILS_PROPER_WITH_TEXT("difference at index 7");
+}
+
+TEST(UnitTestMacros, DOUBLES_ARRAY_EQUAL_ULPSBehavesAsProperMacro)
+{
+    const double data[] = { 1.0, 2.0 };
+    if (false) DOUBLES_ARRAY_EQUAL_ULPS(data, data + 1, 1, 0);
+    else DOUBLES_ARRAY_EQUAL_ULPS(data, data, 2, 0);
+}
+
+#else
+
+static void DOUBLES_ARRAY_EQUAL_ULPSFailingTestMethod_()
+{
+    const double data[] = { 1.0 };
+    DOUBLES_ARRAY_EQUAL_ULPS(data, data, 1, 0);
+    TestTestingFixture::lineExecutedAfterCheck(); // LCOV_EXCL_LINE
+} // LCOV_EXCL_LINE
+
+TEST(UnitTestMacros, DOUBLES_ARRAY_EQUAL_ULPSFailsWithUnsupportedFeature)
+{
+    fixture.runTestWithMethod(DOUBLES_ARRAY_EQUAL_ULPSFailingTestMethod_);
+    CHECK_TEST_FAILS_PROPER_WITH_TEXT("CPPUTEST_USE_LONG_LONG");
+}
+
+#endif
+
 static void MEMCMP_EQUALFailingTestMethodWithUnequalInput_()
 {
     unsigned char expectedData[] = { 0x00, 0x01, 0x02, 0x03 };
@@ -1105,6 +1342,233 @@ IGNORE_TEST(UnitTestMacros, MEMCMP_EQUAL_TEXTWorksInAnIgnoredTest)
     MEMCMP_EQUAL_TEXT("TEST", "test", 5, "Failed because it failed"); // LCOV_EXCL_LINE
 } // LCOV_EXCL_LINE
 
+static unsigned char fakeGoldenFile_[8];
+static size_t fakeGoldenFileSize_ = 0;
+
+static void* fakeMapGoldenFile_(const char*, size_t* size, int writable)
+{
+    if (writable) fakeGoldenFileSize_ = *size;
+    else *size = fakeGoldenFileSize_;
+    return (*size > 0) ? fakeGoldenFile_ : NULLPTR;
+}
+
+static void* failMapGoldenFile_(const char*, size_t*, int)
+{
+    return NULLPTR;
+}
+
+static void fakeUnmapGoldenFile_(void*, size_t)
+{
+}
+
+static size_t fakeGoldenFileOffset_ = 0;
+
+static PlatformSpecificFile fakeFOpenGoldenFile_(const char*, const char*)
+{
+    fakeGoldenFileOffset_ = 0;
+    return fakeGoldenFile_;
+}
+
+static PlatformSpecificFile failFOpenGoldenFile_(const char*, const char*)
+{
+    return NULLPTR;
+}
+
+static size_t fakeFReadGoldenFile_(void* buffer, size_t, PlatformSpecificFile)
+{
+    if (fakeGoldenFileOffset_ == fakeGoldenFileSize_) return 0;
+    PlatformSpecificMemCpy(buffer, fakeGoldenFile_ + fakeGoldenFileOffset_++, 1);
+    return 1;
+}
+
+static size_t fakeFWriteGoldenFile_(const void* buffer, size_t size, PlatformSpecificFile)
+{
+    PlatformSpecificMemCpy(fakeGoldenFile_, buffer, size);
+    fakeGoldenFileSize_ = size;
+    return size;
+}
+
+static void fakeFCloseGoldenFile_(PlatformSpecificFile)
+{
+}
+
+static void setUnmappableFakeGoldenFile(const unsigned char* contents, size_t size)
+{
+    PlatformSpecificMemCpy(fakeGoldenFile_, contents, size);
+    fakeGoldenFileSize_ = size;
+    UT_PTR_SET(PlatformSpecificMapFile, failMapGoldenFile_);
+    UT_PTR_SET(PlatformSpecificFOpen, fakeFOpenGoldenFile_);
+    UT_PTR_SET(PlatformSpecificFRead, fakeFReadGoldenFile_);
+    UT_PTR_SET(PlatformSpecificFWrite, fakeFWriteGoldenFile_);
+    UT_PTR_SET(PlatformSpecificFClose, fakeFCloseGoldenFile_);
+}
+
+static void setFakeGoldenFile(const unsigned char* contents, size_t size)
+{
+    PlatformSpecificMemCpy(fakeGoldenFile_, contents, size);
+    fakeGoldenFileSize_ = size;
+    UT_PTR_SET(PlatformSpecificMapFile, fakeMapGoldenFile_);
+    UT_PTR_SET(PlatformSpecificUnmapPages, fakeUnmapGoldenFile_);
+}
+
+static const unsigned char goldenData_[] = { 0x00, 0x01, 0x02, 0x03 };
+
+TEST(UnitTestMacros, CHECK_FILE_EQUALSucceedsWithAnEqualGoldenFile)
+{
+    setFakeGoldenFile(goldenData_, sizeof(goldenData_));
+    CHECK_FILE_EQUAL("golden.bin", goldenData_, sizeof(goldenData_));
+}
+
+TEST(UnitTestMacros, CHECK_FILE_EQUALSucceedsWithAnEmptyGoldenFile)
+{
+    setFakeGoldenFile(goldenData_, 0);
+    CHECK_FILE_EQUAL("golden.bin", goldenData_, 0);
+}
+
+static void CHECK_FILE_EQUALFailingTestMethodWithUnequalInput_()
+{
+    unsigned char actualData[] = { 0x00, 0x01, 0x03, 0x03 };
+
+    CHECK_FILE_EQUAL("golden.bin", actualData, sizeof(actualData));
+    TestTestingFixture::lineExecutedAfterCheck(); // LCOV_EXCL_LINE
+} // LCOV_EXCL_LINE
+
+TEST(UnitTestMacros, CHECK_FILE_EQUALFailureWithUnequalInput)
+{
+    setFakeGoldenFile(goldenData_, sizeof(goldenData_));
+    fixture.runTestWithMethod(CHECK_FILE_EQUALFailingTestMethodWithUnequalInput_);
+    CHECK_TEST_FAILS_PROPER_WITH_TEXT("golden file <golden.bin> differs at offset 2, it has 4 bytes and the actual contents have 4");
+    CHECK_TEST_FAILS_PROPER_WITH_TEXT("expected <00 01 02 03>");
+    CHECK_TEST_FAILS_PROPER_WITH_TEXT("but was  <00 01 03 03>");
+    CHECK_TEST_FAILS_PROPER_WITH_TEXT("difference starts at position 2");
+}
+
+static void CHECK_FILE_EQUALFailingTestMethodWithShorterInput_()
+{
+    CHECK_FILE_EQUAL_TEXT("golden.bin", goldenData_, 3, "shorter");
+    TestTestingFixture::lineExecutedAfterCheck(); // LCOV_EXCL_LINE
+} // LCOV_EXCL_LINE
+
+TEST(UnitTestMacros, CHECK_FILE_EQUAL_TEXTFailureWithShorterInput)
+{
+    setFakeGoldenFile(goldenData_, sizeof(goldenData_));
+    fixture.runTestWithMethod(CHECK_FILE_EQUALFailingTestMethodWithShorterInput_);
+    CHECK_TEST_FAILS_PROPER_WITH_TEXT("Message: shorter");
+    CHECK_TEST_FAILS_PROPER_WITH_TEXT("golden file <golden.bin> differs at offset 3, it has 4 bytes and the actual contents have 3");
+    CHECK_TEST_FAILS_PROPER_WITH_TEXT("expected <00 01 02 03>");
+    CHECK_TEST_FAILS_PROPER_WITH_TEXT("but was  <00 01 02>");
+}
+
+static void CHECK_FILE_EQUALFailingTestMethodWithMissingGoldenFile_()
+{
+    CHECK_FILE_EQUAL("missing.bin", goldenData_, sizeof(goldenData_));
+    TestTestingFixture::lineExecutedAfterCheck(); // LCOV_EXCL_LINE
+} // LCOV_EXCL_LINE
+
+TEST(UnitTestMacros, CHECK_FILE_EQUALFailureWithMissingGoldenFile)
+{
+    UT_PTR_SET(PlatformSpecificMapFile, failMapGoldenFile_);
+    UT_PTR_SET(PlatformSpecificFOpen, failFOpenGoldenFile_);
+    fixture.runTestWithMethod(CHECK_FILE_EQUALFailingTestMethodWithMissingGoldenFile_);
+    CHECK_TEST_FAILS_PROPER_WITH_TEXT("golden file <missing.bin> could not be read (run with -ug to create it)");
+}
+
+TEST(UnitTestMacros, CHECK_FILE_EQUALWritesTheGoldenFileWhenUpdatingGoldenFiles)
+{
+    unsigned char actualData[] = { 0x04, 0x05, 0x06 };
+    setFakeGoldenFile(goldenData_, sizeof(goldenData_));
+    UtestShell::setUpdateGoldenFiles(true);
+
+    CHECK_FILE_EQUAL("golden.bin", actualData, sizeof(actualData));
+
+    MEMCMP_EQUAL(actualData, fakeGoldenFile_, sizeof(actualData));
+    LONGS_EQUAL(sizeof(actualData), fakeGoldenFileSize_);
+}
+
+static void CHECK_FILE_EQUALFailingTestMethodWhenTheGoldenFileCantBeWritten_()
+{
+    UtestShell::setUpdateGoldenFiles(true);
+    CHECK_FILE_EQUAL("readonly.bin", goldenData_, sizeof(goldenData_));
+    TestTestingFixture::lineExecutedAfterCheck(); // LCOV_EXCL_LINE
+} // LCOV_EXCL_LINE
+
+TEST(UnitTestMacros, CHECK_FILE_EQUALFailureWhenTheGoldenFileCantBeWritten)
+{
+    UT_PTR_SET(PlatformSpecificMapFile, failMapGoldenFile_);
+    UT_PTR_SET(PlatformSpecificFOpen, failFOpenGoldenFile_);
+    fixture.runTestWithMethod(CHECK_FILE_EQUALFailingTestMethodWhenTheGoldenFileCantBeWritten_);
+    CHECK_TEST_FAILS_PROPER_WITH_TEXT("golden file <readonly.bin> could not be written");
+}
+
+TEST(UnitTestMacros, CHECK_FILE_EQUALReadsAGoldenFileThatCantBeMapped)
+{
+    setUnmappableFakeGoldenFile(goldenData_, sizeof(goldenData_));
+    CHECK_FILE_EQUAL("golden.bin", goldenData_, sizeof(goldenData_));
+
+    fixture.runTestWithMethod(CHECK_FILE_EQUALFailingTestMethodWithUnequalInput_);
+    CHECK_TEST_FAILS_PROPER_WITH_TEXT("golden file <golden.bin> differs at offset 2, it has 4 bytes and the actual contents have 4");
+}
+
+TEST(UnitTestMacros, CHECK_FILE_EQUALWritesAGoldenFileThatCantBeMapped)
+{
+    unsigned char actualData[] = { 0x04, 0x05, 0x06 };
+    setUnmappableFakeGoldenFile(goldenData_, sizeof(goldenData_));
+    UtestShell::setUpdateGoldenFiles(true);
+
+    CHECK_FILE_EQUAL("golden.bin", actualData, sizeof(actualData));
+
+    MEMCMP_EQUAL(actualData, fakeGoldenFile_, sizeof(actualData));
+    LONGS_EQUAL(sizeof(actualData), fakeGoldenFileSize_);
+}
+
+#if CPPUTEST_USE_STD_C_LIB
+
+static const char* temporaryGoldenFileName_ = "UnitTestMacrosGoldenFile.tmp";
+
+static void CHECK_FILE_EQUALFailingTestMethodWithTheTemporaryGoldenFile_()
+{
+    CHECK_FILE_EQUAL(temporaryGoldenFileName_, goldenData_, 3);
+    TestTestingFixture::lineExecutedAfterCheck(); // LCOV_EXCL_LINE
+} // LCOV_EXCL_LINE
+
+static void checkTheTemporaryGoldenFile()
+{
+    UtestShell::setUpdateGoldenFiles(true);
+    CHECK_FILE_EQUAL(temporaryGoldenFileName_, goldenData_, sizeof(goldenData_));
+    UtestShell::setUpdateGoldenFiles(false);
+    CHECK_FILE_EQUAL(temporaryGoldenFileName_, goldenData_, sizeof(goldenData_));
+
+    TestTestingFixture fixture;
+    fixture.runTestWithMethod(CHECK_FILE_EQUALFailingTestMethodWithTheTemporaryGoldenFile_);
+    remove(temporaryGoldenFileName_);
+    fixture.assertPrintContains("differs at offset 3, it has 4 bytes and the actual contents have 3");
+}
+
+TEST(UnitTestMacros, CHECK_FILE_EQUALWritesAndComparesARealGoldenFile)
+{
+    checkTheTemporaryGoldenFile();
+}
+
+TEST(UnitTestMacros, CHECK_FILE_EQUALWritesAndComparesARealGoldenFileThatCantBeMapped)
+{
+    UT_PTR_SET(PlatformSpecificMapFile, failMapGoldenFile_);
+    checkTheTemporaryGoldenFile();
+}
+
+#endif
+
+TEST(UnitTestMacros, CHECK_FILE_EQUALBehavesAsAProperMacro)
+{
+    setFakeGoldenFile(goldenData_, sizeof(goldenData_));
+    if (false) CHECK_FILE_EQUAL("golden.bin", "TEST", 5);
+    else CHECK_FILE_EQUAL("golden.bin", goldenData_, sizeof(goldenData_));
+}
+
+IGNORE_TEST(UnitTestMacros, CHECK_FILE_EQUALWorksInAnIgnoredTest)
+{
+    CHECK_FILE_EQUAL("golden.bin", "TEST", 5); // LCOV_EXCL_LINE
+} // LCOV_EXCL_LINE
+
 TEST(UnitTestMacros, BITS_EQUALBehavesAsAProperMacro)
 {
     if (false) BITS_EQUAL(0x00, 0xFF, 0xFF);
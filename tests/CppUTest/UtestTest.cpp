@@ -29,6 +29,7 @@
 #include "CppUTest/TestOutput.h"
 #include "CppUTest/TestTestingFixture.h"
 #include "CppUTest/PlatformSpecificFunctions.h"
+#include "CppUTest/MemoryLeakDetector.h"
 
 #if CPPUTEST_USE_STD_C_LIB
 #include <math.h>
@@ -361,6 +362,16 @@ TEST(UtestShell, veryVebose)
     STRCMP_CONTAINS("\n------ before runTest", normalOutput.getOutput().asCharString());
 }
 
+TEST(UtestShell, namesAsCharStringsPointToTheRegisteredNames)
+{
+    const char* file = "file.cpp";
+    UtestShell shell("Group", "name", file, 1);
+
+    STRCMP_EQUAL("Group", shell.getGroupAsCharString());
+    STRCMP_EQUAL("name", shell.getNameAsCharString());
+    POINTERS_EQUAL(file, shell.getFileAsCharString());
+}
+
 class defaultUtestShell: public UtestShell
 {
 };
@@ -404,6 +415,211 @@ TEST(UtestShell, TestDefaultCrashMethodInSeparateProcessTest)
 
 #endif
 
+#if CPPUTEST_USE_MEM_LEAK_DETECTION
+
+static int childExitCodes[10];
+static int startedChildren;
+static int endedChildren;
+static int childWithOtherExitCode;
+static int otherExitCode;
+
+static int startChildInThisProcess(int (*function)(void*), void* data)
+{
+    childExitCodes[startedChildren] = function(data);
+    return ++startedChildren;
+}
+
+static int waitForChildInThisProcess(const int*, size_t, int* result)
+{
+    *result = childExitCodes[endedChildren];
+    if (endedChildren + 1 == childWithOtherExitCode) *result = otherExitCode;
+    return ++endedChildren;
+}
+
+static int failToStartChild(int (*)(void*), void*)
+{
+    return -1;
+}
+
+static void allocatingTwiceAndCheckingForNull_()
+{
+    char* memory = (char*) malloc(10);
+    CHECK(memory != NULLPTR);
+    free(memory);
+    memory = (char*) malloc(20);
+    CHECK(memory != NULLPTR);
+    free(memory);
+}
+
+TEST_GROUP(UtestShellAllocationFailureSweep)
+{
+    TestTestingFixture fixture;
+    int (*originalStartChildProcess)(int (*)(void*), void*);
+    int (*originalWaitForChildProcess)(const int*, size_t, int*);
+
+    void setup() CPPUTEST_OVERRIDE
+    {
+        originalStartChildProcess = PlatformSpecificStartChildProcess;
+        originalWaitForChildProcess = PlatformSpecificWaitForChildProcess;
+        startedChildren = 0;
+        endedChildren = 0;
+        childWithOtherExitCode = 0;
+        UT_PTR_SET(PlatformSpecificStartChildProcess, startChildInThisProcess);
+        UT_PTR_SET(PlatformSpecificWaitForChildProcess, waitForChildInThisProcess);
+    }
+
+    void teardown() CPPUTEST_OVERRIDE
+    {
+        UtestShell::setAllocationFailureSweep(0);
+    }
+};
+
+TEST(UtestShellAllocationFailureSweep, isOffByDefault)
+{
+    fixture.setTestFunction(allocatingTwiceAndCheckingForNull_);
+    fixture.runAllTests();
+    LONGS_EQUAL(0, startedChildren);
+    LONGS_EQUAL(0, fixture.getFailureCount());
+}
+
+TEST(UtestShellAllocationFailureSweep, testThatFailsOnEveryFailingAllocationIsFine)
+{
+    UtestShell::setAllocationFailureSweep(2);
+    fixture.setTestFunction(allocatingTwiceAndCheckingForNull_);
+    fixture.runAllTests();
+    fixture.assertPrintContains("Allocation failure sweep of TEST(ExecFunction, ExecFunction): 2 allocations, 0 passed, 2 failed, 0 leaked, 0 crashed");
+    LONGS_EQUAL(0, fixture.getFailureCount());
+}
+
+TEST(UtestShellAllocationFailureSweep, leakIsReportedWithTheFailingAllocation)
+{
+    UtestShell::setAllocationFailureSweep(2);
+    childWithOtherExitCode = 2;
+    otherExitCode = 0x102;
+    fixture.setTestFunction(allocatingTwiceAndCheckingForNull_);
+    fixture.runAllTests();
+    fixture.assertPrintContains("2 allocations, 0 passed, 1 failed, 1 leaked, 0 crashed");
+    fixture.assertPrintContains("failing allocation 2 leaked memory");
+    LONGS_EQUAL(1, fixture.getFailureCount());
+}
+
+TEST(UtestShellAllocationFailureSweep, crashIsReportedWithTheFailingAllocation)
+{
+    UtestShell::setAllocationFailureSweep(2);
+    childWithOtherExitCode = 1;
+    otherExitCode = -11;
+    fixture.setTestFunction(allocatingTwiceAndCheckingForNull_);
+    fixture.runAllTests();
+    fixture.assertPrintContains("2 allocations, 0 passed, 1 failed, 0 leaked, 1 crashed");
+    fixture.assertPrintContains("failing allocation 1 crashed with signal 11");
+}
+
+TEST(UtestShellAllocationFailureSweep, failsWhenChildrenCantBeStarted)
+{
+    UtestShell::setAllocationFailureSweep(2);
+    UT_PTR_SET(PlatformSpecificStartChildProcess, failToStartChild);
+    fixture.setTestFunction(allocatingTwiceAndCheckingForNull_);
+    fixture.runAllTests();
+    fixture.assertPrintContains("-af doesn't work on this platform, as it can't start child processes");
+}
+
+TEST(UtestShellAllocationFailureSweep, isNotDoneWhenSetupFailed)
+{
+    UtestShell::setAllocationFailureSweep(2);
+    fixture.setSetup(failMethod_);
+    fixture.runAllTests();
+    LONGS_EQUAL(0, startedChildren);
+}
+
+TEST(UtestShellAllocationFailureSweep, unexpectedExitIsReportedAsCrash)
+{
+    UtestShell::setAllocationFailureSweep(2);
+    childWithOtherExitCode = 2;
+    otherExitCode = 42;
+    fixture.setTestFunction(allocatingTwiceAndCheckingForNull_);
+    fixture.runAllTests();
+    fixture.assertPrintContains("failing allocation 2 crashed with exit code 42");
+}
+
+#if defined(CPPUTEST_HAVE_FORK) && defined(CPPUTEST_HAVE_WAITPID)
+
+#include <unistd.h>
+
+static void leakingWhenSecondAllocationFails_()
+{
+    char* first = (char*) malloc(10);
+    char* second = (char*) malloc(10);
+    if (second == NULLPTR) return;
+    free(second);
+    free(first);
+}
+
+static void crashingOnFailingAllocation_()
+{
+    char* memory = (char*) malloc(10);
+    if (memory == NULLPTR) UtestShell::crash();
+    free(memory);
+}
+
+static void exitingOnFailingAllocation_()
+{
+    char* memory = (char*) malloc(10);
+    if (memory == NULLPTR) _exit(1);
+    free(memory);
+}
+
+TEST(UtestShellAllocationFailureSweep, runsEveryFailingAllocationInAChildProcess)
+{
+    UtestShell::setAllocationFailureSweep(2);
+    UT_PTR_SET(PlatformSpecificStartChildProcess, originalStartChildProcess);
+    UT_PTR_SET(PlatformSpecificWaitForChildProcess, originalWaitForChildProcess);
+    fixture.setTestFunction(crashingOnFailingAllocation_);
+    fixture.runAllTests();
+    fixture.assertPrintContains("1 allocations, 0 passed, 0 failed, 0 leaked, 1 crashed");
+    fixture.assertPrintContains("failing allocation 1 crashed with signal");
+}
+
+TEST(UtestShellAllocationFailureSweep, leakInChildProcessIsReported)
+{
+    UtestShell::setAllocationFailureSweep(2);
+    UT_PTR_SET(PlatformSpecificStartChildProcess, originalStartChildProcess);
+    UT_PTR_SET(PlatformSpecificWaitForChildProcess, originalWaitForChildProcess);
+    fixture.setTestFunction(leakingWhenSecondAllocationFails_);
+    fixture.runAllTests();
+    fixture.assertPrintContains("2 allocations, 1 passed, 0 failed, 1 leaked, 0 crashed");
+    fixture.assertPrintContains("failing allocation 2 leaked memory");
+}
+
+TEST(UtestShellAllocationFailureSweep, exitInChildProcessIsNotTakenForAnOutcome)
+{
+    UtestShell::setAllocationFailureSweep(2);
+    UT_PTR_SET(PlatformSpecificStartChildProcess, originalStartChildProcess);
+    UT_PTR_SET(PlatformSpecificWaitForChildProcess, originalWaitForChildProcess);
+    fixture.setTestFunction(exitingOnFailingAllocation_);
+    fixture.runAllTests();
+    fixture.assertPrintContains("1 allocations, 0 passed, 0 failed, 0 leaked, 1 crashed");
+    fixture.assertPrintContains("failing allocation 1 crashed with exit code 1");
+}
+
+TEST(UtestShellAllocationFailureSweep, onlyTheSweepChildrenAreWaitedFor)
+{
+    UtestShell::setAllocationFailureSweep(2);
+    UT_PTR_SET(PlatformSpecificStartChildProcess, originalStartChildProcess);
+    UT_PTR_SET(PlatformSpecificWaitForChildProcess, originalWaitForChildProcess);
+    int otherChild = PlatformSpecificFork();
+    if (otherChild == 0) _exit(0);
+    fixture.setTestFunction(allocatingTwiceAndCheckingForNull_);
+    fixture.runAllTests();
+
+    int status = 0;
+    LONGS_EQUAL(otherChild, PlatformSpecificWaitPid(otherChild, &status, 0));
+    fixture.assertPrintContains("2 allocations, 0 passed, 2 failed, 0 leaked, 0 crashed");
+}
+
+#endif
+
+#endif
+
 #if CPPUTEST_HAVE_EXCEPTIONS
 
 static bool destructorWasCalledOnFailedTest = false;
@@ -27,6 +27,7 @@
 
 #include "CppUTest/TestHarness.h"
 #include "CppUTest/TestOutput.h"
+#include "CppUTest/PlatformSpecificFunctions.h"
 #include "CppUTestExt/MemoryReporterPlugin.h"
 #include "CppUTestExt/MemoryReportFormatter.h"
 #include "CppUTestExt/MockSupport.h"
@@ -52,6 +53,18 @@ public:
 class MockMemoryReportFormatter : public MemoryReportFormatter
 {
 public:
+    virtual void report_testrun_start(TestResult* result) CPPUTEST_OVERRIDE
+    {
+        TemporaryDefaultNewAllocator tempAlloc(previousNewAllocator);
+        mock("formatter").actualCall("report_testrun_start").withParameter("result", result);
+    }
+
+    virtual void report_testrun_end(TestResult* result) CPPUTEST_OVERRIDE
+    {
+        TemporaryDefaultNewAllocator tempAlloc(previousNewAllocator);
+        mock("formatter").actualCall("report_testrun_end").withParameter("result", result);
+    }
+
     virtual void report_testgroup_start(TestResult* result, UtestShell& test) CPPUTEST_OVERRIDE
     {
         TemporaryDefaultNewAllocator tempAlloc(previousNewAllocator);
@@ -273,6 +286,37 @@ TEST(MemoryReporterPlugin, endOfaTestGroupWillReportSo)
     reporter->postTestAction(thirdTest, *result);
 }
 
+TEST(MemoryReporterPlugin, testRunActionsReportTheTestRun)
+{
+    mock("formatter").expectOneCall("report_testrun_start").withParameter("result", result);
+    mock("formatter").expectOneCall("report_testrun_end").withParameter("result", result);
+
+    reporter->preTestRunAction(*result);
+    reporter->postTestRunAction(*result);
+}
+
+TEST(MemoryReporterPlugin, groupWhoseNextTestDoesntRunEndsWhenTheNextGroupStartsOrTheTestRunEnds)
+{
+    UtestForMemoryReportingPlugingTest fourthTest("differentGroupName", NULLPTR);
+    UtestForMemoryReportingPlugingTest thirdTest("differentGroupName", &fourthTest);
+    UtestForMemoryReportingPlugingTest secondTest("groupname", &thirdTest);
+    UtestForMemoryReportingPlugingTest firstTest("groupname", &secondTest);
+
+    mock("formatter").strictOrder();
+    mock("formatter").expectOneCall("report_testrun_start").withParameter("result", result);
+    mock("formatter").expectOneCall("report_testgroup_end").withParameter("result", result).withParameter("test", &firstTest);
+    mock("formatter").expectOneCall("report_testgroup_end").withParameter("result", result).withParameter("test", &thirdTest);
+    mock("formatter").expectOneCall("report_testrun_end").withParameter("result", result);
+    mock("formatter").ignoreOtherCalls();
+
+    reporter->preTestRunAction(*result);
+    reporter->preTestAction(firstTest, *result);
+    reporter->postTestAction(firstTest, *result);
+    reporter->preTestAction(thirdTest, *result);
+    reporter->postTestAction(thirdTest, *result);
+    reporter->postTestRunAction(*result);
+}
+
 TEST(MemoryReporterPlugin, preActionReplacesAllocators)
 {
     mock("formatter").ignoreOtherCalls();
@@ -306,6 +350,32 @@ TEST(MemoryReporterPlugin, shouldCreateCodeMemoryReportFormatterWithoutMock)
     CHECK(realReporter.parseArguments(1, cmd_line, 0));
 }
 
+static void* fakeMapTraceFile_(const char*, size_t* size, int)
+{
+    return PlatformSpecificMalloc(*size);
+}
+
+static void fakeUnmapTraceFile_(void* memory, size_t)
+{
+    PlatformSpecificFree(memory);
+}
+
+TEST(MemoryReporterPlugin, shouldCreateTraceMemoryReportFormatterWithoutMock)
+{
+    UT_PTR_SET(PlatformSpecificMapFile, fakeMapTraceFile_);
+    UT_PTR_SET(PlatformSpecificUnmapPages, fakeUnmapTraceFile_);
+    MemoryReporterPlugin realReporter;
+    const char *cmd_line[] = {"-pmemoryreport=trace:memory.trace"};
+    CHECK(realReporter.parseArguments(1, cmd_line, 0));
+}
+
+TEST(MemoryReporterPlugin, shouldCreateSitesMemoryReportFormatterWithoutMock)
+{
+    MemoryReporterPlugin realReporter;
+    const char *cmd_line[] = {"-pmemoryreport=sites:5"};
+    CHECK(realReporter.parseArguments(1, cmd_line, 0));
+}
+
 TEST(MemoryReporterPlugin, shouldntCrashCreateInvalidMemoryReportFormatterWithoutMock)
 {
     MemoryReporterPlugin realReporter;
@@ -241,6 +241,25 @@ TEST(MockFailureTest, MockUnexpectedParameterValueFailure)
                  "\t\tint boo: <20 (0x14)>", failure.getMessage().asCharString());
 }
 
+TEST(MockFailureTest, MockUnexpectedParameterValueFailureWithLongStrings)
+{
+    SimpleString expectedValue = SimpleString("a", 300);
+    SimpleString actualValue = SimpleString("a", 150) + "b" + SimpleString("a", 149);
+    call1->withName("foo").withParameter("boo", expectedValue.asCharString());
+    call2->withName("foo").withParameter("boo", "short");
+    call3->withName("unrelated");
+    addThreeCallsToList();
+
+    MockNamedValue actualParameter("boo");
+    actualParameter.setValue(actualValue.asCharString());
+
+    MockUnexpectedInputParameterFailure failure(UtestShell::getCurrent(), "foo", actualParameter, *list);
+    STRCMP_CONTAINS("\tDIFFERENCE to the first expected call:\n"
+                    "\t\texpected <...aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa...>\n"
+                    "\tbut was  <...aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaabaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa...>\n"
+                    "\tdifference starts at position 150 at: <aaaaaaaaaabaaaaaaaaa>\n", failure.getMessage().asCharString());
+}
+
 TEST(MockFailureTest, MockExpectedParameterDidntHappenFailure)
 {
     call1->withName("foo").withParameter("bar", 2).withParameter("boo", "str");
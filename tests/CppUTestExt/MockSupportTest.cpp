@@ -27,6 +27,7 @@
 
 #include "CppUTest/TestHarness.h"
 #include "CppUTest/TestTestingFixture.h"
+#include "CppUTest/TestMemoryAllocator.h"
 #include "CppUTestExt/MockSupport.h"
 #include "CppUTestExt/MockExpectedCall.h"
 #include "CppUTestExt/MockFailure.h"
@@ -284,3 +285,41 @@ TEST(MockSupportTestWithFixture, failedMockShouldFailAgainWhenRepeated)
         fixture.flushOutputAndResetResult();
     }
 }
+
+#if CPPUTEST_SIMPLESTRING_INLINE_BUFFER_SIZE >= 8
+
+TEST_GROUP(MockSupportStringAllocations)
+{
+    MemoryAccountant accountant;
+    AccountingTestMemoryAllocator* allocator;
+    GlobalSimpleStringAllocatorStash stash;
+
+    void setup() CPPUTEST_OVERRIDE
+    {
+        stash.save();
+        allocator = new AccountingTestMemoryAllocator(accountant, SimpleString::getStringAllocator());
+        SimpleString::setStringAllocator(allocator);
+    }
+
+    void teardown() CPPUTEST_OVERRIDE
+    {
+        mock().clear();
+        stash.restore();
+        delete allocator;
+    }
+};
+
+/* Each iteration below used to allocate over a hundred strings. Its names are short enough to stay inline now */
+TEST(MockSupportStringAllocations, shortNamesInAMockHeavyTestDoNotAllocateStrings)
+{
+    for (int i = 0; i < 100; i++) {
+        mock().expectOneCall("read").withParameter("fd", i).withParameter("size", 16).andReturnValue(i);
+        mock().actualCall("read").withParameter("fd", i).withParameter("size", 16).returnIntValue();
+    }
+    mock().checkExpectations();
+    mock().clear();
+
+    LONGS_EQUAL(0, accountant.totalAllocations());
+}
+
+#endif
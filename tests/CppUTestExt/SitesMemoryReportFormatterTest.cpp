@@ -0,0 +1,258 @@
+/*
+ * Copyright (c) 2007, Michael Feathers, James Grenning and Bas Vodde
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE EARLIER MENTIONED AUTHORS ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <copyright holder> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTest/TestOutput.h"
+#include "CppUTest/PlatformSpecificFunctions.h"
+#include "CppUTestExt/MemoryReportAllocator.h"
+#include "CppUTestExt/SitesMemoryReportFormatter.h"
+
+static void* (*originalMalloc_)(size_t) = NULLPTR;
+
+static void* failLargeMalloc_(size_t size)
+{
+    if (size >= 2048) return NULLPTR;
+    return originalMalloc_(size);
+}
+
+TEST_GROUP(SitesMemoryReportFormatter)
+{
+    char memory[2000];
+    TestMemoryAllocator* allocator;
+    StringBufferTestOutput testOutput;
+    TestResult* testResult;
+    UtestShell* test;
+    SitesMemoryReportFormatter* formatter;
+
+    void setup() CPPUTEST_OVERRIDE
+    {
+        allocator = defaultMallocAllocator();
+        originalMalloc_ = PlatformSpecificMalloc;
+        testResult = new TestResult(testOutput);
+        test = new UtestShell("group", "test", "file", 1);
+        formatter = new SitesMemoryReportFormatter(3);
+        formatter->report_testgroup_start(testResult, *test);
+        formatter->report_test_start(testResult, *test);
+    }
+
+    void teardown() CPPUTEST_OVERRIDE
+    {
+        delete formatter;
+        delete test;
+        delete testResult;
+    }
+
+    void alloc(size_t index, size_t size, const char* file, size_t line)
+    {
+        formatter->report_alloc_memory(testResult, allocator, size, memory + index, file, line);
+    }
+
+    void dealloc(size_t index)
+    {
+        formatter->report_free_memory(testResult, allocator, memory + index, "file", 1);
+    }
+};
+
+TEST(SitesMemoryReportFormatter, countsAllocationsAndBytesPerSite)
+{
+    alloc(0, 10, "file", 1);
+    alloc(1, 20, "file", 1);
+    alloc(2, 5, "file", 2);
+
+    LONGS_EQUAL(2, formatter->numberOfSites());
+    LONGS_EQUAL(2, formatter->findSite("file", 1)->allocations_);
+    LONGS_EQUAL(30, formatter->findSite("file", 1)->bytes_);
+    LONGS_EQUAL(1, formatter->findSite("file", 2)->allocations_);
+    POINTERS_EQUAL(NULLPTR, formatter->findSite("file", 3));
+}
+
+TEST(SitesMemoryReportFormatter, failedAllocationsAreNotCounted)
+{
+    formatter->report_alloc_memory(testResult, allocator, 10, NULLPTR, "file", 1);
+    LONGS_EQUAL(0, formatter->numberOfSites());
+}
+
+TEST(SitesMemoryReportFormatter, lifetimeIsTheNumberOfAllocationsDoneWhileAlive)
+{
+    alloc(0, 10, "file", 1);
+    alloc(1, 10, "file", 2);
+    alloc(2, 10, "file", 2);
+    dealloc(0);
+    dealloc(2);
+
+    LONGS_EQUAL(1, formatter->findSite("file", 1)->frees_);
+    LONGS_EQUAL(2, formatter->findSite("file", 1)->lifetimes_);
+    LONGS_EQUAL(1, formatter->findSite("file", 2)->frees_);
+    LONGS_EQUAL(0, formatter->findSite("file", 2)->lifetimes_);
+}
+
+TEST(SitesMemoryReportFormatter, freeOfMemoryThatWasntReportedIsIgnored)
+{
+    alloc(0, 10, "file", 1);
+    dealloc(1);
+    LONGS_EQUAL(0, formatter->findSite("file", 1)->frees_);
+}
+
+TEST(SitesMemoryReportFormatter, remembersTheTestThatAllocatedMostFromASite)
+{
+    UtestShell busiest("group", "busiest", "file", 1);
+    alloc(0, 10, "file", 1);
+    formatter->report_test_start(testResult, busiest);
+    alloc(1, 10, "file", 1);
+    alloc(2, 10, "file", 1);
+    formatter->report_test_start(testResult, *test);
+    alloc(3, 10, "file", 1);
+
+    POINTERS_EQUAL(&busiest, formatter->findSite("file", 1)->busiestTest_);
+    LONGS_EQUAL(2, formatter->findSite("file", 1)->busiestTestAllocations_);
+}
+
+TEST(SitesMemoryReportFormatter, groupCountsStartOverForEveryGroup)
+{
+    alloc(0, 10, "file", 1);
+    formatter->report_testgroup_start(testResult, *test);
+    alloc(1, 20, "file", 1);
+    dealloc(0);
+
+    const MemoryAllocationSite* site = formatter->findSite("file", 1);
+    LONGS_EQUAL(2, site->allocations_);
+    LONGS_EQUAL(1, site->groupAllocations_);
+    LONGS_EQUAL(20, site->groupBytes_);
+    LONGS_EQUAL(1, site->groupFrees_);
+}
+
+TEST(SitesMemoryReportFormatter, printsTheTopSitesOfTheGroupAndTheTestRunAtTheEnd)
+{
+    alloc(0, 10, "file", 1);
+    alloc(1, 10, "file", 2);
+    alloc(2, 10, "file", 2);
+    alloc(3, 10, "file", 3);
+    alloc(4, 10, "file", 3);
+    alloc(5, 10, "file", 3);
+    alloc(6, 10, "file", 4);
+    dealloc(6);
+    formatter->report_testgroup_end(testResult, *test);
+    formatter->report_testrun_end(testResult);
+
+    STRCMP_CONTAINS("Allocation sites of TEST_GROUP(group), top 3 of 4:\n"
+                    "    allocs        bytes  lifetime  site\n"
+                    "         3           30         -  file:3\n"
+                    "         2           20         -  file:2\n", testOutput.getOutput().asCharString());
+    STRCMP_CONTAINS("Allocation sites of the test run, top 3 of 4:\n", testOutput.getOutput().asCharString());
+    STRCMP_CONTAINS("         3           30         -  file:3  busiest TEST(group, test) with 3\n", testOutput.getOutput().asCharString());
+    STRCMP_CONTAINS("file:1", testOutput.getOutput().asCharString());
+    CHECK(!testOutput.getOutput().contains("file:4"));
+}
+
+TEST(SitesMemoryReportFormatter, printsTheAverageLifetime)
+{
+    alloc(0, 10, "file", 1);
+    alloc(1, 10, "file", 2);
+    dealloc(0);
+    alloc(0, 10, "file", 1);
+    dealloc(0);
+    formatter->report_testgroup_end(testResult, *test);
+
+    STRCMP_CONTAINS("         2           20       0.5  file:1\n", testOutput.getOutput().asCharString());
+}
+
+TEST(SitesMemoryReportFormatter, theTestRunIsOnlyPrintedAtTheEndOfTheTestRun)
+{
+    alloc(0, 10, "file", 1);
+    formatter->report_testgroup_end(testResult, *test);
+
+    STRCMP_CONTAINS("TEST_GROUP(group)", testOutput.getOutput().asCharString());
+    CHECK(!testOutput.getOutput().contains("the test run"));
+}
+
+TEST(SitesMemoryReportFormatter, everyRepetitionOfTheTestRunIsCountedOnItsOwn)
+{
+    alloc(0, 10, "file", 1);
+    formatter->report_testrun_end(testResult);
+    formatter->report_testrun_start(testResult);
+    formatter->report_testgroup_start(testResult, *test);
+    formatter->report_test_start(testResult, *test);
+    alloc(1, 20, "file", 1);
+    formatter->report_testrun_end(testResult);
+
+    const MemoryAllocationSite* site = formatter->findSite("file", 1);
+    LONGS_EQUAL(1, site->allocations_);
+    LONGS_EQUAL(20, site->bytes_);
+    STRCMP_CONTAINS("         1           20         -  file:1  busiest TEST(group, test) with 1\n", testOutput.getOutput().asCharString());
+}
+
+TEST(SitesMemoryReportFormatter, nothingIsPrintedWithoutAllocations)
+{
+    formatter->report_testgroup_end(testResult, *test);
+    formatter->report_testrun_end(testResult);
+    STRCMP_EQUAL("", testOutput.getOutput().asCharString());
+}
+
+TEST(SitesMemoryReportFormatter, keepsCountingWhenTheTablesGrow)
+{
+    for (size_t i = 0; i < 1000; i++)
+        alloc(i, 1, "file", i);
+    for (size_t i = 0; i < 1000; i += 2)
+        dealloc(i);
+    for (size_t i = 0; i < 1000; i++)
+        alloc(1000 + i, 1, "file", i % 10);
+    for (size_t i = 1; i < 1000; i += 2)
+        dealloc(i);
+
+    LONGS_EQUAL(1000, formatter->numberOfSites());
+    LONGS_EQUAL(101, formatter->findSite("file", 5)->allocations_);
+    LONGS_EQUAL(1, formatter->findSite("file", 5)->frees_);
+    LONGS_EQUAL(1, formatter->findSite("file", 999)->frees_);
+    LONGS_EQUAL(1000, formatter->findSite("file", 999)->lifetimes_);
+}
+
+TEST(SitesMemoryReportFormatter, stopsCountingWhenTheTablesCantGrow)
+{
+    UT_PTR_SET(PlatformSpecificMalloc, failLargeMalloc_);
+    for (size_t i = 0; i < 200; i++)
+        alloc(i, 1, "file", i);
+    dealloc(0);
+
+    LONGS_EQUAL(128, formatter->numberOfSites());
+    LONGS_EQUAL(1, formatter->findSite("file", 0)->frees_);
+    POINTERS_EQUAL(NULLPTR, formatter->findSite("file", 128));
+    STRCMP_EQUAL("Could not allocate memory for the allocation sites, the allocations from here on are not counted\n", testOutput.getOutput().asCharString());
+}
+
+TEST(SitesMemoryReportFormatter, countsNothingWithoutMemoryForTheTables)
+{
+    UT_PTR_SET(PlatformSpecificMalloc, failLargeMalloc_);
+    delete formatter;
+    formatter = new SitesMemoryReportFormatter(3);
+    alloc(0, 10, "file", 1);
+    alloc(1, 10, "file", 1);
+    dealloc(0);
+
+    LONGS_EQUAL(0, formatter->numberOfSites());
+    POINTERS_EQUAL(NULLPTR, formatter->findSite("file", 1));
+    STRCMP_EQUAL("Could not allocate memory for the allocation sites, the allocations from here on are not counted\n", testOutput.getOutput().asCharString());
+}
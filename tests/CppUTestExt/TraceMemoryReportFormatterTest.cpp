@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) 2007, Michael Feathers, James Grenning and Bas Vodde
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the <organization> nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE EARLIER MENTIONED AUTHORS ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL <copyright holder> BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTest/TestOutput.h"
+#include "CppUTest/PlatformSpecificFunctions.h"
+#include "CppUTestExt/MemoryReportAllocator.h"
+#include "CppUTestExt/TraceMemoryReportFormatter.h"
+
+#define TESTOUTPUT_EQUAL(a) STRCMP_EQUAL_LOCATION(a, testOutput.getOutput().asCharString(), "", __FILE__, __LINE__)
+
+static const char* mappedFileName_ = NULLPTR;
+static size_t mappedFileSize_ = 0;
+
+static void* fakeMapFile_(const char* filename, size_t* size, int)
+{
+    mappedFileName_ = filename;
+    mappedFileSize_ = *size;
+    return PlatformSpecificMalloc(*size);
+}
+
+static void fakeUnmapFile_(void* memory, size_t)
+{
+    PlatformSpecificFree(memory);
+}
+
+static void* failMapFile_(const char*, size_t*, int)
+{
+    return NULLPTR;
+}
+
+static void* (*originalMalloc_)(size_t) = NULLPTR;
+
+static void* failLargeMalloc_(size_t size)
+{
+    if (size >= 32 * 1024) return NULLPTR;
+    return originalMalloc_(size);
+}
+
+static unsigned long fakeTime_ = 0;
+
+static unsigned long fakeTimeInMicros_()
+{
+    return fakeTime_;
+}
+
+TEST_GROUP(TraceMemoryReportFormatter)
+{
+    StringBufferTestOutput testOutput;
+    TestResult* testResult;
+
+    void setup() CPPUTEST_OVERRIDE
+    {
+        UT_PTR_SET(PlatformSpecificMapFile, fakeMapFile_);
+        UT_PTR_SET(PlatformSpecificUnmapPages, fakeUnmapFile_);
+        UT_PTR_SET(GetPlatformSpecificTimeInMicros, fakeTimeInMicros_);
+        fakeTime_ = 0;
+        originalMalloc_ = PlatformSpecificMalloc;
+        testResult = new TestResult(testOutput);
+    }
+
+    void teardown() CPPUTEST_OVERRIDE
+    {
+        delete testResult;
+    }
+};
+
+TEST(TraceMemoryReportFormatter, mapsTheTraceFileWithRoomForAllRecords)
+{
+    TraceMemoryReportFormatter formatter("trace.bin", 10, 100);
+
+    CHECK(formatter.isMappedToFile());
+    STRCMP_EQUAL("trace.bin", mappedFileName_);
+    CHECK(mappedFileSize_ >= sizeof(MemoryTraceHeader) + 100 + 10 * sizeof(MemoryTraceRecord));
+}
+
+TEST(TraceMemoryReportFormatter, writesAHeaderDescribingTheTrace)
+{
+    TraceMemoryReportFormatter formatter("trace.bin", 10, 100);
+    const MemoryTraceHeader& header = formatter.header();
+
+    STRCMP_EQUAL("CPPUTRC", header.magic_);
+    LONGS_EQUAL(1, header.version_);
+    LONGS_EQUAL(0x01020304, header.byteOrder_);
+    LONGS_EQUAL(sizeof(size_t), header.wordSize_);
+    LONGS_EQUAL(sizeof(MemoryTraceRecord), header.recordSize_);
+    LONGS_EQUAL(10, header.capacity_);
+    LONGS_EQUAL(100, header.stringTableSize_);
+    LONGS_EQUAL(0, header.recordsWritten_);
+    STRCMP_EQUAL("?", formatter.stringAt(0));
+}
+
+TEST(TraceMemoryReportFormatter, recordsAllocationsAndFrees)
+{
+    TraceMemoryReportFormatter formatter("trace.bin", 10, 100);
+    char* memory = (char*) 0x1234;
+    formatter.report_alloc_memory(testResult, defaultMallocAllocator(), 10, memory, "file", 9);
+    formatter.report_free_memory(testResult, defaultMallocAllocator(), memory, "file", 12);
+
+    LONGS_EQUAL(2, formatter.numberOfRecords());
+    const MemoryTraceRecord& alloc = formatter.record(0);
+    LONGS_EQUAL(memory_trace_alloc, alloc.kind_);
+    LONGS_EQUAL(0x1234, alloc.address_);
+    LONGS_EQUAL(10, alloc.size_);
+    STRCMP_EQUAL("file", formatter.stringAt(alloc.file_));
+    LONGS_EQUAL(9, alloc.line_);
+
+    const MemoryTraceRecord& free = formatter.record(1);
+    LONGS_EQUAL(memory_trace_free, free.kind_);
+    LONGS_EQUAL(0x1234, free.address_);
+    LONGS_EQUAL(12, free.line_);
+}
+
+TEST(TraceMemoryReportFormatter, fileNamesAreStoredOnce)
+{
+    TraceMemoryReportFormatter formatter("trace.bin", 10, 100);
+    const char* file = "file";
+    formatter.report_alloc_memory(testResult, defaultMallocAllocator(), 10, NULLPTR, file, 1);
+    size_t used = formatter.header().stringTableUsed_;
+    formatter.report_alloc_memory(testResult, defaultMallocAllocator(), 10, NULLPTR, file, 2);
+
+    LONGS_EQUAL(used, formatter.header().stringTableUsed_);
+    LONGS_EQUAL(formatter.record(0).file_, formatter.record(1).file_);
+}
+
+TEST(TraceMemoryReportFormatter, namesThatDontFitAreUnknown)
+{
+    TraceMemoryReportFormatter formatter("trace.bin", 10, 4);
+    formatter.report_alloc_memory(testResult, defaultMallocAllocator(), 10, NULLPTR, "long file name", 1);
+
+    STRCMP_EQUAL("?", formatter.stringAt(formatter.record(0).file_));
+}
+
+TEST(TraceMemoryReportFormatter, warnsOnceWhenTheStringTableIsFull)
+{
+    TraceMemoryReportFormatter formatter("trace.bin", 10, 8);
+    formatter.report_alloc_memory(testResult, defaultMallocAllocator(), 10, NULLPTR, "fil", 1);
+    TESTOUTPUT_EQUAL("");
+
+    formatter.report_alloc_memory(testResult, defaultMallocAllocator(), 10, NULLPTR, "long file name", 1);
+    formatter.report_alloc_memory(testResult, defaultMallocAllocator(), 10, NULLPTR, "other file name", 1);
+
+    TESTOUTPUT_EQUAL("The memory trace string table of 8 bytes is full, later file and test names are traced as ?\n");
+}
+
+TEST(TraceMemoryReportFormatter, recordsTheTestOfEveryEvent)
+{
+    TraceMemoryReportFormatter formatter("trace.bin", 10, 100);
+    UtestShell test("groupName", "TestName", "file", 1);
+    formatter.report_test_start(testResult, test);
+    formatter.report_alloc_memory(testResult, defaultMallocAllocator(), 10, NULLPTR, "file", 1);
+    formatter.report_test_end(testResult, test);
+
+    LONGS_EQUAL(memory_trace_test_start, formatter.record(0).kind_);
+    STRCMP_EQUAL("groupName.TestName", formatter.stringAt(formatter.record(0).test_));
+    LONGS_EQUAL(formatter.record(0).test_, formatter.record(1).test_);
+    LONGS_EQUAL(memory_trace_test_end, formatter.record(2).kind_);
+    TESTOUTPUT_EQUAL("");
+}
+
+TEST(TraceMemoryReportFormatter, testNamesAreStoredOnce)
+{
+    TraceMemoryReportFormatter formatter("trace.bin", 10, 100);
+    UtestShell test("groupName", "TestName", "file", 1);
+    formatter.report_test_start(testResult, test);
+    formatter.report_test_end(testResult, test);
+    size_t used = formatter.header().stringTableUsed_;
+    formatter.report_test_start(testResult, test);
+
+    LONGS_EQUAL(used, formatter.header().stringTableUsed_);
+    LONGS_EQUAL(formatter.record(0).test_, formatter.record(2).test_);
+}
+
+TEST(TraceMemoryReportFormatter, recordsMicrosecondsSinceTheTraceStarted)
+{
+    fakeTime_ = 5000;
+    TraceMemoryReportFormatter formatter("trace.bin", 10, 100);
+    fakeTime_ = 5001;
+    formatter.report_alloc_memory(testResult, defaultMallocAllocator(), 10, NULLPTR, "file", 1);
+    fakeTime_ = 5250;
+    formatter.report_free_memory(testResult, defaultMallocAllocator(), NULLPTR, "file", 2);
+
+    LONGS_EQUAL(1, formatter.record(0).timestamp_);
+    LONGS_EQUAL(250, formatter.record(1).timestamp_);
+}
+
+TEST(TraceMemoryReportFormatter, theRingKeepsTheNewestRecords)
+{
+    TraceMemoryReportFormatter formatter("trace.bin", 3, 100);
+    for (size_t i = 1; i <= 5; i++)
+        formatter.report_alloc_memory(testResult, defaultMallocAllocator(), i, NULLPTR, "file", i);
+
+    LONGS_EQUAL(5, formatter.header().recordsWritten_);
+    LONGS_EQUAL(3, formatter.numberOfRecords());
+    LONGS_EQUAL(3, formatter.record(0).size_);
+    LONGS_EQUAL(5, formatter.record(2).size_);
+}
+
+TEST(TraceMemoryReportFormatter, keepsTheTraceInMemoryWhenTheFileCantBeMapped)
+{
+    UT_PTR_SET(PlatformSpecificMapFile, failMapFile_);
+    TraceMemoryReportFormatter formatter("trace.bin", 10, 100);
+    UtestShell test("groupName", "TestName", "file", 1);
+    formatter.report_testgroup_start(testResult, test);
+    formatter.report_testgroup_start(testResult, test);
+    formatter.report_alloc_memory(testResult, defaultMallocAllocator(), 10, NULLPTR, "file", 1);
+
+    CHECK_FALSE(formatter.isMappedToFile());
+    LONGS_EQUAL(1, formatter.numberOfRecords());
+    TESTOUTPUT_EQUAL("Could not map memory trace file trace.bin, the trace is only kept in memory\n");
+}
+
+TEST(TraceMemoryReportFormatter, doesNotTraceWhenTheTraceCantBeAllocated)
+{
+    UT_PTR_SET(PlatformSpecificMapFile, failMapFile_);
+    UT_PTR_SET(PlatformSpecificMalloc, failLargeMalloc_);
+    TraceMemoryReportFormatter formatter("trace.bin", 100000, 100);
+    UtestShell test("groupName", "TestName", "file", 1);
+    formatter.report_testgroup_start(testResult, test);
+    formatter.report_test_start(testResult, test);
+    formatter.report_alloc_memory(testResult, defaultMallocAllocator(), 10, NULLPTR, "file", 1);
+    formatter.report_free_memory(testResult, defaultMallocAllocator(), NULLPTR, "file", 2);
+    formatter.report_test_end(testResult, test);
+
+    CHECK_FALSE(formatter.isTracing());
+    LONGS_EQUAL(0, formatter.numberOfRecords());
+    TESTOUTPUT_EQUAL("Could not allocate memory trace trace.bin, memory is not traced\n");
+}
+
+TEST(TraceMemoryReportFormatter, doesNotTraceWhenTheNameCacheCantBeAllocated)
+{
+    UT_PTR_SET(PlatformSpecificMalloc, failLargeMalloc_);
+    TraceMemoryReportFormatter formatter("trace.bin", 10, 100);
+    UtestShell test("groupName", "TestName", "file", 1);
+    formatter.report_alloc_memory(testResult, defaultMallocAllocator(), 10, NULLPTR, "file", 1);
+    formatter.report_alloc_memory(testResult, defaultMallocAllocator(), 10, NULLPTR, "file", 1);
+
+    CHECK_FALSE(formatter.isTracing());
+    LONGS_EQUAL(0, formatter.numberOfRecords());
+    TESTOUTPUT_EQUAL("Could not allocate memory trace trace.bin, memory is not traced\n");
+}
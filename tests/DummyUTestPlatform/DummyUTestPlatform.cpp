@@ -10,6 +10,8 @@ TestOutput::WorkingEnvironment PlatformSpecificGetWorkingEnvironment()
 void (*PlatformSpecificRunTestInASeperateProcess)(UtestShell* shell, TestPlugin* plugin, TestResult* result) = NULLPTR;
 int (*PlatformSpecificFork)(void) = NULLPTR;
 int (*PlatformSpecificWaitPid)(int pid, int* status, int options) = NULLPTR;
+int (*PlatformSpecificStartChildProcess)(int (*function)(void* data), void* data) = NULLPTR;
+int (*PlatformSpecificWaitForChildProcess)(const int* children, size_t count, int* result) = NULLPTR;
 
 static jmp_buf test_exit_jmp_buf[10];
 static int jmp_buf_index = 0;
@@ -47,6 +49,12 @@ static unsigned long fakeTimeInMillis(void)
 }
 unsigned long (*GetPlatformSpecificTimeInMillis)(void) = fakeTimeInMillis;
 
+static unsigned long fakeTimeInMicros(void)
+{
+    return 0;
+}
+unsigned long (*GetPlatformSpecificTimeInMicros)(void) = fakeTimeInMicros;
+
 static const char* fakeTimeString(void)
 {
     return "";
@@ -87,6 +95,20 @@ static void fakeFPuts(const char* str, PlatformSpecificFile file)
 }
 void (*PlatformSpecificFPuts)(const char* str, PlatformSpecificFile file) = fakeFPuts;
 
+extern "C" size_t fread(void*, size_t, size_t, void*);
+static size_t fakeFRead(void* buffer, size_t size, PlatformSpecificFile file)
+{
+    return fread(buffer, 1, size, file);
+}
+size_t (*PlatformSpecificFRead)(void* buffer, size_t size, PlatformSpecificFile file) = fakeFRead;
+
+extern "C" size_t fwrite(const void*, size_t, size_t, void*);
+static size_t fakeFWrite(const void* buffer, size_t size, PlatformSpecificFile file)
+{
+    return fwrite(buffer, 1, size, file);
+}
+size_t (*PlatformSpecificFWrite)(const void* buffer, size_t size, PlatformSpecificFile file) = fakeFWrite;
+
 extern "C" int fclose(void* stream);
 static void fakeFClose(PlatformSpecificFile file)
 {
@@ -138,3 +160,38 @@ void (*PlatformSpecificMutexDestroy)(PlatformSpecificMutex mtx) = fakeMutexFunc;
 
 extern "C" void abort(void);
 void (*PlatformSpecificAbort)(void) = abort;
+
+static int fakeBacktrace(void**, int)
+{
+    return 0;
+}
+int (*PlatformSpecificBacktrace)(void** addresses, int maxAddresses) = fakeBacktrace;
+
+static void fakeSymbolize(void*, char* name, size_t size)
+{
+    if (size > 0) name[0] = '\0';
+}
+void (*PlatformSpecificSymbolize)(void* address, char* name, size_t size) = fakeSymbolize;
+
+static size_t fakePageSize(void)
+{
+    return 0;
+}
+size_t (*PlatformSpecificPageSize)(void) = fakePageSize;
+
+static void* fakeMapPages(size_t)
+{
+    return 0;
+}
+void* (*PlatformSpecificMapPages)(size_t size) = fakeMapPages;
+
+static void fakePageOperation(void*, size_t) {}
+void (*PlatformSpecificProtectPages)(void* memory, size_t size) = fakePageOperation;
+void (*PlatformSpecificUnmapPages)(void* memory, size_t size) = fakePageOperation;
+void (*PlatformSpecificAdviseHugePages)(void* memory, size_t size) = fakePageOperation;
+
+static void* fakeMapFile(const char*, size_t*, int)
+{
+    return 0;
+}
+void* (*PlatformSpecificMapFile)(const char* filename, size_t* size, int writable) = fakeMapFile;